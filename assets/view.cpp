@@ -24,6 +24,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <config/globals.h>
 #include <database/logs.h>
 #include <flate/flate.h>
+#include <filter/metrics.h>
 
 
 Assets_View::Assets_View ()
@@ -72,6 +73,7 @@ string Assets_View::render (string tpl1, string tpl2)
 {
   // Variable tpl is a relative path. Make it a full one.
   string tpl = filter_url_create_root_path (tpl1, tpl2 + ".html");
+  Filter_Metrics_Timer timer ("template", tpl1 + "/" + tpl2);
 
   // The flate engine crashes if the template does not exist, so be sure it exists.  
   if (!file_or_dir_exists (tpl)) {
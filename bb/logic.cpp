@@ -279,8 +279,10 @@ void bible_logic_log_change (const string& bible, int book, int chapter, const s
   
   string stylesheet = Database_Config_Bible::getExportStylesheet (bible);
 
-  vector <int> existing_verse_numbers = usfm_get_verse_numbers (existing_usfm);
-  vector <int> verse_numbers = usfm_get_verse_numbers (usfm);
+  Filter_Usfm_Chapter existing_chapter (existing_usfm);
+  Filter_Usfm_Chapter new_chapter (usfm);
+  vector <int> existing_verse_numbers = existing_chapter.verse_numbers ();
+  vector <int> verse_numbers = new_chapter.verse_numbers ();
   vector <int> verses = existing_verse_numbers;
   verses.insert (verses.end (), verse_numbers.begin (), verse_numbers.end ());
   verses = array_unique (verses);
@@ -291,8 +293,8 @@ void bible_logic_log_change (const string& bible, int book, int chapter, const s
   body.push_back ("Changes:");
   
   for (auto verse : verses) {
-    string existing_verse_usfm = usfm_get_verse_text (existing_usfm, verse);
-    string verse_usfm = usfm_get_verse_text (usfm, verse);
+    string existing_verse_usfm = existing_chapter.verse_text (verse);
+    string verse_usfm = new_chapter.verse_text (verse);
     if (existing_verse_usfm != verse_usfm) {
       Filter_Text filter_text_old = Filter_Text (bible);
       Filter_Text filter_text_new = Filter_Text (bible);
@@ -445,10 +447,12 @@ void bible_logic_merge_irregularity_mail (vector <string> users, vector <Merge_C
     // Go through all verses available in the USFM,
     // and make a record for each verse,
     // where the USFM differs between the change that the user made and the result that was saved.
-    vector <int> verses = usfm_get_verse_numbers (conflict.result);
+    Filter_Usfm_Chapter change_chapter (conflict.change);
+    Filter_Usfm_Chapter result_chapter (conflict.result);
+    vector <int> verses = result_chapter.verse_numbers ();
     for (auto verse : verses) {
-      string change = usfm_get_verse_text (conflict.change, verse);
-      string result = usfm_get_verse_text (conflict.result, verse);
+      string change = change_chapter.verse_text (verse);
+      string result = result_chapter.verse_text (verse);
       // When there's no change in the verse, skip it.
       if (change == result) continue;
       // Record the difference.
@@ -571,14 +575,17 @@ void bible_logic_client_receive_merge_mail (const string & bible, int book, int
   // Go through all verses from the client,
   // and make a record for each verse,
   // where the USFM differs between client and server.
-  vector <int> verses = usfm_get_verse_numbers (client_old);
+  Filter_Usfm_Chapter client_old_chapter (client_old);
+  Filter_Usfm_Chapter client_new_chapter (client_new);
+  Filter_Usfm_Chapter server_chapter (server);
+  vector <int> verses = client_old_chapter.verse_numbers ();
   for (auto verse : verses) {
-    string client_old_verse = usfm_get_verse_text (client_old, verse);
-    string client_new_verse = usfm_get_verse_text (client_new, verse);
+    string client_old_verse = client_old_chapter.verse_text (verse);
+    string client_new_verse = client_new_chapter.verse_text (verse);
     // When there's no change in the verse as sent by the client, skip further checks.
     if (client_old_verse == client_new_verse) continue;
     // Check whether the client's change made it to the server.
-    string server_verse = usfm_get_verse_text (server, verse);
+    string server_verse = server_chapter.verse_text (verse);
     if (client_new_verse == server_verse) continue;
     // Record the difference.
     client_diff.push_back (client_new_verse);
@@ -718,10 +725,12 @@ void bible_logic_client_no_write_access_mail (const string & bible, int book, in
   // Go through all verses from the client,
   // and make a record for each verse,
   // where the USFM differs between client and server.
-  vector <int> verses = usfm_get_verse_numbers (oldusfm);
+  Filter_Usfm_Chapter old_chapter (oldusfm);
+  Filter_Usfm_Chapter new_chapter (newusfm);
+  vector <int> verses = old_chapter.verse_numbers ();
   for (auto verse : verses) {
-    string client_old_verse = usfm_get_verse_text (oldusfm, verse);
-    string client_new_verse = usfm_get_verse_text (newusfm, verse);
+    string client_old_verse = old_chapter.verse_text (verse);
+    string client_new_verse = new_chapter.verse_text (verse);
     // When there's no change in the verse as sent by the client, skip further checks.
     if (client_old_verse == client_new_verse) continue;
     // Record the difference.
@@ -787,10 +796,12 @@ void bible_logic_recent_save_email (const string & bible, int book, int chapter,
   // Go through all verses available in the USFM,
   // and make a record for each verse,
   // where the USFM differs between the old and the new USFM.
-  vector <int> verses = usfm_get_verse_numbers (new_usfm);
+  Filter_Usfm_Chapter old_chapter (old_usfm);
+  Filter_Usfm_Chapter new_chapter (new_usfm);
+  vector <int> verses = new_chapter.verse_numbers ();
   for (auto verse : verses) {
-    string old_verse = usfm_get_verse_text (old_usfm, verse);
-    string new_verse = usfm_get_verse_text (new_usfm, verse);
+    string old_verse = old_chapter.verse_text (verse);
+    string new_verse = new_chapter.verse_text (verse);
     // When there's no change in the verse, skip further checks.
     if (old_verse == new_verse) continue;
     // Record the difference.
@@ -905,11 +916,14 @@ void bible_logic_optional_merge_irregularity_email (const string & bible, int bo
 
   // Go through all verses available in the USFM,
   // and check the differences for each verse.
-  vector <int> verses = usfm_get_verse_numbers (merged_usfm);
+  Filter_Usfm_Chapter ancestor_chapter (ancestor_usfm);
+  Filter_Usfm_Chapter edited_chapter (edited_usfm);
+  Filter_Usfm_Chapter merged_chapter (merged_usfm);
+  vector <int> verses = merged_chapter.verse_numbers ();
   for (auto verse : verses) {
-    string ancestor_verse_usfm = usfm_get_verse_text (ancestor_usfm, verse);
-    string edited_verse_usfm = usfm_get_verse_text (edited_usfm, verse);
-    string merged_verse_usfm = usfm_get_verse_text (merged_usfm, verse);
+    string ancestor_verse_usfm = ancestor_chapter.verse_text (verse);
+    string edited_verse_usfm = edited_chapter.verse_text (verse);
+    string merged_verse_usfm = merged_chapter.verse_text (verse);
     // There's going to be a check to find out that all the changes the user made,
     // are available among the changes resulting from the merge.
     // If all the changes are there, all is good.
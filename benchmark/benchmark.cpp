@@ -0,0 +1,133 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+#include <benchmark/benchmark.h>
+#include <benchmark/sword.h>
+#include <benchmark/diff.h>
+#include <benchmark/usfm.h>
+#include <benchmark/editor.h>
+#include <benchmark/search.h>
+#include <benchmark/text.h>
+#include <benchmark/merge.h>
+#include <benchmark/checks.h>
+#include <benchmark/notes.h>
+#include <benchmark/sync.h>
+#include <benchmark/flate.h>
+#include <benchmark/server.h>
+#include <benchmark/journal.h>
+#include <benchmark/locale.h>
+#include <benchmark/related.h>
+#include <benchmark/versification.h>
+#include <unittests/utilities.h>
+#include <config/globals.h>
+#include <filter/url.h>
+#include <filter/date.h>
+#include <filter/string.h>
+#include <styles/logic.h>
+#include <database/bibles.h>
+#include <database/state.h>
+
+
+// Gives the moment a timed run starts, in microseconds.
+long benchmark_start ()
+{
+  return filter_date_elapsed_microseconds (0);
+}
+
+
+// Prints the result of a timed run as one line of JSON,
+// so results of different commits can be compared by a script.
+void benchmark_report (string name, int iterations, long start)
+{
+  long microseconds = filter_date_elapsed_microseconds (start);
+  cout << "{ \"benchmark\": \"" << name << "\", \"iterations\": " << iterations << ", \"microseconds\": " << microseconds << " }" << endl;
+}
+
+
+// Gives the chapters of the sample Bible in the "demo" folder.
+vector <BookChapterData> benchmark_bible ()
+{
+  vector <BookChapterData> chapters;
+  string directory = filter_url_create_root_path ("demo");
+  vector <string> files = filter_url_scandir (directory);
+  for (auto & file : files) {
+    if (filter_url_get_extension (file) != "usfm") continue;
+    string usfm = filter_url_file_get_contents (filter_url_create_path (directory, file));
+    vector <BookChapterData> book_chapters = usfm_import (usfm, styles_logic_standard_sheet ());
+    for (auto & data : book_chapters) {
+      if (data.book && data.chapter) chapters.push_back (data);
+    }
+  }
+  return chapters;
+}
+
+
+// Stores the sample Bible in the "demo" folder as a Bible in the sandbox.
+// It gives the name of that Bible.
+string benchmark_store_bible ()
+{
+  string bible = "benchmark";
+  Database_State::create ();
+  Database_Bibles database_bibles;
+  if (!in_array (bible, database_bibles.getBibles ())) {
+    database_bibles.createBible (bible);
+    for (auto & data : benchmark_bible ()) {
+      database_bibles.storeChapter (bible, data.book, data.chapter, data.data);
+    }
+  }
+  return bible;
+}
+
+
+int main (int argc, char **argv)
+{
+  // The benchmarks to run: All of them, or only the ones given on the command line.
+  vector <string> names;
+  for (int i = 1; i < argc; i++) names.push_back (argv [i]);
+  auto enabled = [&names] (string name) {
+    return names.empty () || in_array (name, names);
+  };
+
+  // Directory where the benchmarks will run.
+  testing_directory = "/tmp/bibledit-benchmarks";
+  filter_url_mkdir (testing_directory);
+  refresh_sandbox (false);
+  config_globals_document_root = testing_directory;
+  config_globals_unit_testing = true;
+
+  if (enabled ("sword")) benchmark_sword ();
+  if (enabled ("diff")) benchmark_diff ();
+  if (enabled ("usfm")) benchmark_usfm ();
+  if (enabled ("editor")) benchmark_editor ();
+  if (enabled ("search")) benchmark_search ();
+  if (enabled ("text")) benchmark_text ();
+  if (enabled ("merge")) benchmark_merge ();
+  if (enabled ("checks")) benchmark_checks ();
+  if (enabled ("notes")) benchmark_notes ();
+  if (enabled ("sync")) benchmark_sync ();
+  if (enabled ("flate")) benchmark_flate ();
+  if (enabled ("server")) benchmark_server ();
+  if (enabled ("journal")) benchmark_journal ();
+  if (enabled ("locale")) benchmark_locale ();
+  if (enabled ("related")) benchmark_related ();
+  if (enabled ("versification")) benchmark_versification ();
+
+  refresh_sandbox (false);
+  return 0;
+}
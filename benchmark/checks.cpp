@@ -0,0 +1,50 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <benchmark/checks.h>
+#include <benchmark/benchmark.h>
+#include <checks/run.h>
+#include <database/check.h>
+#include <database/config/bible.h>
+
+
+// Runs the checks on the whole Bible, as the nightly checks do.
+void benchmark_checks ()
+{
+  string bible = benchmark_store_bible ();
+  Database_Check database_check;
+  database_check.create ();
+
+  // Enable the checks that go through every verse.
+  Database_Config_Bible::setCheckDoubleSpacesUsfm (bible, true);
+  Database_Config_Bible::setCheckFullStopInHeadings (bible, true);
+  Database_Config_Bible::setCheckSpaceBeforePunctuation (bible, true);
+  Database_Config_Bible::setCheckSentenceStructure (bible, true);
+  Database_Config_Bible::setCheckParagraphStructure (bible, true);
+  Database_Config_Bible::setCheckWellFormedUsfm (bible, true);
+  Database_Config_Bible::setCheckMissingPunctuationEndVerse (bible, true);
+  Database_Config_Bible::setCheckMatchingPairs (bible, true);
+  Database_Config_Bible::setCheckSpaceEndVerse (bible, true);
+  Database_Config_Bible::setCheckValidUTF8Text (bible, true);
+
+  {
+    long start = benchmark_start ();
+    checks_run (bible);
+    benchmark_report ("checks_bible", 1, start);
+  }
+}
@@ -0,0 +1,74 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+#include <benchmark/diff.h>
+#include <benchmark/benchmark.h>
+#include <filter/diff.h>
+#include <filter/string.h>
+
+
+// Diffs a revision of every chapter of the Bible against the chapter,
+// as the nightly change notifications and the RSS feed do.
+void benchmark_diff ()
+{
+  vector <BookChapterData> chapters = benchmark_bible ();
+
+  // A revision of every chapter that changes every tenth word.
+  vector <string> revisions;
+  for (auto & chapter : chapters) {
+    vector <string> words = filter_string_explode (chapter.data, ' ');
+    for (size_t i = 0; i < words.size (); i += 10) {
+      words [i].append (",");
+    }
+    revisions.push_back (filter_string_implode (words, " "));
+  }
+  
+  {
+    long start = benchmark_start ();
+    for (size_t i = 0; i < chapters.size (); i++) {
+      vector <string> removals, additions;
+      filter_diff_diff (chapters [i].data, revisions [i], &removals, &additions);
+    }
+    benchmark_report ("diff_chapters", chapters.size (), start);
+  }
+
+  // The same diffs spread over a number of threads.
+  {
+    long start = benchmark_start ();
+    atomic <size_t> next (0);
+    vector <thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.push_back (thread ([&] () {
+        for (size_t i = next++; i < chapters.size (); i = next++) {
+          filter_diff_diff (chapters [i].data, revisions [i]);
+        }
+      }));
+    }
+    for (auto & t : threads) t.join ();
+    benchmark_report ("diff_chapters_threads_4", chapters.size (), start);
+  }
+
+  {
+    long start = benchmark_start ();
+    for (size_t i = 0; i < chapters.size (); i++) {
+      filter_diff_word_similarity (chapters [i].data, revisions [i]);
+    }
+    benchmark_report ("diff_word_similarity", chapters.size (), start);
+  }
+}
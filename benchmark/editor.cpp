@@ -0,0 +1,59 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+#include <benchmark/editor.h>
+#include <benchmark/benchmark.h>
+#include <editor/usfm2html.h>
+#include <editor/html2usfm.h>
+#include <styles/logic.h>
+
+
+// Converts the whole Bible to the html for the editors, and back to USFM, as loading and saving chapters do.
+void benchmark_editor ()
+{
+  vector <BookChapterData> chapters = benchmark_bible ();
+  string stylesheet = styles_logic_standard_sheet ();
+
+  // From USFM to html.
+  vector <string> htmls;
+  {
+    long start = benchmark_start ();
+    for (auto & chapter : chapters) {
+      Editor_Usfm2Html editor_usfm2html;
+      editor_usfm2html.load (chapter.data);
+      editor_usfm2html.stylesheet (stylesheet);
+      editor_usfm2html.run ();
+      htmls.push_back (editor_usfm2html.get ());
+    }
+    benchmark_report ("editor_bible_usfm2html", chapters.size (), start);
+  }
+
+  // From html to USFM.
+  {
+    long start = benchmark_start ();
+    for (auto & html : htmls) {
+      Editor_Html2Usfm editor_html2usfm;
+      editor_html2usfm.load (html);
+      editor_html2usfm.stylesheet (stylesheet);
+      editor_html2usfm.run ();
+      editor_html2usfm.get ();
+    }
+    benchmark_report ("editor_bible_html2usfm", htmls.size (), start);
+  }
+}
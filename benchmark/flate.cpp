@@ -0,0 +1,48 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <benchmark/flate.h>
+#include <benchmark/benchmark.h>
+#include <assets/view.h>
+
+
+// Renders page templates through the template engine, as every page request does.
+void benchmark_flate ()
+{
+  vector <pair <string, string> > templates = {
+    { "assets", "header" },
+    { "assets", "xhtml_start" },
+    { "bb", "manage" },
+    { "edit", "index" },
+    { "help", "changelog" }
+  };
+  int iterations = 200;
+  long start = benchmark_start ();
+  for (int i = 0; i < iterations; i++) {
+    for (auto & element : templates) {
+      Assets_View view;
+      view.set_variable ("title", "Benchmark");
+      view.set_variable ("success_message", "Success");
+      view.set_variable ("error_message", "Error");
+      view.enable_zone ("login");
+      view.enable_zone ("write_access");
+      view.render (element.first, element.second);
+    }
+  }
+  benchmark_report ("flate_render", iterations * templates.size (), start);
+}
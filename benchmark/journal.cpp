@@ -0,0 +1,53 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <benchmark/journal.h>
+#include <benchmark/benchmark.h>
+#include <database/logs.h>
+#include <filter/string.h>
+
+
+// Writes many entries to the journal, as the checks and the sync do, and reads them back.
+void benchmark_journal ()
+{
+  int iterations = 10000;
+  long start = benchmark_start ();
+  for (int i = 0; i < iterations; i++) {
+    Database_Logs::log ("Journal entry " + convert_to_string (i));
+  }
+  Database_Logs::flush ();
+  benchmark_report ("journal_log", iterations, start);
+
+  start = benchmark_start ();
+  string lastfilename;
+  vector <string> filenames = Database_Logs::get (lastfilename);
+  for (auto & filename : filenames) {
+    Database_Logs::entry (filename);
+  }
+  benchmark_report ("journal_read", filenames.size (), start);
+
+  start = benchmark_start ();
+  string filename = "0";
+  int count = 0;
+  while (!Database_Logs::next (filename).empty ()) count++;
+  benchmark_report ("journal_next", count, start);
+
+  start = benchmark_start ();
+  Database_Logs::rotate ();
+  benchmark_report ("journal_rotate", 1, start);
+}
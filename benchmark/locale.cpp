@@ -0,0 +1,58 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <benchmark/locale.h>
+#include <benchmark/benchmark.h>
+#include <database/localization.h>
+#include <database/config/general.h>
+#include <locale/translate.h>
+#include <locale/logic.h>
+#include <filter/url.h>
+
+
+// Translates the strings of the user interface, as a localized page does.
+void benchmark_locale ()
+{
+  string po = filter_url_create_root_path ("locale", "nl.po");
+  Database_Localization database_localization ("nl");
+  database_localization.create (po);
+  vector <string> msgids;
+  for (auto & element : locale_logic_read_po (po)) msgids.push_back (element.first);
+  Database_Config_General::setSiteLanguage ("nl");
+
+  int iterations = 10000;
+  long start = benchmark_start ();
+  for (int i = 0; i < iterations; i++) {
+    translate (msgids [i % msgids.size ()]);
+  }
+  benchmark_report ("locale_translate", iterations, start);
+
+  locale_translate_obfuscation_search = { "Bibledit", "Bible", "Scripture", "Notes", "Consultation" };
+  locale_translate_obfuscation_replace = { "Translation tool", "Book", "Text", "Remarks", "Talk" };
+  locale_translate_obfuscation_compile ();
+  start = benchmark_start ();
+  for (int i = 0; i < iterations; i++) {
+    translate (msgids [i % msgids.size ()]);
+  }
+  benchmark_report ("locale_translate_obfuscate", iterations, start);
+
+  locale_translate_obfuscation_search.clear ();
+  locale_translate_obfuscation_replace.clear ();
+  locale_translate_obfuscation_compile ();
+  Database_Config_General::setSiteLanguage ("");
+}
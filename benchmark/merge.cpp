@@ -0,0 +1,60 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <benchmark/merge.h>
+#include <benchmark/benchmark.h>
+#include <filter/merge.h>
+#include <filter/string.h>
+
+
+// Merges two revisions of every chapter of the Bible, as saving a chapter edited elsewhere does.
+void benchmark_merge ()
+{
+  vector <BookChapterData> chapters = benchmark_bible ();
+
+  // One revision changes the start of every line, the other one the end of every line.
+  vector <string> changes, prioritized_changes;
+  for (auto & chapter : chapters) {
+    vector <string> lines = filter_string_explode (chapter.data, '\n');
+    vector <string> change (lines), prioritized_change (lines);
+    for (size_t i = 0; i < lines.size (); i += 5) {
+      change [i].insert (0, "A ");
+      prioritized_change [i].append (" B");
+    }
+    changes.push_back (filter_string_implode (change, "\n"));
+    prioritized_changes.push_back (filter_string_implode (prioritized_change, "\n"));
+  }
+
+  {
+    long start = benchmark_start ();
+    for (size_t i = 0; i < chapters.size (); i++) {
+      vector <Merge_Conflict> conflicts;
+      filter_merge_run (chapters [i].data, changes [i], prioritized_changes [i], false, conflicts);
+    }
+    benchmark_report ("merge_chapters", chapters.size (), start);
+  }
+
+  {
+    long start = benchmark_start ();
+    for (size_t i = 0; i < chapters.size (); i++) {
+      vector <Merge_Conflict> conflicts;
+      filter_merge_run (chapters [i].data, changes [i], prioritized_changes [i], true, conflicts);
+    }
+    benchmark_report ("merge_chapters_clever", chapters.size (), start);
+  }
+}
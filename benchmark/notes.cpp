@@ -0,0 +1,69 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <benchmark/notes.h>
+#include <benchmark/benchmark.h>
+#include <database/notes.h>
+#include <database/state.h>
+#include <filter/string.h>
+#include <webserver/request.h>
+
+
+// Selects consultation notes the way the notes list does it, from a store of many notes.
+void benchmark_notes ()
+{
+  Webserver_Request request;
+  request.session_logic ()->setUsername ("benchmark");
+  Database_Notes database_notes (&request);
+  database_notes.create ();
+  vector <string> bibles = { "bible1", "bible2" };
+
+  // Notes spread over the books, chapters and verses of two Bibles.
+  int count = 1000;
+  {
+    long start = benchmark_start ();
+    for (int i = 0; i < count; i++) {
+      string bible = bibles [i % 2];
+      int book = 1 + (i % 66);
+      int chapter = 1 + (i % 50);
+      int verse = 1 + (i % 30);
+      database_notes.store_new_note (bible, book, chapter, verse, "Summary " + convert_to_string (i), "Contents of note " + convert_to_string (i), false);
+    }
+    benchmark_report ("notes_store", count, start);
+  }
+
+  // Select on all passages, on a book, on a chapter, and on a verse.
+  vector <int> passage_selectors = { 3, 2, 1, 0 };
+  {
+    long start = benchmark_start ();
+    for (int i = 0; i < 100; i++) {
+      int passage_selector = passage_selectors [i % passage_selectors.size ()];
+      database_notes.select_notes (bibles, 1 + (i % 66), 1 + (i % 50), 1 + (i % 30), passage_selector, 0, 0, "", "", "", false, -1, 0, "", -1);
+    }
+    benchmark_report ("notes_select", 100, start);
+  }
+
+  // Select a page of notes by searching their text.
+  {
+    long start = benchmark_start ();
+    for (int i = 0; i < 100; i++) {
+      database_notes.select_notes (bibles, 0, 0, 0, 3, 0, 0, "", "", "", false, -1, 1, "note " + convert_to_string (i), 50);
+    }
+    benchmark_report ("notes_select_search", 100, start);
+  }
+}
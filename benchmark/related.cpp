@@ -0,0 +1,46 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <benchmark/related.h>
+#include <benchmark/benchmark.h>
+#include <related/logic.h>
+
+
+// Looks up the related passages of verses in the Old and the New Testament, as the related verses resource does.
+void benchmark_related ()
+{
+  vector <Passage> passages = {
+    Passage ("", 1, 10, "6"),
+    Passage ("", 13, 1, "20"),
+    Passage ("", 40, 3, "3"),
+    Passage ("", 42, 3, "4"),
+    Passage ("", 23, 40, "3"),
+    Passage ("", 2, 3, "4"),
+  };
+  // The first lookup parses the XML files with the related passages.
+  {
+    long start = benchmark_start ();
+    related_logic_get_verses ({ passages [0] });
+    benchmark_report ("related_first_lookup", 1, start);
+  }
+  {
+    long start = benchmark_start ();
+    for (auto & passage : passages) related_logic_get_verses ({ passage });
+    benchmark_report ("related_get_verses", passages.size (), start);
+  }
+}
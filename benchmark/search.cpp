@@ -0,0 +1,82 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <benchmark/search.h>
+#include <benchmark/benchmark.h>
+#include <search/logic.h>
+#include <search/terms.h>
+#include <database/bibles.h>
+
+
+// Indexes the whole Bible for searching, and searches it, as the search pages do.
+void benchmark_search ()
+{
+  string bible = benchmark_store_bible ();
+  Database_Bibles database_bibles;
+
+  // Index every chapter.
+  {
+    long start = benchmark_start ();
+    int iterations = 0;
+    for (auto book : database_bibles.getBooks (bible)) {
+      for (auto chapter : database_bibles.getChapters (bible, book)) {
+        search_logic_index_chapter (bible, book, chapter);
+        iterations++;
+      }
+    }
+    benchmark_report ("search_index_chapters", iterations, start);
+  }
+
+  // Words that occur very often, and ones that occur a few times only.
+  vector <string> words = { "the", "LORD", "Jerusalem", "shepherd", "covenant", "Melchizedek" };
+
+  {
+    long start = benchmark_start ();
+    for (auto & word : words) search_logic_search_bible_text (bible, word);
+    benchmark_report ("search_bible_text", words.size (), start);
+  }
+
+  {
+    long start = benchmark_start ();
+    for (auto & word : words) search_logic_search_bible_text_case_sensitive (bible, word);
+    benchmark_report ("search_bible_text_case_sensitive", words.size (), start);
+  }
+
+  {
+    long start = benchmark_start ();
+    for (auto & word : words) search_logic_search_bible_usfm (bible, word);
+    benchmark_report ("search_bible_usfm", words.size (), start);
+  }
+
+  {
+    long start = benchmark_start ();
+    for (auto & word : words) search_logic_search_text (word, { bible });
+    benchmark_report ("search_text", words.size (), start);
+  }
+
+  // The verses similar to a few verses, as the page for similar verses finds them.
+  {
+    vector <string> texts;
+    for (auto verse : { 1, 2, 3 }) texts.push_back (search_logic_get_bible_verse_text (bible, 43, 3, verse));
+    // The first lookup reads the term statistics from the index, and they stay in memory.
+    search_terms_similar (bible, texts [0]);
+    long start = benchmark_start ();
+    for (auto & text : texts) search_terms_similar (bible, text);
+    benchmark_report ("search_similar", texts.size (), start);
+  }
+}
@@ -0,0 +1,75 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <benchmark/server.h>
+#include <benchmark/benchmark.h>
+#include <webserver/webserver.h>
+#include <config/globals.h>
+#include <filter/url.h>
+#include <database/state.h>
+#include <database/login.h>
+#include <database/users.h>
+
+
+// Sends many requests from a number of clients at the same time to the web server.
+void benchmark_server ()
+{
+  Database_State::create ();
+  Database_Login::create ();
+  Database_Users database_users;
+  database_users.create ();
+  database_users.upgrade ();
+
+  // Run the server on a port of its own.
+  config_globals_negotiated_port_number = "18088";
+  config_globals_webserver_running = true;
+  thread server (http_server);
+  this_thread::sleep_for (chrono::milliseconds (500));
+  string address = "http://localhost:" + config_globals_negotiated_port_number;
+
+  // A static file, and pages that go through the request handlers.
+  vector <pair <string, string> > urls = {
+    { "server_static_file", "/css/stylesheet.css" },
+    { "server_page", "/index/index" },
+    { "server_ajax", "/navigation/update?bible=&book=1&chapter=1&verse=1" }
+  };
+  for (auto & url : urls) {
+    int clients = 8;
+    int requests = 25;
+    long start = benchmark_start ();
+    vector <thread> threads;
+    for (int c = 0; c < clients; c++) {
+      threads.push_back (thread ([&] () {
+        for (int r = 0; r < requests; r++) {
+          string error;
+          filter_url_http_get (address + url.second, error, false);
+        }
+      }));
+    }
+    for (auto & t : threads) t.join ();
+    benchmark_report (url.first, clients * requests, start);
+  }
+
+  // Stop the server: It checks the flag after it accepts the next connection.
+  config_globals_webserver_running = false;
+  string error;
+  filter_url_http_get (address, error, false);
+  server.join ();
+  // Give requests still being processed the time to finish.
+  this_thread::sleep_for (chrono::milliseconds (500));
+}
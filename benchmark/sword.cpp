@@ -0,0 +1,96 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+#include <benchmark/sword.h>
+#include <benchmark/benchmark.h>
+#include <unittests/utilities.h>
+#include <filter/url.h>
+#include <filter/string.h>
+#include <filter/shell.h>
+#include <database/versifications.h>
+#include <database/books.h>
+#include <sword/reader.h>
+#include <sword/logic.h>
+
+
+// Compares reading a SWORD module natively with running diatheke.
+void benchmark_sword ()
+{
+  Database_Versifications database_versifications;
+  database_versifications.create ();
+  database_versifications.defaults ();
+  string sword_path = filter_url_create_root_path ("sword");
+
+  // A compressed module with text in every verse of the KJV versification.
+  vector <Passage> passages = database_versifications.getBooksChaptersVerses ("English");
+  map <string, map <int, string> > texts;
+  for (auto & passage : passages) {
+    int verse_count = convert_to_int (passage.verse);
+    for (int verse = 1; verse <= verse_count; verse++) {
+      string testament;
+      int index = 0;
+      if (!sword_reader_get_index (passage.book, passage.chapter, verse, testament, index)) continue;
+      string text = Database_Books::getEnglishFromId (passage.book) + " " + convert_to_string (passage.chapter) + ":" + convert_to_string (verse);
+      texts [testament][index] = "<w lemma=\"strong:G1\">" + text + "</w> and the words of the verse that follow.";
+    }
+  }
+  test_sword_write_module (sword_path, "BENCH", true, texts);
+
+  // Read the whole Bible chapter by chapter.
+  {
+    long start = benchmark_start ();
+    for (auto & passage : passages) {
+      map <int, string> chapter_texts;
+      sword_reader_get_chapter (sword_path, "BENCH", passage.book, passage.chapter, chapter_texts);
+    }
+    benchmark_report ("sword_reader_chapter", passages.size (), start);
+  }
+  
+  // Read the verses of one book one by one, after emptying the block cache.
+  sword_reader_forget ("BENCH");
+  vector <Passage> verses;
+  for (auto & passage : passages) {
+    if (passage.book != 1) continue;
+    int verse_count = convert_to_int (passage.verse);
+    for (int verse = 1; verse <= verse_count; verse++) {
+      verses.push_back (Passage ("", passage.book, passage.chapter, convert_to_string (verse)));
+    }
+  }
+  {
+    long start = benchmark_start ();
+    for (auto & passage : verses) {
+      string text;
+      sword_reader_get_verse (sword_path, "BENCH", passage.book, passage.chapter, convert_to_int (passage.verse), text);
+    }
+    benchmark_report ("sword_reader_verse", verses.size (), start);
+  }
+  
+  // Run diatheke for a sample of the same verses, the way the server used to do it.
+  if (filter_shell_is_present ("diatheke")) {
+    verses.resize (100);
+    long start = benchmark_start ();
+    for (auto & passage : verses) {
+      string osis = Database_Books::getOsisFromId (passage.book);
+      string chapter_verse = convert_to_string (passage.chapter) + ":" + passage.verse;
+      string text, error;
+      filter_shell_run (sword_path, "diatheke", { "-b", "BENCH", "-k", osis, chapter_verse }, &text, &error);
+    }
+    benchmark_report ("sword_diatheke_verse", verses.size (), start);
+  }
+}
@@ -0,0 +1,59 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <benchmark/sync.h>
+#include <benchmark/benchmark.h>
+#include <checksum/logic.h>
+#include <database/bibles.h>
+#include <webserver/request.h>
+
+
+// Calculates the checksums the clients and the Cloud compare when they send and receive Bibles.
+void benchmark_sync ()
+{
+  string bible = benchmark_store_bible ();
+  Webserver_Request request;
+  Database_Bibles database_bibles;
+
+  {
+    long start = benchmark_start ();
+    int iterations = 0;
+    for (auto book : database_bibles.getBooks (bible)) {
+      for (auto chapter : database_bibles.getChapters (bible, book)) {
+        Checksum_Logic::getChapter (&request, bible, book, chapter);
+        iterations++;
+      }
+    }
+    benchmark_report ("sync_checksum_chapters", iterations, start);
+  }
+
+  {
+    long start = benchmark_start ();
+    vector <int> books = database_bibles.getBooks (bible);
+    for (auto book : books) {
+      Checksum_Logic::getBook (&request, bible, book);
+    }
+    benchmark_report ("sync_checksum_books", books.size (), start);
+  }
+
+  {
+    long start = benchmark_start ();
+    Checksum_Logic::getBibles (&request, { bible });
+    benchmark_report ("sync_checksum_bibles", 1, start);
+  }
+}
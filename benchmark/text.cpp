@@ -0,0 +1,55 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#include <benchmark/text.h>
+#include <benchmark/benchmark.h>
+#include <filter/text.h>
+#include <filter/usfm.h>
+#include <filter/string.h>
+#include <database/bibles.h>
+#include <html/text.h>
+#include <text/text.h>
+#include <styles/logic.h>
+
+
+// Exports every book of the Bible to html and to plain text, as the exports do.
+void benchmark_text ()
+{
+  string bible = benchmark_store_bible ();
+  Database_Bibles database_bibles;
+  string stylesheet = styles_logic_standard_sheet ();
+  vector <int> books = database_bibles.getBooks (bible);
+
+  {
+    long start = benchmark_start ();
+    for (auto book : books) {
+      Filter_Text filter_text = Filter_Text (bible);
+      filter_text.html_text_standard = new Html_Text (bible);
+      filter_text.text_text = new Text_Text ();
+      for (auto chapter : database_bibles.getChapters (bible, book)) {
+        string usfm = database_bibles.getChapter (bible, book, chapter);
+        usfm = usfm_remove_word_level_attributes (usfm);
+        filter_text.addUsfmCode (filter_string_trim (usfm));
+      }
+      filter_text.run (stylesheet);
+      filter_text.html_text_standard->get_inner_html ();
+      filter_text.text_text->get ();
+    }
+    benchmark_report ("text_export_books", books.size (), start);
+  }
+}
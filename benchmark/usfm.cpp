@@ -0,0 +1,80 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+#include <benchmark/usfm.h>
+#include <benchmark/benchmark.h>
+#include <filter/usfm.h>
+
+
+// Looks up every verse of long chapters, as the search indexer and the checks do.
+void benchmark_usfm ()
+{
+  vector <BookChapterData> chapters = benchmark_bible ();
+
+  // Psalm 119 is the longest chapter in the Bible.
+  string psalm;
+  for (auto & chapter : chapters) {
+    if ((chapter.book == 19) && (chapter.chapter == 119)) psalm = chapter.data;
+  }
+  
+  // Getting the verses one by one, which goes through the whole chapter for each verse.
+  {
+    long start = benchmark_start ();
+    vector <int> verses = usfm_get_verse_numbers (psalm);
+    for (auto verse : verses) {
+      usfm_get_verse_text (psalm, verse);
+    }
+    benchmark_report ("usfm_psalm_119_verse_by_verse", verses.size (), start);
+  }
+
+  // Getting the verses from the chapter parsed once.
+  {
+    long start = benchmark_start ();
+    Filter_Usfm_Chapter parsed (psalm);
+    vector <int> verses = parsed.verse_numbers ();
+    for (auto verse : verses) {
+      parsed.verse_text (verse);
+    }
+    benchmark_report ("usfm_psalm_119_parsed", verses.size (), start);
+  }
+
+  // The offsets of the verses, as the USFM editor uses them.
+  {
+    long start = benchmark_start ();
+    Filter_Usfm_Chapter parsed (psalm);
+    vector <int> verses = parsed.verse_numbers ();
+    for (auto verse : verses) {
+      parsed.verse_offset (verse);
+    }
+    benchmark_report ("usfm_psalm_119_offsets", verses.size (), start);
+  }
+
+  // Getting all verses of all chapters of the Bible.
+  {
+    long start = benchmark_start ();
+    for (auto & chapter : chapters) {
+      Filter_Usfm_Chapter parsed (chapter.data);
+      vector <int> verses = parsed.verse_numbers ();
+      for (auto verse : verses) {
+        parsed.verse_text (verse);
+      }
+    }
+    benchmark_report ("usfm_bible_parsed", chapters.size (), start);
+  }
+}
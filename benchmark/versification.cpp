@@ -0,0 +1,60 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+#include <benchmark/versification.h>
+#include <benchmark/benchmark.h>
+#include <database/versifications.h>
+#include <database/mappings.h>
+#include <filter/string.h>
+
+
+// Walks through the chapters and verses of the whole Bible, and maps each verse, as the navigation and the resources do.
+void benchmark_versification ()
+{
+  Database_Versifications database_versifications;
+  database_versifications.create ();
+  database_versifications.defaults ();
+  Database_Mappings database_mappings;
+  database_mappings.create1 ();
+  database_mappings.defaults ();
+  database_mappings.create2 ();
+  string name = english ();
+  {
+    long start = benchmark_start ();
+    int iterations = 0;
+    for (auto book : database_versifications.getBooks (name)) {
+      for (auto chapter : database_versifications.getChapters (name, book, true)) {
+        database_versifications.getVerses (name, book, chapter);
+        iterations++;
+      }
+    }
+    benchmark_report ("versification_chapters_verses", iterations, start);
+  }
+  {
+    long start = benchmark_start ();
+    int iterations = 0;
+    for (auto & passage : database_versifications.getBooksChaptersVerses (name)) {
+      for (int verse = 1; verse <= convert_to_int (passage.verse); verse++) {
+        database_mappings.translate (name, "Vulgate", passage.book, passage.chapter, verse);
+        iterations++;
+      }
+    }
+    benchmark_report ("versification_translate", iterations, start);
+  }
+}
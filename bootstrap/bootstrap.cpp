@@ -171,6 +171,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <consistency/input.h>
 #include <webbb/search.h>
 #include <developer/index.h>
+#include <developer/metrics.h>
+#include <developer/prometheus.h>
 #include <paratext/index.h>
 #include <personalize/index.h>
 #include <menu/index.h>
@@ -672,6 +674,16 @@ void bootstrap_index (void * webserver_request)
     request->reply = developer_index (request);
     return;
   }
+
+  if ((url == developer_metrics_url ()) && browser_request_security_okay (request) && developer_metrics_acl (request)) {
+    request->reply = developer_metrics (request);
+    return;
+  }
+  
+  if ((url == developer_prometheus_url ()) && developer_prometheus_acl (request)) {
+    request->reply = developer_prometheus (request);
+    return;
+  }
   
   // Settings menu.
   if ((url == personalize_index_url ()) && browser_request_security_okay (request) && personalize_index_acl (request)) {
@@ -1248,5 +1260,6 @@ void bootstrap_index (void * webserver_request)
   }
 
   // Forward the browser to the default home page.
+  if (!url.empty ()) request->unknown_route = true;
   redirect_browser (request, index_index_url ());
 }
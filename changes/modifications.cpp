@@ -64,15 +64,19 @@ void changes_process_identifiers (Webserver_Request * request,
     string old_chapter_usfm = old_chapter_text.oldtext;
     Database_Modifications_Text new_chapter_text = database_modifications.getUserChapter (user, bible, book, chapter, newId);
     string new_chapter_usfm = new_chapter_text.newtext;
-    vector <int> old_verse_numbers = usfm_get_verse_numbers (old_chapter_usfm);
-    vector <int> new_verse_numbers = usfm_get_verse_numbers (new_chapter_usfm);
+    Filter_Usfm_Chapter old_chapter (old_chapter_usfm);
+    Filter_Usfm_Chapter new_chapter (new_chapter_usfm);
+    vector <int> old_verse_numbers = old_chapter.verse_numbers ();
+    vector <int> new_verse_numbers = new_chapter.verse_numbers ();
     vector <int> verses = old_verse_numbers;
     verses.insert (verses.end (), new_verse_numbers.begin (), new_verse_numbers.end ());
     verses = array_unique (verses);
     sort (verses.begin(), verses.end());
+    // Record the notifications for this chapter in one go.
+    database_modifications.beginNotifications ();
     for (auto verse : verses) {
-      string old_verse_usfm = usfm_get_verse_text (old_chapter_usfm, verse);
-      string new_verse_usfm = usfm_get_verse_text (new_chapter_usfm, verse);
+      string old_verse_usfm = old_chapter.verse_text (verse);
+      string new_verse_usfm = new_chapter.verse_text (verse);
       if (old_verse_usfm != new_verse_usfm) {
         Filter_Text filter_text_old = Filter_Text (bible);
         Filter_Text filter_text_new = Filter_Text (bible);
@@ -110,6 +114,7 @@ void changes_process_identifiers (Webserver_Request * request,
         time_count++;
       }
     }
+    database_modifications.commitNotifications ();
   }
 }
 
@@ -129,8 +134,7 @@ void changes_modifications ()
 
 
   // Check on the health of the modifications database and (re)create it if needed.
-  if (!database_modifications.healthy ()) database_modifications.erase ();
-  database_modifications.create ();
+  database_modifications.checkup ();
   
   
   // Create online change notifications for users who made changes in Bibles
@@ -300,15 +304,19 @@ void changes_modifications ()
         Database_Logs::log ("Change notifications: " + bible + " " + filter_passage_display (book, chapter, ""), Filter_Roles::translator ());
         string old_chapter_usfm = database_modifications.getTeamDiff (bible, book, chapter);
         string new_chapter_usfm = request.database_bibles()->getChapter (bible, book, chapter);
-        vector <int> old_verse_numbers = usfm_get_verse_numbers (old_chapter_usfm);
-        vector <int> new_verse_numbers = usfm_get_verse_numbers (new_chapter_usfm);
+        Filter_Usfm_Chapter old_chapter (old_chapter_usfm);
+        Filter_Usfm_Chapter new_chapter (new_chapter_usfm);
+        vector <int> old_verse_numbers = old_chapter.verse_numbers ();
+        vector <int> new_verse_numbers = new_chapter.verse_numbers ();
         vector <int> verses = old_verse_numbers;
         verses.insert (verses.end (), new_verse_numbers.begin (), new_verse_numbers.end ());
         verses = array_unique (verses);
         sort (verses.begin (), verses.end());
+        // Record the notifications for this chapter in one go.
+        database_modifications.beginNotifications ();
         for (auto verse : verses) {
-          string old_verse_usfm = usfm_get_verse_text (old_chapter_usfm, verse);
-          string new_verse_usfm = usfm_get_verse_text (new_chapter_usfm, verse);
+          string old_verse_usfm = old_chapter.verse_text (verse);
+          string new_verse_usfm = new_chapter.verse_text (verse);
           if (old_verse_usfm != new_verse_usfm) {
             processedChangesCount++;
             // In case of too many change notifications, processing them would take too much time, so take a few shortcuts.
@@ -345,6 +353,8 @@ void changes_modifications ()
             }
           }
         }
+        // Commit the notifications before the diff data is deleted.
+        database_modifications.commitNotifications ();
         // Delete the diff data for this chapter, for two reasons:
         // 1. New diffs for this chapter can be stored straightaway.
         // 2. In case of large amounts of diff data, and this function gets killed,
@@ -396,8 +406,8 @@ void changes_modifications ()
   }
 
   
-  // Index the data and remove expired notifications.
-  Database_Logs::log ("Change notifications: Indexing", Filter_Roles::translator ());
+  // Remove expired notifications.
+  Database_Logs::log ("Change notifications: Trimming", Filter_Roles::translator ());
   database_modifications.indexTrimAllNotifications ();
 
   
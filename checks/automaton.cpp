@@ -0,0 +1,91 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <checks/automaton.h>
+#include <filter/string.h>
+
+
+// The $patterns are those of the check on patterns, with their identifiers equal to their positions.
+// The $pairs are the matching pairs, each character of which is looked for.
+Checks_Automaton::Checks_Automaton (const vector <string> & patterns, const vector <pair <string, string> > & pairs)
+{
+  this->patterns = patterns;
+  this->pairs = pairs;
+  for (auto & pattern : patterns) {
+    add (pattern, kind_pattern);
+  }
+  for (auto & punctuation : punctuations ()) {
+    add (punctuation, kind_punctuation);
+  }
+  vector <string> characters;
+  for (auto & element : pairs) {
+    for (auto & character : {element.first, element.second}) {
+      // The check on the pairs goes through the text character by character.
+      if (unicode_string_length (character) != 1) continue;
+      if (in_array (character, characters)) continue;
+      characters.push_back (character);
+      add (character, kind_pair);
+    }
+  }
+  automaton.compile ();
+}
+
+
+void Checks_Automaton::add (const string & fragment, int kind)
+{
+  automaton.add (fragment, (int) fragments.size ());
+  fragments.push_back (fragment);
+  kinds.push_back (kind);
+}
+
+
+// The fragments the check on a space before punctuation looks for.
+vector <string> Checks_Automaton::punctuations ()
+{
+  return {" ,", " ;", " :", " .", " ?", " !"};
+}
+
+
+mutex checks_automaton_mutex;
+map <string, shared_ptr <Checks_Automaton> > checks_automaton_cache;
+
+
+// Gets the automaton for the checks of the $bible.
+// It is compiled once, and kept as long as the $patterns and the $pairs of the Bible remain the same.
+shared_ptr <Checks_Automaton> Checks_Automaton::get (const string & bible, const vector <string> & patterns, const vector <pair <string, string> > & pairs)
+{
+  lock_guard <mutex> lock (checks_automaton_mutex);
+  shared_ptr <Checks_Automaton> & automaton = checks_automaton_cache [bible];
+  if (!automaton || (automaton->patterns != patterns) || (automaton->pairs != pairs)) {
+    automaton = make_shared <Checks_Automaton> (patterns, pairs);
+  }
+  return automaton;
+}
+
+
+// Scans each of the $texts of the verses once.
+// It returns the identifiers of the fragments found per verse, in the order they occur in the text.
+map <int, vector <int> > Checks_Automaton::scan (const map <int, string> & texts) const
+{
+  map <int, vector <int> > found;
+  for (auto & element : texts) {
+    found [element.first] = automaton.search (element.second);
+  }
+  return found;
+}
@@ -0,0 +1,51 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef INCLUDED_CHECKS_AUTOMATON_H
+#define INCLUDED_CHECKS_AUTOMATON_H
+
+
+#include <config/libraries.h>
+#include <filter/automaton.h>
+
+
+// All fragments the checks look for in the text of the verses,
+// compiled into one automaton, so that each verse is scanned once for all of them.
+class Checks_Automaton
+{
+public:
+  Checks_Automaton (const vector <string> & patterns, const vector <pair <string, string> > & pairs);
+  static shared_ptr <Checks_Automaton> get (const string & bible, const vector <string> & patterns, const vector <pair <string, string> > & pairs);
+  map <int, vector <int> > scan (const map <int, string> & texts) const;
+  // The fragment each identifier stands for, and what kind of fragment it is.
+  vector <string> fragments;
+  vector <int> kinds;
+  static const int kind_pattern = 0;
+  static const int kind_punctuation = 1;
+  static const int kind_pair = 2;
+  static vector <string> punctuations ();
+private:
+  vector <string> patterns;
+  vector <pair <string, string> > pairs;
+  Filter_Automaton automaton;
+  void add (const string & fragment, int kind);
+};
+
+
+#endif
@@ -29,6 +29,18 @@ void Checks_Pairs::run (const string & bible, int book, int chapter,
                         const map <int, string> & texts,
                         const vector <pair <string, string> > & pairs,
                         bool french_citation_style)
+{
+  Checks_Automaton automaton ({}, pairs);
+  run (bible, book, chapter, automaton, automaton.scan (texts), pairs, french_citation_style);
+}
+
+
+// Checks the opening and closing characters of the pairs the $automaton $found in the verses.
+void Checks_Pairs::run (const string & bible, int book, int chapter,
+                        const Checks_Automaton & automaton,
+                        const map <int, vector <int> > & found,
+                        const vector <pair <string, string> > & pairs,
+                        bool french_citation_style)
 {
   // This holds the opener characters of the pairs which were opened in the text.
   // For example, it may hold the "[".
@@ -51,14 +63,13 @@ void Checks_Pairs::run (const string & bible, int book, int chapter,
 
   Database_Check database_check;
 
-  // Go through the verses with their texts.
-  for (auto & element : texts) {
+  // Go through the verses with the characters of the pairs found in them.
+  for (auto & element : found) {
     int verse = element.first;
-    string text = element.second;
-    size_t length = unicode_string_length (text);
-    for (size_t pos = 0; pos < length; pos++) {
+    for (auto id : element.second) {
       
-      string character = unicode_string_substr (text, pos, 1);
+      if (automaton.kinds [id] != Checks_Automaton::kind_pair) continue;
+      const string & character = automaton.fragments [id];
       
       if (in_array (character, openers)) {
         verses.push_back (verse);
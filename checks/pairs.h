@@ -22,6 +22,7 @@
 
 
 #include <config/libraries.h>
+#include <checks/automaton.h>
 
 
 class Checks_Pairs
@@ -31,6 +32,11 @@ public:
                    const map <int, string> & texts,
                    const vector <pair <string, string> > & pairs,
                    bool french_citation_style);
+  static void run (const string & bible, int book, int chapter,
+                   const Checks_Automaton & automaton,
+                   const map <int, vector <int> > & found,
+                   const vector <pair <string, string> > & pairs,
+                   bool french_citation_style);
 private:
   static string match (const string & character, const vector <pair <string, string> > & pairs);
 };
@@ -43,11 +43,214 @@
 #include <checks/index.h>
 #include <checks/settings.h>
 #include <checks/french.h>
+#include <checks/automaton.h>
 #include <email/send.h>
 #include <sendreceive/logic.h>
 #include <rss/logic.h>
+#include <database/styles.h>
+#include <database/versifications.h>
+#include <filter/md5.h>
 
 
+// The settings of the checks of one Bible.
+// They are read once per run, and shared by all threads that check chapters.
+class Checks_Run_Settings
+{
+public:
+  string bible;
+  string stylesheet;
+  bool check_double_spaces_usfm;
+  bool check_full_stop_in_headings;
+  bool check_space_before_punctuation;
+  bool check_sentence_structure;
+  bool check_paragraph_structure;
+  Checks_Sentences checks_sentences;
+  string end_marks;
+  string center_marks;
+  string disregards;
+  vector <string> within_sentence_paragraph_markers;
+  bool check_chapters_verses_versification;
+  bool check_well_formed_usfm;
+  bool check_missing_punctuation_end_verse;
+  bool check_patterns;
+  vector <string> checking_patterns;
+  bool check_matching_pairs;
+  vector <pair <string, string> > matching_pairs;
+  bool check_space_end_verse;
+  bool check_french_punctuation;
+  bool check_french_citation_style;
+  bool check_valid_utf8_text;
+  shared_ptr <Checks_Automaton> automaton;
+  // Everything the output of the checks on a chapter depends on, apart from the chapter itself.
+  string signature;
+};
+
+
+// A chapter to be checked, with the output of the checks on it.
+class Checks_Run_Chapter
+{
+public:
+  int book;
+  int chapter;
+  string usfm;
+  string hash;
+  bool cached;
+  vector <Database_Check_Hit> hits;
+};
+
+
+// Runs the checks that look at one chapter at a time.
+void checks_run_chapter (const Checks_Run_Settings & settings, int book, int chapter, const string & chapterUsfm,
+                         Checks_Sentences & checks_sentences, Checks_Usfm & checks_usfm)
+{
+  const string & bible = settings.bible;
+  Database_Check database_check;
+
+  Filter_Usfm_Chapter parsed_chapter (chapterUsfm);
+  vector <int> verses = parsed_chapter.verse_numbers ();
+  if (settings.check_chapters_verses_versification) Checks_Versification::verses (bible, book, chapter, verses);
+  
+  
+  // Split the chapter into its verses in one pass.
+  map <int, string> verses_usfm = parsed_chapter.verses_text ();
+  for (auto verse : verses) {
+    const string & verseUsfm = verses_usfm [verse];
+    if (settings.check_double_spaces_usfm) {
+      Checks_Space::doubleSpaceUsfm (bible, book, chapter, verse, verseUsfm);
+    }
+    if (settings.check_valid_utf8_text) {
+      if (!unicode_string_is_valid (verseUsfm)) {
+        string msg = "Invalid UTF-8 Unicode in verse text";
+        database_check.recordOutput (bible, book, chapter, verse, msg);
+      }
+    }
+  }
+  
+  
+  Filter_Text filter_text = Filter_Text (bible);
+  filter_text.initializeHeadingsAndTextPerVerse (false);
+  filter_text.addUsfmCode (chapterUsfm);
+  filter_text.run (settings.stylesheet);
+  map <int, string>  verses_headings = filter_text.verses_headings;
+  map <int, string> verses_text = filter_text.getVersesText ();
+  vector <map <int, string>> verses_paragraphs = filter_text.verses_paragraphs;
+  // Scan the text of each verse once for everything the checks on fragments of text look for.
+  map <int, vector <int> > found;
+  if (settings.check_space_before_punctuation || settings.check_patterns || settings.check_matching_pairs) {
+    found = settings.automaton->scan (verses_text);
+  }
+  if (settings.check_full_stop_in_headings) {
+    Checks_Headers::noPunctuationAtEnd (bible, book, chapter, verses_headings, settings.center_marks, settings.end_marks);
+  }
+  if (settings.check_space_before_punctuation) {
+    Checks_Space::spaceBeforePunctuation (bible, book, chapter, * settings.automaton, found);
+  }
+  
+  if (settings.check_sentence_structure || settings.check_paragraph_structure) {
+    checks_sentences.initialize ();
+    if (settings.check_sentence_structure) checks_sentences.check (verses_text);
+    if (settings.check_paragraph_structure) {
+      checks_sentences.paragraphs (filter_text.paragraph_starting_markers,
+                                   settings.within_sentence_paragraph_markers,
+                                   verses_paragraphs);
+    }
+    
+    vector <pair<int, string>> results = checks_sentences.getResults ();
+    for (auto result : results) {
+      int verse = result.first;
+      string msg = result.second;
+      database_check.recordOutput (bible, book, chapter, verse, msg);
+    }
+  }
+  
+  if (settings.check_well_formed_usfm) {
+    checks_usfm.initialize (book, chapter);
+    checks_usfm.check (chapterUsfm);
+    checks_usfm.finalize ();
+    vector <pair<int, string>>  results = checks_usfm.getResults ();
+    for (auto element : results) {
+      int verse = element.first;
+      string msg = element.second;
+      database_check.recordOutput (bible, book, chapter, verse, msg);
+    }
+  }
+  
+  if (settings.check_missing_punctuation_end_verse) {
+    Checks_Verses::missingPunctuationAtEnd (bible, book, chapter, verses_text, settings.center_marks, settings.end_marks, settings.disregards);
+  }
+  
+  if (settings.check_patterns) {
+    Checks_Verses::patterns (bible, book, chapter, * settings.automaton, found);
+  }
+  
+  if (settings.check_matching_pairs) {
+    Checks_Pairs::run (bible, book, chapter, * settings.automaton, found, settings.matching_pairs, settings.check_french_citation_style);
+  }
+  
+  if (settings.check_space_end_verse) {
+    Checks_Space::spaceEndVerse (bible, book, chapter, chapterUsfm);
+  }
+  
+  if (settings.check_french_punctuation) {
+    Checks_French::spaceBeforeAfterPunctuation (bible, book, chapter, verses_headings);
+    Checks_French::spaceBeforeAfterPunctuation (bible, book, chapter, verses_text);
+  }
+  
+  if (settings.check_french_citation_style) {
+    Checks_French::citationStyle (bible, book, chapter, verses_paragraphs);
+  }
+}
+
+
+// A thread that takes the next chapter still to be checked, until all chapters are done.
+// The output of the checks goes into the chapter, not into the database.
+void checks_run_thread (const Checks_Run_Settings * settings, vector <Checks_Run_Chapter> * chapters, atomic <unsigned int> * next)
+{
+  // The sentence and USFM checks keep state, so each thread has its own.
+  Checks_Sentences checks_sentences (settings->checks_sentences);
+  Checks_Usfm checks_usfm (settings->bible);
+  while (true) {
+    unsigned int index = (*next)++;
+    if (index >= chapters->size ()) break;
+    Checks_Run_Chapter & chapter = chapters->at (index);
+    if (chapter.cached) continue;
+    Database_Check::collect (&chapter.hits);
+    checks_run_chapter (* settings, chapter.book, chapter.chapter, chapter.usfm, checks_sentences, checks_usfm);
+    Database_Check::collect (NULL);
+  }
+}
+
+
+// The parts of the stylesheet that the checks depend on.
+string checks_run_stylesheet_signature (string stylesheet)
+{
+  string signature;
+  Database_Styles database_styles;
+  vector <string> markers = database_styles.getMarkers (stylesheet);
+  for (auto & marker : markers) {
+    Database_Styles_Item style = database_styles.getMarkerData (stylesheet, marker);
+    signature.append (marker);
+    signature.append (" " + convert_to_string (style.type));
+    signature.append (" " + convert_to_string (style.subtype));
+    signature.append (" " + convert_to_string (style.userbool1));
+    signature.append (" " + convert_to_string (style.userbool2));
+    signature.append (" " + convert_to_string (style.userbool3));
+    signature.append (" " + convert_to_string (style.userint1));
+    signature.append (" " + convert_to_string (style.userint2));
+    signature.append (" " + convert_to_string (style.userint3));
+    signature.append (" " + style.userstring1);
+    signature.append (" " + style.userstring2);
+    signature.append (" " + style.userstring3);
+    signature.append ("\n");
+  }
+  return signature;
+}
+
+
+// Runs the checks on the $bible.
+// Each chapter is checked once, and the checks of unchanged chapters are not run again.
+// The results of the checks on a chapter are cached together with a hash of the chapter and the settings.
+// Chapters are checked in parallel, and their results recorded in the original order of books and chapters.
 void checks_run (string bible)
 {
   Webserver_Request request;
@@ -66,67 +269,112 @@ void checks_run (string bible)
   database_check.truncateOutput (bible);
   
   
-  string stylesheet = Database_Config_Bible::getExportStylesheet (bible);
-  
-  
-  bool check_double_spaces_usfm = Database_Config_Bible::getCheckDoubleSpacesUsfm (bible);
-  bool check_full_stop_in_headings = Database_Config_Bible::getCheckFullStopInHeadings (bible);
-  bool check_space_before_punctuation = Database_Config_Bible::getCheckSpaceBeforePunctuation (bible);
-  bool check_sentence_structure = Database_Config_Bible::getCheckSentenceStructure (bible);
-  bool check_paragraph_structure = Database_Config_Bible::getCheckParagraphStructure (bible);
-  Checks_Sentences checks_sentences;
-  checks_sentences.enterCapitals (Database_Config_Bible::getSentenceStructureCapitals (bible));
-  checks_sentences.enterSmallLetters (Database_Config_Bible::getSentenceStructureSmallLetters (bible));
-  string end_marks = Database_Config_Bible::getSentenceStructureEndPunctuation (bible);
-  checks_sentences.enterEndMarks (end_marks);
-  string center_marks = Database_Config_Bible::getSentenceStructureMiddlePunctuation (bible);
-  checks_sentences.enterCenterMarks (center_marks);
-  string disregards = Database_Config_Bible::getSentenceStructureDisregards (bible);
-  checks_sentences.enterDisregards (disregards);
-  checks_sentences.enterNames (Database_Config_Bible::getSentenceStructureNames (bible));
-  vector <string> within_sentence_paragraph_markers = filter_string_explode (Database_Config_Bible::getSentenceStructureWithinSentenceMarkers (bible), ' ');
+  Checks_Run_Settings settings;
+  settings.bible = bible;
+  settings.stylesheet = Database_Config_Bible::getExportStylesheet (bible);
+  settings.check_double_spaces_usfm = Database_Config_Bible::getCheckDoubleSpacesUsfm (bible);
+  settings.check_full_stop_in_headings = Database_Config_Bible::getCheckFullStopInHeadings (bible);
+  settings.check_space_before_punctuation = Database_Config_Bible::getCheckSpaceBeforePunctuation (bible);
+  settings.check_sentence_structure = Database_Config_Bible::getCheckSentenceStructure (bible);
+  settings.check_paragraph_structure = Database_Config_Bible::getCheckParagraphStructure (bible);
+  string capitals = Database_Config_Bible::getSentenceStructureCapitals (bible);
+  settings.checks_sentences.enterCapitals (capitals);
+  string small_letters = Database_Config_Bible::getSentenceStructureSmallLetters (bible);
+  settings.checks_sentences.enterSmallLetters (small_letters);
+  settings.end_marks = Database_Config_Bible::getSentenceStructureEndPunctuation (bible);
+  settings.checks_sentences.enterEndMarks (settings.end_marks);
+  settings.center_marks = Database_Config_Bible::getSentenceStructureMiddlePunctuation (bible);
+  settings.checks_sentences.enterCenterMarks (settings.center_marks);
+  settings.disregards = Database_Config_Bible::getSentenceStructureDisregards (bible);
+  settings.checks_sentences.enterDisregards (settings.disregards);
+  string names = Database_Config_Bible::getSentenceStructureNames (bible);
+  settings.checks_sentences.enterNames (names);
+  string within_sentence_markers = Database_Config_Bible::getSentenceStructureWithinSentenceMarkers (bible);
+  settings.within_sentence_paragraph_markers = filter_string_explode (within_sentence_markers, ' ');
   bool check_books_versification = Database_Config_Bible::getCheckBooksVersification (bible);
-  bool check_chapters_verses_versification = Database_Config_Bible::getCheckChaptesVersesVersification (bible);
-  bool check_well_formed_usfm = Database_Config_Bible::getCheckWellFormedUsfm (bible);
-  Checks_Usfm checks_usfm = Checks_Usfm (bible);
-  bool check_missing_punctuation_end_verse = Database_Config_Bible::getCheckMissingPunctuationEndVerse (bible);
-  bool check_patterns = Database_Config_Bible::getCheckPatterns (bible);
+  settings.check_chapters_verses_versification = Database_Config_Bible::getCheckChaptesVersesVersification (bible);
+  settings.check_well_formed_usfm = Database_Config_Bible::getCheckWellFormedUsfm (bible);
+  settings.check_missing_punctuation_end_verse = Database_Config_Bible::getCheckMissingPunctuationEndVerse (bible);
+  settings.check_patterns = Database_Config_Bible::getCheckPatterns (bible);
   string s_checking_patterns = Database_Config_Bible::getCheckingPatterns (bible);
-  vector <string> checking_patterns = filter_string_explode (s_checking_patterns, '\n');
-  bool check_matching_pairs = Database_Config_Bible::getCheckMatchingPairs (bible);
-  vector <pair <string, string> > matching_pairs;
+  settings.checking_patterns = filter_string_explode (s_checking_patterns, '\n');
+  settings.check_matching_pairs = Database_Config_Bible::getCheckMatchingPairs (bible);
+  string s_matching_pairs = Database_Config_Bible::getMatchingPairs (bible);
   {
-    string fragment = Database_Config_Bible::getMatchingPairs (bible);
-    vector <string> pairs = filter_string_explode (fragment, ' ');
+    vector <string> pairs = filter_string_explode (s_matching_pairs, ' ');
     for (auto & pair : pairs) {
       pair = filter_string_trim (pair);
       size_t length = unicode_string_length (pair);
       if (length == 2) {
         string opener = unicode_string_substr (pair, 0, 1);
         string closer = unicode_string_substr (pair, 1, 1);
-        matching_pairs.push_back (make_pair (opener, closer));
+        settings.matching_pairs.push_back (make_pair (opener, closer));
       }
     }
   }
-  bool check_space_end_verse = Database_Config_Bible::getCheckSpaceEndVerse (bible);
-  bool check_french_punctuation = Database_Config_Bible::getCheckFrenchPunctuation (bible);
-  bool check_french_citation_style = Database_Config_Bible::getCheckFrenchCitationStyle (bible);
+  settings.check_space_end_verse = Database_Config_Bible::getCheckSpaceEndVerse (bible);
+  settings.check_french_punctuation = Database_Config_Bible::getCheckFrenchPunctuation (bible);
+  settings.check_french_citation_style = Database_Config_Bible::getCheckFrenchCitationStyle (bible);
   bool transpose_fix_space_in_notes = Database_Config_Bible::getTransposeFixSpacesNotes (bible);
-  bool check_valid_utf8_text = Database_Config_Bible::getCheckValidUTF8Text (bible);
+  settings.check_valid_utf8_text = Database_Config_Bible::getCheckValidUTF8Text (bible);
+  settings.automaton = Checks_Automaton::get (bible, settings.checking_patterns, settings.matching_pairs);
+  {
+    // A change in any of the settings means all chapters need to be checked again.
+    // That includes a change in the data of the versification system, even if its name stays the same.
+    string versification = Database_Config_Bible::getVersificationSystem (bible);
+    Database_Versifications database_versifications;
+    vector <string> signature = {
+      settings.stylesheet,
+      checks_run_stylesheet_signature (settings.stylesheet),
+      versification,
+      md5 (database_versifications.output (versification)),
+      Database_Config_General::getSiteLanguage (),
+      convert_to_string (settings.check_double_spaces_usfm),
+      convert_to_string (settings.check_full_stop_in_headings),
+      convert_to_string (settings.check_space_before_punctuation),
+      convert_to_string (settings.check_sentence_structure),
+      convert_to_string (settings.check_paragraph_structure),
+      capitals,
+      small_letters,
+      settings.end_marks,
+      settings.center_marks,
+      settings.disregards,
+      names,
+      within_sentence_markers,
+      convert_to_string (settings.check_chapters_verses_versification),
+      convert_to_string (settings.check_well_formed_usfm),
+      convert_to_string (settings.check_missing_punctuation_end_verse),
+      convert_to_string (settings.check_patterns),
+      s_checking_patterns,
+      convert_to_string (settings.check_matching_pairs),
+      s_matching_pairs,
+      convert_to_string (settings.check_space_end_verse),
+      convert_to_string (settings.check_french_punctuation),
+      convert_to_string (settings.check_french_citation_style),
+      convert_to_string (settings.check_valid_utf8_text),
+    };
+    settings.signature = md5 (filter_string_implode (signature, "\n"));
+  }
 
   
   vector <int> books = request.database_bibles()->getBooks (bible);
   if (check_books_versification) Checks_Versification::books (bible, books);
   
   
+  // Gather the chapters, and take the results of the unchanged chapters from the cache.
+  vector <Checks_Run_Chapter> chapters;
+  map <int, vector <int> > book_chapters;
   for (auto book : books) {
     
     
-    vector <int> chapters = request.database_bibles()->getChapters (bible, book);
-    if (check_chapters_verses_versification) Checks_Versification::chapters (bible, book, chapters);
+    vector <int> chapter_numbers = request.database_bibles()->getChapters (bible, book);
+    book_chapters [book] = chapter_numbers;
+    map <int, string> cached_hashes = database_check.getChapterHashes (bible, book);
+    vector <Database_Check_Hit> cached_hits;
+    if (!cached_hashes.empty ()) cached_hits = database_check.getChapterHits (bible, book);
     
     
-    for (auto chapter : chapters) {
+    for (auto chapter : chapter_numbers) {
       string chapterUsfm = request.database_bibles()->getChapter (bible, book, chapter);
     
       
@@ -153,94 +401,71 @@ void checks_run (string bible)
       }
       
       
-      vector <int> verses = usfm_get_verse_numbers (chapterUsfm);
-      if (check_chapters_verses_versification) Checks_Versification::verses (bible, book, chapter, verses);
-      
-      
-      for (auto verse : verses) {
-        string verseUsfm = usfm_get_verse_text (chapterUsfm, verse);
-        if (check_double_spaces_usfm) {
-          Checks_Space::doubleSpaceUsfm (bible, book, chapter, verse, verseUsfm);
-        }
-        if (check_valid_utf8_text) {
-          if (!unicode_string_is_valid (verseUsfm)) {
-            string msg = "Invalid UTF-8 Unicode in verse text";
-            database_check.recordOutput (bible, book, chapter, verse, msg);
-          }
-        }
-      }
-      
-      
-      Filter_Text filter_text = Filter_Text (bible);
-      filter_text.initializeHeadingsAndTextPerVerse (false);
-      filter_text.addUsfmCode (chapterUsfm);
-      filter_text.run (stylesheet);
-      map <int, string>  verses_headings = filter_text.verses_headings;
-      map <int, string> verses_text = filter_text.getVersesText ();
-      vector <map <int, string>> verses_paragraphs = filter_text.verses_paragraphs;
-      if (check_full_stop_in_headings) {
-        Checks_Headers::noPunctuationAtEnd (bible, book, chapter, verses_headings, center_marks, end_marks);
-      }
-      if (check_space_before_punctuation) {
-        Checks_Space::spaceBeforePunctuation (bible, book, chapter, verses_text);
-      }
-      
-      if (check_sentence_structure || check_paragraph_structure) {
-        checks_sentences.initialize ();
-        if (check_sentence_structure) checks_sentences.check (verses_text);
-        if (check_paragraph_structure) {
-          checks_sentences.paragraphs (filter_text.paragraph_starting_markers,
-                                       within_sentence_paragraph_markers,
-                                       verses_paragraphs);
-        }
-        
-        vector <pair<int, string>> results = checks_sentences.getResults ();
-        for (auto result : results) {
-          int verse = result.first;
-          string msg = result.second;
-          database_check.recordOutput (bible, book, chapter, verse, msg);
-        }
-      }
-
-      if (check_well_formed_usfm) {
-        checks_usfm.initialize (book, chapter);
-        checks_usfm.check (chapterUsfm);
-        checks_usfm.finalize ();
-        vector <pair<int, string>>  results = checks_usfm.getResults ();
-        for (auto element : results) {
-          int verse = element.first;
-          string msg = element.second;
-          database_check.recordOutput (bible, book, chapter, verse, msg);
+      Checks_Run_Chapter item;
+      item.book = book;
+      item.chapter = chapter;
+      item.hash = md5 (settings.signature + chapterUsfm);
+      auto iterator = cached_hashes.find (chapter);
+      item.cached = (iterator != cached_hashes.end ()) && (iterator->second == item.hash);
+      if (item.cached) {
+        for (auto & hit : cached_hits) {
+          if (hit.chapter == chapter) item.hits.push_back (hit);
         }
+      } else {
+        item.usfm = chapterUsfm;
       }
-
-      if (check_missing_punctuation_end_verse) {
-        Checks_Verses::missingPunctuationAtEnd (bible, book, chapter, verses_text, center_marks, end_marks, disregards);
-      }
-      
-      if (check_patterns) {
-        Checks_Verses::patterns (bible, book, chapter, verses_text, checking_patterns);
-      }
-      
-      if (check_matching_pairs) {
-        Checks_Pairs::run (bible, book, chapter, verses_text, matching_pairs, check_french_citation_style);
-      }
-      
-      if (check_space_end_verse) {
-        Checks_Space::spaceEndVerse (bible, book, chapter, chapterUsfm);
-      }
-      
-      if (check_french_punctuation) {
-        Checks_French::spaceBeforeAfterPunctuation (bible, book, chapter, verses_headings);
-        Checks_French::spaceBeforeAfterPunctuation (bible, book, chapter, verses_text);
+      chapters.push_back (item);
+    }
+    
+    
+    // Remove the cached results of chapters no longer in the book.
+    for (auto & element : cached_hashes) {
+      if (!in_array (element.first, chapter_numbers)) {
+        database_check.eraseChapterHits (bible, book, element.first);
       }
-      
-      if (check_french_citation_style) {
-        Checks_French::citationStyle (bible, book, chapter, verses_paragraphs);
+    }
+  }
+  
+  
+  // Check the changed chapters in parallel.
+  {
+    unsigned int changed_count = 0;
+    for (auto & chapter : chapters) if (!chapter.cached) changed_count++;
+    unsigned int thread_count = thread::hardware_concurrency ();
+    if (thread_count > changed_count) thread_count = changed_count;
+    if (thread_count < 1) thread_count = 1;
+    atomic <unsigned int> next (0);
+    vector <thread> threads;
+    for (unsigned int i = 0; i < thread_count; i++) {
+      threads.push_back (thread (checks_run_thread, &settings, &chapters, &next));
+    }
+    for (auto & thread : threads) {
+      thread.join ();
+    }
+  }
+  
+  
+  // Record the results in the order of the books and chapters,
+  // so that the suppressions and the limits on repeated output apply as before.
+  // Cache the results of the chapters that were checked.
+  vector <Database_Check_Hit> output;
+  size_t chapter_pointer = 0;
+  for (auto book : books) {
+    if (settings.check_chapters_verses_versification) {
+      Database_Check::collect (&output);
+      Checks_Versification::chapters (bible, book, book_chapters [book]);
+      Database_Check::collect (NULL);
+    }
+    while ((chapter_pointer < chapters.size ()) && (chapters [chapter_pointer].book == book)) {
+      Checks_Run_Chapter & chapter = chapters [chapter_pointer];
+      output.insert (output.end (), chapter.hits.begin (), chapter.hits.end ());
+      if (!chapter.cached) {
+        database_check.storeChapterHits (bible, chapter.book, chapter.chapter, chapter.hash, chapter.hits);
       }
-      
+      chapter_pointer++;
     }
   }
+  database_check.recordOutput (output);
   
   
   // Create an email with the checking results for this bible.
@@ -38,28 +38,32 @@ void Checks_Space::doubleSpaceUsfm (string bible, int book, int chapter, int ver
 
 
 void Checks_Space::spaceBeforePunctuation (string bible, int book, int chapter, map <int, string> texts)
+{
+  Checks_Automaton automaton ({}, {});
+  spaceBeforePunctuation (bible, book, chapter, automaton, automaton.scan (texts));
+}
+
+
+// Reports the spaces before punctuation the $automaton $found in the verses.
+void Checks_Space::spaceBeforePunctuation (string bible, int book, int chapter, const Checks_Automaton & automaton, const map <int, vector <int> > & found)
 {
   Database_Check database_check;
-  for (auto element : texts) {
+  for (auto & element : found) {
     int verse = element.first;
-    string text = element.second;
-    if (text.find (" ,") != string::npos) {
-      database_check.recordOutput (bible, book, chapter, verse, translate ("Space before a comma"));
-    }
-    if (text.find (" ;") != string::npos) {
-      database_check.recordOutput (bible, book, chapter, verse, translate ("Space before a semicolon"));
-    }
-    if (text.find (" :") != string::npos) {
-      database_check.recordOutput (bible, book, chapter, verse, translate ("Space before a colon"));
-    }
-    if (text.find (" .") != string::npos) {
-      database_check.recordOutput (bible, book, chapter, verse, translate ("Space before a full stop"));
-    }
-    if (text.find (" ?") != string::npos) {
-      database_check.recordOutput (bible, book, chapter, verse, translate ("Space before a question mark"));
-    }
-    if (text.find (" !") != string::npos) {
-      database_check.recordOutput (bible, book, chapter, verse, translate ("Space before an exclamation mark"));
+    vector <bool> hits (automaton.fragments.size (), false);
+    for (auto id : element.second) hits [id] = true;
+    for (size_t id = 0; id < hits.size (); id++) {
+      if (automaton.kinds [id] != Checks_Automaton::kind_punctuation) continue;
+      if (!hits [id]) continue;
+      string fragment = automaton.fragments [id];
+      string message;
+      if (fragment == " ,") message = translate ("Space before a comma");
+      if (fragment == " ;") message = translate ("Space before a semicolon");
+      if (fragment == " :") message = translate ("Space before a colon");
+      if (fragment == " .") message = translate ("Space before a full stop");
+      if (fragment == " ?") message = translate ("Space before a question mark");
+      if (fragment == " !") message = translate ("Space before an exclamation mark");
+      database_check.recordOutput (bible, book, chapter, verse, message);
     }
   }
 }
@@ -68,10 +72,11 @@ void Checks_Space::spaceBeforePunctuation (string bible, int book, int chapter,
 void Checks_Space::spaceEndVerse (string bible, int book, int chapter, string usfm)
 {
   Database_Check database_check;
-  vector <int> verses = usfm_get_verse_numbers (usfm);
+  Filter_Usfm_Chapter parsed_chapter (usfm);
+  vector <int> verses = parsed_chapter.verse_numbers ();
   for (auto verse : verses) {
     if (!verse) continue;
-    string text = usfm_get_verse_text (usfm, verse);
+    string text = parsed_chapter.verse_text (verse);
     vector <string> items = usfm_get_markers_and_text (text);
     for (auto item : items) {
       if (usfm_is_usfm_marker (item)) {
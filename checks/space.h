@@ -22,6 +22,7 @@
 
 
 #include <config/libraries.h>
+#include <checks/automaton.h>
 
 
 class Checks_Space
@@ -29,6 +30,7 @@ class Checks_Space
 public:
   static void doubleSpaceUsfm (string bible, int book, int chapter, int verse, string data);
   static void spaceBeforePunctuation (string bible, int book, int chapter, map <int, string> texts);
+  static void spaceBeforePunctuation (string bible, int book, int chapter, const Checks_Automaton & automaton, const map <int, vector <int> > & found);
   static void spaceEndVerse (string bible, int book, int chapter, string usfm);
   static bool transposeNoteSpace (string & usfm);
 private:
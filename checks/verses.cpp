@@ -53,15 +53,24 @@ void Checks_Verses::missingPunctuationAtEnd (string bible, int book, int chapter
 
 
 void Checks_Verses::patterns (string bible, int book, int chapter, map <int, string> verses, vector <string> patterns)
+{
+  Checks_Automaton automaton (patterns, {});
+  Checks_Verses::patterns (bible, book, chapter, automaton, automaton.scan (verses));
+}
+
+
+// Reports the patterns the $automaton $found in the verses, in the order of the patterns.
+void Checks_Verses::patterns (string bible, int book, int chapter, const Checks_Automaton & automaton, const map <int, vector <int> > & found)
 {
   Database_Check database_check;
-  for (auto element : verses) {
+  for (auto & element : found) {
     int verse = element.first;
-    string text = element.second;
-    for (auto pattern : patterns) {
-      if (pattern.empty ()) continue;
-      if (text.find (pattern) != string::npos) {
-        database_check.recordOutput (bible, book, chapter, verse, translate ("Pattern found in text:") + " " + pattern);
+    vector <bool> hits (automaton.fragments.size (), false);
+    for (auto id : element.second) hits [id] = true;
+    for (size_t id = 0; id < hits.size (); id++) {
+      if (automaton.kinds [id] != Checks_Automaton::kind_pattern) continue;
+      if (hits [id]) {
+        database_check.recordOutput (bible, book, chapter, verse, translate ("Pattern found in text:") + " " + automaton.fragments [id]);
       }
     }
   }
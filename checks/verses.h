@@ -22,6 +22,7 @@
 
 
 #include <config/libraries.h>
+#include <checks/automaton.h>
 
 
 class Checks_Verses
@@ -30,6 +31,7 @@ public:
   static void missingPunctuationAtEnd (string bible, int book, int chapter, map <int, string> verses,
                                        string center_marks, string end_marks, string disregards);
   static void patterns (string bible, int book, int chapter, map <int, string> verses, vector <string> patterns);
+  static void patterns (string bible, int book, int chapter, const Checks_Automaton & automaton, const map <int, vector <int> > & found);
 private:
 };
 
@@ -77,6 +77,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <atomic>
 #include <unordered_map>
 #include <codecvt>
+#include <memory>
 
 
 // Headers dependencies.
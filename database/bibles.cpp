@@ -23,6 +23,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/url.h>
 #include <filter/string.h>
 #include <filter/date.h>
+#include <filter/diff.h>
 #include <search/logic.h>
 #include <export/logic.h>
 
@@ -32,6 +33,55 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 // Because no real database is used, no database can get corrupted.
 
 
+// Each chapter folder has a file with the text of the chapter, and a file with its history.
+// The text file starts with a line with the identifier, the timestamp, and the size of the history.
+// The full text of the chapter follows that line.
+// So getting the chapter reads one small file, and applies no deltas.
+// The history file holds the older revisions, oldest first.
+// Each revision starts with a line with its identifier, its timestamp, and the size of the data that follows.
+// The data of each revision is a delta against the revision that follows it, the newest one against the text.
+// Storing a chapter appends a delta of the previous text to the history,
+// then writes the new text to a temporary file, and renames it to the text file.
+// So a store does not copy the history.
+// Only as many bytes of the history as the text file gives belong to it.
+// Anything a store left behind when it got interrupted after appending to the history gets dropped next time.
+// Optimizing the Bibles trims the history to the most recent revisions.
+// Chapters used to be stored as one file per revision, named after the identifier, or as one pack with all revisions.
+// Those get converted when the chapter is stored next time, or when the Bibles get optimized.
+
+
+// Changes to the chapters of a Bible are done one at a time.
+// Changes to different Bibles can go on at the same time.
+mutex database_bibles_mutexes_mutex;
+map <string, mutex> database_bibles_mutexes;
+atomic <unsigned int> database_bibles_file_counter (0);
+
+
+// The mutex for changing the chapters of the $bible.
+mutex & database_bibles_mutex (const string & bible)
+{
+  lock_guard <mutex> lock (database_bibles_mutexes_mutex);
+  return database_bibles_mutexes [bible];
+}
+
+
+// Gives the header line of a $revision with $size bytes of data.
+string database_bibles_header (const Database_Bibles_Revision & revision, size_t size)
+{
+  return convert_to_string (revision.id) + " " + convert_to_string (revision.timestamp) + " " + convert_to_string (size) + "\n";
+}
+
+
+// Writes the $contents to the file at $path through a temporary file, so no reader ever sees half a file.
+void database_bibles_write (const string & path, const string & contents)
+{
+  // Each write has a temporary file of its own, so two writes can never mix in one file.
+  string temporary = path + "." + convert_to_string ((size_t) database_bibles_file_counter++) + ".tmp";
+  filter_url_file_put_contents (temporary, contents);
+  filter_url_rename (temporary, path);
+}
+
+
 string Database_Bibles::mainFolder ()
 {
   return filter_url_create_root_path ("bibles");
@@ -56,6 +106,149 @@ string Database_Bibles::chapterFolder (string bible, int book, int chapter)
 }
 
 
+string Database_Bibles::chapterText (string bible, int book, int chapter)
+{
+  return filter_url_create_path (chapterFolder (bible, book, chapter), "text");
+}
+
+
+string Database_Bibles::chapterHistory (string bible, int book, int chapter)
+{
+  return filter_url_create_path (chapterFolder (bible, book, chapter), "history");
+}
+
+
+// Reads the newest $revision of the chapter, and the size of the history that goes with it.
+// Returns false if the chapter has no text file.
+bool Database_Bibles::readText (string bible, int book, int chapter, Database_Bibles_Revision & revision, size_t & history_size)
+{
+  string path = chapterText (bible, book, chapter);
+  if (!file_or_dir_exists (path)) return false;
+  string contents = filter_url_file_get_contents (path);
+  size_t eol = contents.find ('\n');
+  if (eol == string::npos) return false;
+  vector <string> bits = filter_string_explode (contents.substr (0, eol), ' ');
+  if (bits.size () != 3) return false;
+  revision.id = convert_to_int (bits [0]);
+  revision.timestamp = convert_to_int (bits [1]);
+  revision.text = contents.substr (eol + 1);
+  history_size = convert_to_int (bits [2]);
+  return true;
+}
+
+
+// Reads the revisions of the chapter, newest first.
+// Without the $history it reads the newest revision only.
+vector <Database_Bibles_Revision> Database_Bibles::readRevisions (string bible, int book, int chapter, bool history)
+{
+  vector <Database_Bibles_Revision> revisions;
+  Database_Bibles_Revision revision;
+  size_t history_size;
+  if (readText (bible, book, chapter, revision, history_size)) {
+    revisions.push_back (revision);
+    if (!history) return revisions;
+    string contents = filter_url_file_get_contents (chapterHistory (bible, book, chapter));
+    if (contents.size () > history_size) contents.resize (history_size);
+    // The history is oldest first, and each delta works on the revision after it.
+    vector <Database_Bibles_Revision> older;
+    size_t pos = 0;
+    while (pos < contents.size ()) {
+      size_t eol = contents.find ('\n', pos);
+      if (eol == string::npos) break;
+      vector <string> bits = filter_string_explode (contents.substr (pos, eol - pos), ' ');
+      if (bits.size () != 3) break;
+      size_t size = convert_to_int (bits [2]);
+      if (eol + 1 + size > contents.size ()) break;
+      revision.id = convert_to_int (bits [0]);
+      revision.timestamp = convert_to_int (bits [1]);
+      revision.text = contents.substr (eol + 1, size);
+      older.push_back (revision);
+      pos = eol + 1 + size;
+    }
+    for (auto iterator = older.rbegin (); iterator != older.rend (); iterator++) {
+      iterator->text = filter_diff_apply_delta (revisions.back ().text, iterator->text);
+      revisions.push_back (*iterator);
+    }
+    return revisions;
+  }
+  return readLegacy (bible, book, chapter, history);
+}
+
+
+// Reads the revisions of a chapter stored before the text and history files, newest first.
+vector <Database_Bibles_Revision> Database_Bibles::readLegacy (string bible, int book, int chapter, bool history)
+{
+  vector <Database_Bibles_Revision> revisions;
+  string folder = chapterFolder (bible, book, chapter);
+  string path = filter_url_create_path (folder, "pack");
+  if (file_or_dir_exists (path)) {
+    // One pack with the revisions, newest first, the older ones as deltas against the revision before them.
+    string pack = filter_url_file_get_contents (path);
+    size_t pos = 0;
+    while (pos < pack.size ()) {
+      size_t eol = pack.find ('\n', pos);
+      if (eol == string::npos) break;
+      vector <string> bits = filter_string_explode (pack.substr (pos, eol - pos), ' ');
+      if (bits.size () != 3) break;
+      size_t size = convert_to_int (bits [2]);
+      if (eol + 1 + size > pack.size ()) break;
+      Database_Bibles_Revision revision;
+      revision.id = convert_to_int (bits [0]);
+      revision.timestamp = convert_to_int (bits [1]);
+      revision.text = pack.substr (eol + 1, size);
+      if (!revisions.empty ()) revision.text = filter_diff_apply_delta (revisions.back ().text, revision.text);
+      revisions.push_back (revision);
+      if (!history) break;
+      pos = eol + 1 + size;
+    }
+  } else {
+    // One file per revision.
+    vector <int> ids;
+    for (auto & file : filter_url_scandir (folder)) {
+      if (filter_string_is_numeric (file)) ids.push_back (convert_to_int (file));
+    }
+    sort (ids.begin (), ids.end ());
+    reverse (ids.begin (), ids.end ());
+    for (auto id : ids) {
+      string file = filter_url_create_path (folder, convert_to_string (id));
+      Database_Bibles_Revision revision;
+      revision.id = id;
+      revision.timestamp = filter_url_file_modification_time (file);
+      revision.text = filter_url_file_get_contents (file);
+      revisions.push_back (revision);
+      if (!history) break;
+    }
+  }
+  return revisions;
+}
+
+
+// Writes the $revisions of the chapter, newest first, and removes the files from before the text and history files.
+// Without $revisions it removes the text and the history.
+void Database_Bibles::writeRevisions (string bible, int book, int chapter, const vector <Database_Bibles_Revision> & revisions)
+{
+  string folder = chapterFolder (bible, book, chapter);
+  if (!file_or_dir_exists (folder)) filter_url_mkdir (folder);
+  if (revisions.empty ()) {
+    filter_url_unlink (chapterText (bible, book, chapter));
+    filter_url_unlink (chapterHistory (bible, book, chapter));
+  } else {
+    string history;
+    for (size_t i = revisions.size () - 1; i > 0; i--) {
+      string delta = filter_diff_delta (revisions [i - 1].text, revisions [i].text);
+      history.append (database_bibles_header (revisions [i], delta.size ()));
+      history.append (delta);
+    }
+    database_bibles_write (chapterHistory (bible, book, chapter), history);
+    database_bibles_write (chapterText (bible, book, chapter), database_bibles_header (revisions [0], history.size ()) + revisions [0].text);
+  }
+  filter_url_unlink (filter_url_create_path (folder, "pack"));
+  for (auto & file : filter_url_scandir (folder)) {
+    if (filter_string_is_numeric (file)) filter_url_unlink (filter_url_create_path (folder, file));
+  }
+}
+
+
 // Returns an array with the available Bibles.
 vector <string> Database_Bibles::getBibles ()
 {
@@ -90,9 +283,6 @@ void Database_Bibles::deleteBible (string name)
 // Stores data of one chapter in Bible $name,
 void Database_Bibles::storeChapter (string name, int book, int chapter_number, string chapter_text)
 {
-  string folder = chapterFolder (name, book, chapter_number);
-  if (!file_or_dir_exists (folder)) filter_url_mkdir (folder);
-
   // Ensure that the data to be stored ends with a new line.
   if (!chapter_text.empty ()) {
     size_t pos = chapter_text.length () - 1;
@@ -100,11 +290,41 @@ void Database_Bibles::storeChapter (string name, int book, int chapter_number, s
       chapter_text.append ("\n");
     }
   }
-  // Increase the chapter identifier, and store the chapter data.
-  int id = getChapterId (name, book, chapter_number);
-  id++;
-  string file = filter_url_create_path (folder, convert_to_string (id));
-  filter_url_file_put_contents (file, chapter_text);
+  // Increase the chapter identifier, and store the chapter data as the newest revision.
+  {
+    lock_guard <mutex> lock (database_bibles_mutex (name));
+    Database_Bibles_Revision revision;
+    revision.timestamp = filter_date_seconds_since_epoch ();
+    revision.text = chapter_text;
+    Database_Bibles_Revision previous;
+    size_t history_size;
+    if (readText (name, book, chapter_number, previous, history_size)) {
+      revision.id = previous.id + 1;
+      string path = chapterHistory (name, book, chapter_number);
+      // Drop anything an interrupted store left behind after the history.
+      if (filter_url_filesize (path) != (int) history_size) {
+        string history = filter_url_file_get_contents (path);
+        if (history.size () > history_size) history.resize (history_size);
+        history_size = history.size ();
+        database_bibles_write (path, history);
+      }
+      // Add the previous text to the history.
+      string delta = filter_diff_delta (revision.text, previous.text);
+      string record = database_bibles_header (previous, delta.size ()) + delta;
+      filter_url_file_put_contents_append (path, record);
+      history_size += record.size ();
+      database_bibles_write (chapterText (name, book, chapter_number), database_bibles_header (revision, history_size) + revision.text);
+    } else {
+      // A new chapter, or a chapter stored the way it was done before.
+      vector <Database_Bibles_Revision> revisions = readLegacy (name, book, chapter_number, true);
+      revision.id = 100000000;
+      if (!revisions.empty ()) revision.id = revisions [0].id;
+      revision.id++;
+      revisions.insert (revisions.begin (), revision);
+      if (revisions.size () > pack_history) revisions.resize (pack_history);
+      writeRevisions (name, book, chapter_number, revisions);
+    }
+  }
 
   // Update search fields.
   updateSearchFields (name, book, chapter_number);
@@ -176,14 +396,10 @@ void Database_Bibles::deleteChapter (string bible, int book, int chapter)
 // Gets the chapter data as a string.
 string Database_Bibles::getChapter (string bible, int book, int chapter)
 {
-  string folder = chapterFolder (bible, book, chapter);
-  vector <string> files = filter_url_scandir (folder);
-  if (!files.empty ()) {
-    string file = files [files.size () - 1];
-    string data = filter_url_file_get_contents (filter_url_create_path (folder, file));
+  vector <Database_Bibles_Revision> revisions = readRevisions (bible, book, chapter, false);
+  if (!revisions.empty ()) {
     // Remove trailing new line.
-    data = filter_string_trim (data);
-    return data;
+    return filter_string_trim (revisions [0].text);
   }
   return "";
 }
@@ -192,12 +408,8 @@ string Database_Bibles::getChapter (string bible, int book, int chapter)
 // Gets the chapter id.
 int Database_Bibles::getChapterId (string bible, int book, int chapter)
 {
-  string folder = chapterFolder (bible, book, chapter);
-  vector <string> files = filter_url_scandir (folder);
-  if (!files.empty ()) {
-    string file = files [files.size() - 1];
-    return convert_to_int (file);
-  }
+  vector <Database_Bibles_Revision> revisions = readRevisions (bible, book, chapter, false);
+  if (!revisions.empty ()) return revisions [0].id;
   return 100000000;
 }
 
@@ -205,14 +417,10 @@ int Database_Bibles::getChapterId (string bible, int book, int chapter)
 // Gets the chapter's time stamp in seconds since the Epoch.
 int Database_Bibles::getChapterAge (string bible, int book, int chapter)
 {
-  string folder = chapterFolder (bible, book, chapter);
-  vector <string> files = filter_url_scandir (folder);
-  if (!files.empty ()) {
-    string file = files [files.size() - 1];
-    string path = filter_url_create_path (folder, file);
-    int time = filter_url_file_modification_time (path);
+  vector <Database_Bibles_Revision> revisions = readRevisions (bible, book, chapter, false);
+  if (!revisions.empty ()) {
     int now = filter_date_seconds_since_epoch ();
-    return now - time;
+    return now - revisions [0].timestamp;
   }
   return 100000000;
 }
@@ -227,29 +435,28 @@ void Database_Bibles::optimize ()
     for (int book : books) {
       vector <int> chapters = getChapters (bible, book);
       for (int chapter : chapters) {
-        string folder = chapterFolder (bible, book, chapter);
-        // Read the files in the folder.
-        vector <string> files = filter_url_scandir (folder);
-        // Remove files with 0 size. so that in case a chapter was emptied by accident, 
+        lock_guard <mutex> lock (database_bibles_mutex (bible));
+        vector <Database_Bibles_Revision> revisions = readRevisions (bible, book, chapter, true);
+        // Remove empty revisions, so that in case a chapter was emptied by accident,
         // it is removed now, effectually reverting the chapter to an earlier version.
-        vector <string> files2;
-        for (string file : files) {
-          string path = filter_url_create_path (folder, file);
-          if (filter_url_filesize (path) == 0) {
-            filter_url_unlink (path);
+        vector <Database_Bibles_Revision> revisions2;
+        for (auto & revision : revisions) {
+          if (revision.text.empty ()) {
             Database_State::setExport (bible, 0, Export_Logic::export_needed);
           }
-          else files2.push_back (file);
+          else revisions2.push_back (revision);
         }
-        // Remove the three most recent files from the array, so they don't get deleted.
-        // Because scandir sorts the files, the files to be kept are at the end.
-        if (!files2.empty()) files2.pop_back ();
-        if (!files2.empty()) files2.pop_back ();
-        if (!files2.empty()) files2.pop_back ();
-        // Remove the remaining files. These are the older versions.
-        for (string file : files2) {
-          string path = filter_url_create_path (folder, file);
-          filter_url_unlink (path);
+        // Keep a limited history.
+        // As older revisions are stored as deltas, a long history takes little space.
+        if (revisions2.size () > pack_history) revisions2.resize (pack_history);
+        // Write the chapter only when it changes, or when it converts the files from before the text and history files,
+        // or when an interrupted store left something behind after the history.
+        Database_Bibles_Revision revision;
+        size_t history_size = 0;
+        bool current = readText (bible, book, chapter, revision, history_size);
+        if (current) current = (filter_url_filesize (chapterHistory (bible, book, chapter)) == (int) history_size);
+        if (!current || (revisions2.size () != revisions.size ())) {
+          writeRevisions (bible, book, chapter, revisions2);
         }
       }
     }
@@ -24,6 +24,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <config/libraries.h>
 
 
+// One revision of a chapter.
+class Database_Bibles_Revision
+{
+public:
+  int id;
+  int timestamp;
+  string text;
+};
+
+
 class Database_Bibles
 {
 public:
@@ -47,6 +57,13 @@ public:
 private:
   string bookFolder (string bible, int book);
   string chapterFolder (string bible, int book, int chapter);
+  string chapterText (string bible, int book, int chapter);
+  string chapterHistory (string bible, int book, int chapter);
+  bool readText (string bible, int book, int chapter, Database_Bibles_Revision & revision, size_t & history_size);
+  vector <Database_Bibles_Revision> readRevisions (string bible, int book, int chapter, bool history);
+  vector <Database_Bibles_Revision> readLegacy (string bible, int book, int chapter, bool history);
+  void writeRevisions (string bible, int book, int chapter, const vector <Database_Bibles_Revision> & revisions);
+  static const size_t pack_history = 100;
 };
 
 
@@ -24,6 +24,28 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/diff.h>
 #include <locale/translate.h>
 #include <database/booksdata.h>
+#include <database/booksindex.h>
+
+
+// Looks up the $key in the perfect hash table with the $slots made with the $seed.
+// The $field of the book found should equal the $key, ignoring the case if $fold is set.
+// Returns the book's identifier, or 0 if there's no such book.
+static int database_books_find (const string & key, unsigned int seed, const short * slots, const char * book_record::* field, bool fold)
+{
+  if (key.empty ()) return 0;
+  int i = slots [Database_Books::hash (key, seed, fold) % books_slot_count];
+  if (i < 0) return 0;
+  const char * name = books_table[i].*field;
+  if (fold) {
+    if (key.length () != strlen (name)) return 0;
+    for (size_t c = 0; c < key.length (); c++) {
+      if (tolower ((unsigned char) key [c]) != tolower ((unsigned char) name [c])) return 0;
+    }
+  } else {
+    if (key != name) return 0;
+  }
+  return books_table[i].id;
+}
 
 
 vector <int> Database_Books::getIDs ()
@@ -39,89 +61,71 @@ vector <int> Database_Books::getIDs ()
 
 int Database_Books::getIdFromEnglish (string english)
 {
-  for (unsigned int i = 0; i < data_count(); i++) {
-    if (english == books_table[i].english) {
-      return books_table[i].id;
-    }
-  }
-  return 0;  
+  return database_books_find (english, books_english_seed, books_english_slots, &book_record::english, false);
 }
 
 
 string Database_Books::getEnglishFromId (int id)
 {
-  for (unsigned int i = 0; i < data_count(); i++) {
-    if (id == books_table[i].id) {
-      return books_table[i].english;
-    }
-  }
-  return translate ("Unknown");
+  int i = position (id);
+  if (i < 0) return translate ("Unknown");
+  return books_table[i].english;
 }
 
 
 string Database_Books::getUsfmFromId (int id)
 {
-  for (unsigned int i = 0; i < data_count(); i++) {
-    if (id == books_table[i].id) {
-      return books_table[i].usfm;
-    }
-  }
-  return "XXX";
+  int i = position (id);
+  if (i < 0) return "XXX";
+  return books_table[i].usfm;
 }
 
 
 string Database_Books::getBibleworksFromId (int id)
 {
-  for (unsigned int i = 0; i < data_count(); i++) {
-    if (id == books_table[i].id) {
-      return books_table[i].bibleworks;
-    }
-  }
-  return "Xxx";
+  int i = position (id);
+  if (i < 0) return "Xxx";
+  return books_table[i].bibleworks;
 }
 
 
 string Database_Books::getOsisFromId (int id)
 {
-  for (unsigned int i = 0; i < data_count(); i++) {
-    if (id == books_table[i].id) {
-      return books_table[i].osis;
-    }
-  }
-  return translate ("Unknown");
+  int i = position (id);
+  if (i < 0) return translate ("Unknown");
+  return books_table[i].osis;
 }
 
 
 int Database_Books::getIdFromUsfm (string usfm)
 {
-  for (unsigned int i = 0; i < data_count(); i++) {
-    if (usfm == books_table[i].usfm) {
-      return books_table[i].id;
-    }
-  }
-  return 0;
+  return database_books_find (usfm, books_usfm_seed, books_usfm_slots, &book_record::usfm, false);
 }
 
 
 int Database_Books::getIdFromOsis (string osis)
 {
-  for (unsigned int i = 0; i < data_count(); i++) {
-    if (osis == books_table[i].osis) {
-      return books_table[i].id;
-    }
-  }
-  return 0;
+  return database_books_find (osis, books_osis_seed, books_osis_slots, &book_record::osis, false);
+}
+
+
+// Looks up the $usfm identifier regardless of its case, for a book that a user typed.
+int Database_Books::getIdFromUsfmIgnoringCase (string usfm)
+{
+  return database_books_find (usfm, books_usfm_folded_seed, books_usfm_folded_slots, &book_record::usfm, true);
+}
+
+
+// Looks up the $osis abbreviation regardless of its case.
+int Database_Books::getIdFromOsisIgnoringCase (string osis)
+{
+  return database_books_find (osis, books_osis_folded_seed, books_osis_folded_slots, &book_record::osis, true);
 }
 
 
 int Database_Books::getIdFromBibleworks (string bibleworks)
 {
-  for (unsigned int i = 0; i < data_count(); i++) {
-    if (bibleworks == books_table[i].bibleworks) {
-      return books_table[i].id;
-    }
-  }
-  return 0;
+  return database_books_find (bibleworks, books_bibleworks_seed, books_bibleworks_slots, &book_record::bibleworks, false);
 }
 
 
@@ -157,45 +161,31 @@ int Database_Books::getIdLikeText (string text)
 
 int Database_Books::getIdFromOnlinebible (string onlinebible)
 {
-  for (unsigned int i = 0; i < data_count(); i++) {
-    if (onlinebible == books_table[i].onlinebible) {
-      return books_table[i].id;
-    }
-  }
-  return 0;
+  return database_books_find (onlinebible, books_onlinebible_seed, books_onlinebible_slots, &book_record::onlinebible, false);
 }
 
 
 string Database_Books::getOnlinebibleFromId (int id)
 {
-  for (unsigned int i = 0; i < data_count(); i++) {
-    if (id == books_table[i].id) {
-      return books_table[i].onlinebible;
-    }
-  }
-  return "";
+  int i = position (id);
+  if (i < 0) return "";
+  return books_table[i].onlinebible;
 }
 
 
 int Database_Books::getOrderFromId (int id)
 {
-  for (unsigned int i = 0; i < data_count(); i++) {
-    if (id == books_table[i].id) {
-      return books_table[i].order;
-    }
-  }
-  return 0;
+  int i = position (id);
+  if (i < 0) return 0;
+  return books_table[i].order;
 }
 
 
 string Database_Books::getType (int id)
 {
-  for (unsigned int i = 0; i < data_count(); i++) {
-    if (id == books_table[i].id) {
-      return books_table[i].type;
-    }
-  }
-  return "";
+  int i = position (id);
+  if (i < 0) return "";
+  return books_table[i].type;
 }
 
 
@@ -203,3 +193,30 @@ unsigned int Database_Books::data_count ()
 {
   return sizeof (books_table) / sizeof (*books_table);
 }
+
+
+// The position in the table of the book with the $id, or -1 if there's no such book.
+int Database_Books::position (int id)
+{
+  if (id < 0) return -1;
+  if (id >= (int) (sizeof (books_id_positions) / sizeof (*books_id_positions))) return -1;
+  return books_id_positions [id];
+}
+
+
+// The hash of the $key with the $seed, for the perfect hash tables in booksindex.h.
+// If $fold is set, it ignores the case of the ASCII letters in the $key.
+unsigned int Database_Books::hash (const string & key, unsigned int seed, bool fold)
+{
+  // FNV-1a, with the seed mixed into the offset basis, and a final mix of the bits.
+  unsigned int hash = 2166136261u ^ (seed * 2654435761u);
+  for (unsigned char c : key) {
+    if (fold && (c >= 'A') && (c <= 'Z')) c += 'a' - 'A';
+    hash ^= c;
+    hash *= 16777619u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  return hash;
+}
@@ -35,14 +35,18 @@ public:
   static string getOsisFromId (int id);
   static int getIdFromUsfm (string usfm);
   static int getIdFromOsis (string osis);
+  static int getIdFromUsfmIgnoringCase (string usfm);
+  static int getIdFromOsisIgnoringCase (string osis);
   static int getIdFromBibleworks (string bibleworks);
   static int getIdLikeText (string text);
   static int getIdFromOnlinebible (string onlinebible);
   static string getOnlinebibleFromId (int id);
   static int getOrderFromId (int id);
   static string getType (int id);
+  static unsigned int hash (const string & key, unsigned int seed, bool fold);
 private:
   static unsigned int data_count ();
+  static int position (int id);
 };
 
 
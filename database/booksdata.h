@@ -36,6 +36,7 @@ typedef struct
 
 /*
 This table gives the books Bibledit knows about.
+After changing it, run "generate . books" to update the lookup tables in booksindex.h.
 The books are put in the standard order.
 
 A note about this data.
@@ -51,7 +52,7 @@ A note about this data.
     other     - Other matter
     ap        - Apocrypha
 */
-book_record books_table [] =
+static book_record books_table [] =
 {
   {"Genesis",                    "Gen",     "GEN",  "Gen",  "Ge",    1,  3, "ot",        false}, // ‘1 Moses’ in some Bibles.
   {"Exodus",                     "Exod",    "EXO",  "Exo",  "Ex",    2,  4, "ot",        false}, // ‘2 Moses’ in some Bibles.
@@ -0,0 +1,302 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+// This file is generated from the table of books in booksdata.h by running "generate . books".
+// Do not edit it.
+
+
+constexpr short books_id_positions [] =
+{
+  -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+  15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30,
+  31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46,
+  47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62,
+  63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78,
+  79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94,
+  95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108
+};
+
+
+constexpr unsigned int books_slot_count = 512;
+
+
+constexpr unsigned int books_english_seed = 132010;
+constexpr short books_english_slots [] =
+{
+  -1, -1, -1, -1, 77, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 33,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, 58, 80, 69, -1, 73, -1, -1, -1, 107, -1, -1, 75, -1, -1,
+  -1, -1, -1, -1, -1, -1, 65, -1, -1, -1, -1, -1, 21, -1, 51, 67,
+  -1, 5, -1, -1, 0, 40, -1, 74, -1, -1, 50, -1, -1, -1, -1, -1,
+  30, -1, 106, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 82, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, 68, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, 53, -1, 101, -1, -1, -1, -1, -1,
+  -1, -1, -1, 23, 11, -1, -1, -1, -1, -1, -1, -1, -1, 52, -1, -1,
+  -1, -1, -1, -1, -1, -1, 13, -1, -1, -1, -1, 81, -1, -1, -1, -1,
+  54, 61, -1, 70, -1, -1, -1, 35, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, 76, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 55, -1, -1, 46, -1, -1, -1, -1, -1, -1, -1, 62, 34, -1, 57,
+  9, 71, -1, 8, -1, 87, -1, -1, -1, 25, -1, -1, -1, -1, 105, -1,
+  -1, -1, 88, -1, -1, 78, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1,
+  -1, -1, 37, -1, -1, 28, -1, -1, -1, -1, -1, -1, -1, 94, 95, -1,
+  -1, -1, -1, -1, 98, -1, 43, -1, -1, 93, -1, -1, 4, -1, -1, -1,
+  24, -1, 48, -1, 14, 84, -1, -1, -1, -1, -1, -1, -1, -1, -1, 44,
+  42, 92, -1, 27, 6, -1, -1, -1, 108, -1, -1, -1, 85, -1, -1, -1,
+  18, -1, 64, -1, 102, -1, -1, -1, -1, -1, -1, 26, -1, -1, -1, -1,
+  89, -1, -1, 96, -1, -1, -1, -1, 15, -1, -1, -1, -1, -1, -1, -1,
+  12, -1, -1, -1, 97, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, 63, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, 17, -1, -1, -1, 90, -1, -1, -1, -1, -1, -1,
+  66, -1, -1, 56, -1, -1, -1, -1, 83, 10, -1, 39, -1, -1, -1, -1,
+  -1, -1, 41, -1, -1, -1, 38, -1, -1, -1, -1, -1, -1, -1, 20, -1,
+  -1, -1, 103, -1, -1, 7, 104, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, 79, -1, -1, -1, -1, -1, 36, 3, -1,
+  60, -1, 32, 2, -1, -1, -1, 29, -1, -1, -1, -1, 100, -1, 45, -1,
+  -1, -1, -1, 59, -1, 31, -1, -1, -1, -1, -1, -1, 49, -1, 91, -1,
+  47, 19, -1, -1, -1, -1, -1, 72, -1, -1, -1, -1, -1, 16, -1, -1,
+  -1, -1, -1, -1, -1, 22, -1, -1, -1, -1, 86, -1, -1, 99, -1, -1
+};
+
+
+constexpr unsigned int books_usfm_seed = 92350;
+constexpr short books_usfm_slots [] =
+{
+  -1, -1, 42, -1, -1, -1, -1, -1, -1, -1, -1, 53, -1, -1, -1, 58,
+  -1, -1, -1, -1, 2, 107, -1, -1, 74, 12, -1, 101, -1, 56, 32, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, 50, -1, -1, 24, -1, -1, 72, -1, -1, -1, -1, -1, -1, 47,
+  -1, -1, -1, -1, 83, 7, 70, 87, -1, -1, 108, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 76, -1, -1, -1,
+  -1, 84, -1, 77, -1, -1, -1, -1, -1, -1, -1, 21, -1, -1, 90, -1,
+  -1, 3, -1, -1, -1, 100, -1, -1, 35, 18, -1, -1, -1, -1, -1, -1,
+  64, -1, 1, -1, -1, -1, -1, -1, -1, -1, 68, -1, 82, 59, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, 102, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, 28, -1, -1, -1, 94, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, 36, -1, -1, -1, 96, -1, -1, -1, -1, 95, -1, -1, -1, -1,
+  -1, -1, -1, -1, 57, 9, -1, -1, 0, -1, -1, -1, -1, -1, -1, -1,
+  8, -1, -1, -1, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, 105, 92, -1, 78, -1, -1, 52, -1, -1, 73, -1, 41, -1, 93,
+  46, -1, 13, -1, -1, -1, -1, -1, -1, -1, 27, -1, 71, -1, -1, -1,
+  -1, -1, 45, -1, 15, 97, -1, -1, -1, -1, -1, -1, 86, -1, -1, -1,
+  38, -1, 16, 19, 5, -1, -1, -1, -1, -1, 43, -1, 4, -1, 104, 89,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 80, -1, -1, -1, -1, -1, -1, -1, -1, 85, -1, -1, -1, -1, -1,
+  -1, -1, -1, 23, -1, 48, 51, 31, -1, 40, 30, -1, -1, 44, -1, -1,
+  -1, -1, 67, 62, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  75, 65, 79, -1, 22, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, 99, 37, -1, -1, -1, 63, -1, -1, -1, 29, 81,
+  -1, -1, -1, -1, -1, -1, 49, -1, -1, 20, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, 10, -1, -1, -1, 26, -1, -1, -1, -1, 17, -1,
+  -1, -1, -1, -1, -1, 55, 14, -1, 54, 98, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, 39, -1, 60, -1, -1, -1, -1, -1, -1, -1, -1, -1, 106,
+  25, 66, -1, -1, -1, -1, -1, -1, -1, -1, 6, -1, -1, -1, -1, -1,
+  88, -1, -1, 69, -1, -1, -1, -1, -1, 34, -1, -1, -1, 103, -1, -1,
+  -1, 33, -1, 61, -1, -1, -1, -1, -1, 91, -1, -1, -1, -1, -1, -1
+};
+
+
+constexpr unsigned int books_usfm_folded_seed = 84514;
+constexpr short books_usfm_folded_slots [] =
+{
+  47, -1, 91, -1, -1, -1, -1, -1, 31, -1, -1, -1, -1, 44, -1, -1,
+  58, -1, -1, -1, -1, -1, -1, -1, -1, 49, -1, -1, -1, -1, -1, -1,
+  -1, 94, 22, -1, -1, 84, -1, 59, -1, -1, -1, -1, -1, -1, -1, 25,
+  -1, 19, -1, 63, 33, 20, -1, -1, -1, -1, -1, -1, -1, -1, -1, 103,
+  -1, -1, -1, 0, -1, 27, -1, -1, 28, 78, -1, 12, -1, -1, 30, -1,
+  -1, -1, -1, 4, 66, -1, 89, -1, -1, -1, -1, -1, -1, -1, 67, -1,
+  -1, -1, 40, -1, 2, -1, 96, -1, -1, -1, -1, -1, -1, -1, -1, 65,
+  -1, -1, -1, -1, -1, -1, -1, -1, 41, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, 36, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  76, 83, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 51, -1, -1,
+  -1, -1, -1, -1, 77, -1, -1, -1, -1, -1, -1, -1, 88, -1, -1, -1,
+  -1, -1, -1, 17, -1, -1, 108, 34, 106, -1, 107, -1, -1, -1, 93, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, 95, 85, -1, -1, -1, -1, -1, 55,
+  -1, -1, -1, -1, -1, -1, -1, 16, -1, -1, -1, -1, 99, -1, -1, -1,
+  70, -1, 71, 45, 68, -1, -1, -1, -1, 24, 79, -1, -1, -1, -1, 48,
+  101, -1, -1, -1, -1, 102, -1, -1, 1, -1, -1, -1, 39, -1, -1, 37,
+  10, -1, 104, -1, -1, -1, 35, 32, -1, -1, -1, -1, -1, -1, -1, 3,
+  -1, -1, -1, 62, -1, -1, -1, -1, 87, -1, -1, -1, -1, -1, -1, 6,
+  -1, -1, -1, 29, -1, -1, 86, -1, -1, 26, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, 21, -1, -1, 60, -1, -1, 50, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, 64, -1, -1, -1, -1, -1, -1, 14, -1,
+  -1, 18, 56, -1, -1, -1, -1, -1, -1, 98, -1, -1, -1, 92, 69, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, 5, -1, 46, -1, -1, -1, -1,
+  7, -1, -1, 74, -1, -1, 38, -1, -1, -1, -1, -1, -1, -1, 9, -1,
+  13, 54, -1, -1, 52, -1, -1, 81, 23, -1, -1, 72, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, -1, 105, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 73, -1, -1, -1,
+  -1, -1, 53, -1, -1, 57, -1, 80, 61, -1, -1, -1, -1, -1, 97, -1,
+  8, -1, -1, -1, -1, -1, -1, -1, 90, -1, 11, -1, -1, -1, -1, 42,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 75, 100, -1, -1, -1, -1, -1, -1, -1, -1, 43, -1, -1, -1, -1,
+  -1, -1, -1, 82, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+
+constexpr unsigned int books_osis_seed = 1125;
+constexpr short books_osis_slots [] =
+{
+  80, -1, -1, -1, -1, 40, -1, -1, -1, -1, 6, -1, 21, -1, 61, -1,
+  -1, -1, 16, -1, -1, -1, -1, -1, -1, 45, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, 73, -1, -1, 84, -1, -1, -1, -1, -1, -1, 47, 24,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 48, -1, -1, -1, 50,
+  -1, -1, -1, 41, -1, -1, -1, -1, -1, -1, -1, 53, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, 25, -1, 62, 23, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  74, 12, -1, 60, -1, -1, -1, -1, -1, -1, -1, 58, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, 64, -1, -1, -1, 71, -1, 52,
+  -1, -1, -1, -1, -1, -1, -1, 65, 49, -1, -1, 2, -1, -1, 4, -1,
+  29, -1, -1, -1, -1, -1, -1, -1, 20, -1, -1, -1, -1, -1, -1, -1,
+  42, 79, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 39, -1, -1,
+  -1, 59, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 83, 81, 8, -1,
+  -1, -1, -1, -1, -1, 63, -1, -1, -1, -1, -1, -1, -1, -1, 75, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 0, -1, -1, -1, 72, -1, 22, -1, 19, -1, -1, -1, -1, -1, 70,
+  -1, -1, -1, -1, -1, -1, 86, -1, -1, 46, -1, -1, -1, -1, -1, -1,
+  -1, -1, 13, 33, -1, -1, -1, 78, -1, -1, -1, -1, -1, -1, 43, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 76, -1, -1, 11, 77, 31,
+  -1, -1, -1, 9, -1, -1, -1, -1, -1, 26, -1, -1, -1, -1, 85, -1,
+  -1, -1, -1, -1, 18, 55, -1, -1, -1, 36, -1, -1, -1, 54, -1, 3,
+  -1, -1, -1, 30, -1, -1, -1, -1, -1, -1, -1, 35, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, 10, 38, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 7, -1,
+  -1, -1, -1, 17, -1, -1, -1, -1, 27, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 51, -1,
+  -1, -1, -1, -1, -1, 56, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, 34, -1, -1, -1, -1, -1, -1, 82, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, 37, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 57, -1, -1,
+  -1, -1, -1, 44, -1, 15, 69, -1, -1, -1, -1, -1, 14, -1, 32, -1,
+  -1, -1, -1, 28, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+
+constexpr unsigned int books_osis_folded_seed = 713;
+constexpr short books_osis_folded_slots [] =
+{
+  -1, -1, -1, -1, -1, -1, -1, 6, -1, -1, -1, -1, -1, -1, 69, -1,
+  -1, 46, 24, -1, -1, -1, -1, -1, -1, 30, -1, -1, -1, -1, -1, 38,
+  81, 14, -1, 63, 41, 23, -1, -1, -1, -1, -1, 9, -1, -1, -1, -1,
+  61, 16, -1, -1, -1, -1, -1, -1, 29, 58, -1, 20, -1, -1, -1, -1,
+  -1, -1, -1, -1, 8, 11, -1, -1, -1, -1, -1, -1, 3, -1, -1, 53,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, 34, -1, -1, -1, -1, -1, -1, 40, -1, -1, -1,
+  -1, -1, 36, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, 7, -1, -1, -1, -1, -1, 32, 44, -1, -1, -1, -1, 22,
+  -1, -1, -1, 35, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 77, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, 57, -1, 82, -1, -1, 50, -1, -1,
+  -1, -1, 85, -1, -1, -1, -1, -1, -1, -1, -1, 52, -1, -1, -1, 48,
+  -1, -1, 37, -1, -1, -1, 45, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, 31, -1, -1, -1, 75, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, 47, -1, -1, -1, -1, -1, 51, -1, -1, -1, -1, 42, -1, -1,
+  -1, -1, -1, -1, 10, -1, 21, -1, -1, -1, -1, -1, -1, 80, -1, -1,
+  -1, 19, -1, 49, 15, 25, -1, -1, -1, 64, -1, -1, -1, -1, -1, -1,
+  -1, -1, 65, -1, -1, -1, -1, 12, -1, 74, -1, -1, -1, 59, 1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, -1, -1,
+  -1, -1, 5, 72, -1, -1, -1, 17, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 33, -1, 71, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, 83, -1, -1, -1, -1, -1, 76, -1, -1, 18, -1, -1, 13,
+  -1, -1, -1, 28, -1, -1, -1, -1, 84, -1, -1, -1, -1, -1, -1, 27,
+  54, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 39,
+  -1, 62, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 70, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, 86, -1, -1, 56, -1, -1, -1,
+  -1, 4, -1, -1, 43, 55, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 79, -1, -1, -1,
+  -1, -1, -1, -1, -1, 78, -1, -1, -1, -1, -1, 60, -1, -1, -1, 73,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 26, -1
+};
+
+
+constexpr unsigned int books_bibleworks_seed = 2585;
+constexpr short books_bibleworks_slots [] =
+{
+  -1, -1, -1, -1, -1, 42, -1, -1, -1, -1, -1, 56, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 34, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 26, -1, -1, -1, -1, -1,
+  -1, -1, -1, 18, -1, -1, -1, 58, 70, -1, 8, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, 65, -1, -1, -1, -1, -1, 22, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, 75, 84, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, 40, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 82,
+  -1, -1, -1, -1, -1, -1, 4, -1, 31, -1, -1, -1, -1, -1, 41, 39,
+  -1, -1, -1, 48, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 21, -1, 38, -1, 55, -1, -1, 5, 12, -1, -1, -1, -1, -1, 37,
+  -1, -1, 49, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, 61, -1, -1, -1, -1, -1, 35, -1, -1, -1,
+  -1, 79, -1, -1, -1, 86, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, 29, 85, -1, -1, -1, -1, -1, -1, 77, -1,
+  59, -1, 45, -1, -1, 43, -1, 76, -1, -1, -1, -1, -1, -1, -1, 54,
+  -1, 23, 62, 30, 78, 10, -1, -1, 53, -1, -1, -1, -1, -1, -1, 11,
+  -1, -1, 83, -1, -1, -1, -1, -1, -1, -1, -1, 3, -1, -1, 71, -1,
+  -1, 72, -1, -1, -1, -1, -1, -1, 9, -1, 6, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 17,
+  -1, -1, -1, -1, -1, -1, 44, 50, 0, -1, -1, -1, -1, -1, -1, -1,
+  13, -1, 28, -1, -1, -1, -1, -1, -1, -1, 63, -1, -1, -1, 74, -1,
+  46, -1, -1, -1, -1, -1, -1, 14, -1, -1, -1, -1, 7, 57, -1, -1,
+  -1, -1, 51, -1, -1, -1, -1, -1, -1, 16, -1, 2, -1, -1, 19, 24,
+  -1, -1, 20, -1, -1, -1, -1, -1, -1, 27, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 69, -1, -1, -1,
+  -1, -1, 80, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 73, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, -1,
+  -1, 15, -1, -1, -1, -1, 32, -1, -1, 33, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, 25, -1, -1, -1, -1, -1, 81,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 52, -1, 60, -1,
+  -1, -1, -1, -1, -1, -1, -1, 47, 36, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 64, -1
+};
+
+
+constexpr unsigned int books_onlinebible_seed = 10;
+constexpr short books_onlinebible_slots [] =
+{
+  -1, -1, 53, 64, -1, -1, -1, -1, -1, -1, 29, -1, -1, -1, -1, -1,
+  -1, 15, -1, 5, -1, -1, -1, -1, -1, -1, -1, -1, 52, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, 49, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, 19, -1, -1, -1, 14, -1, -1, -1, 56, -1, 22,
+  -1, 23, -1, -1, -1, -1, -1, -1, -1, -1, 26, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, 45, 43, -1, -1, -1, -1, -1,
+  -1, 40, -1, -1, -1, -1, -1, 20, 48, -1, -1, 62, -1, -1, -1, 37,
+  -1, -1, -1, -1, 21, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 63, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 50,
+  -1, -1, -1, -1, -1, -1, -1, 1, -1, -1, 47, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, 58, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, 8, -1, -1, 12, -1, 24, 35, -1,
+  44, -1, -1, 27, -1, -1, -1, -1, -1, -1, -1, 13, 25, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, 9, -1, 10, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, 61, 3, -1, 36, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, 51, -1, -1, -1, -1, -1, 7, -1,
+  -1, 39, -1, -1, -1, -1, -1, -1, -1, -1, 32, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 38, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, 60, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, 30, 28, -1, -1, -1, -1, -1, -1, -1, 57, -1, 18, -1, -1, -1,
+  -1, -1, -1, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, 33, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 42, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  31, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, 6, -1, -1, 41, 59, -1, -1, -1, -1, -1, -1, -1,
+  -1, -1, -1, -1, -1, -1, -1, -1, 11, -1, 34, -1, 16, -1, -1, 54,
+  -1, -1, 46, -1, -1, -1, -1, -1, 55, -1, 17, 65, -1, -1, -1, -1
+};
@@ -32,6 +32,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 // this table. The table does not contain important data.
 // In cases of extreme corruption, the database file should be manually removed
 // before running setup.
+// Tables "chapters" and "hits" cache the results of the checks per chapter.
+// They get rewritten whenever a chapter or the settings of the checks change.
 
 
 const char * Database_Check::filename ()
@@ -73,6 +75,42 @@ void Database_Check::create ()
            " data text"
            ");");
   sql.execute ();
+
+  sql.clear ();
+
+  sql.add ("CREATE INDEX IF NOT EXISTS output2index ON output2 (bible, data);");
+  sql.execute ();
+
+  sql.clear ();
+
+  sql.add ("CREATE TABLE IF NOT EXISTS chapters ("
+           " bible text,"
+           " book integer,"
+           " chapter integer,"
+           " hash text"
+           ");");
+  sql.execute ();
+
+  sql.clear ();
+
+  sql.add ("CREATE INDEX IF NOT EXISTS chaptersindex ON chapters (bible, book, chapter);");
+  sql.execute ();
+
+  sql.clear ();
+
+  sql.add ("CREATE TABLE IF NOT EXISTS hits ("
+           " bible text,"
+           " book integer,"
+           " chapter integer,"
+           " verse integer,"
+           " data text"
+           ");");
+  sql.execute ();
+
+  sql.clear ();
+
+  sql.add ("CREATE INDEX IF NOT EXISTS hitsindex ON hits (bible, book, chapter);");
+  sql.execute ();
 }
 
 
@@ -98,9 +136,13 @@ void Database_Check::truncateOutput (string bible)
 }
 
 
-void Database_Check::recordOutput (string bible, int book, int chapter, int verse, string data)
+// While this thread collects the output of the checks, this points to where it goes.
+static thread_local vector <Database_Check_Hit> * database_check_collector = nullptr;
+
+
+// Records one item of output of the checks through the open database $sql.
+void database_check_record (SqliteDatabase & sql, string bible, int book, int chapter, int verse, string data)
 {
-  SqliteDatabase sql (filename ());
   int count = 0;
   // Check whether this is a suppressed item.
   // If it was suppressed, do not record it.
@@ -173,6 +215,39 @@ void Database_Check::recordOutput (string bible, int book, int chapter, int vers
 }
 
 
+void Database_Check::recordOutput (string bible, int book, int chapter, int verse, string data)
+{
+  if (database_check_collector) {
+    Database_Check_Hit hit;
+    hit.rowid = 0;
+    hit.bible = bible;
+    hit.book = book;
+    hit.chapter = chapter;
+    hit.verse = verse;
+    hit.data = data;
+    database_check_collector->push_back (hit);
+    return;
+  }
+  SqliteDatabase sql (filename ());
+  database_check_record (sql, bible, book, chapter, verse, data);
+}
+
+
+// Records the output of the checks in $hits, in the given order, in one transaction.
+void Database_Check::recordOutput (const vector <Database_Check_Hit> & hits)
+{
+  SqliteDatabase sql (filename ());
+  sql.add ("BEGIN;");
+  sql.execute ();
+  for (auto & hit : hits) {
+    database_check_record (sql, hit.bible, hit.book, hit.chapter, hit.verse, hit.data);
+  }
+  sql.clear ();
+  sql.add ("COMMIT;");
+  sql.execute ();
+}
+
+
 vector <Database_Check_Hit> Database_Check::getHits ()
 {
   vector <Database_Check_Hit> hits;
@@ -283,3 +358,129 @@ void Database_Check::release (int id)
   sql.execute ();
 }
 
+
+// Let the checks that run on the calling thread put their output in $hits,
+// rather than recording it in the database.
+// Passing NULL records the output in the database again.
+void Database_Check::collect (vector <Database_Check_Hit> * hits)
+{
+  database_check_collector = hits;
+}
+
+
+// Returns the content hashes of the checked chapters of the $bible and $book, keyed by chapter.
+map <int, string> Database_Check::getChapterHashes (string bible, int book)
+{
+  map <int, string> hashes;
+  SqliteDatabase sql (filename ());
+  sql.add ("SELECT chapter, hash FROM chapters WHERE bible =");
+  sql.add (bible);
+  sql.add ("AND book =");
+  sql.add (book);
+  sql.add (";");
+  map <string, vector <string> > result = sql.query ();
+  vector <string> chapters = result ["chapter"];
+  vector <string> hash = result ["hash"];
+  for (unsigned int i = 0; i < chapters.size (); i++) {
+    hashes [convert_to_int (chapters [i])] = hash [i];
+  }
+  return hashes;
+}
+
+
+// Returns the cached results of the checks of all chapters in the $bible and $book,
+// in the order the checks produced them.
+vector <Database_Check_Hit> Database_Check::getChapterHits (string bible, int book)
+{
+  vector <Database_Check_Hit> hits;
+  SqliteDatabase sql (filename ());
+  sql.add ("SELECT rowid, chapter, verse, data FROM hits WHERE bible =");
+  sql.add (bible);
+  sql.add ("AND book =");
+  sql.add (book);
+  sql.add ("ORDER BY rowid;");
+  map <string, vector <string> > result = sql.query ();
+  vector <string> rowids = result ["rowid"];
+  vector <string> chapters = result ["chapter"];
+  vector <string> verses = result ["verse"];
+  vector <string> data = result ["data"];
+  for (unsigned int i = 0; i < rowids.size(); i++) {
+    Database_Check_Hit hit = Database_Check_Hit ();
+    hit.rowid = convert_to_int (rowids [i]);
+    hit.bible = bible;
+    hit.book = book;
+    hit.chapter = convert_to_int (chapters [i]);
+    hit.verse = convert_to_int (verses [i]);
+    hit.data = data [i];
+    hits.push_back (hit);
+  }
+  return hits;
+}
+
+
+// Caches the results of the checks of a chapter, together with the $hash of its content.
+void Database_Check::storeChapterHits (string bible, int book, int chapter, string hash, const vector <Database_Check_Hit> & hits)
+{
+  SqliteDatabase sql (filename ());
+  sql.add ("BEGIN;");
+  sql.add ("DELETE FROM chapters WHERE bible =");
+  sql.add (bible);
+  sql.add ("AND book =");
+  sql.add (book);
+  sql.add ("AND chapter =");
+  sql.add (chapter);
+  sql.add (";");
+  sql.add ("DELETE FROM hits WHERE bible =");
+  sql.add (bible);
+  sql.add ("AND book =");
+  sql.add (book);
+  sql.add ("AND chapter =");
+  sql.add (chapter);
+  sql.add (";");
+  sql.add ("INSERT INTO chapters VALUES (");
+  sql.add (bible);
+  sql.add (",");
+  sql.add (book);
+  sql.add (",");
+  sql.add (chapter);
+  sql.add (",");
+  sql.add (hash);
+  sql.add (");");
+  for (auto & hit : hits) {
+    sql.add ("INSERT INTO hits VALUES (");
+    sql.add (bible);
+    sql.add (",");
+    sql.add (book);
+    sql.add (",");
+    sql.add (chapter);
+    sql.add (",");
+    sql.add (hit.verse);
+    sql.add (",");
+    sql.add (hit.data);
+    sql.add (");");
+  }
+  sql.add ("COMMIT;");
+  sql.execute ();
+}
+
+
+// Removes the cached results of the checks of a chapter.
+void Database_Check::eraseChapterHits (string bible, int book, int chapter)
+{
+  SqliteDatabase sql (filename ());
+  sql.add ("DELETE FROM chapters WHERE bible =");
+  sql.add (bible);
+  sql.add ("AND book =");
+  sql.add (book);
+  sql.add ("AND chapter =");
+  sql.add (chapter);
+  sql.add (";");
+  sql.add ("DELETE FROM hits WHERE bible =");
+  sql.add (bible);
+  sql.add ("AND book =");
+  sql.add (book);
+  sql.add ("AND chapter =");
+  sql.add (chapter);
+  sql.add (";");
+  sql.execute ();
+}
@@ -44,12 +44,18 @@ public:
   void optimize ();
   void truncateOutput (string bible);
   void recordOutput (string bible, int book, int chapter, int verse, string data);
+  void recordOutput (const vector <Database_Check_Hit> & hits);
   vector <Database_Check_Hit> getHits ();
   void approve (int id);
   void erase (int id);
   Passage getPassage (int id);
   vector <Database_Check_Hit> getSuppressions ();
   void release (int id);
+  static void collect (vector <Database_Check_Hit> * hits);
+  map <int, string> getChapterHashes (string bible, int book);
+  vector <Database_Check_Hit> getChapterHits (string bible, int book);
+  void storeChapterHits (string bible, int book, int chapter, string hash, const vector <Database_Check_Hit> & hits);
+  void eraseChapterHits (string bible, int book, int chapter);
 private:
   const char * filename ();
 };
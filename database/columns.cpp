@@ -0,0 +1,493 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+
+#include <database/columns.h>
+#include <database/sqlite.h>
+#include <database/logic.h>
+#include <filter/url.h>
+#include <filter/string.h>
+#ifndef HAVE_WINDOWS
+#include <sys/mman.h>
+#endif
+
+
+// The original-language databases answer one SQLite query per attribute per word.
+// This store keeps the same data in columns, built once from the SQLite database,
+// and mapped into memory, so that looking up a word is a few array accesses.
+// Resilience: It is never written to after it has been built.
+// When the SQLite database changes, it is rebuilt from it.
+
+
+// The layout of the store, all numbers being 32 bits:
+// - The magic bytes, the size and modification time of the SQLite database it was built from,
+//   the number of words, columns and verses, and per column the number of strings,
+//   whether it is indexed, and the size of its characters.
+// - The verse index: book, chapter, verse, and the first word, per verse, plus one closing entry.
+// - The rowid of each word in the SQLite database, and the words sorted on rowid.
+// - Per column: The string per word, the offsets of the sorted strings, and their characters.
+//   For the indexed columns: The offsets of the words per string, and the words.
+
+
+const char * database_columns_magic = "bcolumn1";
+
+
+mutex database_columns_mutex;
+map <string, shared_ptr <Database_Columns> > database_columns_cache;
+
+
+void database_columns_append (string & output, uint32_t value)
+{
+  output.append ((const char *) &value, sizeof (value));
+}
+
+
+Database_Columns::Database_Columns ()
+{
+}
+
+
+Database_Columns::~Database_Columns ()
+{
+#ifndef HAVE_WINDOWS
+  if (mapped) munmap ((void *) data, size);
+#endif
+}
+
+
+// Gets the store for the SQLite $database.
+// The words are in $table, and their attributes in $columns.
+// Each column either holds the strings, or refers to the rowids of a table of strings with the same name.
+// The $indexed columns can be searched on.
+// If there's no store yet, or it is out of date, it gets built.
+shared_ptr <Database_Columns> Database_Columns::get (const string & database, const string & table, const vector <string> & columns, const vector <string> & indexed)
+{
+  lock_guard <mutex> lock (database_columns_mutex);
+  shared_ptr <Database_Columns> & store = database_columns_cache [database];
+  if (!store) {
+    store = make_shared <Database_Columns> ();
+    if (!store->open (database, columns, indexed)) {
+      build (database, table, columns, indexed);
+      store = make_shared <Database_Columns> ();
+      if (!store->open (database, columns, indexed)) {
+        // Without a SQLite database there's an empty store.
+        store = make_shared <Database_Columns> ();
+      }
+    }
+  }
+  return store;
+}
+
+
+// Builds the store for the SQLite $database, if it is out of date, and loads it.
+void Database_Columns::compile (const string & database, const string & table, const vector <string> & columns, const vector <string> & indexed)
+{
+  lock_guard <mutex> lock (database_columns_mutex);
+  shared_ptr <Database_Columns> store = make_shared <Database_Columns> ();
+  if (!store->open (database, columns, indexed)) {
+    build (database, table, columns, indexed);
+    store = make_shared <Database_Columns> ();
+    if (!store->open (database, columns, indexed)) {
+      store = make_shared <Database_Columns> ();
+    }
+  }
+  database_columns_cache [database] = store;
+}
+
+
+string Database_Columns::file (const string & database)
+{
+  return filter_url_create_root_path (database_logic_databases (), database + ".columns");
+}
+
+
+// The rowids of the words in $book $chapter $verse, in the order they were stored.
+vector <int> Database_Columns::rowids (int book, int chapter, int verse) const
+{
+  vector <int> rowids;
+  pair <uint32_t, uint32_t> words = range (book, chapter, verse);
+  for (uint32_t i = words.first; i < words.second; i++) {
+    rowids.push_back (row_rowids [i]);
+  }
+  return rowids;
+}
+
+
+// The string in $column of the word with $rowid.
+string Database_Columns::value (size_t column, int rowid) const
+{
+  if (column >= row_values.size ()) return "";
+  int i = row (rowid);
+  if (i < 0) return "";
+  return text (column, row_values [column][i]);
+}
+
+
+// The strings in $column of the words in $book $chapter $verse.
+vector <string> Database_Columns::values (size_t column, int book, int chapter, int verse) const
+{
+  vector <string> values;
+  if (column >= row_values.size ()) return values;
+  pair <uint32_t, uint32_t> words = range (book, chapter, verse);
+  for (uint32_t i = words.first; i < words.second; i++) {
+    values.push_back (text (column, row_values [column][i]));
+  }
+  return values;
+}
+
+
+// The passages with a word that has $value in $column, in canonical order.
+vector <Passage> Database_Columns::search (size_t column, const string & value) const
+{
+  vector <Passage> passages;
+  if (column >= row_values.size ()) return passages;
+
+  // The strings are sorted, so the one looked for is found through a binary search.
+  uint32_t low = 0;
+  uint32_t high = string_counts [column];
+  while (low < high) {
+    uint32_t middle = low + (high - low) / 2;
+    if (text (column, middle) < value) low = middle + 1;
+    else high = middle;
+  }
+  if (low >= string_counts [column]) return passages;
+  if (text (column, low) != value) return passages;
+  uint32_t id = low;
+
+  // The words with the string, from the inverted index, or else from the column itself.
+  vector <uint32_t> rows;
+  if (postings [column]) {
+    for (uint32_t i = posting_offsets [column][id]; i < posting_offsets [column][id + 1]; i++) {
+      rows.push_back (postings [column][i]);
+    }
+  } else {
+    for (uint32_t i = 0; i < row_count; i++) {
+      if (row_values [column][i] == id) rows.push_back (i);
+    }
+  }
+
+  // The words are in verse order, so each verse they are in follows the previous one.
+  uint32_t previous = verse_count;
+  for (auto i : rows) {
+    // The verse is the last one that starts at or before the word.
+    uint32_t first = 0;
+    uint32_t last = verse_count;
+    while (last - first > 1) {
+      uint32_t middle = first + (last - first) / 2;
+      if (verse_index [middle * 4 + 3] <= i) first = middle;
+      else last = middle;
+    }
+    if (first == previous) continue;
+    previous = first;
+    const uint32_t * entry = verse_index + first * 4;
+    passages.push_back (Passage ("", entry [0], entry [1], to_string (entry [2])));
+  }
+
+  return passages;
+}
+
+
+// Builds the store from the SQLite $database.
+// It returns false if there's no such database.
+bool Database_Columns::build (const string & database, const string & table, const vector <string> & columns, const vector <string> & indexed)
+{
+  string source = database_sqlite_file (database);
+  if (!file_or_dir_exists (source)) return false;
+  sqlite3 * db = database_sqlite_connect (database);
+  if (!db) return false;
+
+  // The columns that refer to a table of strings get their strings from that table.
+  vector <bool> referring;
+  vector <map <int, string> > referred (columns.size ());
+  for (size_t c = 0; c < columns.size (); c++) {
+    SqliteSQL sql;
+    sql.add ("SELECT name FROM sqlite_master WHERE type = 'table' AND name =");
+    sql.add (columns [c]);
+    sql.add (";");
+    bool refers = !database_sqlite_query (db, sql.sql) ["name"].empty ();
+    referring.push_back (refers);
+    if (!refers) continue;
+    sql.clear ();
+    sql.add ("SELECT rowid,");
+    sql.add (columns [c].c_str ());
+    sql.add ("FROM");
+    sql.add (columns [c].c_str ());
+    sql.add (";");
+    map <string, vector <string> > result = database_sqlite_query (db, sql.sql);
+    vector <string> & rowids = result ["rowid"];
+    vector <string> & strings = result [columns [c]];
+    for (size_t i = 0; i < rowids.size () && i < strings.size (); i++) {
+      referred [c][convert_to_int (rowids [i])] = strings [i];
+    }
+  }
+
+  // Read the words one book at a time, sorted on chapter and verse, and in the order they were stored.
+  // Intern the strings of each column as they come in.
+  vector <uint32_t> verse_index;
+  vector <uint32_t> row_rowids;
+  vector <map <string, uint32_t> > interned (columns.size ());
+  vector <vector <uint32_t> > values (columns.size ());
+  vector <string> books;
+  {
+    SqliteSQL sql;
+    sql.add ("SELECT DISTINCT book FROM");
+    sql.add (table.c_str ());
+    sql.add ("ORDER BY book;");
+    books = database_sqlite_query (db, sql.sql) ["book"];
+  }
+  for (auto & book : books) {
+    SqliteSQL sql;
+    sql.add ("SELECT rowid, chapter, verse");
+    for (auto & column : columns) {
+      sql.add (",");
+      sql.add (column.c_str ());
+    }
+    sql.add ("FROM");
+    sql.add (table.c_str ());
+    sql.add ("WHERE book =");
+    sql.add (convert_to_int (book));
+    sql.add ("ORDER BY chapter, verse, rowid;");
+    map <string, vector <string> > result = database_sqlite_query (db, sql.sql);
+    vector <string> & rowids = result ["rowid"];
+    vector <string> & chapters = result ["chapter"];
+    vector <string> & verses = result ["verse"];
+    for (size_t i = 0; i < rowids.size (); i++) {
+      uint32_t b = convert_to_int (book);
+      uint32_t c = convert_to_int (chapters [i]);
+      uint32_t v = convert_to_int (verses [i]);
+      size_t entries = verse_index.size ();
+      if (!entries || (verse_index [entries - 4] != b) || (verse_index [entries - 3] != c) || (verse_index [entries - 2] != v)) {
+        verse_index.insert (verse_index.end (), {b, c, v, (uint32_t) row_rowids.size ()});
+      }
+      row_rowids.push_back (convert_to_int (rowids [i]));
+      for (size_t column = 0; column < columns.size (); column++) {
+        string value = result [columns [column]][i];
+        if (referring [column]) value = referred [column][convert_to_int (value)];
+        auto iterator = interned [column].find (value);
+        if (iterator == interned [column].end ()) {
+          iterator = interned [column].insert ({value, (uint32_t) interned [column].size ()}).first;
+        }
+        values [column].push_back (iterator->second);
+      }
+    }
+  }
+  database_sqlite_disconnect (db);
+
+  uint32_t row_count = row_rowids.size ();
+  uint32_t verse_count = verse_index.size () / 4;
+  verse_index.insert (verse_index.end (), {0, 0, 0, row_count});
+
+  vector <uint32_t> rowid_rows (row_count);
+  iota (rowid_rows.begin (), rowid_rows.end (), 0);
+  sort (rowid_rows.begin (), rowid_rows.end (), [&] (uint32_t a, uint32_t b) {
+    return row_rowids [a] < row_rowids [b];
+  });
+
+  // Give the strings of each column their sorted position as their identifier.
+  vector <string> characters (columns.size ());
+  vector <vector <uint32_t> > offsets (columns.size ());
+  for (size_t column = 0; column < columns.size (); column++) {
+    vector <uint32_t> sorted (interned [column].size ());
+    uint32_t id = 0;
+    for (auto & element : interned [column]) {
+      sorted [element.second] = id++;
+      offsets [column].push_back (characters [column].size ());
+      characters [column].append (element.first);
+    }
+    offsets [column].push_back (characters [column].size ());
+    while (characters [column].size () % 4) characters [column].push_back ('\0');
+    for (auto & value : values [column]) value = sorted [value];
+  }
+
+  string output (database_columns_magic);
+  database_columns_append (output, filter_url_filesize (source));
+  database_columns_append (output, filter_url_file_modification_time (source));
+  database_columns_append (output, row_count);
+  database_columns_append (output, columns.size ());
+  database_columns_append (output, verse_count);
+  for (size_t column = 0; column < columns.size (); column++) {
+    database_columns_append (output, interned [column].size ());
+    database_columns_append (output, in_array (columns [column], indexed));
+    database_columns_append (output, characters [column].size ());
+  }
+  for (auto value : verse_index) database_columns_append (output, value);
+  for (auto value : row_rowids) database_columns_append (output, value);
+  for (auto value : rowid_rows) database_columns_append (output, value);
+  for (size_t column = 0; column < columns.size (); column++) {
+    for (auto value : values [column]) database_columns_append (output, value);
+    for (auto value : offsets [column]) database_columns_append (output, value);
+    output.append (characters [column]);
+    if (!in_array (columns [column], indexed)) continue;
+    // The inverted index: The words per string, in verse order.
+    vector <uint32_t> starts (interned [column].size () + 1, 0);
+    for (auto value : values [column]) starts [value + 1]++;
+    for (size_t i = 1; i < starts.size (); i++) starts [i] += starts [i - 1];
+    vector <uint32_t> words (row_count);
+    vector <uint32_t> positions (starts.begin (), starts.end () - 1);
+    for (uint32_t i = 0; i < row_count; i++) words [positions [values [column][i]]++] = i;
+    for (auto value : starts) database_columns_append (output, value);
+    for (auto value : words) database_columns_append (output, value);
+  }
+
+  // Write the store next to the database, and move it in place,
+  // so that a store still mapped into memory remains valid.
+  string path = file (database);
+  filter_url_file_put_contents (path + ".tmp", output);
+#ifdef HAVE_WINDOWS
+  filter_url_unlink (path);
+#endif
+  filter_url_rename (path + ".tmp", path);
+  return true;
+}
+
+
+// Maps the store for the SQLite $database into memory.
+// It returns false if the store is not there, or is out of date, or is not valid.
+bool Database_Columns::open (const string & database, const vector <string> & columns, const vector <string> & indexed)
+{
+  string path = file (database);
+  if (!file_or_dir_exists (path)) return false;
+
+#ifdef HAVE_WINDOWS
+  buffer = filter_url_file_get_contents (path);
+  data = buffer.data ();
+  size = buffer.size ();
+#else
+  int fd = ::open (path.c_str (), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat status;
+  if (fstat (fd, &status) != 0) {
+    close (fd);
+    return false;
+  }
+  size = status.st_size;
+  if (size) {
+    void * address = mmap (nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (address != MAP_FAILED) {
+      data = (const char *) address;
+      mapped = true;
+    }
+  }
+  close (fd);
+  if (!mapped) return false;
+#endif
+
+  // Walk through the sections, checking that each of them fits.
+  size_t magic = strlen (database_columns_magic);
+  if (size < magic) return false;
+  if (memcmp (data, database_columns_magic, magic) != 0) return false;
+  size_t position = magic;
+  auto take = [&] (size_t count) -> const uint32_t * {
+    if (count > (size - position) / sizeof (uint32_t)) return nullptr;
+    const uint32_t * section = (const uint32_t *) (data + position);
+    position += count * sizeof (uint32_t);
+    return section;
+  };
+
+  const uint32_t * header = take (5);
+  if (!header) return false;
+  string source = database_sqlite_file (database);
+  if (header [0] != (uint32_t) filter_url_filesize (source)) return false;
+  if (header [1] != (uint32_t) filter_url_file_modification_time (source)) return false;
+  if (header [3] != columns.size ()) return false;
+  uint32_t rows = header [2];
+  uint32_t verses = header [4];
+  const uint32_t * descriptions = take (columns.size () * 3);
+  if (!descriptions) return false;
+
+  verse_index = take ((verses + 1) * 4);
+  row_rowids = take (rows);
+  rowid_rows = take (rows);
+  if (!verse_index || !row_rowids || !rowid_rows) return false;
+
+  for (size_t column = 0; column < columns.size (); column++) {
+    uint32_t strings = descriptions [column * 3];
+    bool index = descriptions [column * 3 + 1];
+    uint32_t characters = descriptions [column * 3 + 2];
+    if (index != in_array (columns [column], indexed)) return false;
+    if (characters % 4) return false;
+    string_counts.push_back (strings);
+    row_values.push_back (take (rows));
+    string_offsets.push_back (take (strings + 1));
+    const uint32_t * chars = take (characters / 4);
+    string_data.push_back ((const char *) chars);
+    if (!row_values.back () || !string_offsets.back () || !chars) return false;
+    if (string_offsets.back () [strings] > characters) return false;
+    posting_offsets.push_back (index ? take (strings + 1) : nullptr);
+    postings.push_back (index ? take (rows) : nullptr);
+    if (index && (!posting_offsets.back () || !postings.back ())) return false;
+  }
+
+  row_count = rows;
+  verse_count = verses;
+  return true;
+}
+
+
+// The index of the word with $rowid, or -1 if there's no such word.
+int Database_Columns::row (int rowid) const
+{
+  // The rowids usually run from 1 up without gaps.
+  if ((rowid > 0) && ((uint32_t) rowid <= row_count)) {
+    uint32_t i = rowid_rows [rowid - 1];
+    if (row_rowids [i] == (uint32_t) rowid) return i;
+  }
+  uint32_t low = 0;
+  uint32_t high = row_count;
+  while (low < high) {
+    uint32_t middle = low + (high - low) / 2;
+    if (row_rowids [rowid_rows [middle]] < (uint32_t) rowid) low = middle + 1;
+    else high = middle;
+  }
+  if ((low < row_count) && (row_rowids [rowid_rows [low]] == (uint32_t) rowid)) return rowid_rows [low];
+  return -1;
+}
+
+
+// The first word in $book $chapter $verse, and the one after the last word.
+pair <uint32_t, uint32_t> Database_Columns::range (int book, int chapter, int verse) const
+{
+  uint32_t low = 0;
+  uint32_t high = verse_count;
+  auto before = [&] (uint32_t i) {
+    const uint32_t * entry = verse_index + i * 4;
+    if ((int) entry [0] != book) return (int) entry [0] < book;
+    if ((int) entry [1] != chapter) return (int) entry [1] < chapter;
+    return (int) entry [2] < verse;
+  };
+  while (low < high) {
+    uint32_t middle = low + (high - low) / 2;
+    if (before (middle)) low = middle + 1;
+    else high = middle;
+  }
+  if (low >= verse_count) return {0, 0};
+  const uint32_t * entry = verse_index + low * 4;
+  if (((int) entry [0] != book) || ((int) entry [1] != chapter) || ((int) entry [2] != verse)) return {0, 0};
+  return {entry [3], entry [7]};
+}
+
+
+// The string with $id in $column.
+string Database_Columns::text (size_t column, uint32_t id) const
+{
+  if (id >= string_counts [column]) return "";
+  uint32_t begin = string_offsets [column][id];
+  uint32_t end = string_offsets [column][id + 1];
+  return string (string_data [column] + begin, end - begin);
+}
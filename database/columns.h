@@ -0,0 +1,70 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+
+#ifndef INCLUDED_DATABASE_COLUMNS_H
+#define INCLUDED_DATABASE_COLUMNS_H
+
+
+#include <config/libraries.h>
+#include <filter/passage.h>
+
+
+// A read-only columnar copy of one of the SQLite databases with the original-language texts.
+// Each column holds the interned strings of one attribute of the words,
+// and a verse index maps each book, chapter and verse to the range of words in it.
+class Database_Columns
+{
+public:
+  Database_Columns ();
+  ~Database_Columns ();
+  static shared_ptr <Database_Columns> get (const string & database, const string & table, const vector <string> & columns, const vector <string> & indexed);
+  static void compile (const string & database, const string & table, const vector <string> & columns, const vector <string> & indexed);
+  static string file (const string & database);
+  vector <int> rowids (int book, int chapter, int verse) const;
+  string value (size_t column, int rowid) const;
+  vector <string> values (size_t column, int book, int chapter, int verse) const;
+  vector <Passage> search (size_t column, const string & value) const;
+private:
+  static bool build (const string & database, const string & table, const vector <string> & columns, const vector <string> & indexed);
+  bool open (const string & database, const vector <string> & columns, const vector <string> & indexed);
+  // The memory the store is mapped into, and its size.
+  const char * data = nullptr;
+  size_t size = 0;
+  bool mapped = false;
+  string buffer;
+  // Pointers into the sections of the store.
+  uint32_t row_count = 0;
+  uint32_t verse_count = 0;
+  const uint32_t * verse_index = nullptr;
+  const uint32_t * row_rowids = nullptr;
+  const uint32_t * rowid_rows = nullptr;
+  vector <uint32_t> string_counts;
+  vector <const uint32_t *> row_values;
+  vector <const uint32_t *> string_offsets;
+  vector <const char *> string_data;
+  vector <const uint32_t *> posting_offsets;
+  vector <const uint32_t *> postings;
+  int row (int rowid) const;
+  pair <uint32_t, uint32_t> range (int book, int chapter, int verse) const;
+  string text (size_t column, uint32_t id) const;
+};
+
+
+#endif
@@ -28,6 +28,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 // The speed improvement is supposed to come from reading a value from disk only once,
 // and after that to read the value straight from the memory cache.
 map <string, string> database_config_bible_cache;
+// The settings are read and written from several threads at once.
+mutex database_config_bible_mutex;
 
 
 // Functions for getting and setting values or lists of values follow now:
@@ -58,6 +60,7 @@ string Database_Config_Bible::getValue (string bible, const char * key, const ch
 {
   // Check the memory cache.
   string cachekey = mapkey (bible, key);
+  lock_guard <mutex> lock (database_config_bible_mutex);
   if (database_config_bible_cache.count (cachekey)) {
     return database_config_bible_cache [cachekey];
   }
@@ -77,6 +80,7 @@ void Database_Config_Bible::setValue (string bible, const char * key, string val
 {
   if (bible.empty ()) return;
   // Store in memory cache.
+  lock_guard <mutex> lock (database_config_bible_mutex);
   database_config_bible_cache [mapkey (bible, key)] = value;
   // Store on disk.
   string filename = file (bible, key);
@@ -116,6 +120,7 @@ void Database_Config_Bible::remove (string bible)
   string folder = file (bible);
   filter_url_rmdir (folder);
   // Clear cache.
+  lock_guard <mutex> lock (database_config_bible_mutex);
   database_config_bible_cache.clear ();
 }
 
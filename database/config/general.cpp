@@ -577,3 +577,30 @@ void Database_Config_General::setKeepResourcesCacheForLong (bool value)
   setBValue (keep_resources_cache_for_long_key (), value);
 }
 
+
+const char * index_bibles_format_key ()
+{
+  return "index-bibles-format";
+}
+string Database_Config_General::getIndexBiblesFormat ()
+{
+  return getValue (index_bibles_format_key (), "");
+}
+void Database_Config_General::setIndexBiblesFormat (string value)
+{
+  setValue (index_bibles_format_key (), value);
+}
+
+
+const char * prometheus_key ()
+{
+  return "prometheus-key";
+}
+string Database_Config_General::getPrometheusKey ()
+{
+  return getValue (prometheus_key (), "");
+}
+void Database_Config_General::setPrometheusKey (string key)
+{
+  setValue (prometheus_key (), key);
+}
@@ -150,6 +150,12 @@ public:
   static bool getKeepResourcesCacheForLong ();
   static void setKeepResourcesCacheForLong (bool value);
 
+  static string getIndexBiblesFormat ();
+  static void setIndexBiblesFormat (string value);
+
+  static string getPrometheusKey ();
+  static void setPrometheusKey (string key);
+
 private:
   static string file (const char * key);
   static string getValue (const char * key, const char * default_value);
@@ -23,10 +23,23 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/date.h>
 #include <config/globals.h>
 #include <database/sqlite.h>
+#include <database/columns.h>
 
 
 // Database resilience: 
 // The database is normally only read from.
+// Lookups of the words go to a columnar copy of it.
+
+
+// The attributes of the words, as columns in the columnar store.
+vector <string> database_etcbc4_columns = {
+  "word", "vocalized_lexeme", "consonantal_lexeme",
+  "gloss", "pos", "subpos",
+  "gender", "number", "person",
+  "state", "tense", "stem",
+  "phrase_function", "phrase_type", "phrase_relation",
+  "phrase_a_relation", "clause_text_type", "clause_type", "clause_relation"
+};
 
 
 sqlite3 * Database_Etcbc4::connect ()
@@ -351,20 +364,7 @@ vector <int> Database_Etcbc4::verses (int book, int chapter)
 
 vector <int> Database_Etcbc4::rowids (int book, int chapter, int verse)
 {
-  SqliteSQL sql = SqliteSQL ();
-  sql.add ("SELECT rowid FROM data WHERE book =");
-  sql.add (book);
-  sql.add ("AND chapter =");
-  sql.add (chapter);
-  sql.add ("AND verse =");
-  sql.add (verse);
-  sql.add (";");
-  sqlite3 * db = connect ();
-  vector <string> result = database_sqlite_query (db, sql.sql) ["rowid"];
-  database_sqlite_disconnect (db);
-  vector <int> rowids;
-  for (auto rowid : result) rowids.push_back (convert_to_int (rowid));
-  return rowids;
+  return columns ()->rowids (book, chapter, verse);
 }
 
 
@@ -517,35 +517,19 @@ int Database_Etcbc4::get_id (sqlite3 * db, const char * table_row, string item)
 
 string Database_Etcbc4::get_item (const char * item, int rowid)
 {
-  // The $rowid refers to the main table.
-  // Update it so it refers to the sub table.
-  sqlite3 * db = connect ();
-  {
-    SqliteSQL sql = SqliteSQL ();
-    sql.add ("SELECT");
-    sql.add (item);
-    sql.add ("FROM data WHERE rowid =");
-    sql.add (rowid);
-    sql.add (";");
-    vector <string> result = database_sqlite_query (db, sql.sql) [item];
-    rowid = 0;
-    if (!result.empty ()) rowid = convert_to_int (result [0]);
-  }
-  // Retrieve the requested value from the sub table.
-  string value;
-  {
-    SqliteSQL sql = SqliteSQL ();
-    sql.add ("SELECT");
-    sql.add (item);
-    sql.add ("FROM");
-    sql.add (item);
-    sql.add ("WHERE rowid =");
-    sql.add (rowid);
-    sql.add (";");
-    vector <string> result = database_sqlite_query (db, sql.sql) [item];
-    if (!result.empty ()) value = result [0];
-  }
-  database_sqlite_disconnect (db);
-  // Done.
-  return value;
+  auto iterator = find (database_etcbc4_columns.begin (), database_etcbc4_columns.end (), item);
+  return columns ()->value (distance (database_etcbc4_columns.begin (), iterator), rowid);
+}
+
+
+// Builds the columnar store from the database, if it is out of date.
+void Database_Etcbc4::compile ()
+{
+  Database_Columns::compile ("etcb4", "data", database_etcbc4_columns, {});
+}
+
+
+shared_ptr <Database_Columns> Database_Etcbc4::columns ()
+{
+  return Database_Columns::get ("etcb4", "data", database_etcbc4_columns, {});
 }
@@ -22,6 +22,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 
 #include <config/libraries.h>
+#include <database/columns.h>
 
 
 class Database_Etcbc4
@@ -60,10 +61,12 @@ public:
   string clause_text_type (int rowid);
   string clause_type (int rowid);
   string clause_relation (int rowid);
+  void compile ();
 private:
   sqlite3 * connect ();
   int get_id (sqlite3 * db, const char * table_row, string item);
   string get_item (const char * item, int rowid);
+  shared_ptr <Database_Columns> columns ();
 };
 
 
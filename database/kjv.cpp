@@ -22,11 +22,17 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/string.h>
 #include <config/globals.h>
 #include <database/sqlite.h>
+#include <database/columns.h>
 
 
 // This is the database for the Strong's numbers and English glosses.
 // Resilience: It is not written to.
 // Chances of corruption are nearly zero.
+// Lookups go to a columnar copy of it.
+
+
+// The attributes of the words, as columns in the columnar store.
+vector <string> database_kjv_columns = {"strong", "english"};
 
 
 void Database_Kjv::create ()
@@ -79,11 +85,13 @@ const char * Database_Kjv::filename ()
 vector <Database_Kjv_Item> Database_Kjv::getVerse (int book, int chapter, int verse)
 {
   vector <Database_Kjv_Item> hits;
-  vector <int> rows = rowids (book, chapter, verse);
-  for (auto row : rows) {
+  shared_ptr <Database_Columns> store = columns ();
+  vector <string> strongs = store->values (0, book, chapter, verse);
+  vector <string> englishes = store->values (1, book, chapter, verse);
+  for (size_t i = 0; i < strongs.size (); i++) {
     Database_Kjv_Item item;
-    item.strong = strong (row);
-    item.english = english (row);
+    item.strong = strongs [i];
+    item.english = englishes [i];
     hits.push_back (item);
   }
   return hits;
@@ -93,24 +101,7 @@ vector <Database_Kjv_Item> Database_Kjv::getVerse (int book, int chapter, int ve
 // Get all passages that contain a strong's number.
 vector <Passage> Database_Kjv::searchStrong (string strong)
 {
-  int strongid = get_id ("strong", strong);
-  SqliteDatabase sql = SqliteDatabase (filename ());
-  sql.add ("SELECT DISTINCT book, chapter, verse FROM kjv2 WHERE strong =");
-  sql.add (strongid);
-  sql.add ("ORDER BY rowid;");
-  vector <Passage> hits;
-  map <string, vector <string> > result = sql.query ();
-  vector <string> books = result ["book"];
-  vector <string> chapters = result ["chapter"];
-  vector <string> verses = result ["verse"];
-  for (unsigned int i = 0; i < books.size (); i++) {
-    Passage passage;
-    passage.book = convert_to_int (books [i]);
-    passage.chapter = convert_to_int (chapters [i]);
-    passage.verse = verses [i];
-    hits.push_back (passage);
-  }
-  return hits;
+  return columns ()->search (0, strong);
 }
 
 
@@ -145,18 +136,7 @@ void Database_Kjv::store (int book, int chapter, int verse, string strong, strin
 
 vector <int> Database_Kjv::rowids (int book, int chapter, int verse)
 {
-  SqliteDatabase sql = SqliteDatabase (filename ());
-  sql.add ("SELECT rowid FROM kjv2 WHERE book =");
-  sql.add (book);
-  sql.add ("AND chapter =");
-  sql.add (chapter);
-  sql.add ("AND verse =");
-  sql.add (verse);
-  sql.add ("ORDER BY rowid;");
-  vector <string> result = sql.query () ["rowid"];
-  vector <int> rowids;
-  for (auto rowid : result) rowids.push_back (convert_to_int (rowid));
-  return rowids;
+  return columns ()->rowids (book, chapter, verse);
 }
 
 
@@ -204,28 +184,19 @@ int Database_Kjv::get_id (const char * table_row, string item)
 
 string Database_Kjv::get_item (const char * item, int rowid)
 {
-  // The $rowid refers to the main table.
-  // Update it so it refers to the sub table.
-  SqliteDatabase sql = SqliteDatabase (filename ());
-  sql.add ("SELECT");
-  sql.add (item);
-  sql.add ("FROM kjv2 WHERE rowid =");
-  sql.add (rowid);
-  sql.add (";");
-  vector <string> result = sql.query () [item];
-  rowid = 0;
-  if (!result.empty ()) rowid = convert_to_int (result [0]);
-  // Retrieve the requested value from the sub table.
-  sql.clear ();
-  sql.add ("SELECT");
-  sql.add (item);
-  sql.add ("FROM");
-  sql.add (item);
-  sql.add ("WHERE rowid =");
-  sql.add (rowid);
-  sql.add (";");
-  result = sql.query () [item];
-  if (!result.empty ()) return result [0];
-  // Not found.
-  return "";
+  auto iterator = find (database_kjv_columns.begin (), database_kjv_columns.end (), item);
+  return columns ()->value (distance (database_kjv_columns.begin (), iterator), rowid);
+}
+
+
+// Builds the columnar store from the database, if it is out of date.
+void Database_Kjv::compile ()
+{
+  Database_Columns::compile (filename (), "kjv2", database_kjv_columns, {"strong"});
+}
+
+
+shared_ptr <Database_Columns> Database_Kjv::columns ()
+{
+  return Database_Columns::get (filename (), "kjv2", database_kjv_columns, {"strong"});
 }
@@ -23,6 +23,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 #include <config/libraries.h>
 #include <filter/passage.h>
+#include <database/columns.h>
 
 
 class Database_Kjv_Item
@@ -44,10 +45,12 @@ public:
   vector <int> rowids (int book, int chapter, int verse);
   string strong (int rowid);
   string english (int rowid);
+  void compile ();
 private:
   const char * filename ();
   int get_id (const char * table_row, string item);
   string get_item (const char * item, int rowid);
+  shared_ptr <Database_Columns> columns ();
 };
 
 
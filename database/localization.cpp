@@ -31,6 +31,18 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 // In case of corruption, upgrade Bibledit and it will recreate the database.
 
 
+// The translations of the language last used, kept in memory after loading them once.
+// It gets replaced as a whole, so threads can look up translations in it without locking.
+class Database_Localization_Catalog
+{
+public:
+  string language;
+  shared_ptr <const unordered_map <string, string> > translations;
+};
+shared_ptr <const Database_Localization_Catalog> database_localization_catalog;
+mutex database_localization_catalog_mutex;
+
+
 Database_Localization::Database_Localization (const string& language_in)
 {
   language = language_in;
@@ -68,19 +80,45 @@ void Database_Localization::create (string po)
     database_sqlite_exec (db, sql.sql);
   }
   database_sqlite_disconnect (db);
+  // The translations in memory are outdated now.
+  atomic_store (&database_localization_catalog, shared_ptr <const Database_Localization_Catalog> ());
 }
 
 
-string Database_Localization::translate (const string& english)
+// Gives the translations of the language.
+// They are loaded from the database the first time, and on a change of language.
+shared_ptr <const unordered_map <string, string> > Database_Localization::catalog ()
 {
-  SqliteSQL sql = SqliteSQL ();
-  sql.add ("SELECT msgstr FROM localization WHERE msgid =");
-  sql.add (english);
-  sql.add (";");
+  shared_ptr <const Database_Localization_Catalog> current = atomic_load (&database_localization_catalog);
+  if (current && (current->language == language)) return current->translations;
+  // Load the translations once, even if more threads need them at the same time.
+  lock_guard <mutex> lock (database_localization_catalog_mutex);
+  current = atomic_load (&database_localization_catalog);
+  if (current && (current->language == language)) return current->translations;
+  auto translations = make_shared <unordered_map <string, string> > ();
   sqlite3 * db = connect ();
-  vector <string> msgstrs = database_sqlite_query (db, sql.sql) ["msgstr"];
+  map <string, vector <string> > result = database_sqlite_query (db, "SELECT msgid, msgstr FROM localization;");
   database_sqlite_disconnect (db);
-  if (!msgstrs.empty ()) if (!msgstrs[0].empty ()) return msgstrs [0];
+  vector <string> msgids = result ["msgid"];
+  vector <string> msgstrs = result ["msgstr"];
+  for (size_t i = 0; i < msgids.size (); i++) {
+    if (i >= msgstrs.size ()) break;
+    if (msgstrs [i].empty ()) continue;
+    translations->insert (make_pair (msgids [i], msgstrs [i]));
+  }
+  auto catalog = make_shared <Database_Localization_Catalog> ();
+  catalog->language = language;
+  catalog->translations = translations;
+  atomic_store (&database_localization_catalog, shared_ptr <const Database_Localization_Catalog> (catalog));
+  return translations;
+}
+
+
+string Database_Localization::translate (const string& english)
+{
+  shared_ptr <const unordered_map <string, string> > translations = catalog ();
+  auto iterator = translations->find (english);
+  if (iterator != translations->end ()) return iterator->second;
   return english;
 }
 
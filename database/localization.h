@@ -35,6 +35,7 @@ public:
 private:
   string language;
   sqlite3 * connect ();
+  shared_ptr <const unordered_map <string, string> > catalog ();
 };
 
 
@@ -32,6 +32,179 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 // 2. Android has VACUUM errors due to a locked database.
 
 
+// The journal is kept in segments: Files with the extension ".log" that entries are appended to.
+// Each entry is a line with its identifier and the length of its text, followed by the text.
+// The identifier of an entry consists of the seconds since the Unix epoch and eight digits for the microseconds.
+// It gets raised where needed, so that each entry has its own identifier, and later entries have higher ones.
+// The identifiers are what the journal calls the filenames.
+// New entries are buffered in memory, and a background writer appends them to the segment in batches.
+// An index in memory gives where each entry is, so that readers do not need to scan the folder or read all files.
+
+
+// Where a journal entry is stored.
+class Database_Logs_Record
+{
+public:
+  string filename;
+  string segment;
+  long offset = 0;
+  long length = 0;
+};
+
+
+class Database_Logs_State
+{
+public:
+  mutex state_mutex;
+  // The folder the index belongs to.
+  string folder;
+  bool loaded = false;
+  // The index of the entries, in the order of their identifiers.
+  vector <Database_Logs_Record> records;
+  // The segment the writer appends to, and its size.
+  string segment;
+  long segment_size = 0;
+  // The entries waiting to be written.
+  vector <pair <string, string> > buffer;
+  bool writer_scheduled = false;
+  string last_filename;
+};
+
+
+// This is never deleted, so that a writer still running during exit finds it in place.
+Database_Logs_State * database_logs_state = new Database_Logs_State;
+
+
+// The size at which the writer starts a new segment.
+#ifdef HAVE_TINY_JOURNAL
+#define DATABASE_LOGS_SEGMENT_SIZE 100000
+#else
+#define DATABASE_LOGS_SEGMENT_SIZE 1000000
+#endif
+// The number of buffered entries at which they get written straightaway.
+#define DATABASE_LOGS_BUFFER_SIZE 1000
+
+
+// Reads the index entries from a $segment in the $folder.
+// A damaged end of the segment is left out.
+static void database_logs_index_segment (const string & folder, const string & segment, vector <Database_Logs_Record> & records)
+{
+  string contents = filter_url_file_get_contents (filter_url_create_path (folder, segment));
+  size_t offset = 0;
+  while (offset < contents.size ()) {
+    size_t newline = contents.find ('\n', offset);
+    if (newline == string::npos) break;
+    string header = contents.substr (offset, newline - offset);
+    size_t space = header.find (' ');
+    if (space == string::npos) break;
+    Database_Logs_Record record;
+    record.filename = header.substr (0, space);
+    record.segment = segment;
+    record.offset = newline + 1;
+    record.length = convert_to_int (header.substr (space + 1));
+    if ((record.length < 0) || (record.offset + record.length > (long) contents.size ())) break;
+    records.push_back (record);
+    offset = record.offset + record.length + 1;
+  }
+}
+
+
+// Gives the text to store for an entry with $filename and $contents.
+static string database_logs_serialize (const string & filename, const string & contents)
+{
+  return filename + " " + convert_to_string (contents.size ()) + "\n" + contents + "\n";
+}
+
+
+// Loads the index of the journal, unless the index is current.
+// The index is reloaded when the folder changed, when it is empty,
+// or when the segments were removed from the folder, like in the unit tests.
+static void database_logs_load (Database_Logs_State * state)
+{
+  string folder = Database_Logs::folder ();
+  if (state->loaded && (state->folder == folder) && !state->records.empty ()) {
+    if (file_or_dir_exists (filter_url_create_path (folder, state->records.back ().segment))) {
+      return;
+    }
+  }
+  state->loaded = true;
+  state->folder = folder;
+  state->records.clear ();
+  state->segment.clear ();
+  state->segment_size = 0;
+  vector <string> files = filter_url_scandir (folder);
+  vector <string> legacy;
+  for (auto & file : files) {
+    if (filter_url_get_extension (file) == "log") {
+      database_logs_index_segment (folder, file, state->records);
+    } else if ((file.size () == 18) && (file.find_first_not_of ("0123456789") == string::npos)) {
+      legacy.push_back (file);
+    }
+  }
+  // Older versions stored each entry in a file of its own: Move those into a segment.
+  if (!legacy.empty ()) {
+    string segment = legacy [0] + ".log";
+    string contents;
+    for (auto & file : legacy) {
+      string path = filter_url_create_path (folder, file);
+      contents.append (database_logs_serialize (file, filter_url_file_get_contents (path)));
+    }
+    filter_url_file_put_contents (filter_url_create_path (folder, segment), contents);
+    for (auto & file : legacy) {
+      filter_url_unlink (filter_url_create_path (folder, file));
+    }
+    state->records.clear ();
+    for (auto & file : filter_url_scandir (folder)) {
+      if (filter_url_get_extension (file) == "log") {
+        database_logs_index_segment (folder, file, state->records);
+      }
+    }
+  }
+  if (!state->records.empty () && (state->records.back ().filename > state->last_filename)) {
+    state->last_filename = state->records.back ().filename;
+  }
+}
+
+
+// Appends the buffered entries to the segment in one write.
+static void database_logs_write (Database_Logs_State * state)
+{
+  database_logs_load (state);
+  if (state->buffer.empty ()) return;
+  if (state->segment.empty () || (state->segment_size > DATABASE_LOGS_SEGMENT_SIZE)) {
+    state->segment = state->buffer [0].first + ".log";
+    state->segment_size = 0;
+  }
+  string contents;
+  for (auto & element : state->buffer) {
+    string header = element.first + " " + convert_to_string (element.second.size ()) + "\n";
+    Database_Logs_Record record;
+    record.filename = element.first;
+    record.segment = state->segment;
+    record.offset = state->segment_size + contents.size () + header.size ();
+    record.length = element.second.size ();
+    state->records.push_back (record);
+    contents.append (header);
+    contents.append (element.second);
+    contents.append ("\n");
+  }
+  filter_url_file_put_contents_append (filter_url_create_path (state->folder, state->segment), contents);
+  state->segment_size += contents.size ();
+  state->buffer.clear ();
+}
+
+
+// The background writer: It waits a moment so that more entries can be written in one go.
+static void database_logs_writer ()
+{
+  this_thread::sleep_for (chrono::milliseconds (100));
+  Database_Logs_State * state = database_logs_state;
+  lock_guard <mutex> lock (state->state_mutex);
+  database_logs_write (state);
+  state->writer_scheduled = false;
+}
+
+
 // Records a journal entry.
 void Database_Logs::log (string description, int level)
 {
@@ -45,24 +218,28 @@ void Database_Logs::log (string description, int level)
     description.erase (50000);
     description.append ("... This entry was too large and has been truncated: " + convert_to_string (length) + " bytes");
   }
-  // Save this logbook entry to a filename with seconds and microseconds.
+  description.insert (0, convert_to_string (level) + " ");
+  // The filename of this logbook entry consists of the seconds and the microseconds.
   string seconds = convert_to_string (filter_date_seconds_since_epoch ());
-  string time = seconds + filter_string_fill (convert_to_string (filter_date_numerical_microseconds ()), 8, '0');
-  string file = filter_url_create_path (folder (), time);
+  string filename = seconds + filter_string_fill (convert_to_string (filter_date_numerical_microseconds ()), 8, '0');
+  Database_Logs_State * state = database_logs_state;
+  lock_guard <mutex> lock (state->state_mutex);
+  if (!state->loaded) database_logs_load (state);
   // The microseconds granularity depends on the platform.
   // On Windows it is lower than on Linux.
-  // There may be the rare case of more than one entry per file.
-  // Append the data so it won't overwrite an earlier entry.
-  if (file_or_dir_exists (file)) {
-    description.insert (0, " | ");
-  } else {
-    description.insert (0, convert_to_string (level) + " ");
+  // Raise the filename if needed, so it comes after the previous entry.
+  if (filename <= state->last_filename) {
+    filename = to_string (stoll (state->last_filename) + 1);
+  }
+  state->last_filename = filename;
+  state->buffer.push_back (make_pair (filename, description));
+  if (state->buffer.size () >= DATABASE_LOGS_BUFFER_SIZE) {
+    database_logs_write (state);
+  } else if (!state->writer_scheduled) {
+    state->writer_scheduled = true;
+    thread writer (database_logs_writer);
+    writer.detach ();
   }
-  filter_url_file_put_contents_append (file, description);
-#ifdef HAVE_WINDOWS
-  // Delay to cover for lower usec granularity on Windows.
-  this_thread::sleep_for (chrono::milliseconds (1));
-#endif
 }
 
 
@@ -78,14 +255,6 @@ void Database_Logs::log (string subject, string body, int level)
 
 void Database_Logs::rotate ()
 {
-  // Under PHP it used a mechanism that handled huge amounts of entries.
-  // The PHP function scandir choked on this or took a very long time.
-  // The PHP functions opendir / readdir / closedir handled it better.
-  // But now, in C++, with the new journal mechanism, this is no longer relevant.
-  string directory = folder ();
-  vector <string> files = filter_url_scandir (directory);
-
-  
   // Timestamp for removing older records, depending on whether it's a tiny journal.
 #ifdef HAVE_TINY_JOURNAL
   int oldtimestamp = filter_date_seconds_since_epoch () - (14400);
@@ -93,44 +262,73 @@ void Database_Logs::rotate ()
   int oldtimestamp = filter_date_seconds_since_epoch () - (6 * 86400);
 #endif
 
-  
-  // Limit the journal entry count in the filesystem.
-  // This speeds up subsequent reading of the journal by the users.
-  // In previous versions of Bibledit, there were certain conditions
-  // that led to an infinite loop, as had been noticed at times,
-  // and this quickly exhausted the available inodes on the filesystem.
+  bool filtered_entries = false;
+  {
+    Database_Logs_State * state = database_logs_state;
+    lock_guard <mutex> lock (state->state_mutex);
+    database_logs_write (state);
+    database_logs_load (state);
+    
+    // Limit the journal entry count.
+    // This speeds up subsequent reading of the journal by the users.
+    // In previous versions of Bibledit, there were certain conditions
+    // that led to an infinite loop, as had been noticed at times,
+    // and this quickly exhausted the available inodes on the filesystem.
 #ifdef HAVE_TINY_JOURNAL
-  int limitfilecount = files.size () - 200;
+    int limitcount = state->records.size () - 200;
 #else
-  int limitfilecount = files.size () - 2000;
+    int limitcount = state->records.size () - 2000;
 #endif
 
-  
-  bool filtered_entries = false;
-  for (unsigned int i = 0; i < files.size(); i++) {
-    string path = filter_url_create_path (directory, files [i]);
-
-    // Limit the number of journal entries.
-    if ((int)i < limitfilecount) {
-      filter_url_unlink (path);
-      continue;
-    }
-    
-    // Remove expired entries.
-    int timestamp = convert_to_int (files [i].substr (0, 10));
-    if (timestamp < oldtimestamp) {
-      filter_url_unlink (path);
-      continue;
+    // Go through the segments, and keep the entries that are to remain.
+    vector <string> segments;
+    string contents;
+    map <string, string> rewritten;
+    string segment;
+    bool removed = false;
+    for (unsigned int i = 0; i < state->records.size (); i++) {
+      Database_Logs_Record & record = state->records [i];
+      if (record.segment != segment) {
+        segment = record.segment;
+        segments.push_back (segment);
+        contents = filter_url_file_get_contents (filter_url_create_path (state->folder, segment));
+      }
+      // Limit the number of journal entries.
+      if ((int)i < limitcount) {
+        removed = true;
+        continue;
+      }
+      // Remove expired entries.
+      int timestamp = convert_to_int (record.filename.substr (0, 10));
+      if (timestamp < oldtimestamp) {
+        removed = true;
+        continue;
+      }
+      // Filtering of certain entries.
+      string entry = contents.substr (record.offset, record.length);
+      if (journal_logic_filter_entry (entry)) {
+        filtered_entries = true;
+        removed = true;
+        continue;
+      }
+      rewritten [segment].append (database_logs_serialize (record.filename, entry));
     }
 
-    // Filtering of certain entries.
-    string entry = filter_url_file_get_contents (path);
-    if (journal_logic_filter_entry (entry)) {
-      filtered_entries = true;
-      filter_url_unlink (path);
-      continue;
+    // Write the remaining entries into new segments, then remove the old ones.
+    if (removed) {
+      for (auto & element : rewritten) {
+        filter_url_file_put_contents (filter_url_create_path (state->folder, element.first + ".tmp"), element.second);
+      }
+      for (auto & file : segments) {
+        filter_url_unlink (filter_url_create_path (state->folder, file));
+      }
+      for (auto & element : rewritten) {
+        string path = filter_url_create_path (state->folder, element.first);
+        filter_url_rename (path + ".tmp", path);
+      }
+      state->loaded = false;
+      database_logs_load (state);
     }
-
   }
 
   if (filtered_entries) {
@@ -144,15 +342,18 @@ vector <string> Database_Logs::get (string & lastfilename)
 {
   lastfilename = "0";
 
-  // Read the journal records from the filesystem.
-  vector <string> files = filter_url_scandir (folder ());
-  for (unsigned int i = 0; i < files.size(); i++) {
+  Database_Logs_State * state = database_logs_state;
+  lock_guard <mutex> lock (state->state_mutex);
+  database_logs_write (state);
+  vector <string> filenames;
+  for (auto & record : state->records) {
+    filenames.push_back (record.filename);
     // Last second gets updated based on the filename.
-    lastfilename = files [i];
+    lastfilename = record.filename;
   }
 
   // Done.  
-  return files;
+  return filenames;
 }
 
 
@@ -160,25 +361,61 @@ vector <string> Database_Logs::get (string & lastfilename)
 // Updates "filename" to the item it got.
 string Database_Logs::next (string &filename)
 {
-  vector <string> files = filter_url_scandir (folder ());
-  for (unsigned int i = 0; i < files.size (); i++) {
-    string file = files [i];
-    if (file > filename) {
-      filename = file;
-      return file;
-    }
-  }
-  return "";
+  Database_Logs_State * state = database_logs_state;
+  lock_guard <mutex> lock (state->state_mutex);
+  database_logs_write (state);
+  auto iterator = upper_bound (state->records.begin (), state->records.end (), filename, [] (const string & value, const Database_Logs_Record & record) {
+    return value < record.filename;
+  });
+  if (iterator == state->records.end ()) return "";
+  filename = iterator->filename;
+  return filename;
+}
+
+
+// Gets the contents of the journal entry with "filename":
+// The level of the entry, a space, and the text.
+string Database_Logs::entry (const string & filename)
+{
+  Database_Logs_State * state = database_logs_state;
+  lock_guard <mutex> lock (state->state_mutex);
+  database_logs_write (state);
+  auto iterator = lower_bound (state->records.begin (), state->records.end (), filename, [] (const Database_Logs_Record & record, const string & value) {
+    return record.filename < value;
+  });
+  if ((iterator == state->records.end ()) || (iterator->filename != filename)) return "";
+  ifstream file (filter_url_create_path (state->folder, iterator->segment), ios::in | ios::binary);
+  if (!file.is_open ()) return "";
+  string contents (iterator->length, '\0');
+  file.seekg (iterator->offset);
+  file.read (&contents [0], iterator->length);
+  if (!file) return "";
+  return contents;
+}
+
+
+// Writes the buffered journal entries to disk.
+void Database_Logs::flush ()
+{
+  Database_Logs_State * state = database_logs_state;
+  lock_guard <mutex> lock (state->state_mutex);
+  database_logs_write (state);
 }
 
 
 // Clears all journal entries.
 void Database_Logs::clear ()
 {
-  string directory = folder ();
-  vector <string> files = filter_url_scandir (directory);
-  for (auto file : files) {
-    filter_url_unlink (filter_url_create_path (directory, file));
+  {
+    Database_Logs_State * state = database_logs_state;
+    lock_guard <mutex> lock (state->state_mutex);
+    state->buffer.clear ();
+    string directory = folder ();
+    vector <string> files = filter_url_scandir (directory);
+    for (auto file : files) {
+      filter_url_unlink (filter_url_create_path (directory, file));
+    }
+    state->loaded = false;
   }
   log ("The journal was cleared");
 }
@@ -32,6 +32,8 @@ public:
   static void rotate ();
   static vector <string> get (string & lastfilename);
   static string next (string &filename);
+  static string entry (const string & filename);
+  static void flush ();
   static void clear ();
   static string folder ();
 };
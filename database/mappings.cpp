@@ -44,6 +44,103 @@ sqlite3 * Database_Mappings::connect ()
 }
 
 
+// One line of a mapping: A passage in this versification, and the same passage in the original versification.
+class Database_Mappings_Entry
+{
+public:
+  int book, chapter, verse;
+  int origbook, origchapter, origverse;
+};
+
+
+// A mapping held in memory.
+// It has its entries twice, once sorted on the passages, and once sorted on the original passages,
+// so that a translation either way is a binary search.
+// Entries for the same passage keep the order in which they were imported.
+class Database_Mappings_Table
+{
+public:
+  vector <Database_Mappings_Entry> passages;
+  vector <Database_Mappings_Entry> originals;
+};
+
+
+static bool database_mappings_passage_less (const Database_Mappings_Entry & a, const Database_Mappings_Entry & b)
+{
+  return make_tuple (a.book, a.chapter, a.verse) < make_tuple (b.book, b.chapter, b.verse);
+}
+
+
+static bool database_mappings_original_less (const Database_Mappings_Entry & a, const Database_Mappings_Entry & b)
+{
+  return make_tuple (a.origbook, a.origchapter, a.origverse) < make_tuple (b.origbook, b.origchapter, b.origverse);
+}
+
+
+mutex database_mappings_mutex;
+map <string, shared_ptr <const Database_Mappings_Table> > database_mappings_cache;
+pair <int, int> database_mappings_signature;
+
+
+// Gets the mapping $name from memory.
+// It is read from the database once, and kept till the database changes.
+shared_ptr <const Database_Mappings_Table> Database_Mappings::table (const string& name)
+{
+  lock_guard <mutex> lock (database_mappings_mutex);
+
+  // If the database was changed or replaced behind this object's back, drop what was read from it before.
+  string path = database_sqlite_file ("mappings");
+  pair <int, int> signature (filter_url_filesize (path), filter_url_file_modification_time (path));
+  if (signature != database_mappings_signature) {
+    database_mappings_cache.clear ();
+    database_mappings_signature = signature;
+  }
+
+  shared_ptr <const Database_Mappings_Table> & cached = database_mappings_cache [name];
+  if (cached) return cached;
+
+  SqliteSQL sql = SqliteSQL ();
+  sql.add ("SELECT book, chapter, verse, origbook, origchapter, origverse FROM maps WHERE name =");
+  sql.add (name);
+  sql.add ("ORDER BY rowid ASC;");
+  sqlite3 * db = connect ();
+  map <string, vector <string> > result = database_sqlite_query (db, sql.sql);
+  database_sqlite_disconnect (db);
+  vector <string> books = result ["book"];
+  vector <string> chapters = result ["chapter"];
+  vector <string> verses = result ["verse"];
+  vector <string> origbooks = result ["origbook"];
+  vector <string> origchapters = result ["origchapter"];
+  vector <string> origverses = result ["origverse"];
+
+  shared_ptr <Database_Mappings_Table> table = make_shared <Database_Mappings_Table> ();
+  for (unsigned int i = 0; i < books.size (); i++) {
+    Database_Mappings_Entry entry;
+    entry.book = convert_to_int (books [i]);
+    entry.chapter = convert_to_int (chapters [i]);
+    entry.verse = convert_to_int (verses [i]);
+    entry.origbook = convert_to_int (origbooks [i]);
+    entry.origchapter = convert_to_int (origchapters [i]);
+    entry.origverse = convert_to_int (origverses [i]);
+    table->passages.push_back (entry);
+  }
+  table->originals = table->passages;
+  stable_sort (table->passages.begin (), table->passages.end (), database_mappings_passage_less);
+  stable_sort (table->originals.begin (), table->originals.end (), database_mappings_original_less);
+
+  cached = table;
+  return cached;
+}
+
+
+// Drops the mappings held in memory, to be called after the database changes.
+void Database_Mappings::invalidate ()
+{
+  lock_guard <mutex> lock (database_mappings_mutex);
+  database_mappings_cache.clear ();
+}
+
+
 void Database_Mappings::create1 ()
 {
   sqlite3 * db = connect ();
@@ -63,6 +160,7 @@ void Database_Mappings::create1 ()
   sql = "DROP INDEX IF EXISTS original;";
   database_sqlite_exec (db, sql);
   database_sqlite_disconnect (db);
+  invalidate ();
 }
 
 
@@ -173,6 +271,7 @@ void Database_Mappings::import (const string& name, const string& data)
   database_sqlite_exec (db, "COMMIT;");
 
   database_sqlite_disconnect (db);
+  invalidate ();
 }
 
 
@@ -220,6 +319,7 @@ void Database_Mappings::create (const string & name)
   sqlite3 * db = connect ();
   database_sqlite_exec (db, sql.sql);
   database_sqlite_disconnect (db);
+  invalidate ();
 }
 
 
@@ -232,6 +332,7 @@ void Database_Mappings::erase (const string & name)
   sqlite3 * db = connect ();
   database_sqlite_exec (db, sql.sql);
   database_sqlite_disconnect (db);
+  invalidate ();
 }
 
 
@@ -273,29 +374,19 @@ vector <Passage> Database_Mappings::translate (const string& input, const string
     return {passage};
   }
 
-  // Get the $input mapping for the passage from the database.
+  // Get the $input mapping for the passage.
   // This maps the $input to the Hebrew/Greek versification system.
   // Skip this phase if the $input mapping is Hebrew / Greek.
   vector <Passage> origpassage;
   if (input != original ()) {
-    SqliteSQL sql = SqliteSQL ();
-    sql.add ("SELECT origbook, origchapter, origverse FROM maps WHERE name =");
-    sql.add (input);
-    sql.add ("AND book =");
-    sql.add (book);
-    sql.add ("AND chapter =");
-    sql.add (chapter);
-    sql.add ("AND verse =");
-    sql.add (verse);
-    sql.add (";");
-    sqlite3 * db = connect ();
-    map <string, vector <string> > result = database_sqlite_query (db, sql.sql);
-    database_sqlite_disconnect (db);
-    vector <string> origbooks = result ["origbook"];
-    vector <string> origchapters = result ["origchapter"];
-    vector <string> origverses = result ["origverse"];
-    for (unsigned int i = 0; i < origbooks.size (); i++) {
-      Passage passage = Passage ("", convert_to_int (origbooks [i]), convert_to_int (origchapters [i]), origverses [i]);
+    shared_ptr <const Database_Mappings_Table> mapping = table (input);
+    Database_Mappings_Entry key;
+    key.book = book;
+    key.chapter = chapter;
+    key.verse = verse;
+    auto range = equal_range (mapping->passages.begin (), mapping->passages.end (), key, database_mappings_passage_less);
+    for (auto iterator = range.first; iterator != range.second; iterator++) {
+      Passage passage = Passage ("", iterator->origbook, iterator->origchapter, convert_to_string (iterator->origverse));
       origpassage.push_back (passage);
     }
   }
@@ -312,31 +403,18 @@ vector <Passage> Database_Mappings::translate (const string& input, const string
     return origpassage;
   }
   
-  // Get the $output mapping for the passage or two passages from the database.
+  // Get the $output mapping for the passage or two passages.
   // This is a translation from Hebrew/Greek to the $output system.
   vector <Passage> targetpassage;
+  shared_ptr <const Database_Mappings_Table> mapping = table (output);
   for (Passage & passage : origpassage) {
-    int origbook = passage.book;
-    int origchapter = passage.chapter;
-    int origverse = convert_to_int (passage.verse);
-    SqliteSQL sql = SqliteSQL ();
-    sql.add ("SELECT book, chapter, verse FROM maps WHERE name =");
-    sql.add (output);
-    sql.add ("AND origbook =");
-    sql.add (origbook);
-    sql.add ("AND origchapter =");
-    sql.add (origchapter);
-    sql.add ("AND origverse =");
-    sql.add (origverse);
-    sql.add (";");
-    sqlite3 * db = connect ();
-    map <string, vector <string> > result = database_sqlite_query (db, sql.sql);
-    database_sqlite_disconnect (db);
-    vector <string> books = result ["book"];
-    vector <string> chapters = result ["chapter"];
-    vector <string> verses = result ["verse"];
-    for (unsigned int i = 0; i < books.size (); i++) {
-      Passage passage = Passage ("", convert_to_int (books [i]), convert_to_int (chapters [i]), verses [i]);
+    Database_Mappings_Entry key;
+    key.origbook = passage.book;
+    key.origchapter = passage.chapter;
+    key.origverse = convert_to_int (passage.verse);
+    auto range = equal_range (mapping->originals.begin (), mapping->originals.end (), key, database_mappings_original_less);
+    for (auto iterator = range.first; iterator != range.second; iterator++) {
+      Passage passage = Passage ("", iterator->book, iterator->chapter, convert_to_string (iterator->verse));
       bool passageExists = false;
       for (auto & existingpassage : targetpassage) {
         if (existingpassage.equal (passage)) passageExists = true;
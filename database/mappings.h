@@ -25,6 +25,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/passage.h>
 
 
+class Database_Mappings_Table;
+
+
 class Database_Mappings
 {
 public:
@@ -43,6 +46,8 @@ public:
   vector <Passage> translate (const string& input, const string& output, int book, int chapter, int verse);
 private:
   sqlite3 * connect ();
+  shared_ptr <const Database_Mappings_Table> table (const string& name);
+  static void invalidate ();
 };
 
 
@@ -24,12 +24,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/date.h>
 #include <database/sqlite.h>
 #include <database/logic.h>
+#include <database/logs.h>
+#include <filter/diff.h>
+#include <filter/roles.h>
 
 
 // Database resilience:
-// All information is stored in the filesystem as files or as very small databases.
-// The large database is only used as an index.
-// It is re-indexed every night.
+// The user and team data is stored in the filesystem as files.
+// The change notifications are stored in the database, one row per notification.
+// Expired notifications are removed every night.
 
 
 const char * Database_Modifications::filename ()
@@ -65,9 +68,36 @@ void Database_Modifications::create ()
     " book integer,"
     " chapter integer,"
     " verse integer,"
-    " modification text"
+    " modification text,"
+    " oldtext text,"
+    " newtext text"
     ");";
   database_sqlite_exec (db, sql);
+
+  // Upgrade the table: Store the old and new texts with the notifications.
+  // They used to be stored in a separate small database per notification.
+  sql = "PRAGMA table_info (notifications);";
+  vector <string> columns = database_sqlite_query (db, sql) ["name"];
+  if (find (columns.begin(), columns.end(), "oldtext") == columns.end()) {
+    sql = "ALTER TABLE notifications ADD COLUMN oldtext text;";
+    database_sqlite_exec (db, sql);
+    sql = "ALTER TABLE notifications ADD COLUMN newtext text;";
+    database_sqlite_exec (db, sql);
+  }
+
+  // Indexes for selecting notifications without going through all of them.
+  sql = "CREATE INDEX IF NOT EXISTS notifications_identifier ON notifications (identifier);";
+  database_sqlite_exec (db, sql);
+  sql = "CREATE INDEX IF NOT EXISTS notifications_username ON notifications (username, category, bible);";
+  database_sqlite_exec (db, sql);
+  sql = "CREATE INDEX IF NOT EXISTS notifications_passage ON notifications (book, chapter, verse, identifier);";
+  database_sqlite_exec (db, sql);
+  sql = "CREATE INDEX IF NOT EXISTS notifications_timestamp ON notifications (timestamp);";
+  database_sqlite_exec (db, sql);
+
+  // Move any notifications stored in the old way into the table.
+  if (file_or_dir_exists (notificationsMainFolder ())) importNotifications (db);
+
   database_sqlite_disconnect (db);
 }
 
@@ -78,6 +108,40 @@ bool Database_Modifications::healthy ()
 }
 
 
+// Does a checkup on the health of the database, and creates it if needed.
+// The change notifications are stored in this database only.
+// So a damaged database is not deleted.
+// It is set aside, and the notifications that can still be read from it are copied into a new database.
+void Database_Modifications::checkup ()
+{
+  string file = database_sqlite_file (filename ());
+  if ((filter_url_filesize (file) > 0) && !healthy ()) {
+    Database_Logs::log ("The database with the change notifications is damaged: Recovering the notifications", Filter_Roles::translator ());
+    string damaged = file + ".damaged";
+    filter_url_rename (file, damaged);
+    create ();
+    sqlite3 * db = connect ();
+    SqliteSQL sql = SqliteSQL ();
+    sql.add ("ATTACH DATABASE");
+    sql.add (damaged);
+    sql.add ("AS damaged;");
+    database_sqlite_exec (db, sql.sql);
+    vector <string> attached = database_sqlite_query (db, "PRAGMA database_list;") ["name"];
+    if (in_array (string ("damaged"), attached)) {
+      string columns = "identifier, timestamp, username, category, bible, book, chapter, verse, modification, oldtext, newtext";
+      database_sqlite_exec (db, "INSERT INTO notifications (" + columns + ") SELECT " + columns + " FROM damaged.notifications;");
+      database_sqlite_exec (db, "DETACH DATABASE damaged;");
+    }
+    vector <string> result = database_sqlite_query (db, "SELECT count(*) FROM notifications;") ["count(*)"];
+    database_sqlite_disconnect (db);
+    string count = result.empty () ? "0" : result [0];
+    // The damaged database stays for whatever further recovery is needed.
+    Database_Logs::log ("Recovered change notifications: " + count + ", the damaged database is at " + damaged, Filter_Roles::translator ());
+  }
+  create ();
+}
+
+
 void Database_Modifications::vacuum ()
 {
   sqlite3 * db = connect ();
@@ -273,6 +337,7 @@ void Database_Modifications::truncateTeams ()
 // Code dealing with the "users" data.
 
 
+// The deep folder structure the saves by the users were stored in before they went into the logs.
 string Database_Modifications::userMainFolder ()
 {
   return filter_url_create_root_path (database_logic_databases (), "modifications", "users");
@@ -333,93 +398,309 @@ string Database_Modifications::userNewTextFile (const string& username, const st
 }
 
 
+// The saves by the users are appended to a log, one log per user.
+// Each save in the log starts with a line with the timestamp, book, chapter, old ID, new ID,
+// whether the old text has a base, and the sizes of the Bible, the old text, and the new text.
+// Then follow the Bible, the old text, the new text, and a new line.
+// The old text is a delta against the new text of the save with the old ID, if that save is in the log,
+// else against an empty base.
+// The new text is a delta against the old text.
+// Normally this leaves only the bit of text that the user changed.
+
+
+mutex database_modifications_user_mutex;
+
+
+// The new ID and the new text of the last save per user / Bible / book / chapter,
+// with the order in which they were saved.
+class Database_Modifications_Last_Save
+{
+public:
+  int newid = 0;
+  string newtext;
+  long sequence = 0;
+};
+map <string, Database_Modifications_Last_Save> database_modifications_user_last_saves;
+long database_modifications_user_last_sequence = 0;
+// The number of last saves kept in memory.
+// Without the last save of a chapter, its next save is stored in full, rather than as a delta.
+#define DATABASE_MODIFICATIONS_MAXIMUM_LAST_SAVES 500
+
+
+// Forgets the last saves of the user, for when the user's log is gone.
+void database_modifications_user_forget (const string& username)
+{
+  string prefix = username + "\n";
+  auto iter = database_modifications_user_last_saves.lower_bound (prefix);
+  while ((iter != database_modifications_user_last_saves.end ()) && (iter->first.compare (0, prefix.size (), prefix) == 0)) {
+    iter = database_modifications_user_last_saves.erase (iter);
+  }
+}
+
+
+string Database_Modifications::userLogFolder ()
+{
+  return filter_url_create_root_path (database_logic_databases (), "modifications", "saves");
+}
+
+
+string Database_Modifications::userLogFile (const string& username)
+{
+  return filter_url_create_path (userLogFolder (), username);
+}
+
+
 void Database_Modifications::recordUserSave (const string& username, const string& bible, int book, int chapter, int oldID, const string& oldText, int newID, const string& newText)
 {
-  // This entry is saved in a deep folder structure with the new ID in it.
-  string folder = userNewIDFolder (username, bible, book, chapter, newID);
+  Database_Modifications_Save save;
+  save.timestamp = filter_date_seconds_since_epoch ();
+  save.bible = bible;
+  save.book = book;
+  save.chapter = chapter;
+  save.oldid = oldID;
+  save.oldtext = oldText;
+  save.newid = newID;
+  save.newtext = newText;
+  appendUserSave (username, save);
+}
+
+
+void Database_Modifications::appendUserSave (const string& username, const Database_Modifications_Save& save)
+{
+  string key = username + "\n" + save.bible + "\n" + convert_to_string (save.book) + "\n" + convert_to_string (save.chapter);
+  string path = userLogFile (username);
+  lock_guard <mutex> lock (database_modifications_user_mutex);
+  // A delta can only be against a save that is in the log.
+  if (!file_or_dir_exists (path)) database_modifications_user_forget (username);
+  if (!database_modifications_user_last_saves.count (key)) {
+    // Make space by forgetting the chapter saved longest ago.
+    if (database_modifications_user_last_saves.size () >= DATABASE_MODIFICATIONS_MAXIMUM_LAST_SAVES) {
+      auto oldest = database_modifications_user_last_saves.begin ();
+      for (auto iter = oldest; iter != database_modifications_user_last_saves.end (); iter++) {
+        if (iter->second.sequence < oldest->second.sequence) oldest = iter;
+      }
+      database_modifications_user_last_saves.erase (oldest);
+    }
+  }
+  Database_Modifications_Last_Save & last_save = database_modifications_user_last_saves [key];
+  bool based = (last_save.newid != 0) && (last_save.newid == save.oldid);
+  string olddelta = filter_diff_delta (based ? last_save.newtext : "", save.oldtext);
+  string newdelta = filter_diff_delta (save.oldtext, save.newtext);
+  string entry;
+  for (auto number : {save.timestamp, save.book, save.chapter, save.oldid, save.newid, (int) based, (int) save.bible.size (), (int) olddelta.size ()}) {
+    entry.append (convert_to_string (number));
+    entry.append (" ");
+  }
+  entry.append (convert_to_string ((int) newdelta.size ()));
+  entry.append ("\n");
+  entry.append (save.bible);
+  entry.append (olddelta);
+  entry.append (newdelta);
+  entry.append ("\n");
+  string folder = userLogFolder ();
   if (!file_or_dir_exists (folder)) filter_url_mkdir (folder);
-  // The other data is stored in separate files in the newID folder.
-  string timeFile = userTimeFile (username, bible, book, chapter, newID);
-  filter_url_file_put_contents (timeFile, convert_to_string (filter_date_seconds_since_epoch ()));
-  string oldIDFile = userOldIDFile (username, bible, book, chapter, newID);
-  filter_url_file_put_contents (oldIDFile, convert_to_string (oldID));
-  string oldTextFile = userOldTextFile (username, bible, book, chapter, newID);
-  filter_url_file_put_contents (oldTextFile, oldText);
-  string newTextFile = userNewTextFile (username, bible, book, chapter, newID);
-  filter_url_file_put_contents (newTextFile, newText);
+  filter_url_file_put_contents_append (path, entry);
+  last_save.newid = save.newid;
+  last_save.newtext = save.newtext;
+  last_save.sequence = ++database_modifications_user_last_sequence;
+}
+
+
+// Reads the saves in the log of the user in one go.
+// The saves remain loaded till the log changes, indexed by Bible, book and chapter, and by new ID.
+const vector <Database_Modifications_Save> & Database_Modifications::getUserSaves (const string& username)
+{
+  string path = userLogFile (username);
+  int size = filter_url_filesize (path);
+  if ((username == loaded_username) && (size == loaded_size)) return loaded_saves;
+  loaded_username = username;
+  loaded_size = size;
+  loaded_saves.clear ();
+  loaded_chapters.clear ();
+  loaded_positions.clear ();
+  string log = filter_url_file_get_contents (path);
+  size_t pos = 0;
+  while (pos < log.size ()) {
+    size_t eol = log.find ('\n', pos);
+    if (eol == string::npos) break;
+    // A save that was not written in full gets skipped.
+    // The next save may follow straight after it, not on a new line,
+    // so reading goes on at the next number that starts a save that is there in full.
+    vector <string> bits = filter_string_explode (log.substr (pos, eol - pos), ' ');
+    bool whole = (bits.size () == 9);
+    for (auto & bit : bits) if (!filter_string_is_numeric (bit)) whole = false;
+    size_t start = eol + 1;
+    size_t bible_size = 0, old_size = 0, new_size = 0;
+    if (whole) {
+      bible_size = convert_to_int (bits [6]);
+      old_size = convert_to_int (bits [7]);
+      new_size = convert_to_int (bits [8]);
+      size_t end = start + bible_size + old_size + new_size;
+      whole = (end < log.size ()) && (log [end] == '\n');
+    }
+    if (!whole) {
+      do pos++;
+      while ((pos < log.size ()) && !(isdigit (log [pos]) && !isdigit (log [pos - 1])));
+      continue;
+    }
+    Database_Modifications_Save save;
+    save.timestamp = convert_to_int (bits [0]);
+    save.book = convert_to_int (bits [1]);
+    save.chapter = convert_to_int (bits [2]);
+    save.oldid = convert_to_int (bits [3]);
+    save.newid = convert_to_int (bits [4]);
+    save.bible = log.substr (start, bible_size);
+    string key = save.bible + "\n" + convert_to_string (save.book) + "\n" + convert_to_string (save.chapter) + "\n";
+    string base;
+    if (convert_to_bool (bits [5])) {
+      auto iter = loaded_positions.find (key + convert_to_string (save.oldid));
+      if (iter != loaded_positions.end ()) base = loaded_saves [iter->second].newtext;
+      else {
+        // The save this one is a delta against was skipped, so this one cannot be read either.
+        pos = start + bible_size + old_size + new_size + 1;
+        continue;
+      }
+    }
+    save.oldtext = filter_diff_apply_delta (base, log.substr (start + bible_size, old_size));
+    save.newtext = filter_diff_apply_delta (save.oldtext, log.substr (start + bible_size + old_size, new_size));
+    loaded_positions [key + convert_to_string (save.newid)] = loaded_saves.size ();
+    loaded_chapters [key].push_back (loaded_saves.size ());
+    loaded_saves.push_back (save);
+    pos = start + bible_size + old_size + new_size + 1;
+  }
+  return loaded_saves;
+}
+
+
+const Database_Modifications_Save * Database_Modifications::getUserSave (const string& username, const string& bible, int book, int chapter, int newID)
+{
+  const vector <Database_Modifications_Save> & saves = getUserSaves (username);
+  string key = bible + "\n" + convert_to_string (book) + "\n" + convert_to_string (chapter) + "\n" + convert_to_string (newID);
+  auto iter = loaded_positions.find (key);
+  if (iter == loaded_positions.end ()) return NULL;
+  return &saves [iter->second];
+}
+
+
+// Moves the saves of the user stored in the deep folder structure into the user's log.
+// This is how they were stored till October 2026.
+void Database_Modifications::importUserSaves (const string& username)
+{
+  vector <Database_Modifications_Save> saves;
+  for (auto & bible : filter_url_scandir (userUserFolder (username))) {
+    for (auto & sbook : filter_url_scandir (userBibleFolder (username, bible))) {
+      int book = convert_to_int (sbook);
+      for (auto & schapter : filter_url_scandir (userBookFolder (username, bible, book))) {
+        int chapter = convert_to_int (schapter);
+        vector <int> newids;
+        for (auto & newid : filter_url_scandir (userChapterFolder (username, bible, book, chapter))) {
+          newids.push_back (convert_to_int (newid));
+        }
+        sort (newids.begin (), newids.end ());
+        for (auto newid : newids) {
+          Database_Modifications_Save save;
+          save.timestamp = convert_to_int (filter_url_file_get_contents (userTimeFile (username, bible, book, chapter, newid)));
+          save.bible = bible;
+          save.book = book;
+          save.chapter = chapter;
+          save.oldid = convert_to_int (filter_url_file_get_contents (userOldIDFile (username, bible, book, chapter, newid)));
+          save.oldtext = filter_url_file_get_contents (userOldTextFile (username, bible, book, chapter, newid));
+          save.newid = newid;
+          save.newtext = filter_url_file_get_contents (userNewTextFile (username, bible, book, chapter, newid));
+          saves.push_back (save);
+        }
+      }
+    }
+  }
+  for (auto & save : saves) {
+    appendUserSave (username, save);
+  }
+  filter_url_rmdir (userUserFolder (username));
 }
 
 
 void Database_Modifications::clearUserUser (const string& username)
 {
-  string folder = userUserFolder (username);
-  filter_url_rmdir (folder);
+  {
+    lock_guard <mutex> lock (database_modifications_user_mutex);
+    filter_url_unlink (userLogFile (username));
+    database_modifications_user_forget (username);
+  }
+  filter_url_rmdir (userUserFolder (username));
+  loaded_username.clear ();
+  loaded_saves.clear ();
+  loaded_chapters.clear ();
+  loaded_positions.clear ();
 }
 
 
 vector <string> Database_Modifications::getUserUsernames ()
 {
-  string folder = userMainFolder ();
-  vector <string> usernames = filter_url_scandir (folder);
-  return usernames;
+  // Move any saves still stored in the old way into the logs.
+  for (auto & username : filter_url_scandir (userMainFolder ())) {
+    importUserSaves (username);
+  }
+  return filter_url_scandir (userLogFolder ());
 }
 
 
 vector <string> Database_Modifications::getUserBibles (const string& username)
 {
-  string folder = userUserFolder (username);
-  return filter_url_scandir (folder);
+  set <string> bibles;
+  for (auto & save : getUserSaves (username)) {
+    bibles.insert (save.bible);
+  }
+  return vector <string> (bibles.begin (), bibles.end ());
 }
 
 
 vector <int> Database_Modifications::getUserBooks (const string& username, const string& bible)
 {
-  string folder = userBibleFolder (username, bible);
-  vector <string> files = filter_url_scandir (folder);
-  vector <int> books;
-  for (auto & file : files) {
-    books.push_back (convert_to_int (file));
+  set <int> books;
+  for (auto & save : getUserSaves (username)) {
+    if (save.bible == bible) books.insert (save.book);
   }
-  sort (books.begin(), books.end());
-  return books;
+  return vector <int> (books.begin (), books.end ());
 }
 
 
 vector <int> Database_Modifications::getUserChapters (const string& username, const string& bible, int book)
 {
-  string folder = userBookFolder (username, bible, book);
-  vector <string> files = filter_url_scandir (folder);
+  // The time of the last save per chapter.
+  map <int, int> times;
+  for (auto & save : getUserSaves (username)) {
+    if (save.bible != bible) continue;
+    if (save.book != book) continue;
+    times [save.chapter] = max (times [save.chapter], save.timestamp);
+  }
   vector <int> chapters;
-  for (auto & file : files) {
-    string path = filter_url_create_path (folder, file);
-    int time = filter_url_file_modification_time (path);
-    int days = (filter_date_seconds_since_epoch () - time) / 86400;
-    if (days > 5) {
-      // Unprocessed user changes older than so many days usually indicate a problem.
-      // Perhaps the server crashed so it never could process them.
-      // Cases like this have been seen on servers with limited memory.
-      // Therefore just remove this change, without processing it.
-      filter_url_rmdir (path);
-    } else {
-      chapters.push_back (convert_to_int (file));
-    }
+  for (auto & element : times) {
+    int days = (filter_date_seconds_since_epoch () - element.second) / 86400;
+    // Unprocessed user changes older than so many days usually indicate a problem.
+    // Perhaps the server crashed so it never could process them.
+    // Cases like this have been seen on servers with limited memory.
+    // Therefore just skip this change, without processing it.
+    // It gets removed when the user's log is cleared.
+    if (days > 5) continue;
+    chapters.push_back (element.first);
   }
-  sort (chapters.begin(), chapters.end());
   return chapters;
 }
 
 
+// Gets the identifiers of the saves of the chapter, in the order they were saved.
 vector <Database_Modifications_Id> Database_Modifications::getUserIdentifiers (const string& username, const string& bible, int book, int chapter)
 {
-  string folder = userChapterFolder (username, bible, book, chapter);
   vector <Database_Modifications_Id> ids;
-  vector <string> newids = filter_url_scandir (folder);
-  for (auto & newid : newids) {
-    string file = userOldIDFile (username, bible, book, chapter, convert_to_int (newid));
-    string oldid = filter_url_file_get_contents (file);
+  const vector <Database_Modifications_Save> & saves = getUserSaves (username);
+  string key = bible + "\n" + convert_to_string (book) + "\n" + convert_to_string (chapter) + "\n";
+  auto iter = loaded_chapters.find (key);
+  if (iter == loaded_chapters.end ()) return ids;
+  for (auto position : iter->second) {
+    const Database_Modifications_Save & save = saves [position];
     Database_Modifications_Id id;
-    id.oldid = convert_to_int (oldid);
-    id.newid = convert_to_int (newid);
+    id.oldid = save.oldid;
+    id.newid = save.newid;
     ids.push_back (id);
   }
   return ids;
@@ -428,23 +709,20 @@ vector <Database_Modifications_Id> Database_Modifications::getUserIdentifiers (c
 
 Database_Modifications_Text Database_Modifications::getUserChapter (const string& username, const string& bible, int book, int chapter, int newID)
 {
-  string oldfile = userOldTextFile (username, bible, book, chapter, newID);
-  string newfile = userNewTextFile (username, bible, book, chapter, newID);
-  string oldtext = filter_url_file_get_contents (oldfile);
-  string newtext = filter_url_file_get_contents (newfile);
   Database_Modifications_Text data;
-  data.oldtext = oldtext;
-  data.newtext = newtext;
+  const Database_Modifications_Save * save = getUserSave (username, bible, book, chapter, newID);
+  if (save) {
+    data.oldtext = save->oldtext;
+    data.newtext = save->newtext;
+  }
   return data;
 }
 
 
 int Database_Modifications::getUserTimestamp (const string& username, const string& bible, int book, int chapter, int newID)
 {
-  string file = userTimeFile (username, bible, book, chapter, newID);
-  string contents = filter_url_file_get_contents (file);
-  int time = convert_to_int (contents);
-  if (time > 0) return time;
+  const Database_Modifications_Save * save = getUserSave (username, bible, book, chapter, newID);
+  if (save && (save->timestamp > 0)) return save->timestamp;
   return filter_date_seconds_since_epoch ();
 }
 
@@ -464,225 +742,108 @@ string Database_Modifications::notificationIdentifierDatabase (int identifier)
 }
 
 
-// This function is for the unit tests.
 void Database_Modifications::notificationUpdateTime (int identifier, int timestamp)
 {
-  SqliteDatabase sql (notificationIdentifierDatabase (identifier));
-  sql.add ("UPDATE notification SET timestamp =");
+  SqliteSQL sql = SqliteSQL ();
+  sql.add ("UPDATE notifications SET timestamp =");
   sql.add (timestamp);
+  sql.add ("WHERE identifier =");
+  sql.add (identifier);
   sql.add (";");
-  sql.execute ();
+  sqlite3 * db = connect ();
+  database_sqlite_exec (db, sql.sql);
+  database_sqlite_disconnect (db);
 }
 
 
 int Database_Modifications::getNextAvailableNotificationIdentifier ()
 {
-  // Read the existing identifiers in the folder.
-  vector <string> files = filter_url_scandir (notificationsMainFolder ());
-  // Sort from low to high.
-  vector <int> identifiers;
-  for (auto file : files) {
-    identifiers.push_back (convert_to_int (file));
-  }
-  sort (identifiers.begin(), identifiers.end());
-  // Fetch the last and highest identifier.
+  // During a batch of notifications the identifiers are handed out in sequence.
+  if (batching) return batch_identifier;
+  // Take the one after the highest identifier in use.
+  // The index on the identifiers gives it straightaway.
+  sqlite3 * db = connect ();
+  vector <string> result = database_sqlite_query (db, "SELECT max(identifier) FROM notifications;") ["max(identifier)"];
+  database_sqlite_disconnect (db);
   int identifier = 0;
-  size_t length = identifiers.size();
-  if (length) identifier = identifiers [length - 1];
-  // Take next one.
+  if (!result.empty ()) identifier = convert_to_int (result [0]);
   identifier++;
-  // Done.
   return identifier;
 }
 
 
+// Starts a batch of notifications.
+// They are held in memory till the batch is committed,
+// and then written through one connection in one transaction.
+// So the database is not locked while the notifications are being prepared.
+void Database_Modifications::beginNotifications ()
+{
+  if (batching) return;
+  batch_identifier = getNextAvailableNotificationIdentifier ();
+  batching = true;
+}
+
+
+void Database_Modifications::commitNotifications ()
+{
+  if (!batching) return;
+  batching = false;
+  if (batch_statements.empty ()) return;
+  sqlite3 * db = connect ();
+  database_sqlite_exec (db, "BEGIN;");
+  for (auto & statement : batch_statements) database_sqlite_exec (db, statement);
+  database_sqlite_exec (db, "COMMIT;");
+  database_sqlite_disconnect (db);
+  batch_statements.clear ();
+}
+
+
 void Database_Modifications::recordNotification (const vector <string> & users, const string& category, const string& bible, int book, int chapter, int verse, const string& oldtext, const string& modification, const string& newtext)
 {
   // Normally this function is called just after midnight.
   // It would then put the current time on changes made the day before.
   // Make a correction for that by subtracting 6 hours.
   int timestamp = filter_date_seconds_since_epoch () - 21600;
+  // Outside of a batch, the notifications for all users go in one transaction.
+  bool local_batch = !batching;
+  if (local_batch) beginNotifications ();
   for (auto & user : users) {
-    int identifier = getNextAvailableNotificationIdentifier ();
-    SqliteDatabase sql (notificationIdentifierDatabase (identifier));
-    sql.add (createNotificationsDbSql ());
-    sql.execute ();
-    sql.clear ();
-    sql.add ("INSERT INTO notification VALUES (");
-    sql.add (timestamp);
-    sql.add (",");
-    sql.add (user);
-    sql.add (",");
-    sql.add (category);
-    sql.add (",");
-    sql.add (bible);
-    sql.add (",");
-    sql.add (book);
-    sql.add (",");
-    sql.add (chapter);
-    sql.add (",");
-    sql.add (verse);
-    sql.add (",");
-    sql.add (oldtext);
-    sql.add (",");
-    sql.add (modification);
-    sql.add (",");
-    sql.add (newtext);
-    sql.add (");");
-    sql.execute ();
+    batch_statements.push_back (insertNotification (batch_identifier, timestamp, user, category, bible, book, chapter, verse, oldtext, modification, newtext));
+    batch_identifier++;
   }
+  if (local_batch) commitNotifications ();
 }
 
 
 void Database_Modifications::indexTrimAllNotifications ()
 {
-  // When the index is not healthy, delete it.
-  if (!healthy ()) erase ();
-  // Create a new index if it does not exist.
-  create ();
+  // Recover a damaged database, and create a new database if it does not exist.
+  checkup ();
 
-  // Get the notification identifiers on disk.
-  vector <string> sidentifiers = filter_url_scandir (notificationsMainFolder ());
+  sqlite3 * db = connect ();
 
   // Change notifications expire after 30 days.
   // But the more there are, the sooner they expire.
+  int count = 0;
+  vector <string> result = database_sqlite_query (db, "SELECT count(*) FROM notifications;") ["count(*)"];
+  if (!result.empty ()) count = convert_to_int (result [0]);
   int expiry_time = filter_date_seconds_since_epoch () - (30 * 3600 * 24);
-  if (sidentifiers.size () > 10000) expiry_time = filter_date_seconds_since_epoch () - (14 * 3600 * 24);
-  if (sidentifiers.size () > 20000) expiry_time = filter_date_seconds_since_epoch () - (7 * 3600 * 14);
-  if (sidentifiers.size () > 30000) expiry_time = filter_date_seconds_since_epoch () - (4 * 3600 * 14);
-
-  // Database: Connect and speed it up.
-  sqlite3 * db = connect ();
-  database_sqlite_exec (db, "PRAGMA synchronous = OFF;");
-
-  // Go through the notifications on disk.
-  vector <int> identifiers;
-  for (auto s : sidentifiers) {
-    identifiers.push_back (convert_to_int (s));
-  }
-  sort (identifiers.begin(), identifiers.end());
-  for (auto & identifier : identifiers) {
-
-    // Fetch the data from the database and validate it.
-
-    string path = notificationIdentifierDatabase (identifier);
-    bool valid = !filter_url_is_dir (path);
-
-    map <string, vector <string> > result;
-    if (valid) {
-      SqliteDatabase sql (path);
-      sql.add ("SELECT * FROM notification;");
-      result = sql.query ();
-    }
-    if (result.empty ()) valid = false;
-
-    int timestamp = 0;
-    if (valid) {
-      vector <string> timestamps = result ["timestamp"];
-      if (timestamps.empty ()) valid = false;
-      else timestamp = convert_to_int (timestamps [0]);
-    }
-    if (timestamp < expiry_time) valid = false;
+  if (count > 10000) expiry_time = filter_date_seconds_since_epoch () - (14 * 3600 * 24);
+  if (count > 20000) expiry_time = filter_date_seconds_since_epoch () - (7 * 3600 * 14);
+  if (count > 30000) expiry_time = filter_date_seconds_since_epoch () - (4 * 3600 * 14);
 
-    bool exists = false;
-    if (valid) {
-      SqliteSQL sql = SqliteSQL ();
-      sql.add ("SELECT count(*) FROM notifications WHERE identifier = ");
-      sql.add (identifier);
-      sql.add (";");
-      vector <string> result = database_sqlite_query (db, sql.sql) ["count(*)"];
-      if (!result.empty ()) {
-        int count = convert_to_int (result [0]);
-        exists = (count > 0);
-      }
-    }
-    
-    string user;
-    if (!exists && valid) {
-      vector <string> usernames = result ["username"];
-      if (usernames.empty ()) valid = false;
-      else user = usernames [0];
-      if (user.empty ()) valid = false;
-    }
-
-    string category;
-    if (!exists && valid) {
-      vector <string> categories = result ["category"];
-      if (categories.empty ()) valid = false;
-      else category = categories [0];
-    }
-
-    string bible;
-    if (!exists && valid) {
-      vector <string> bibles = result ["bible"];
-      if (bibles.empty ()) valid = false;
-      else bible = bibles [0];
-      if (bible.empty ()) valid = false;
-    }
-
-    int book = 0;
-    if (!exists && valid) {
-      vector <string> books = result ["book"];
-      if (books.empty ()) valid = false;
-      else book = convert_to_int (books [0]);
-      if (book == 0) valid = false;
-    }
-
-    int chapter = 0;
-    if (!exists && valid) {
-      vector <string> chapters = result ["chapter"];
-      if (chapters.empty ()) valid = false;
-      else chapter = convert_to_int (chapters [0]);
-      if (chapters [0].empty ()) valid = false;
-    }
-    
-    int verse = 0;
-    if (!exists && valid) {
-      vector <string> verses = result ["verse"];
-      if (verses.empty ()) valid = false;
-      else verse = convert_to_int (verses [0]);
-      if (verses [0].empty ()) valid = false;
-    }
+  // Delete expired and invalid notifications.
+  SqliteSQL sql = SqliteSQL ();
+  sql.add ("DELETE FROM notifications WHERE timestamp <");
+  sql.add (expiry_time);
+  sql.add ("OR timestamp IS NULL");
+  sql.add ("OR username IS NULL OR username = ''");
+  sql.add ("OR bible IS NULL OR bible = ''");
+  sql.add ("OR book IS NULL OR book = 0");
+  sql.add ("OR chapter IS NULL OR verse IS NULL");
+  sql.add ("OR modification IS NULL OR modification = '';");
+  database_sqlite_exec (db, sql.sql);
 
-    string modification;
-    if (!exists && valid) {
-      vector <string> modifications = result ["modification"];
-      if (modifications.empty ()) valid = false;
-      else modification = modifications [0];
-      if (modification.empty()) valid = false;
-    }
-   
-    if (valid) {
-      // Store valid data in the database if it does not yet exist.
-      if (!exists) {
-        SqliteSQL sql = SqliteSQL ();
-        sql.add ("INSERT INTO notifications VALUES (");
-        sql.add (identifier);
-        sql.add (",");
-        sql.add (timestamp);
-        sql.add (",");
-        sql.add (user);
-        sql.add (",");
-        sql.add (category);
-        sql.add (",");
-        sql.add (bible);
-        sql.add (",");
-        sql.add (book);
-        sql.add (",");
-        sql.add (chapter);
-        sql.add (",");
-        sql.add (verse);
-        sql.add (",");
-        sql.add (modification);
-        sql.add (");");
-        database_sqlite_exec (db, sql.sql);
-      }
-    } else {
-      // Delete invalid or expired data.
-      deleteNotification (identifier, db);
-    }
-  }
-  
   database_sqlite_disconnect (db);
 }
 
@@ -764,9 +925,6 @@ vector <string> Database_Modifications::getNotificationDistinctBibles (string us
 
 void Database_Modifications::deleteNotification (int identifier, sqlite3 * db)
 {
-  // Delete from file.
-  deleteNotificationFile (identifier);
-  // Delete from the database.
   SqliteSQL sql = SqliteSQL ();
   sql.add ("DELETE FROM notifications WHERE identifier =");
   sql.add (identifier);
@@ -856,37 +1014,19 @@ Passage Database_Modifications::getNotificationPassage (int id)
 
 string Database_Modifications::getNotificationOldText (int id)
 {
-  string path = notificationIdentifierDatabase (id);
-  if (!file_or_dir_exists (path)) return "";
-  SqliteDatabase sql (path);
-  sql.add ("SELECT oldtext FROM notification;");
-  vector <string> result = sql.query () ["oldtext"];
-  if (result.empty ()) return "";
-  return result [0];
+  return getNotificationField (id, "oldtext");
 }
 
 
 string Database_Modifications::getNotificationModification (int id)
 {
-  string path = notificationIdentifierDatabase (id);
-  if (!file_or_dir_exists (path)) return "";
-  SqliteDatabase sql (path);
-  sql.add ("SELECT modification FROM notification;");
-  vector <string> result = sql.query () ["modification"];
-  if (result.empty ()) return "";
-  return result [0];
+  return getNotificationField (id, "modification");
 }
 
 
 string Database_Modifications::getNotificationNewText (int id)
 {
-  string path = notificationIdentifierDatabase (id);
-  if (!file_or_dir_exists (path)) return "";
-  SqliteDatabase sql (path);
-  sql.add ("SELECT newtext FROM notification;");
-  vector <string> result = sql.query () ["newtext"];
-  if (result.empty ()) return "";
-  return result [0];
+  return getNotificationField (id, "newtext");
 }
 
 
@@ -1016,94 +1156,96 @@ vector <int> Database_Modifications::clearNotificationMatches (string username,
 }
 
 
-// Store a change notification on the client, as received from the server.
 void Database_Modifications::storeClientNotification (int id, string username, string category, string bible, int book, int chapter, int verse, string oldtext, string modification, string newtext)
 {
-  // Erase any existing database.
-  deleteNotificationFile (id);
   // Timestamp is not used: Just put the current time.
   int timestamp = filter_date_seconds_since_epoch ();
-  {
-    SqliteDatabase sql (notificationIdentifierDatabase (id));
-    sql.add (createNotificationsDbSql ());
-    sql.execute ();
-    sql.clear ();
-    sql.add ("INSERT INTO notification VALUES (");
-    sql.add (timestamp);
-    sql.add (",");
-    sql.add (username);
-    sql.add (",");
-    sql.add (category);
-    sql.add (",");
-    sql.add (bible);
-    sql.add (",");
-    sql.add (book);
-    sql.add (",");
-    sql.add (chapter);
-    sql.add (",");
-    sql.add (verse);
-    sql.add (",");
-    sql.add (oldtext);
-    sql.add (",");
-    sql.add (modification);
-    sql.add (",");
-    sql.add (newtext);
-    sql.add (");");
-    sql.execute ();
-  }
-  {
-    sqlite3 * db = connect ();
-    SqliteSQL sql = SqliteSQL ();
-    sql.add ("INSERT INTO notifications VALUES (");
-    sql.add (id);
-    sql.add (",");
-    sql.add (timestamp);
-    sql.add (",");
-    sql.add (username);
-    sql.add (",");
-    sql.add (category);
-    sql.add (",");
-    sql.add (bible);
-    sql.add (",");
-    sql.add (book);
-    sql.add (",");
-    sql.add (chapter);
-    sql.add (",");
-    sql.add (verse);
-    sql.add (",");
-    sql.add (modification);
-    sql.add (");");
-    database_sqlite_exec (db, sql.sql);
-    database_sqlite_disconnect (db);
-  }
+  sqlite3 * db = connect ();
+  database_sqlite_exec (db, "BEGIN;");
+  // Erase any existing notification with this identifier.
+  deleteNotification (id, db);
+  database_sqlite_exec (db, insertNotification (id, timestamp, username, category, bible, book, chapter, verse, oldtext, modification, newtext));
+  database_sqlite_exec (db, "COMMIT;");
+  database_sqlite_disconnect (db);
+}
+
+
+// Gives the SQL that inserts a notification.
+string Database_Modifications::insertNotification (int identifier, int timestamp, const string& username, const string& category, const string& bible, int book, int chapter, int verse, const string& oldtext, const string& modification, const string& newtext)
+{
+  SqliteSQL sql = SqliteSQL ();
+  sql.add ("INSERT INTO notifications (identifier, timestamp, username, category, bible, book, chapter, verse, modification, oldtext, newtext) VALUES (");
+  sql.add (identifier);
+  sql.add (",");
+  sql.add (timestamp);
+  sql.add (",");
+  sql.add (username);
+  sql.add (",");
+  sql.add (category);
+  sql.add (",");
+  sql.add (bible);
+  sql.add (",");
+  sql.add (book);
+  sql.add (",");
+  sql.add (chapter);
+  sql.add (",");
+  sql.add (verse);
+  sql.add (",");
+  sql.add (modification);
+  sql.add (",");
+  sql.add (oldtext);
+  sql.add (",");
+  sql.add (newtext);
+  sql.add (");");
+  return sql.sql;
 }
 
 
-const char * Database_Modifications::createNotificationsDbSql ()
+string Database_Modifications::getNotificationField (int id, const char * field)
 {
-  return
-  "CREATE TABLE notification ("
-  " timestamp integer,"
-  " username text,"
-  " category text,"
-  " bible text,"
-  " book integer,"
-  " chapter integer,"
-  " verse integer,"
-  " oldtext text,"
-  " modification text,"
-  " newtext text"
-  ");";
+  SqliteSQL sql = SqliteSQL ();
+  sql.add ("SELECT");
+  sql.add (field);
+  sql.add ("FROM notifications WHERE identifier =");
+  sql.add (id);
+  sql.add (";");
+  sqlite3 * db = connect ();
+  vector <string> result = database_sqlite_query (db, sql.sql) [field];
+  database_sqlite_disconnect (db);
+  if (result.empty ()) return "";
+  return result [0];
 }
 
 
-void Database_Modifications::deleteNotificationFile (int identifier)
+// Moves the notifications from the small databases, one per notification, into the table.
+// This is how they were stored till October 2026.
+void Database_Modifications::importNotifications (sqlite3 * db)
 {
-  string path = notificationIdentifierDatabase (identifier);
-  // Delete the old folder from the file system (used till Februari 2016).
-  if (filter_url_is_dir (path)) filter_url_rmdir (path);
-  // Delete the new database file from the file system.
-  if (file_or_dir_exists (path)) filter_url_unlink (path);
+  string folder = notificationsMainFolder ();
+  vector <string> files = filter_url_scandir (folder);
+  database_sqlite_exec (db, "BEGIN;");
+  for (auto & file : files) {
+    int identifier = convert_to_int (file);
+    string path = notificationIdentifierDatabase (identifier);
+    // The old folders from before February 2016 are not imported.
+    if (filter_url_is_dir (path)) continue;
+    map <string, vector <string> > result;
+    {
+      SqliteDatabase sql (path);
+      sql.add ("SELECT * FROM notification;");
+      result = sql.query ();
+    }
+    vector <string> timestamps = result ["timestamp"];
+    if (timestamps.empty ()) continue;
+    // The index may already hold this notification without its texts.
+    deleteNotification (identifier, db);
+    database_sqlite_exec (db, insertNotification (identifier, convert_to_int (timestamps [0]),
+                                                  result ["username"][0], result ["category"][0], result ["bible"][0],
+                                                  convert_to_int (result ["book"][0]), convert_to_int (result ["chapter"][0]), convert_to_int (result ["verse"][0]),
+                                                  result ["oldtext"][0], result ["modification"][0], result ["newtext"][0]));
+  }
+  database_sqlite_exec (db, "COMMIT;");
+  filter_url_rmdir (folder);
 }
 
 
@@ -41,12 +41,28 @@ public:
 };
 
 
+// One save of a chapter by a user.
+class Database_Modifications_Save
+{
+public:
+  int timestamp;
+  string bible;
+  int book;
+  int chapter;
+  int oldid;
+  string oldtext;
+  int newid;
+  string newtext;
+};
+
+
 class Database_Modifications
 {
 public:
   void erase ();
   void create ();
   bool healthy ();
+  void checkup ();
   void vacuum ();
   bool teamDiffExists (const string& bible, int book, int chapter);
   void storeTeamDiff (const string& bible, int book, int chapter);
@@ -70,6 +86,8 @@ public:
   Database_Modifications_Text getUserChapter (const string& username, const string& bible, int book, int chapter, int newID);
   int getUserTimestamp (const string& username, const string& bible, int book, int chapter, int newID);
   int getNextAvailableNotificationIdentifier ();
+  void beginNotifications ();
+  void commitNotifications ();
   void recordNotification (const vector <string> & users, const string& category, const string& bible, int book, int chapter, int verse, const string& oldtext, const string& modification, const string& newtext);
   void indexTrimAllNotifications ();
   vector <int> getNotificationIdentifiers (string username, string bible, bool sort_on_category = false);
@@ -103,10 +121,26 @@ private:
   string userOldIDFile (const string& username, const string& bible, int book, int chapter, int newID);
   string userOldTextFile (const string& username, const string& bible, int book, int chapter, int newID);
   string userNewTextFile (const string& username, const string& bible, int book, int chapter, int newID);
+  string userLogFolder ();
+  string userLogFile (const string& username);
+  void importUserSaves (const string& username);
+  void appendUserSave (const string& username, const Database_Modifications_Save& save);
+  const vector <Database_Modifications_Save> & getUserSaves (const string& username);
+  const Database_Modifications_Save * getUserSave (const string& username, const string& bible, int book, int chapter, int newID);
+  string loaded_username;
+  int loaded_size = 0;
+  vector <Database_Modifications_Save> loaded_saves;
+  // The positions of the loaded saves per Bible / book / chapter, and per Bible / book / chapter / new ID.
+  map <string, vector <size_t> > loaded_chapters;
+  map <string, size_t> loaded_positions;
   string notificationsMainFolder ();
   string notificationIdentifierDatabase (int identifier);
-  const char * createNotificationsDbSql ();
-  void deleteNotificationFile (int identifier);
+  void importNotifications (sqlite3 * db);
+  string insertNotification (int identifier, int timestamp, const string& username, const string& category, const string& bible, int book, int chapter, int verse, const string& oldtext, const string& modification, const string& newtext);
+  string getNotificationField (int id, const char * field);
+  bool batching = false;
+  int batch_identifier = 0;
+  vector <string> batch_statements;
 };
 
 
@@ -21,11 +21,17 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/url.h>
 #include <filter/string.h>
 #include <database/sqlite.h>
+#include <database/columns.h>
 
 
 // This is the database for the Greek Bible text morphology.
 // Resilience: It is not written to.
 // Chances of corruption are nearly zero.
+// Lookups go to a columnar copy of it.
+
+
+// The attributes of the words, as columns in the columnar store.
+vector <string> database_morphgnt_columns = {"pos", "parsing", "word", "lemma"};
 
 
 const char * Database_MorphGnt::filename ()
@@ -108,18 +114,7 @@ void Database_MorphGnt::store (int book, int chapter, int verse,
 
 vector <int> Database_MorphGnt::rowids (int book, int chapter, int verse)
 {
-  SqliteDatabase sql = SqliteDatabase (filename ());
-  sql.add ("SELECT rowid FROM morphgnt WHERE book =");
-  sql.add (book);
-  sql.add ("AND chapter =");
-  sql.add (chapter);
-  sql.add ("AND verse =");
-  sql.add (verse);
-  sql.add ("ORDER BY rowid;");
-  vector <string> result = sql.query () ["rowid"];
-  vector <int> rowids;
-  for (auto rowid : result) rowids.push_back (convert_to_int (rowid));
-  return rowids;
+  return columns ()->rowids (book, chapter, verse);
 }
 
 
@@ -179,28 +174,19 @@ int Database_MorphGnt::get_id (const char * table_row, string item)
 
 string Database_MorphGnt::get_item (const char * item, int rowid)
 {
-  // The $rowid refers to the main table.
-  // Update it so it refers to the sub table.
-  SqliteDatabase sql = SqliteDatabase (filename ());
-  sql.add ("SELECT");
-  sql.add (item);
-  sql.add ("FROM morphgnt WHERE rowid =");
-  sql.add (rowid);
-  sql.add (";");
-  vector <string> result = sql.query () [item];
-  rowid = 0;
-  if (!result.empty ()) rowid = convert_to_int (result [0]);
-  // Retrieve the requested value from the sub table.
-  sql.clear ();
-  sql.add ("SELECT");
-  sql.add (item);
-  sql.add ("FROM");
-  sql.add (item);
-  sql.add ("WHERE rowid =");
-  sql.add (rowid);
-  sql.add (";");
-  result = sql.query () [item];
-  if (!result.empty ()) return result [0];
-  // Not found.
-  return "";
+  auto iterator = find (database_morphgnt_columns.begin (), database_morphgnt_columns.end (), item);
+  return columns ()->value (distance (database_morphgnt_columns.begin (), iterator), rowid);
+}
+
+
+// Builds the columnar store from the database, if it is out of date.
+void Database_MorphGnt::compile ()
+{
+  Database_Columns::compile (filename (), "morphgnt", database_morphgnt_columns, {});
+}
+
+
+shared_ptr <Database_Columns> Database_MorphGnt::columns ()
+{
+  return Database_Columns::get (filename (), "morphgnt", database_morphgnt_columns, {});
 }
@@ -22,6 +22,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 
 #include <config/libraries.h>
+#include <database/columns.h>
 
 
 class Database_MorphGnt
@@ -36,10 +37,12 @@ public:
   string parsing (int rowid);
   string word (int rowid);
   string lemma (int rowid);
+  void compile ();
 private:
   const char * filename ();
   int get_id (const char * table_row, string item);
   string get_item (const char * item, int rowid);
+  shared_ptr <Database_Columns> columns ();
 };
 
 
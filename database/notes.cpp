@@ -98,8 +98,67 @@ void Database_Notes::create ()
     " cleantext text"
     ");";
   database_sqlite_exec (db, sql);
+
+  // Upgrade the table: Add a column for sorting the notes on the passages they refer to.
+  bool upgrade = false;
+  sql = "PRAGMA table_info (notes);";
+  vector <string> columns = database_sqlite_query (db, sql) ["name"];
+  if (find (columns.begin(), columns.end(), "passagekey") == columns.end()) {
+    sql = "ALTER TABLE notes ADD COLUMN passagekey integer NOT NULL DEFAULT 0;";
+    database_sqlite_exec (db, sql);
+    upgrade = true;
+  }
+  // A note that refers to passages always gets a positive sort key.
+  // A note that refers to passages but has no sort key was stored before the key existed,
+  // and would sort wrongly in the paged selection, so fill in the keys.
+  sql = "SELECT identifier FROM notes WHERE passagekey = 0 AND TRIM (IFNULL (passage, ''), ' ' || char(10)) != '' LIMIT 1;";
+  if (!database_sqlite_query (db, sql) ["identifier"].empty ()) upgrade = true;
+
+  // Indexes for selecting notes without going through all of them.
+  sql = "CREATE INDEX IF NOT EXISTS notes_identifier ON notes (identifier);";
+  database_sqlite_exec (db, sql);
+  sql = "CREATE INDEX IF NOT EXISTS notes_bible ON notes (bible);";
+  database_sqlite_exec (db, sql);
+  sql = "CREATE INDEX IF NOT EXISTS notes_status ON notes (status);";
+  database_sqlite_exec (db, sql);
+  sql = "CREATE INDEX IF NOT EXISTS notes_severity ON notes (severity);";
+  database_sqlite_exec (db, sql);
+  sql = "CREATE INDEX IF NOT EXISTS notes_modified ON notes (modified);";
+  database_sqlite_exec (db, sql);
+  sql = "DROP INDEX IF EXISTS notes_passagekey;";
+  database_sqlite_exec (db, sql);
+  sql = "CREATE INDEX IF NOT EXISTS notes_passagekey_identifier ON notes (passagekey, identifier);";
+  database_sqlite_exec (db, sql);
+
+  // The passages the notes refer to, one row per passage.
+  sql =
+    "CREATE TABLE IF NOT EXISTS passages ("
+    " identifier integer,"
+    " book integer,"
+    " chapter integer,"
+    " verse integer"
+    ");";
+  database_sqlite_exec (db, sql);
+  sql = "CREATE INDEX IF NOT EXISTS passages_passage ON passages (book, chapter, verse);";
+  database_sqlite_exec (db, sql);
+  sql = "CREATE INDEX IF NOT EXISTS passages_identifier ON passages (identifier);";
+  database_sqlite_exec (db, sql);
+
+  // The users the notes are assigned to, and the users subscribed to them, one row per user.
+  for (auto table : {"assignees", "subscribers"}) {
+    sql = "CREATE TABLE IF NOT EXISTS " + string (table) + " (identifier integer, user text);";
+    database_sqlite_exec (db, sql);
+    sql = "CREATE INDEX IF NOT EXISTS " + string (table) + "_user ON " + table + " (user);";
+    database_sqlite_exec (db, sql);
+    sql = "CREATE INDEX IF NOT EXISTS " + string (table) + "_identifier ON " + table + " (identifier);";
+    database_sqlite_exec (db, sql);
+  }
+
   database_sqlite_disconnect (db);
 
+  // Fill the new tables from the notes already in the database.
+  if (upgrade) reindex ();
+
   // Create the database and table for the checksums.
   // A general reason for having this separate is robustness.
   // A specific reason for this is that when the main notes database is being repaired,
@@ -396,7 +455,10 @@ void Database_Notes::update_database_internal (int identifier, int modified, str
   sql.add (summary);
   sql.add (",");
   sql.add (contents);
-  sql.add (")");
+  sql.add (");");
+  sql.sql.append (index_passages_sql (identifier, passage));
+  sql.sql.append (index_users_sql ("assignees", identifier, assigned));
+  sql.sql.append (index_users_sql ("subscribers", identifier, subscriptions));
   database_sqlite_exec (db, sql.sql);
   
   database_sqlite_disconnect (db);
@@ -446,11 +508,15 @@ void Database_Notes::set_identifier (int identifier, int new_identifier)
   // Update main notes database.
   sqlite3 * db = connect ();
   SqliteSQL sql;
-  sql.add ("UPDATE notes SET identifier =");
-  sql.add (new_identifier);
-  sql.add ("WHERE identifier =");
-  sql.add (identifier);
-  sql.add (";");
+  for (auto table : {"notes", "passages", "assignees", "subscribers"}) {
+    sql.add ("UPDATE");
+    sql.add (table);
+    sql.add ("SET identifier =");
+    sql.add (new_identifier);
+    sql.add ("WHERE identifier =");
+    sql.add (identifier);
+    sql.add (";");
+  }
   database_sqlite_exec (db, sql.sql);
   database_sqlite_disconnect (db);
   
@@ -489,7 +555,7 @@ vector <int> Database_Notes::get_identifiers ()
 {
   sqlite3 * db = connect ();
   vector <int> identifiers;
-  vector <string> result = database_sqlite_query (db, "SELECT identifier FROM notes;") ["identifier"];
+  vector <string> result = database_sqlite_query (db, "SELECT identifier FROM notes ORDER BY id;") ["identifier"];
   for (auto & id : result) {
     identifiers.push_back (convert_to_int (id));
   }
@@ -591,7 +657,8 @@ int Database_Notes::store_new_note (const string& bible, int book, int chapter,
   sql.add (summary);
   sql.add (",");
   sql.add (contents);
-  sql.add (")");
+  sql.add (");");
+  sql.sql.append (index_passages_sql (identifier, passage));
   database_sqlite_exec (db, sql.sql);
   database_sqlite_disconnect (db);
   
@@ -616,8 +683,11 @@ int Database_Notes::store_new_note (const string& bible, int book, int chapter,
 // severity_selector: Optionally limits the selection, based on a note's severity.
 // text_selector: Optionally limits the selection to notes that contains certain text. Used for searching notes.
 // search_text: Works with text_selector, contains the text to search for.
-// limit: If >= 0, it indicates the starting limit for the selection.
-vector <int> Database_Notes::select_notes (vector <string> bibles, int book, int chapter, int verse, int passage_selector, int edit_selector, int non_edit_selector, const string& status_selector, string bible_selector, string assignment_selector, bool subscription_selector, int severity_selector, int text_selector, const string& search_text, int limit)
+// limit: If > 0, it indicates the maximum number of notes to select.
+// after_key and after: If given, the selection continues after the note with this passage key and identifier.
+// The notes are ordered on the passages they refer to, so a page of notes can be selected after the last note of the previous page.
+// A search on the text orders the notes on relevance instead, and does not use after_key and after.
+vector <int> Database_Notes::select_notes (vector <string> bibles, int book, int chapter, int verse, int passage_selector, int edit_selector, int non_edit_selector, const string& status_selector, string bible_selector, string assignment_selector, bool subscription_selector, int severity_selector, int text_selector, const string& search_text, int limit, int after_key, int after)
 {
   string username = ((Webserver_Request *) webserver_request)->session_logic ()->currentUser ();
   vector <int> identifiers;
@@ -630,25 +700,21 @@ vector <int> Database_Notes::select_notes (vector <string> bibles, int book, int
   // SQL FROM ... WHERE statement.
   query.append (notes_from_where_statement ());
   // Consider passage selector.
-  string passage;
   switch (passage_selector) {
     case 0:
       // Select notes that refer to the current verse.
       // It means that the book, the chapter, and the verse, should match.
-      passage = encode_passage (book, chapter, verse);
-      query.append (" AND passage LIKE '%" + passage + "%' ");
+      query.append (" AND identifier IN (SELECT identifier FROM passages WHERE book = " + convert_to_string (book) + " AND chapter = " + convert_to_string (chapter) + " AND verse = " + convert_to_string (verse) + ") ");
       break;
     case 1:
       // Select notes that refer to the current chapter.
       // It means that the book and the chapter should match.
-      passage = encode_passage (book, chapter, -1);
-      query.append (" AND passage LIKE '%" + passage + "%' ");
+      query.append (" AND identifier IN (SELECT identifier FROM passages WHERE book = " + convert_to_string (book) + " AND chapter = " + convert_to_string (chapter) + ") ");
       break;
     case 2:
       // Select notes that refer to the current book.
       // It means that the book should match.
-      passage = encode_passage (book, -1, -1);
-      query.append (" AND passage LIKE '%" + passage + "%' ");
+      query.append (" AND identifier IN (SELECT identifier FROM passages WHERE book = " + convert_to_string (book) + ") ");
       break;
     case 3:
       // Select notes that refer to any passage: No constraint to apply here.
@@ -746,15 +812,15 @@ vector <int> Database_Notes::select_notes (vector <string> bibles, int book, int
   // Consider note assignment constraints.
   if (assignment_selector != "") {
     assignment_selector = database_sqlite_no_sql_injection (assignment_selector);
-    query.append (" AND assigned LIKE '% ");
+    query.append (" AND identifier IN (SELECT identifier FROM assignees WHERE user = '");
     query.append (assignment_selector);
-    query.append (" %' ");
+    query.append ("') ");
   }
   // Consider note subscription constraints.
   if (subscription_selector) {
-    query.append (" AND subscriptions LIKE '% ");
-    query.append (username);
-    query.append (" %' ");
+    query.append (" AND identifier IN (SELECT identifier FROM subscribers WHERE user = '");
+    query.append (database_sqlite_no_sql_injection (username));
+    query.append ("') ");
   }
   // Consider the note severity.
   if (severity_selector != -1) {
@@ -770,14 +836,25 @@ vector <int> Database_Notes::select_notes (vector <string> bibles, int book, int
     // If searching in fulltext mode, notes get ordered on relevance of search hits.
     query.append (notes_order_by_relevance_statement ());
   } else {
-    // Notes get ordered by the passage they refer to. It is a rough method and better ordering is needed.
-    query.append (" ORDER BY ABS (passage) ");
+    // Continue after the given note.
+    // The cursor consists of values rather than of a note,
+    // so it remains valid when the note it was taken from gets deleted.
+    if (after) {
+      query.append (" AND (passagekey, identifier) > (");
+      query.append (convert_to_string (after_key));
+      query.append (", ");
+      query.append (convert_to_string (after));
+      query.append (") ");
+    }
+    // Notes get ordered by the average of the passages they refer to,
+    // and notes with the same passages by their identifiers.
+    query.append (" ORDER BY passagekey, identifier ");
   }
   // Limit the selection if a limit is given.
-  if (limit >= 0) {
+  if (limit > 0) {
     query.append (" LIMIT ");
     query.append (convert_to_string (limit));
-    query.append (", 50 ");
+    query.append (" ");
   }
   query.append (";");
 
@@ -860,9 +937,13 @@ void Database_Notes::erase (int identifier)
   // Update databases as well.
   delete_checksum (identifier);
   SqliteSQL sql;
-  sql.add ("DELETE FROM notes WHERE identifier =");
-  sql.add (identifier);
-  sql.add (";");
+  for (auto table : {"notes", "passages", "assignees", "subscribers"}) {
+    sql.add ("DELETE FROM");
+    sql.add (table);
+    sql.add ("WHERE identifier =");
+    sql.add (identifier);
+    sql.add (";");
+  }
   sqlite3 * db = connect ();
   database_sqlite_exec (db, sql.sql);
   database_sqlite_disconnect (db);
@@ -945,6 +1026,7 @@ void Database_Notes::set_raw_subscriptions (int identifier, const string& subscr
   sql.add ("WHERE identifier =");
   sql.add (identifier);
   sql.add (";");
+  sql.sql.append (index_users_sql ("subscribers", identifier, subscriptions));
   sqlite3 * db = connect ();
   database_sqlite_exec (db, sql.sql);
   database_sqlite_disconnect (db);
@@ -1015,6 +1097,7 @@ void Database_Notes::set_raw_assigned (int identifier, const string& assigned)
   sql.add ("WHERE identifier =");
   sql.add (identifier);
   sql.add (";");
+  sql.sql.append (index_users_sql ("assignees", identifier, assigned));
   sqlite3 * db = connect ();
   database_sqlite_exec (db, sql.sql);
   database_sqlite_disconnect (db);
@@ -1030,27 +1113,16 @@ void Database_Notes::set_raw_assigned (int identifier, const string& assigned)
 // Normally the database is in sync with the filesystem.
 vector <string> Database_Notes::get_all_assignees (const vector <string>& bibles)
 {
-  set <string> unique_assignees;
   SqliteSQL sql;
-  sql.add ("SELECT DISTINCT assigned FROM notes WHERE bible = ''");
+  sql.add ("SELECT DISTINCT user FROM assignees WHERE identifier IN (SELECT identifier FROM notes WHERE bible = ''");
   for (auto & bible : bibles) {
     sql.add ("OR bible =");
     sql.add (bible);
   }
-  sql.add (";");
+  sql.add (") ORDER BY user;");
   sqlite3 * db = connect ();
-  vector <string> result = database_sqlite_query (db, sql.sql) ["assigned"];
-  for (auto & item : result) {
-    if (item.empty ()) continue;
-    vector <string> names = filter_string_explode (item, '\n');
-    for (auto & name : names) unique_assignees.insert (name);
-  }
+  vector <string> assignees = database_sqlite_query (db, sql.sql) ["user"];
   database_sqlite_disconnect (db);
-  
-  vector <string> assignees (unique_assignees.begin(), unique_assignees.end());
-  for (auto & assignee : assignees) {
-    assignee = filter_string_trim (assignee);
-  }
   return assignees;
 }
 
@@ -1281,6 +1353,7 @@ void Database_Notes::index_raw_passage (int identifier, const string& passage)
   sql.add ("WHERE identifier =");
   sql.add (identifier);
   sql.add (";");
+  sql.sql.append (index_passages_sql (identifier, passage));
   sqlite3 * db = connect ();
   database_sqlite_exec (db, sql.sql);
   database_sqlite_disconnect (db);
@@ -1336,7 +1409,8 @@ void Database_Notes::set_status (int identifier, const string& status, bool impo
 vector <Database_Notes_Text> Database_Notes::get_possible_statuses ()
 {
   // Get an array with the statuses used in the database, ordered by occurrence, most often used ones first.
-  string query = "SELECT status, COUNT(status) AS occurrences FROM notes GROUP BY status ORDER BY occurrences DESC;";
+  // Equally frequent statuses are in alphabetical order.
+  string query = "SELECT status, COUNT(status) AS occurrences FROM notes GROUP BY status ORDER BY occurrences DESC, status;";
   sqlite3 * db = connect ();
   vector <string> statuses = database_sqlite_query (db, query) ["status"];
   database_sqlite_disconnect (db);
@@ -1434,6 +1508,21 @@ int Database_Notes::get_modified (int identifier)
 }
 
 
+// Returns the key the note identified by identifier sorts on in the paged selection.
+int Database_Notes::get_passage_key (int identifier)
+{
+  SqliteSQL sql;
+  sql.add ("SELECT passagekey FROM notes WHERE identifier =");
+  sql.add (identifier);
+  sql.add (";");
+  sqlite3 * db = connect ();
+  vector <string> keys = database_sqlite_query (db, sql.sql) ["passagekey"];
+  database_sqlite_disconnect (db);
+  if (keys.empty ()) return 0;
+  return convert_to_int (keys [0]);
+}
+
+
 void Database_Notes::set_modified (int identifier, int time)
 {
   // Update the filesystem.
@@ -1822,6 +1911,90 @@ string Database_Notes::notes_order_by_relevance_statement ()
 }
 
 
+// Gives the SQL that indexes the $passage of the note $identifier:
+// One row per passage, and the key for sorting the note on its passages.
+string Database_Notes::index_passages_sql (int identifier, const string & passage)
+{
+  SqliteSQL sql;
+  sql.add ("DELETE FROM passages WHERE identifier =");
+  sql.add (identifier);
+  sql.add (";");
+  vector <double> numeric_passages;
+  vector <string> lines = filter_string_explode (passage, '\n');
+  for (auto & line : lines) {
+    if (line.empty ()) continue;
+    Passage decoded = decode_passage (line);
+    sql.add ("INSERT INTO passages VALUES (");
+    sql.add (identifier);
+    sql.add (",");
+    sql.add (decoded.book);
+    sql.add (",");
+    sql.add (decoded.chapter);
+    sql.add (",");
+    sql.add (convert_to_int (decoded.verse));
+    sql.add (");");
+    numeric_passages.push_back (filter_passage_to_integer (decoded));
+  }
+  // The sort key is the average of the passages.
+  // It is at least one, so that a key of zero means the note refers to no passages.
+  int passage_key = 0;
+  if (!numeric_passages.empty ()) {
+    double average = accumulate (numeric_passages.begin (), numeric_passages.end (), 0) / numeric_passages.size ();
+    passage_key = max (1, (int) round (average));
+  }
+  sql.add ("UPDATE notes SET passagekey =");
+  sql.add (passage_key);
+  sql.add ("WHERE identifier =");
+  sql.add (identifier);
+  sql.add (";");
+  return sql.sql;
+}
+
+
+// Gives the SQL that indexes the $users assigned or subscribed to the note $identifier in the $table.
+string Database_Notes::index_users_sql (const char * table, int identifier, const string & users)
+{
+  SqliteSQL sql;
+  sql.add ("DELETE FROM");
+  sql.add (table);
+  sql.add ("WHERE identifier =");
+  sql.add (identifier);
+  sql.add (";");
+  for (auto & user : get_assignees_internal (users)) {
+    sql.add ("INSERT INTO");
+    sql.add (table);
+    sql.add ("VALUES (");
+    sql.add (identifier);
+    sql.add (",");
+    sql.add (user);
+    sql.add (");");
+  }
+  return sql.sql;
+}
+
+
+// Fills the passages, the assignees, and the subscribers, from the notes in the database.
+void Database_Notes::reindex ()
+{
+  sqlite3 * db = connect ();
+  map <string, vector <string> > result = database_sqlite_query (db, "SELECT identifier, passage, assigned, subscriptions FROM notes;");
+  vector <string> identifiers = result ["identifier"];
+  vector <string> passages = result ["passage"];
+  vector <string> assigned = result ["assigned"];
+  vector <string> subscriptions = result ["subscriptions"];
+  string sql = "BEGIN;";
+  for (size_t i = 0; i < identifiers.size (); i++) {
+    int identifier = convert_to_int (identifiers [i]);
+    sql.append (index_passages_sql (identifier, passages [i]));
+    sql.append (index_users_sql ("assignees", identifier, assigned [i]));
+    sql.append (index_users_sql ("subscribers", identifier, subscriptions [i]));
+  }
+  sql.append ("COMMIT;");
+  database_sqlite_exec (db, sql);
+  database_sqlite_disconnect (db);
+}
+
+
 // This returns JSON that contains the notes indicated by $identifiers.
 string Database_Notes::get_bulk (vector <int> identifiers)
 {
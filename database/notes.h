@@ -71,7 +71,7 @@ private:
   int get_new_unique_identifier ();
   
 public:
-  vector <int> select_notes (vector <string> bibles, int book, int chapter, int verse, int passage_selector, int edit_selector, int non_edit_selector, const string& status_selector, string bible_selector, string assignment_selector, bool subscription_selector, int severity_selector, int text_selector, const string& search_text, int limit);
+  vector <int> select_notes (vector <string> bibles, int book, int chapter, int verse, int passage_selector, int edit_selector, int non_edit_selector, const string& status_selector, string bible_selector, string assignment_selector, bool subscription_selector, int severity_selector, int text_selector, const string& search_text, int limit, int after_key = 0, int after = 0);
 private:
   string notes_select_identifier ();
   string notes_optional_fulltext_search_relevance_statement (string search);
@@ -163,6 +163,7 @@ private:
 
 public:
   int get_modified (int identifier);
+  int get_passage_key (int identifier);
   void set_modified (int identifier, int time);
 private:
   string modified_key ();
@@ -209,6 +210,9 @@ public:
 private:
   void update_database (int identifier);
   void update_database_internal (int identifier, int modified, string assigned, string subscriptions, string bible, string passage, string status, int severity, string summary, string contents);
+  string index_passages_sql (int identifier, const string & passage);
+  string index_users_sql (const char * table, int identifier, const string & users);
+  void reindex ();
   
 private:
   friend void test_database_notes ();
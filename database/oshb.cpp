@@ -22,11 +22,17 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/string.h>
 #include <config/globals.h>
 #include <database/sqlite.h>
+#include <database/columns.h>
 
 
 // This is the database for the Hebrew Bible text plus lemmas and morphology.
 // Resilience: It is never written to.
 // Chances of corruption are nearly zero.
+// Lookups go to a columnar copy of it.
+
+
+// The attributes of the words, as columns in the columnar store.
+vector <string> database_oshb_columns = {"lemma", "word", "morph"};
 
 
 const char * Database_OsHb::filename ()
@@ -82,36 +88,14 @@ void Database_OsHb::optimize ()
 // Get Hebrew words for $book $chapter $verse.
 vector <string> Database_OsHb::getVerse (int book, int chapter, int verse)
 {
-  vector <string> words;
-  vector <int> rows = rowids (book, chapter, verse);
-  for (auto row : rows) {
-    words.push_back (word (row));
-  }
-  return words;
+  return columns ()->values (1, book, chapter, verse);
 }
 
 
 // Get array of book / chapter / verse of all passages that contain a $hebrew word.
 vector <Passage> Database_OsHb::searchHebrew (string hebrew)
 {
-  int word_id = get_id ("word", hebrew);
-  SqliteDatabase sql = SqliteDatabase (filename ());
-  sql.add ("SELECT DISTINCT book, chapter, verse FROM oshb WHERE word =");
-  sql.add (word_id);
-  sql.add ("ORDER BY book, chapter, verse ASC;");
-  vector <Passage> hits;
-  map <string, vector <string> > result = sql.query ();
-  vector <string> books = result ["book"];
-  vector <string> chapters = result ["chapter"];
-  vector <string> verses = result ["verse"];
-  for (unsigned int i = 0; i < books.size (); i++) {
-    Passage passage;
-    passage.book = convert_to_int (books [i]);
-    passage.chapter = convert_to_int (chapters [i]);
-    passage.verse = verses [i];
-    hits.push_back (passage);
-  }
-  return hits;
+  return columns ()->search (1, hebrew);
 }
 
 
@@ -149,18 +133,7 @@ void Database_OsHb::store (int book, int chapter, int verse, string lemma, strin
 
 vector <int> Database_OsHb::rowids (int book, int chapter, int verse)
 {
-  SqliteDatabase sql = SqliteDatabase (filename ());
-  sql.add ("SELECT rowid FROM oshb WHERE book =");
-  sql.add (book);
-  sql.add ("AND chapter =");
-  sql.add (chapter);
-  sql.add ("AND verse =");
-  sql.add (verse);
-  sql.add ("ORDER BY rowid;");
-  vector <string> result = sql.query () ["rowid"];
-  vector <int> rowids;
-  for (auto rowid : result) rowids.push_back (convert_to_int (rowid));
-  return rowids;
+  return columns ()->rowids (book, chapter, verse);
 }
 
 
@@ -214,28 +187,19 @@ int Database_OsHb::get_id (const char * table_row, string item)
 
 string Database_OsHb::get_item (const char * item, int rowid)
 {
-  // The $rowid refers to the main table.
-  // Update it so it refers to the sub table.
-  SqliteDatabase sql = SqliteDatabase (filename ());
-  sql.add ("SELECT");
-  sql.add (item);
-  sql.add ("FROM oshb WHERE rowid =");
-  sql.add (rowid);
-  sql.add (";");
-  vector <string> result = sql.query () [item];
-  rowid = 0;
-  if (!result.empty ()) rowid = convert_to_int (result [0]);
-  // Retrieve the requested value from the sub table.
-  sql.clear ();
-  sql.add ("SELECT");
-  sql.add (item);
-  sql.add ("FROM");
-  sql.add (item);
-  sql.add ("WHERE rowid =");
-  sql.add (rowid);
-  sql.add (";");
-  result = sql.query () [item];
-  if (!result.empty ()) return result [0];
-  // Not found.
-  return "";
+  auto iterator = find (database_oshb_columns.begin (), database_oshb_columns.end (), item);
+  return columns ()->value (distance (database_oshb_columns.begin (), iterator), rowid);
+}
+
+
+// Builds the columnar store from the database, if it is out of date.
+void Database_OsHb::compile ()
+{
+  Database_Columns::compile (filename (), "oshb", database_oshb_columns, {"word"});
+}
+
+
+shared_ptr <Database_Columns> Database_OsHb::columns ()
+{
+  return Database_Columns::get (filename (), "oshb", database_oshb_columns, {"word"});
 }
@@ -19,12 +19,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 #include <database/sblgnt.h>
 #include <filter/string.h>
-#include <database/sqlite.h>
+#include <database/columns.h>
 
 
 // This is the database for the Greek New Testament.
 // Resilience: It is never written to. 
 // Chances of corruption are nearly zero.
+// Lookups go to a columnar copy of it.
 
 
 Database_Sblgnt::Database_Sblgnt ()
@@ -37,52 +38,28 @@ Database_Sblgnt::~Database_Sblgnt ()
 }
 
 
-sqlite3 * Database_Sblgnt::connect ()
+// Builds the columnar store from the database, if it is out of date.
+void Database_Sblgnt::compile ()
 {
-  return database_sqlite_connect ("sblgnt");
+  Database_Columns::compile ("sblgnt", "sblgnt", {"greek"}, {"greek"});
+}
+
+
+shared_ptr <Database_Columns> Database_Sblgnt::columns ()
+{
+  return Database_Columns::get ("sblgnt", "sblgnt", {"greek"}, {"greek"});
 }
 
 
 // Get Greek words for $book $chapter $verse.
 vector <string> Database_Sblgnt::getVerse (int book, int chapter, int verse)
 {
-  SqliteSQL sql = SqliteSQL ();
-  sql.add ("SELECT greek FROM sblgnt WHERE book =");
-  sql.add (book);
-  sql.add ("AND chapter =");
-  sql.add (chapter);
-  sql.add ("AND verse =");
-  sql.add (verse);
-  sql.add (";");
-  sqlite3 * db = connect ();
-  vector <string> words = database_sqlite_query (db, sql.sql) ["greek"];
-  database_sqlite_disconnect (db);
-  return words;
+  return columns ()->values (0, book, chapter, verse);
 }
 
 
 // Get the passages that contain a $greek word.
 vector <Passage> Database_Sblgnt::searchGreek (string greek)
 {
-  SqliteSQL sql = SqliteSQL ();
-  sql.add ("SELECT DISTINCT book, chapter, verse FROM sblgnt WHERE greek =");
-  sql.add (greek);
-  sql.add (";");
-  vector <Passage> hits;
-  sqlite3 * db = connect ();
-  map <string, vector <string> > result = database_sqlite_query (db, sql.sql);
-  database_sqlite_disconnect (db);
-  vector <string> books = result ["book"];
-  vector <string> chapters = result ["chapter"];
-  vector <string> verses = result ["verse"];
-  for (unsigned int i = 0; i < books.size (); i++) {
-    Passage passage;
-    passage.book = convert_to_int (books [i]);
-    passage.chapter = convert_to_int (chapters [i]);
-    passage.verse = verses [i];
-    hits.push_back (passage);
-  }
-  return hits;
+  return columns ()->search (0, greek);
 }
-
-
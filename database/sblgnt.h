@@ -22,6 +22,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 
 #include <config/libraries.h>
+#include <database/columns.h>
 #include <filter/passage.h>
 
 
@@ -32,8 +33,9 @@ public:
   ~Database_Sblgnt ();
   vector <string> getVerse (int book, int chapter, int verse);
   vector <Passage> searchGreek (string greek);
+  void compile ();
 private:
-  sqlite3 * connect ();
+  shared_ptr <Database_Columns> columns ();
 };
 
 
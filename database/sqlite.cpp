@@ -22,6 +22,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/string.h>
 #include <database/logs.h>
 #include <database/logic.h>
+#include <filter/metrics.h>
 
 
 /*
@@ -139,6 +140,7 @@ string database_sqlite_no_sql_injection (string sql)
 
 void database_sqlite_exec (sqlite3 * db, string sql)
 {
+  Filter_Metrics_Timer timer ("sql", sql);
   char *error = NULL;
   if (db) {
     sqlite_execute_mutex.lock ();
@@ -154,6 +156,7 @@ void database_sqlite_exec (sqlite3 * db, string sql)
 
 map <string, vector <string> > database_sqlite_query (sqlite3 * db, string sql)
 {
+  Filter_Metrics_Timer timer ("sql", sql);
   char * error = NULL;
   SqliteReader reader (0);
   if (db) {
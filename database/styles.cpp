@@ -46,6 +46,10 @@ map <string, Database_Styles_Item> default_styles_cache;
 map <string, map <string, Database_Styles_Item>> database_styles_cache;
 // Cache read and write lock.
 mutex database_styles_cache_mutex;
+// The compiled stylesheets, and their version.
+// Any change in any stylesheet gives a new version.
+map <string, shared_ptr <const Database_Styles_Sheet>> database_styles_sheets;
+int database_styles_version = 0;
 
 
 sqlite3 * Database_Styles::connect ()
@@ -101,6 +105,8 @@ void Database_Styles::deleteSheet (string sheet)
   if (!sheet.empty ()) filter_url_rmdir (sheetfolder (sheet));
   database_styles_cache_mutex.lock ();
   database_styles_cache.clear ();
+  database_styles_sheets.clear ();
+  database_styles_version++;
   database_styles_cache_mutex.unlock ();
 }
 
@@ -119,6 +125,8 @@ void Database_Styles::deleteMarker (string sheet, string marker)
   filter_url_unlink (stylefile (sheet, marker));
   database_styles_cache_mutex.lock ();
   database_styles_cache.clear ();
+  database_styles_sheets.clear ();
+  database_styles_version++;
   database_styles_cache_mutex.unlock ();
 }
 
@@ -162,6 +170,36 @@ Database_Styles_Item Database_Styles::getMarkerData (string sheet, string marker
 }
 
 
+// Returns the compiled stylesheet.
+// It is compiled once, and shared, till the stylesheets change.
+shared_ptr <const Database_Styles_Sheet> Database_Styles::compile (string sheet)
+{
+  int version;
+  {
+    lock_guard <mutex> lock (database_styles_cache_mutex);
+    auto iterator = database_styles_sheets.find (sheet);
+    if (iterator != database_styles_sheets.end ()) return iterator->second;
+    version = database_styles_version;
+  }
+  
+  // Compile the stylesheet, with the markers in alphabetical order.
+  shared_ptr <Database_Styles_Sheet> compiled = make_shared <Database_Styles_Sheet> ();
+  compiled->version = version;
+  vector <string> markers = getMarkers (sheet);
+  sort (markers.begin (), markers.end ());
+  for (auto & marker : markers) {
+    if (compiled->identifiers.count (marker)) continue;
+    compiled->identifiers [marker] = compiled->items.size ();
+    compiled->items.push_back (read_item (sheet, marker));
+  }
+  
+  // Keep it, unless the stylesheets changed while it was being compiled.
+  lock_guard <mutex> lock (database_styles_cache_mutex);
+  if (version == database_styles_version) database_styles_sheets [sheet] = compiled;
+  return compiled;
+}
+
+
 // Updates a style's name.
 void Database_Styles::updateName (string sheet, string marker, string name)
 {
@@ -616,6 +654,8 @@ void Database_Styles::write_item (string sheet, Database_Styles_Item & item)
   // Clear cache.
   database_styles_cache_mutex.lock ();
   database_styles_cache.clear ();
+  database_styles_sheets.clear ();
+  database_styles_version++;
   database_styles_cache_mutex.unlock ();
 }
 
@@ -701,3 +741,31 @@ Database_Styles_Item::Database_Styles_Item ()
   userstring3 = "";
   backgroundcolor = "#FFFFFF";
 }
+
+
+// The number of the $marker in the stylesheet, or -1 if it is not in there.
+int Database_Styles_Sheet::identifier (const string & marker) const
+{
+  auto iterator = identifiers.find (marker);
+  if (iterator == identifiers.end ()) return -1;
+  return iterator->second;
+}
+
+
+// The style of the $marker, or nullptr if it is not in the stylesheet.
+const Database_Styles_Item * Database_Styles_Sheet::find (const string & marker) const
+{
+  int id = identifier (marker);
+  if (id < 0) return nullptr;
+  return &items [id];
+}
+
+
+// The style of the $marker, or a default style if it is not in the stylesheet.
+const Database_Styles_Item & Database_Styles_Sheet::get (const string & marker) const
+{
+  static const Database_Styles_Item empty;
+  const Database_Styles_Item * item = find (marker);
+  if (item) return * item;
+  return empty;
+}
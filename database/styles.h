@@ -62,6 +62,23 @@ public:
 };
 
 
+// A stylesheet compiled for quick lookups while converting USFM.
+// Each marker has a small number, which is its position in the flat array of styles.
+// It is shared and never changes: A change in the stylesheet gives a new version.
+class Database_Styles_Sheet
+{
+public:
+  int version = 0;
+  vector <Database_Styles_Item> items;
+  int identifier (const string & marker) const;
+  const Database_Styles_Item * find (const string & marker) const;
+  const Database_Styles_Item & get (const string & marker) const;
+private:
+  friend class Database_Styles;
+  unordered_map <string, int> identifiers;
+};
+
+
 class Database_Styles
 {
 public:
@@ -74,6 +91,7 @@ public:
   map <string, string> getMarkersAndNames (string sheet);
   vector <string> getMarkers (string sheet);
   Database_Styles_Item getMarkerData (string sheet, string marker);
+  shared_ptr <const Database_Styles_Sheet> compile (string sheet);
   void updateName (string sheet, string marker, string name);
   void updateInfo (string sheet, string marker, string info);
   void updateCategory (string sheet, string marker, string category);
@@ -19,6 +19,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 #include <database/versifications.h>
 #include <filter/string.h>
+#include <filter/url.h>
 #include <database/sqlite.h>
 #include <database/books.h>
 #include <database/logs.h>
@@ -42,6 +43,109 @@ sqlite3 * Database_Versifications::connect ()
 }
 
 
+// A versification system held in memory.
+// The chapters of all books are laid out one after the other,
+// each holding the last verse of that chapter, or -1 if the system does not have the chapter.
+class Database_Versifications_System
+{
+public:
+  vector <int> books;
+  // Per book, where its chapters start, with one more entry to mark the end of the last book.
+  vector <size_t> offsets;
+  vector <int> last_verses;
+  int last_verse (int book, int chapter) const;
+};
+
+
+int Database_Versifications_System::last_verse (int book, int chapter) const
+{
+  if ((book < 0) || (chapter < 0)) return -1;
+  if ((size_t) book + 1 >= offsets.size ()) return -1;
+  size_t position = offsets [book] + chapter;
+  if (position >= offsets [book + 1]) return -1;
+  return last_verses [position];
+}
+
+
+mutex database_versifications_mutex;
+map <string, shared_ptr <const Database_Versifications_System> > database_versifications_cache;
+pair <int, int> database_versifications_signature;
+
+
+// Gets the versification system $name from memory.
+// It is read from the database once, and kept till the database changes.
+shared_ptr <const Database_Versifications_System> Database_Versifications::system (const string& name)
+{
+  lock_guard <mutex> lock (database_versifications_mutex);
+
+  // If the database was changed or replaced behind this object's back, drop what was read from it before.
+  string path = database_sqlite_file ("versifications");
+  pair <int, int> signature (filter_url_filesize (path), filter_url_file_modification_time (path));
+  if (signature != database_versifications_signature) {
+    database_versifications_cache.clear ();
+    database_versifications_signature = signature;
+  }
+  
+  shared_ptr <const Database_Versifications_System> & cached = database_versifications_cache [name];
+  if (cached) return cached;
+
+  SqliteSQL sql = SqliteSQL ();
+  sql.add ("SELECT book, chapter, verse FROM data WHERE system =");
+  sql.add (getID (name));
+  sql.add ("ORDER BY book, chapter ASC;");
+  sqlite3 * db = connect ();
+  map <string, vector <string> > result = database_sqlite_query (db, sql.sql);
+  database_sqlite_disconnect (db);
+  vector <string> books = result ["book"];
+  vector <string> chapters = result ["chapter"];
+  vector <string> verses = result ["verse"];
+
+  // The highest chapter per book gives the size of the book.
+  map <int, int> last_chapters;
+  for (unsigned int i = 0; i < books.size (); i++) {
+    int book = convert_to_int (books [i]);
+    int chapter = convert_to_int (chapters [i]);
+    if ((book < 0) || (chapter < 0)) continue;
+    if (last_chapters.count (book)) last_chapters [book] = max (last_chapters [book], chapter);
+    else last_chapters [book] = chapter;
+  }
+
+  shared_ptr <Database_Versifications_System> system = make_shared <Database_Versifications_System> ();
+  int book_count = last_chapters.empty () ? 0 : last_chapters.rbegin ()->first + 1;
+  system->offsets.assign (book_count + 1, 0);
+  size_t offset = 0;
+  for (int book = 0; book < book_count; book++) {
+    system->offsets [book] = offset;
+    auto iterator = last_chapters.find (book);
+    if (iterator == last_chapters.end ()) continue;
+    system->books.push_back (book);
+    offset += iterator->second + 1;
+  }
+  system->offsets [book_count] = offset;
+  system->last_verses.assign (offset, -1);
+  
+  // Should the system give a chapter more than once, its highest last verse counts.
+  for (unsigned int i = 0; i < books.size (); i++) {
+    int book = convert_to_int (books [i]);
+    int chapter = convert_to_int (chapters [i]);
+    if ((book < 0) || (chapter < 0)) continue;
+    int & last_verse = system->last_verses [system->offsets [book] + chapter];
+    last_verse = max (last_verse, convert_to_int (verses [i]));
+  }
+
+  cached = system;
+  return cached;
+}
+
+
+// Drops the versification systems held in memory, to be called after the database changes.
+void Database_Versifications::invalidate ()
+{
+  lock_guard <mutex> lock (database_versifications_mutex);
+  database_versifications_cache.clear ();
+}
+
+
 void Database_Versifications::create ()
 {
   sqlite3 * db = connect ();
@@ -61,6 +165,7 @@ void Database_Versifications::create ()
     ");";
   database_sqlite_exec (db, sql);
   database_sqlite_disconnect (db);
+  invalidate ();
 }
 
 
@@ -112,6 +217,7 @@ void Database_Versifications::input (const string& contents, const string& name)
   
   database_sqlite_exec (db, "COMMIT;");
   database_sqlite_disconnect (db);
+  invalidate ();
 }
 
 
@@ -151,6 +257,7 @@ void Database_Versifications::erase (const string& name)
   database_sqlite_exec (db, sql1.sql);
   database_sqlite_exec (db, sql2.sql);
   database_sqlite_disconnect (db);
+  invalidate ();
 }
 
 
@@ -198,6 +305,7 @@ int Database_Versifications::createSystem (const string& name)
   sql.add (");");
   database_sqlite_exec (db, sql.sql);
   database_sqlite_disconnect (db);
+  invalidate ();
   // Return new ID.
   return id;
 }
@@ -217,23 +325,14 @@ vector <string> Database_Versifications::getSystems ()
 vector <Passage> Database_Versifications::getBooksChaptersVerses (const string& name)
 {
   vector <Passage> data;
-  int id = getID (name);
-  SqliteSQL sql = SqliteSQL ();
-  sql.add ("SELECT book, chapter, verse FROM data WHERE system =");
-  sql.add (id);
-  sql.add ("ORDER BY book, chapter, verse ASC;");
-  sqlite3 * db = connect ();
-  map <string, vector <string> > result = database_sqlite_query (db, sql.sql);
-  database_sqlite_disconnect (db);
-  vector <string> books = result ["book"];
-  vector <string> chapters = result ["chapter"];
-  vector <string> verses = result ["verse"];
-  for (unsigned int i = 0; i < books.size (); i++) {
-    Passage passage;
-    passage.book = convert_to_int (books [i]);
-    passage.chapter = convert_to_int (chapters [i]);
-    passage.verse = verses [i];
-    data.push_back (passage);
+  shared_ptr <const Database_Versifications_System> versification = system (name);
+  for (auto book : versification->books) {
+    for (size_t position = versification->offsets [book]; position < versification->offsets [book + 1]; position++) {
+      int verse = versification->last_verses [position];
+      if (verse < 0) continue;
+      int chapter = (int) (position - versification->offsets [book]);
+      data.push_back (Passage ("", book, chapter, convert_to_string (verse)));
+    }
   }
   return data;
 }
@@ -241,19 +340,7 @@ vector <Passage> Database_Versifications::getBooksChaptersVerses (const string&
 
 vector <int> Database_Versifications::getBooks (const string& name)
 {
-  vector <int> books;
-  int id = getID (name);
-  SqliteSQL sql = SqliteSQL ();
-  sql.add ("SELECT DISTINCT book FROM data WHERE system =");
-  sql.add (id);
-  sql.add ("ORDER BY book ASC;");
-  sqlite3 * db = connect ();
-  vector <string> sbooks = database_sqlite_query (db, sql.sql) ["book"];
-  database_sqlite_disconnect (db);
-  for (auto & book : sbooks) {
-    books.push_back (convert_to_int (book));
-  }
-  return books;
+  return system (name)->books;
 }
 
 
@@ -263,18 +350,11 @@ vector <int> Database_Versifications::getChapters (const string& name, int book,
 {
   vector <int> chapters;
   if (include0) chapters.push_back (0);
-  int id = this->getID (name);
-  SqliteSQL sql = SqliteSQL ();
-  sql.add ("SELECT DISTINCT chapter FROM data WHERE system =");
-  sql.add (id);
-  sql.add ("AND book =");
-  sql.add (book);
-  sql.add ("ORDER BY chapter ASC;");
-  sqlite3 * db = connect ();
-  vector <string> schapters = database_sqlite_query (db, sql.sql) ["chapter"];
-  database_sqlite_disconnect (db);
-  for (auto & chapter : schapters) {
-    chapters.push_back (convert_to_int (chapter));
+  shared_ptr <const Database_Versifications_System> versification = system (name);
+  if ((book < 0) || ((size_t) book + 1 >= versification->offsets.size ())) return chapters;
+  for (size_t position = versification->offsets [book]; position < versification->offsets [book + 1]; position++) {
+    if (versification->last_verses [position] < 0) continue;
+    chapters.push_back ((int) (position - versification->offsets [book]));
   }
   return chapters;
 }
@@ -283,23 +363,9 @@ vector <int> Database_Versifications::getChapters (const string& name, int book,
 vector <int> Database_Versifications::getVerses (const string& name, int book, int chapter)
 {
   vector <int> verses;
-  int id = getID (name);
-  SqliteSQL sql = SqliteSQL ();
-  sql.add ("SELECT DISTINCT verse FROM data WHERE system =");
-  sql.add (id);
-  sql.add ("AND book =");
-  sql.add (book);
-  sql.add ("AND chapter =");
-  sql.add (chapter);
-  sql.add ("ORDER BY verse ASC;");
-  sqlite3 * db = connect ();
-  vector <string> sverses = database_sqlite_query (db, sql.sql) ["verse"];
-  database_sqlite_disconnect (db);
-  for (auto & verse : sverses) {
-    int maxverse = convert_to_int (verse);
-    for (int i = 0; i <= maxverse; i++) {
-      verses.push_back (i);
-    }
+  int maxverse = system (name)->last_verse (book, chapter);
+  for (int i = 0; i <= maxverse; i++) {
+    verses.push_back (i);
   }
   // Put verse 0 in chapter 0.
   if (chapter == 0) verses.push_back (0);
@@ -313,6 +379,7 @@ void Database_Versifications::defaults ()
   database_sqlite_exec (db, "DELETE FROM names WHERE system < 1000;");
   database_sqlite_exec (db, "DELETE FROM data WHERE system < 1000;");
   database_sqlite_disconnect (db);
+  invalidate ();
 
   creating_defaults = true;
   vector <string> names = versification_logic_names ();
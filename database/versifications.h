@@ -25,6 +25,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/passage.h>
 
 
+class Database_Versifications_System;
+
+
 class Database_Versifications
 {
 public:
@@ -47,6 +50,8 @@ public:
 private:
   sqlite3 * connect ();
   bool creating_defaults = false;
+  shared_ptr <const Database_Versifications_System> system (const string& name);
+  static void invalidate ();
 };
 
 
@@ -0,0 +1,111 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <developer/metrics.h>
+#include <assets/view.h>
+#include <assets/page.h>
+#include <assets/header.h>
+#include <filter/roles.h>
+#include <filter/string.h>
+#include <filter/metrics.h>
+#include <database/config/general.h>
+#include <webserver/request.h>
+
+
+const char * developer_metrics_url ()
+{
+  return "developer/metrics";
+}
+
+
+bool developer_metrics_acl (void * webserver_request)
+{
+  return Filter_Roles::access_control (webserver_request, Filter_Roles::admin ());
+}
+
+
+// Gives the $microseconds as milliseconds with one decimal.
+static string developer_metrics_milliseconds (long microseconds)
+{
+  return to_string (microseconds / 1000) + "." + to_string (microseconds % 1000 / 100);
+}
+
+
+string developer_metrics (void * webserver_request)
+{
+  Webserver_Request * request = (Webserver_Request *) webserver_request;
+
+  if (request->query.count ("tracing")) {
+    filter_metrics_set_tracing (request->query ["tracing"] == "on");
+  }
+  if (request->query.count ("clear")) {
+    filter_metrics_clear ();
+  }
+  if (request->post.count ("prometheus")) {
+    Database_Config_General::setPrometheusKey (filter_string_trim (request->post ["prometheuskey"]));
+  }
+
+  string page;
+
+  Assets_Header header = Assets_Header ("Metrics", webserver_request);
+  page = header.run ();
+
+  Assets_View view;
+
+  // The routes, the ones that took the most time in total first.
+  map <string, Filter_Metrics_Route> routes = filter_metrics_routes ();
+  vector <string> names;
+  for (auto & element : routes) names.push_back (element.first);
+  sort (names.begin (), names.end (), [&routes] (const string & a, const string & b) {
+    return routes [a].microseconds > routes [b].microseconds;
+  });
+  for (auto & name : names) {
+    Filter_Metrics_Route & route = routes [name];
+    view.add_iteration ("route", {
+      make_pair ("route", escape_special_xml_characters (name)),
+      make_pair ("count", to_string (route.count)),
+      make_pair ("total", developer_metrics_milliseconds (route.microseconds)),
+      make_pair ("average", developer_metrics_milliseconds (route.microseconds / route.count)),
+      make_pair ("p50", developer_metrics_milliseconds (filter_metrics_percentile (route, 50))),
+      make_pair ("p95", developer_metrics_milliseconds (filter_metrics_percentile (route, 95))),
+      make_pair ("maximum", developer_metrics_milliseconds (route.maximum)),
+      make_pair ("in", to_string (route.bytes_in / 1024)),
+      make_pair ("out", to_string (route.bytes_out / 1024))
+    });
+  }
+  view.set_variable ("inflight", convert_to_string (filter_metrics_in_flight ()));
+  view.set_variable ("prometheuskey", escape_special_xml_characters (Database_Config_General::getPrometheusKey ()));
+
+  // The traces of the recent requests, with the parts they consist of.
+  if (filter_metrics_get_tracing ()) view.enable_zone ("tracing");
+  else view.enable_zone ("nottracing");
+  string traces;
+  for (auto & trace : filter_metrics_traces ()) {
+    traces.append (trace.route + " " + developer_metrics_milliseconds (trace.microseconds) + " ms\n");
+    for (auto & span : trace.spans) {
+      traces.append ("  +" + developer_metrics_milliseconds (span.start) + " " + developer_metrics_milliseconds (span.microseconds) + " ms " + span.kind + " " + span.detail + "\n");
+    }
+    traces.append ("\n");
+  }
+  view.set_variable ("traces", escape_special_xml_characters (traces));
+
+  page += view.render ("developer", "metrics");
+  page += Assets_Page::footer ();
+
+  return page;
+}
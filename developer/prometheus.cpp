@@ -0,0 +1,49 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <developer/prometheus.h>
+#include <filter/roles.h>
+#include <filter/metrics.h>
+#include <database/config/general.h>
+#include <webserver/request.h>
+
+
+const char * developer_prometheus_url ()
+{
+  return "developer/prometheus";
+}
+
+
+// The statistics are available to an administrator,
+// and to a scraper, which does not log in, but passes the key set on the metrics page.
+// The address of the scraper is not trusted, since behind a proxy all requests come from the same machine.
+bool developer_prometheus_acl (void * webserver_request)
+{
+  Webserver_Request * request = (Webserver_Request *) webserver_request;
+  string key = Database_Config_General::getPrometheusKey ();
+  if (!key.empty () && (request->query ["key"] == key)) return true;
+  return Filter_Roles::access_control (webserver_request, Filter_Roles::admin ());
+}
+
+
+string developer_prometheus (void * webserver_request)
+{
+  Webserver_Request * request = (Webserver_Request *) webserver_request;
+  request->response_content_type = "text/plain; version=0.0.4";
+  return filter_metrics_prometheus ();
+}
@@ -185,6 +185,7 @@ function editorLoadChapter ()
   editorLoadedBook = editorNavigationBook;
   editorLoadedChapter = editorNavigationChapter;
   editorChapterIdOnServer = 0;
+  edit2UpdateRevision = 0;
   edit2CaretPosition = getCaretPosition ();
   edit2CaretInitialized = false;
   $.ajax ({
@@ -1215,6 +1216,10 @@ Section for the smart editor updating logic.
 
 var editorHtmlAtStartOfUpdate = null;
 var useShadowQuill = false;
+// The revision of the editor html the server has, and that html, encoded.
+// Zero means that the server does not have it, so the editor sends the full html.
+var edit2UpdateRevision = 0;
+var edit2UpdateRevisionHtml = "";
 
 
 function edit2UpdateExecute ()
@@ -1252,14 +1257,27 @@ function edit2UpdateExecute ()
   var checksum1 = checksum_get (encodedLoadedHtml);
   var checksum2 = checksum_get (encodedEditedHtml);
 
+  var data = { bible: editorLoadedBible, book: editorLoadedBook, chapter: editorLoadedChapter, checksum1: checksum1, checksum2: checksum2, id: chapterEditorUniqueID };
+  if (edit2UpdateRevision) {
+    // Send only what changed since the revision the server has.
+    data.revision = edit2UpdateRevision;
+    data.loadeddelta = edit2UpdateDelta (edit2UpdateRevisionHtml, encodedLoadedHtml);
+    data.editeddelta = edit2UpdateDelta (encodedLoadedHtml, encodedEditedHtml);
+  } else {
+    data.loaded = encodedLoadedHtml;
+    data.edited = encodedEditedHtml;
+  }
+
   edit2AjaxActive = true;
 
   $.ajax ({
     url: "update",
     type: "POST",
     async: true,
-    data: { bible: editorLoadedBible, book: editorLoadedBook, chapter: editorLoadedChapter, loaded: encodedLoadedHtml, edited: encodedEditedHtml, checksum1: checksum1, checksum2: checksum2, id: chapterEditorUniqueID },
+    data: data,
     error: function (jqXHR, textStatus, errorThrown) {
+      // Send the full html next time.
+      edit2UpdateRevision = 0;
       editorStatus (editorChapterRetrying);
       edit2ContentChanged ();
     },
@@ -1294,6 +1312,10 @@ function edit2UpdateExecute ()
         // The next bit is the new chapter identifier.
         oneverseChapterId = bits.shift();
 
+        // The next bit is the revision of the html the server now has.
+        edit2UpdateRevision = parseInt (bits.shift ());
+        edit2UpdateRevisionHtml = encodedEditedHtml;
+
         // Apply the remaining data, the differences, to the editor.
         while (bits.length > 0) {
           var position = parseInt (bits.shift ());
@@ -1360,6 +1382,7 @@ function edit2UpdateExecute ()
       } else {
         // If the checksum is not valid, the response will become false.
         // Checksum error.
+        edit2UpdateRevision = 0;
         editorStatus (editorChapterRetrying);
       }
 
@@ -1378,6 +1401,33 @@ function edit2UpdateExecute ()
 
 }
 
+
+// Gives the $text as a delta against the $base:
+// The number of bytes at the start and at the end that are the same,
+// and then the text that differs in between.
+function edit2UpdateDelta (base, text)
+{
+  var limit = Math.min (base.length, text.length);
+  var prefix = 0;
+  while ((prefix < limit) && (base.charAt (prefix) == text.charAt (prefix))) prefix++;
+  // Do not split a character encoded as a surrogate pair.
+  if ((prefix > 0) && (prefix < text.length)) {
+    var code = text.charCodeAt (prefix - 1);
+    if ((code >= 0xD800) && (code <= 0xDBFF)) prefix--;
+  }
+  var suffix = 0;
+  while ((suffix < limit - prefix) && (base.charAt (base.length - 1 - suffix) == text.charAt (text.length - 1 - suffix))) suffix++;
+  if (suffix > 0) {
+    var code = text.charCodeAt (text.length - suffix);
+    if ((code >= 0xDC00) && (code <= 0xDFFF)) suffix--;
+  }
+  var middle = text.substring (prefix, text.length - suffix);
+  // The server counts the bytes of the UTF-8 encoding.
+  var prefixBytes = checksum_get (text.substring (0, prefix));
+  var suffixBytes = checksum_get (text.substring (text.length - suffix));
+  return prefixBytes + " " + suffixBytes + " " + middle;
+}
+
                                           
 var quill2 = undefined;
 
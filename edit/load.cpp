@@ -59,6 +59,9 @@ string edit_load (void * webserver_request)
   // Store a copy of the USFM loaded in the editor for later reference.
   storeLoadedUsfm2 (webserver_request, bible, book, chapter, unique_id);
   
+  // The editor starts afresh with this chapter, so the server no longer needs what it had from the editor.
+  forgetUpdatedHtml2 (webserver_request, unique_id);
+  
   string stylesheet = Database_Config_Bible::getEditorStylesheet (bible);
   
   string usfm = request->database_bibles()->getChapter (bible, book, chapter);
@@ -64,3 +64,69 @@ string getLoadedUsfm2 (void * webserver_request, string bible, int book, int cha
   
   return usfm;
 }
+
+
+// The chapter editor sends its changes as deltas against the html the server got from it the time before.
+// The server keeps that html, per user and editor, in memory only, so an update does not write to disk.
+// An editor has one chapter loaded at a time, so loading a chapter forgets what the editor had before.
+// Once too many editors are open, it forgets the one that was updated longest ago,
+// and the next update from that editor sends the full html again.
+class Edit_Logic_Revision
+{
+public:
+  string chapter;
+  Edit_Revision revision;
+  long used = 0;
+};
+mutex edit2_logic_revisions_mutex;
+map <string, Edit_Logic_Revision> edit2_logic_revisions;
+long edit2_logic_revisions_used = 0;
+#define EDIT2_LOGIC_MAXIMUM_REVISIONS 100
+
+
+static string edit2_logic_revision_key (void * webserver_request, string editor)
+{
+  return convert_to_string (filter_string_user_identifier (webserver_request)) + " " + editor;
+}
+
+
+void storeUpdatedHtml2 (void * webserver_request, string bible, int book, int chapter, string editor, const Edit_Revision & revision)
+{
+  string key = edit2_logic_revision_key (webserver_request, editor);
+  lock_guard <mutex> lock (edit2_logic_revisions_mutex);
+  if ((edit2_logic_revisions.size () >= EDIT2_LOGIC_MAXIMUM_REVISIONS) && !edit2_logic_revisions.count (key)) {
+    auto oldest = edit2_logic_revisions.begin ();
+    for (auto iterator = oldest; iterator != edit2_logic_revisions.end (); iterator++) {
+      if (iterator->second.used < oldest->second.used) oldest = iterator;
+    }
+    edit2_logic_revisions.erase (oldest);
+  }
+  Edit_Logic_Revision & stored = edit2_logic_revisions [key];
+  stored.chapter = edit2_logic_volatile_key (bible, book, chapter, editor);
+  stored.revision = revision;
+  stored.used = ++edit2_logic_revisions_used;
+}
+
+
+// Gets the html and the USFM the editor sent the time before.
+// It returns false if the server does not have them.
+bool getUpdatedHtml2 (void * webserver_request, string bible, int book, int chapter, string editor, Edit_Revision & revision)
+{
+  string key = edit2_logic_revision_key (webserver_request, editor);
+  lock_guard <mutex> lock (edit2_logic_revisions_mutex);
+  auto iterator = edit2_logic_revisions.find (key);
+  if (iterator == edit2_logic_revisions.end ()) return false;
+  if (iterator->second.chapter != edit2_logic_volatile_key (bible, book, chapter, editor)) return false;
+  revision = iterator->second.revision;
+  iterator->second.used = ++edit2_logic_revisions_used;
+  return true;
+}
+
+
+// Forgets what the $editor sent before, for when it loads a chapter.
+void forgetUpdatedHtml2 (void * webserver_request, string editor)
+{
+  string key = edit2_logic_revision_key (webserver_request, editor);
+  lock_guard <mutex> lock (edit2_logic_revisions_mutex);
+  edit2_logic_revisions.erase (key);
+}
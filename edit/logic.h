@@ -28,4 +28,23 @@ void storeLoadedUsfm2 (void * webserver_request, string bible, int book, int cha
 string getLoadedUsfm2 (void * webserver_request, string bible, int book, int chapter, string editor);
 
 
+// What the server has from an editor after its last update.
+class Edit_Revision
+{
+public:
+  // The number the editor refers to when it sends its next changes.
+  int revision = 0;
+  // The html the editor sent, and the USFM converted from it.
+  string html;
+  string usfm;
+  // The chapter as stored then, and the html converted from it with the stylesheet.
+  string stylesheet;
+  string server_usfm;
+  string server_html;
+};
+void storeUpdatedHtml2 (void * webserver_request, string bible, int book, int chapter, string editor, const Edit_Revision & revision);
+bool getUpdatedHtml2 (void * webserver_request, string bible, int book, int chapter, string editor, Edit_Revision & revision);
+void forgetUpdatedHtml2 (void * webserver_request, string editor);
+
+
 #endif
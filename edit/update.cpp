@@ -78,8 +78,15 @@ string edit_update (void * webserver_request)
     if (!request->post.count ("bible")) parameters_ok = false;
     if (!request->post.count ("book")) parameters_ok = false;
     if (!request->post.count ("chapter")) parameters_ok = false;
-    if (!request->post.count ("loaded")) parameters_ok = false;
-    if (!request->post.count ("edited")) parameters_ok = false;
+    // The editor sends either the loaded and edited html,
+    // or the changes since the revision of the html the server got before.
+    if (request->post.count ("revision")) {
+      if (!request->post.count ("loadeddelta")) parameters_ok = false;
+      if (!request->post.count ("editeddelta")) parameters_ok = false;
+    } else {
+      if (!request->post.count ("loaded")) parameters_ok = false;
+      if (!request->post.count ("edited")) parameters_ok = false;
+    }
     if (!parameters_ok) {
       messages.push_back (translate("Don't know what to update"));
       good2go = false;
@@ -96,16 +103,38 @@ string edit_update (void * webserver_request)
   string checksum1;
   string checksum2;
   string unique_id;
+  int revision = 0;
+  Edit_Revision previous;
+  bool have_previous = false;
   if (good2go) {
     bible = request->post["bible"];
     book = convert_to_int (request->post["book"]);
     chapter = convert_to_int (request->post["chapter"]);
-    loaded_html = request->post["loaded"];
-    edited_html = request->post["edited"];
     checksum1 = request->post["checksum1"];
     checksum2 = request->post["checksum2"];
     unique_id = request->post ["id"];
+    have_previous = getUpdatedHtml2 (webserver_request, bible, book, chapter, unique_id, previous);
+    if (request->post.count ("revision")) {
+      revision = convert_to_int (request->post ["revision"]);
+      // The editor sent the deltas of the loaded html against the html of the revision,
+      // and of the edited html against the loaded html.
+      // Usually both deltas are as small as the edits made in the editor.
+      if (have_previous && (previous.revision == revision)) {
+        loaded_html = filter_diff_apply_delta (previous.html, request->post["loadeddelta"]);
+        edited_html = filter_diff_apply_delta (loaded_html, request->post["editeddelta"]);
+      } else {
+        // The server no longer has this revision: The editor is to send the full html.
+        request->response_code = 409;
+        messages.push_back (translate ("Checksum error"));
+        good2go = false;
+      }
+    } else {
+      loaded_html = request->post["loaded"];
+      edited_html = request->post["edited"];
+    }
   }
+  string encoded_loaded_html (loaded_html);
+  string encoded_edited_html (edited_html);
 
 
   // Checksums of the loaded and edited html.
@@ -166,8 +195,12 @@ string edit_update (void * webserver_request)
   // This needs the loaded USFM as the ancestor,
   // the edited USFM as a change-set,
   // and the existing USFM as a prioritized change-set.
+  // The USFM of html that did not change since the revision the editor had is not converted again.
   string loaded_chapter_usfm;
-  if (good2go) {
+  if (good2go && have_previous && (previous.stylesheet == stylesheet) && (encoded_loaded_html == previous.html)) {
+    loaded_chapter_usfm = previous.usfm;
+  }
+  else if (good2go) {
     Editor_Html2Usfm editor_export;
     editor_export.load (loaded_html);
     editor_export.stylesheet (stylesheet);
@@ -175,13 +208,25 @@ string edit_update (void * webserver_request)
     loaded_chapter_usfm = editor_export.get ();
   }
   string edited_chapter_usfm;
-  if (good2go) {
+  if (good2go && (edited_html == loaded_html)) {
+    edited_chapter_usfm = loaded_chapter_usfm;
+  }
+  else if (good2go) {
     Editor_Html2Usfm editor_export;
     editor_export.load (edited_html);
     editor_export.stylesheet (stylesheet);
     editor_export.run ();
     edited_chapter_usfm = editor_export.get ();
   }
+  // Keep the edited html and its USFM for the next revision,
+  // so the next update from the editor can send the changes only.
+  Edit_Revision current;
+  if (good2go) {
+    current.revision = max (revision, previous.revision) + 1;
+    current.html = encoded_edited_html;
+    current.usfm = edited_chapter_usfm;
+    current.stylesheet = stylesheet;
+  }
   string existing_chapter_usfm = filter_string_trim (old_chapter_usfm);
 
 
@@ -305,6 +350,13 @@ string edit_update (void * webserver_request)
   response.append (convert_to_string (newID));
 
   
+  // Add separator and the revision of the html the server now has from the editor.
+  // If the update was not good to go, the revision is zero,
+  // and the editor will send the full html next time.
+  response.append (separator);
+  response.append (convert_to_string (good2go ? current.revision : 0));
+
+  
   // The main purpose of the following block of code is this:
   // To send the differences between what the editor has now and what the server has now.
   // The purpose of sending the differences to the editor is this:
@@ -314,20 +366,28 @@ string edit_update (void * webserver_request)
   // delete - position
   if (good2go) {
     // Determine the server's current chapter content, and the editor's current chapter content.
+    // The html of the stored chapter is converted again only if the chapter or the stylesheet changed since the previous update.
     string editor_html (edited_html);
     string server_html;
-    {
+    if (have_previous && (previous.stylesheet == stylesheet) && (previous.server_usfm == new_chapter_usfm)) {
+      server_html = previous.server_html;
+    } else {
       Editor_Usfm2Html editor_usfm2html;
       editor_usfm2html.load (new_chapter_usfm);
       editor_usfm2html.stylesheet (stylesheet);
       editor_usfm2html.run ();
       server_html = editor_usfm2html.get ();
     }
+    current.server_usfm = new_chapter_usfm;
+    current.server_html = server_html;
+    storeUpdatedHtml2 (webserver_request, bible, book, chapter, unique_id, current);
     vector <int> positions;
     vector <int> sizes;
     vector <string> operators;
     vector <string> content;
-    bible_logic_html_to_editor_updates (editor_html, server_html, positions, sizes, operators, content);
+    if (editor_html != server_html) {
+      bible_logic_html_to_editor_updates (editor_html, server_html, positions, sizes, operators, content);
+    }
     // Encode the condensed differences for the response to the Javascript editor.
     for (size_t i = 0; i < positions.size(); i++) {
       response.append ("#_be_#");
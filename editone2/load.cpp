@@ -31,9 +31,6 @@
 #include <database/config/bible.h>
 
 
-using namespace pugi;
-
-
 string editone2_load_url ()
 {
   return "editone2/load";
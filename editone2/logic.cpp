@@ -22,6 +22,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <editor/html2usfm.h>
 #include <filter/string.h>
 #include <filter/url.h>
+#include <pugixml/pugixml.hpp>
+
+
+using namespace pugi;
 
 
 void editone_logic_prefix_html (string usfm, string stylesheet, string & html, string & last_p_style)
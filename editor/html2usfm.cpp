@@ -24,7 +24,6 @@
 #include <locale/translate.h>
 #include <styles/logic.h>
 #include <database/logs.h>
-#include <pugixml/utils.h>
 #include <quill/logic.h>
 
 
@@ -34,7 +33,7 @@ void Editor_Html2Usfm::load (string html)
   html = filter_string_str_replace (unicode_non_breaking_space_entity (), " ", html);
   
   // The web editor produces <hr> and other elements following the HTML specs,
-  // but the pugixml XML parser needs <hr/> and similar elements.
+  // but the XML parser needs <hr/> and similar elements.
   html = html2xml (html);
   
   // The user may add several spaces in sequence. Convert them to single spaces.
@@ -45,27 +44,223 @@ void Editor_Html2Usfm::load (string html)
   html = filter_string_str_replace ("   ", "  ", html);
   
   string xml = "<body>" + html + "</body>";
-  // Parse document such that all whitespace is put in the DOM tree.
-  // See http://pugixml.org/docs/manual.html for more information.
-  // It is not enough to only parse with parse_ws_pcdata_single, it really needs parse_ws_pcdata.
-  // This is significant for, for example, the space after verse numbers, among other cases.
-  xml_parse_result result = document.load_string (xml.c_str(), parse_ws_pcdata);
+  parse (xml);
+}
+
+
+// Parses the $xml into the list of nodes, in one pass.
+// All whitespace is kept in the text nodes.
+// This is significant for, for example, the space after verse numbers, among other cases.
+// Character entities are kept as they are, they get unescaped in the USFM.
+// Comments, CDATA sections, and processing instructions are skipped.
+// On an error, it logs that, and keeps the nodes parsed so far.
+void Editor_Html2Usfm::parse (const string & xml)
+{
+  nodes.clear ();
+  // Like a C string, the xml ends at a null character.
+  size_t length = xml.find ('\0');
+  if (length == string::npos) length = xml.size ();
+  auto is_space = [] (char c) {
+    return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+  };
+  auto is_start_symbol = [] (char c) {
+    return isalpha ((unsigned char) c) || (c == '_') || (c == ':') || ((unsigned char) c > 127);
+  };
+  auto is_symbol = [&] (char c) {
+    return is_start_symbol (c) || isdigit ((unsigned char) c) || (c == '-') || (c == '.');
+  };
+  // The element now being parsed, or -1 at the level of the document.
+  int cursor = -1;
+  string error;
+  size_t pos = 0;
+  while (error.empty () && (pos < length)) {
+    if (xml [pos] != '<') {
+      // Text, up to the next tag.
+      size_t end = xml.find ('<', pos);
+      if ((end == string::npos) || (end > length)) end = length;
+      if (cursor >= 0) {
+        int node = appendNode (cursor, false);
+        nodes [node].text = xml.substr (pos, end - pos);
+      }
+      pos = end;
+      continue;
+    }
+    pos++;
+    char c = (pos < length) ? xml [pos] : 0;
+    if (is_start_symbol (c)) {
+      // The start of an element.
+      size_t start = pos;
+      while ((pos < length) && is_symbol (xml [pos])) pos++;
+      int node = appendNode (cursor, true);
+      nodes [node].name = xml.substr (start, pos - start);
+      bool has_class = false;
+      bool empty = false;
+      if ((pos < length) && !is_space (xml [pos]) && (xml [pos] != '>') && (xml [pos] != '/')) {
+        error = "Error parsing start element tag";
+      }
+      while (error.empty ()) {
+        while ((pos < length) && is_space (xml [pos])) pos++;
+        c = (pos < length) ? xml [pos] : 0;
+        if (is_start_symbol (c)) {
+          // An attribute.
+          start = pos;
+          while ((pos < length) && is_symbol (xml [pos])) pos++;
+          string name = xml.substr (start, pos - start);
+          while ((pos < length) && is_space (xml [pos])) pos++;
+          if ((pos >= length) || (xml [pos] != '=')) {
+            error = "Error parsing element attribute";
+            break;
+          }
+          pos++;
+          while ((pos < length) && is_space (xml [pos])) pos++;
+          if ((pos >= length) || ((xml [pos] != '"') && (xml [pos] != '\''))) {
+            error = "Error parsing element attribute";
+            break;
+          }
+          char quote = xml [pos];
+          start = ++pos;
+          size_t end = xml.find (quote, pos);
+          if ((end == string::npos) || (end >= length)) {
+            // An unterminated value runs up to the end of the xml.
+            end = length;
+            error = "Error parsing element attribute";
+          }
+          if ((name == "class") && !has_class) {
+            nodes [node].classs = xml.substr (start, end - start);
+            has_class = true;
+          }
+          if (!error.empty ()) break;
+          pos = end + 1;
+          if ((pos < length) && is_start_symbol (xml [pos])) {
+            error = "Error parsing element attribute";
+          }
+        } else if ((c == '/') && (pos + 1 < length) && (xml [pos + 1] == '>')) {
+          pos += 2;
+          empty = true;
+          break;
+        } else if (c == '>') {
+          pos++;
+          break;
+        } else {
+          error = "Error parsing start element tag";
+        }
+      }
+      if (!empty) cursor = node;
+    } else if (c == '/') {
+      // The end of an element, which should be the one now being parsed.
+      size_t start = ++pos;
+      while ((pos < length) && is_symbol (xml [pos])) pos++;
+      if ((cursor < 0) || (xml.substr (start, pos - start) != nodes [cursor].name)) {
+        error = "Start-end tags mismatch";
+        break;
+      }
+      cursor = nodes [cursor].parent;
+      while ((pos < length) && is_space (xml [pos])) pos++;
+      if ((pos >= length) || (xml [pos] != '>')) {
+        error = "Error parsing end element tag";
+        break;
+      }
+      pos++;
+    } else if (xml.compare (pos, 3, "!--") == 0) {
+      // A comment.
+      size_t end = xml.find ("-->", pos + 3);
+      if ((end == string::npos) || (end + 3 > length)) error = "Error parsing comment";
+      else pos = end + 3;
+    } else if (xml.compare (pos, 8, "![CDATA[") == 0) {
+      // A CDATA section.
+      size_t end = xml.find ("]]>", pos + 8);
+      if ((end == string::npos) || (end + 3 > length)) error = "Error parsing CDATA section";
+      else pos = end + 3;
+    } else if ((c == '?') || (c == '!')) {
+      // A declaration or processing instruction.
+      size_t end = xml.find ('>', pos);
+      if ((end == string::npos) || (end >= length)) error = "Error parsing document declaration/processing instruction";
+      else pos = end + 1;
+    } else {
+      error = "Could not determine tag type";
+    }
+  }
+  // Check that the last tag is closed.
+  if (error.empty () && (cursor >= 0)) error = "Start-end tags mismatch";
   // Log parsing errors.
-  pugixml_utils_error_logger (&result, xml);
+  if (!error.empty ()) {
+    if (pos > length) pos = length;
+    size_t start = 0;
+    if (pos > 10) start = pos - 10;
+    string fragment = xml.substr (start, 20);
+    fragment = filter_string_str_replace ("\n", "", fragment);
+    Database_Logs::log (error + " at offset " + convert_to_string (pos) + ": " + fragment);
+  }
+}
+
+
+// Appends a new node to the children of the $parent, and returns its position.
+int Editor_Html2Usfm::appendNode (int parent, bool element)
+{
+  int node = (int) nodes.size ();
+  nodes.push_back (Editor_Html2Usfm_Node ());
+  nodes [node].element = element;
+  nodes [node].parent = parent;
+  if (parent >= 0) {
+    if (nodes [parent].last_child >= 0) nodes [nodes [parent].last_child].next_sibling = node;
+    else nodes [parent].first_child = node;
+    nodes [parent].last_child = node;
+  }
+  return node;
+}
+
+
+// Appends a copy of the $node, and of its descendants, to the children of the $parent.
+void Editor_Html2Usfm::appendCopy (int parent, int node)
+{
+  int copy = appendNode (parent, nodes [node].element);
+  nodes [copy].name = nodes [node].name;
+  nodes [copy].classs = nodes [node].classs;
+  nodes [copy].text = nodes [node].text;
+  for (int child = nodes [node].first_child; child >= 0; child = nodes [child].next_sibling) {
+    appendCopy (copy, child);
+  }
+}
+
+
+// Takes the $child out of the children of the $parent.
+// The removed node keeps its link to its next sibling,
+// so that an iteration over the children can continue from there.
+void Editor_Html2Usfm::removeChild (int parent, int child)
+{
+  if ((parent < 0) || (child < 0)) return;
+  int previous = -1;
+  for (int node = nodes [parent].first_child; node >= 0; node = nodes [node].next_sibling) {
+    if (node == child) {
+      int next = nodes [node].next_sibling;
+      if (previous >= 0) nodes [previous].next_sibling = next;
+      else nodes [parent].first_child = next;
+      if (nodes [parent].last_child == node) nodes [parent].last_child = previous;
+      nodes [node].parent = -1;
+      return;
+    }
+    previous = node;
+  }
+}
+
+
+// The tag name of the $node, or nothing for a text node or no node.
+string Editor_Html2Usfm::nodeName (int node)
+{
+  if (node < 0) return string ();
+  return nodes [node].name;
 }
 
 
 void Editor_Html2Usfm::stylesheet (string stylesheet)
 {
-  styles.clear ();
   noteOpeners.clear ();
   characterStyles.clear ();
   Database_Styles database_styles;
-  vector <string> markers = database_styles.getMarkers (stylesheet);
+  styles = database_styles.compile (stylesheet);
   // Load the style information into the object.
-  for (string & marker : markers) {
-    Database_Styles_Item style = database_styles.getMarkerData (stylesheet, marker);
-    styles [marker] = style;
+  for (auto & style : styles->items) {
+    const string & marker = style.marker;
     // Get markers with should not have endmarkers.
     bool suppress = false;
     int type = style.type;
@@ -100,12 +295,12 @@ void Editor_Html2Usfm::run ()
 void Editor_Html2Usfm::process ()
 {
   // Iterate over the children to retrieve the "p" elements, then process them.
-  xml_node body = document.first_child ();
-  for (xml_node node : body.children()) {
+  if (nodes.empty ()) return;
+  for (int node = nodes [0].first_child; node >= 0; node = nodes [node].next_sibling) {
     // Do not process the notes <div> or <p> and beyond
     // because it is at the end of the text body,
     // and note-related data has already been extracted from it.
-    string classs = update_quill_class (node.attribute ("class").value ());
+    string classs = update_quill_class (nodes [node].classs);
     if (classs == "notes") break;
     // Process the node.
     processNode (node);
@@ -124,45 +319,30 @@ string Editor_Html2Usfm::get ()
 }
 
 
-void Editor_Html2Usfm::processNode (xml_node node)
+void Editor_Html2Usfm::processNode (int node)
 {
-  switch (node.type ()) {
-    case node_element:
-    {
-      // Skip a note with class "ql-cursor" because that is an internal Quill node.
-      // The user didn't insert it.
-      string classs = node.attribute("class").value();
-      if (classs == "ql-cursor") break;
-      // Process this node.
-      openElementNode (node);
-      for (xml_node child : node.children()) {
-        processNode (child);
-      }
-      closeElementNode (node);
-      break;
-    }
-    case node_pcdata:
-    {
-      // Add the text to the current USFM line.
-      string text = node.text ().get ();
-      currentLine += text;
-      break;
-    }
-    default:
-    {
-      string nodename = node.name ();
-      Database_Logs::log ("Unknown XML node " + nodename + " while saving editor text");
-      break;
+  if (nodes [node].element) {
+    // Skip a note with class "ql-cursor" because that is an internal Quill node.
+    // The user didn't insert it.
+    if (nodes [node].classs == "ql-cursor") return;
+    // Process this node.
+    openElementNode (node);
+    for (int child = nodes [node].first_child; child >= 0; child = nodes [child].next_sibling) {
+      processNode (child);
     }
+    closeElementNode (node);
+  } else {
+    // Add the text to the current USFM line.
+    currentLine += nodes [node].text;
   }
 }
 
 
-void Editor_Html2Usfm::openElementNode (xml_node node)
+void Editor_Html2Usfm::openElementNode (int node)
 {
   // The tag and class names of this element node.
-  string tagName = node.name ();
-  string className = update_quill_class (node.attribute ("class").value ());
+  string tagName = nodes [node].name;
+  string className = update_quill_class (nodes [node].classs);
   
   if (tagName == "p")
   {
@@ -203,11 +383,11 @@ void Editor_Html2Usfm::openElementNode (xml_node node)
 }
 
 
-void Editor_Html2Usfm::closeElementNode (xml_node node)
+void Editor_Html2Usfm::closeElementNode (int node)
 {
   // The tag and class names of this element node.
-  string tagName = node.name ();
-  string className = update_quill_class (node.attribute ("class").value ());
+  string tagName = nodes [node].name;
+  string className = update_quill_class (nodes [node].classs);
   
   if (tagName == "p")
   {
@@ -291,19 +471,18 @@ void Editor_Html2Usfm::openInline (string className)
 }
 
 
-void Editor_Html2Usfm::processNoteCitation (xml_node node)
+void Editor_Html2Usfm::processNoteCitation (int node)
 {
   // Remove the note citation from the main text body.
   // It means that this:
   //   <span class="i-notecall1">1</span>
   // becomes this:
   //   <span class="i-notecall1" />
-  xml_node child = node.first_child ();
-  node.remove_child (child);
+  removeChild (node, nodes [node].first_child);
 
   // Get more information about the note to retrieve.
   // <span class="i-notecall1" />
-  string id = node.attribute ("class").value ();
+  string id = nodes [node].classs;
   id = filter_string_str_replace ("call", "body", id);
 
   // Sample footnote body.
@@ -313,26 +492,25 @@ void Editor_Html2Usfm::processNoteCitation (xml_node node)
   // http://www.grinninglizard.com/tinyxml2docs/index.html
   // But XPath crashed on Android with libxml2.
   // Therefore now it iterates over all the nodes to find the required element.
-  // After moving to pugixml, the XPath expression could have been used again, but this was not done.
-  xml_node note_p_element = get_note_pointer (document.first_child (), id);
-  if (note_p_element) {
+  int note_p_element = get_note_pointer (0, id);
+  if (note_p_element >= 0) {
 
     // It now has the <p>.
     // Remove the first <span> element.
     // So we remain with:
     // <p class="x"><span> </span><span>+ 2 Joh. 1.1</span></p>
     {
-      xml_node node = note_p_element.first_child();
-      string name = node.name ();
-      if (name != "span") {
+      int node = nodes [note_p_element].first_child;
+      string name = nodeName (node);
+      if ((node >= 0) && (name != "span")) {
         // Normally the <span> is the first child in the <p> that is a note.
         // But the user may have typed some text there.
         // If so, then the <span> is the second child of the <p>.
         // This code cares for that situation.
-        node = node.next_sibling();
-        name = node.name();
+        node = nodes [node].next_sibling;
+        name = nodeName (node);
       }
-      note_p_element.remove_child (node);
+      removeChild (note_p_element, node);
     }
 
     // Preserve active character styles in the main text, and reset them for the note.
@@ -348,8 +526,7 @@ void Editor_Html2Usfm::processNoteCitation (xml_node node)
     characterStyles = preservedCharacterStyles;
     
     // Remove this element so it can't be processed again.
-    xml_node parent = note_p_element.parent ();
-    parent.remove_child (note_p_element);
+    removeChild (nodes [note_p_element].parent, note_p_element);
 
   } else {
     Database_Logs::log ("Discarding note with id " + id);
@@ -403,17 +580,17 @@ void Editor_Html2Usfm::postprocess ()
 }
 
 
-// Retrieves a pointer to a relevant footnote element in the XML.
-xml_node Editor_Html2Usfm::get_note_pointer (xml_node body, string id)
+// Retrieves the position of a relevant footnote element in the nodes.
+int Editor_Html2Usfm::get_note_pointer (int body, string id)
 {
   // The note wrapper node to look for.
-  xml_node p_note_wrapper;
+  int p_note_wrapper = -1;
 
   // Check that there's a node to start with.
-  if (!body) return p_note_wrapper;
+  if (body >= (int) nodes.size ()) return p_note_wrapper;
 
   // Assert that the <body> node is given.
-  if (string(body.name ()) != "body") return p_note_wrapper;
+  if (nodes [body].name != "body") return p_note_wrapper;
 
   // Some of the children of the <body> node will be the note wrappers.
   // Consider this XML:
@@ -432,19 +609,19 @@ xml_node Editor_Html2Usfm::get_note_pointer (xml_node body, string id)
   // It handles a situation that the user presses <Enter> while in a note.
   // The solution is to include the next p node too if it belongs to the correct note wrapper p node.
   bool within_matching_p_node = false;
-  for (xml_node p_body_child : body.children ()) {
-    xml_node span_notebody = p_body_child.first_child();
-    string name = span_notebody.name ();
-    if (name != "span") {
+  for (int p_body_child = nodes [body].first_child; p_body_child >= 0; p_body_child = nodes [p_body_child].next_sibling) {
+    int span_notebody = nodes [p_body_child].first_child;
+    string name = nodeName (span_notebody);
+    if ((span_notebody >= 0) && (name != "span")) {
       // Normally the <span> is the first child in the <p> that is a note.
       // But the user may have typed some text there.
       // If so, then the <span> is the second child of the <p>.
       // This code cares for that situation.
-      span_notebody = span_notebody.next_sibling();
-      name = span_notebody.name();
+      span_notebody = nodes [span_notebody].next_sibling;
+      name = nodeName (span_notebody);
     }
     if (name == "span") {
-      string classs = span_notebody.attribute ("class").value ();
+      string classs = nodes [span_notebody].classs;
       if (classs.substr (0, 10) == id.substr(0, 10)) {
         if (classs == id) {
           within_matching_p_node = true;
@@ -454,11 +631,11 @@ xml_node Editor_Html2Usfm::get_note_pointer (xml_node body, string id)
       }
     }
     if (within_matching_p_node) {
-      if (!p_note_wrapper) {
+      if (p_note_wrapper < 0) {
         p_note_wrapper = p_body_child;
       } else {
-        for (xml_node child = p_body_child.first_child(); child; child = child.next_sibling()) {
-          p_note_wrapper.append_copy(child);
+        for (int child = nodes [p_body_child].first_child; child >= 0; child = nodes [child].next_sibling) {
+          appendCopy (p_note_wrapper, child);
         }
       }
     }
@@ -23,10 +23,22 @@
 
 #include <config/libraries.h>
 #include <database/styles.h>
-#include <pugixml/pugixml.hpp>
 
 
-using namespace pugi;
+// A node of the html, an element or a text.
+// The nodes are stored in one list in document order, and link to each other by their positions in that list.
+class Editor_Html2Usfm_Node
+{
+public:
+  bool element = false;
+  string name; // The tag name of an element.
+  string classs; // The class attribute of an element.
+  string text; // The text of a text node.
+  int parent = -1;
+  int first_child = -1;
+  int last_child = -1;
+  int next_sibling = -1;
+};
 
 
 class Editor_Html2Usfm
@@ -37,8 +49,8 @@ public:
   void run ();
   string get ();
 private:
-  xml_document document; // DOMDocument holding the html.
-  map <string, Database_Styles_Item> styles; // Style information.
+  vector <Editor_Html2Usfm_Node> nodes; // The html, the <body> node is the first one.
+  shared_ptr <const Database_Styles_Sheet> styles; // Style information.
   vector <string> output; // Output USFM.
   string currentLine; // Growing current USFM line.
   bool mono; // Monospace font.
@@ -47,17 +59,22 @@ private:
   vector <string> characterStyles; // Active character styles.
   bool processingNote = false; // Note processing flag.
   string lastNoteStyle; // The most recent style opened inside a note.
+  void parse (const string & xml);
+  int appendNode (int parent, bool element);
+  void appendCopy (int parent, int node);
+  void removeChild (int parent, int child);
+  string nodeName (int node);
   void preprocess ();
   void flushLine ();
   void postprocess ();
   void process ();
-  void processNode (xml_node node);
-  void openElementNode (xml_node node);
-  void closeElementNode (xml_node node);
+  void processNode (int node);
+  void openElementNode (int node);
+  void closeElementNode (int node);
   void openInline (string className);
-  void processNoteCitation (xml_node node);
+  void processNoteCitation (int node);
   string cleanUSFM (string usfm);
-  xml_node get_note_pointer (xml_node body, string id);
+  int get_note_pointer (int body, string id);
   string update_quill_class (string classname);
 };
 
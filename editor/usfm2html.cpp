@@ -27,6 +27,40 @@
 #include <quill/logic.h>
 
 
+// Appends the $text to the $html, escaped the way the XML writers escape it.
+// In an $attribute value the quote and the line breaks are escaped as well.
+// Like a C string, the text ends at a null character.
+static void editor_usfm2html_escape (string & html, const string & text, bool attribute)
+{
+  for (char c : text) {
+    switch (c) {
+      case '\0': return;
+      case '&': html.append ("&amp;"); break;
+      case '<': html.append ("&lt;"); break;
+      case '>': html.append ("&gt;"); break;
+      case '"':
+        if (attribute) html.append ("&quot;");
+        else html.push_back (c);
+        break;
+      default:
+      {
+        unsigned int ch = (unsigned char) c;
+        bool special = (ch < 32) && (ch != '\t');
+        if (!attribute && ((ch == '\n') || (ch == '\r'))) special = false;
+        if (special) {
+          html.append ("&#");
+          html.push_back ((char) ('0' + ch / 10));
+          html.push_back ((char) ('0' + ch % 10));
+          html.push_back (';');
+        } else {
+          html.push_back (c);
+        }
+      }
+    }
+  }
+}
+
+
 void Editor_Usfm2Html::load (string usfm)
 {
   // Clean up.
@@ -42,12 +76,9 @@ void Editor_Usfm2Html::load (string usfm)
 void Editor_Usfm2Html::stylesheet (string stylesheet)
 {
   Database_Styles database_styles;
-  styles.clear();
-  vector <string> markers = database_styles.getMarkers (stylesheet);
-  // Load the style information into the object.
-  for (auto & marker : markers) {
-    Database_Styles_Item style = database_styles.getMarkerData (stylesheet, marker);
-    styles [marker] = style;
+  styles = database_styles.compile (stylesheet);
+  // Get the standard markers of the notes.
+  for (auto & style : styles->items) {
     if (style.type == StyleTypeFootEndNote) {
       if (style.subtype == FootEndNoteSubtypeStandardContent) {
         standardContentMarkerFootEndNote = style.marker;
@@ -73,38 +104,25 @@ void Editor_Usfm2Html::run ()
 string Editor_Usfm2Html::get ()
 {
   closeParagraph ();
+  endParagraph ();
 
-  // If there are notes, move the notes <div> or <p> after everything else.
-  // (It has the <hr> or <br> as a child).
-  size_t count = distance (notes_node.begin (), notes_node.end ());
-  if (count > 1) {
-    body_node.append_move (notes_node);
-  }
+  string html (body_html);
 
+  // If there are notes, add the notes <p> after everything else.
   // A Quill-based editor does not work with embedded <p> elements.
-  // Move the notes out of their parent and append them to the end of the main body.
-  while (xml_node note = notes_node.first_child ().next_sibling ()) {
-    body_node.append_move (note);
-  }
-  
-  // Get the html code, including body, without head.
-  stringstream output;
-  body_node.print (output, "", format_raw);
-  string html = output.str ();
-  
-  // Remain with the stuff within the <body> elements.
-  size_t pos = html.find ("<body>");
-  if (pos != string::npos) {
-    html.erase (0, pos + 6);
-    pos = html.find ("</body>");
-    if (pos != string::npos) {
-      html.erase  (pos);
-    }
+  // So the notes follow that <p> rather than being part of it.
+  if (!notes_html.empty ()) {
+    html.append ("<p class=\"");
+    html.append (quill_logic_class_prefix_block ());
+    html.append ("notes\">");
+    html.append (non_breaking_space_u00A0 ());
+    html.append ("</p>");
+    html.append (notes_html);
+    html.append ("</p>");
   }
   
-  // Currently the XML library produces hexadecimal character entities.
-  // This is unwanted behaviour: Convert them to normal characters.
-  html = convert_xml_character_entities_to_characters (html);
+  // An empty document.
+  if (html.empty ()) html = "<body />";
   
   // Result.
   return html;
@@ -121,21 +139,11 @@ void Editor_Usfm2Html::preprocess ()
   textLength = 0;
   verseStartOffsets = { make_pair (0, 0) };
   current_p_open = false;
+  current_p_unfinished = false;
+  current_p_empty = false;
   note_p_open = false;
-
-  // XPath crashes on Android with libxml2 2.9.2 compiled through the Android NDK.
-  // After the move to pugixml, this no longer applies.
-
-  body_node = document.append_child ("body");
-  
-  // Create notes xml node.
-  // It comes at the start of the document.
-  // (Later, it will either be deleted, or moved to the end).
-  string notes_value = "notes";
-  notes_node = document.append_child ("p");
-  notes_value.insert (0, quill_logic_class_prefix_block ());
-  notes_node.append_attribute ("class") = notes_value.c_str ();
-  notes_node.text().set(non_breaking_space_u00A0().c_str());
+  body_html.clear ();
+  notes_html.clear ();
 }
 
 
@@ -152,9 +160,9 @@ void Editor_Usfm2Html::process ()
       bool isEmbeddedMarker = usfm_is_embedded_marker (currentItem);
       // Clean up the marker, so we remain with the basic version, e.g. 'id'.
       string marker = usfm_get_marker (currentItem);
-      if (styles.count (marker))
+      if (const Database_Styles_Item * found = styles->find (marker))
       {
-        Database_Styles_Item style = styles [marker];
+        const Database_Styles_Item & style = * found;
         switch (style.type)
         {
           case StyleTypeIdentifier:
@@ -406,13 +414,19 @@ void Editor_Usfm2Html::outputAsIs (string marker, bool isOpeningMarker)
 void Editor_Usfm2Html::newParagraph (string style)
 {
   // Handle new paragraph.
-  current_p_node = body_node.append_child ("p");
+  endParagraph ();
+  body_html.append ("<p");
   current_p_open = true;
+  current_p_unfinished = true;
+  current_p_empty = true;
   if (!style.empty()) {
     string style2 (style);
     style2.insert (0, quill_logic_class_prefix_block ());
-    current_p_node.append_attribute ("class") = style2.c_str();
+    body_html.append (" class=\"");
+    editor_usfm2html_escape (body_html, style2, true);
+    body_html.append ("\"");
   }
+  body_html.append (">");
   currentParagraphStyle = style;
   currentParagraphContent.clear();
   // A Quill-based editor assigns a length of one to a new line.
@@ -431,16 +445,31 @@ void Editor_Usfm2Html::closeParagraph ()
   // This <br> is also needed for live editor updates.
   if (current_p_open) {
     if (currentParagraphContent.empty()) {
-      current_p_node.append_child("br");
+      body_html.append ("<br />");
+      current_p_empty = false;
     }
   }
 }
 
 
+// Writes the end of the current p element, if it was not yet written.
+void Editor_Usfm2Html::endParagraph ()
+{
+  if (!current_p_unfinished) return;
+  if (current_p_empty) {
+    // A paragraph without children is written as an empty element.
+    body_html.insert (body_html.size () - 1, " /");
+  } else {
+    body_html.append ("</p>");
+  }
+  current_p_unfinished = false;
+}
+
+
 // This opens a text style.
 // $style: the array containing the style variables.
 // $embed: boolean: Whether to open embedded / nested style.
-void Editor_Usfm2Html::openTextStyle (Database_Styles_Item & style, bool embed)
+void Editor_Usfm2Html::openTextStyle (const Database_Styles_Item & style, bool embed)
 {
   string marker = style.marker;
   if (noteOpened) {
@@ -475,11 +504,9 @@ void Editor_Usfm2Html::addText (string text)
     if (!current_p_open) {
       newParagraph ();
     }
-    xml_node spanDomElement = current_p_node.append_child ("span");
-    spanDomElement.text ().set (text.c_str());
+    string textstyle;
     if (!currentTextStyles.empty ()) {
       // Take character style(s) as specified in this object.
-      string textstyle;
       for (auto & style : currentTextStyles) {
         if (!textstyle.empty ()) {
           // The Quill library is fussy about class names.
@@ -493,8 +520,9 @@ void Editor_Usfm2Html::addText (string text)
         textstyle.append (style);
       }
       textstyle.insert (0, quill_logic_class_prefix_inline ());
-      spanDomElement.append_attribute ("class") = textstyle.c_str();
     }
+    addSpan (body_html, text, textstyle);
+    current_p_empty = false;
     currentParagraphContent.append (text);
   }
   textLength += unicode_string_length (text);
@@ -525,19 +553,23 @@ void Editor_Usfm2Html::addNote (string citation, string style, bool endnote)
   noteOpened = true;
   
   // Add the link with all relevant data for the note citation.
-  addNotelLink (current_p_node, noteCount, "call", citation);
+  addNotelLink (body_html, noteCount, "call", citation);
+  current_p_empty = false;
   
   // Open a paragraph element for the note body.
-  notePnode = notes_node.append_child ("p");
+  // The paragraph of any previous note body ends here.
+  if (!notes_html.empty ()) notes_html.append ("</p>");
   note_p_open = true;
   string cls (style);
   cls.insert (0, quill_logic_class_prefix_block ());
-  notePnode.append_attribute ("class") = cls.c_str();
+  notes_html.append ("<p class=\"");
+  editor_usfm2html_escape (notes_html, cls, true);
+  notes_html.append ("\">");
   
   closeTextStyle (false);
   
   // Add the link with all relevant data for the note body.
-  addNotelLink (notePnode, noteCount, "body", citation);
+  addNotelLink (notes_html, noteCount, "body", citation);
   
   // Add a space.
   addNoteText (" ");
@@ -555,15 +587,13 @@ void Editor_Usfm2Html::addNoteText (string text)
   if (!note_p_open) {
     addNote ("?", "");
   }
-  xml_node spanDomElement = notePnode.append_child ("span");
-  spanDomElement.text ().set (text.c_str());
+  string classs;
   if (!currentNoteTextStyles.empty()) {
     // Take character style(s) as specified in this object.
-    string classs;
     classs = filter_string_implode (currentNoteTextStyles, "0");
     classs.insert (0, quill_logic_class_prefix_inline ());
-    spanDomElement.append_attribute ("class") = classs.c_str();
   }
+  addSpan (notes_html, text, classs);
 }
 
 
@@ -578,17 +608,30 @@ void Editor_Usfm2Html::closeCurrentNote ()
 
 
 // This adds a link as a mechanism to connect body text with a note body.
-// $domNode: The DOM node where to add the link to.
+// $html: The html where to add the link to.
 // $identifier: The link's identifier.
 // $style: A style for the note citation, and one for the note body.
 // $text: The link's text.
 // It also deals with a Quill-based editor, in a slightly different way.
-void Editor_Usfm2Html::addNotelLink (xml_node domNode, int identifier, string style, string text)
+void Editor_Usfm2Html::addNotelLink (string & html, int identifier, string style, string text)
 {
-  xml_node aDomElement = domNode.append_child ("span");
   string cls = "i-note" + style + convert_to_string (identifier);
-  aDomElement.append_attribute ("class") = cls.c_str();
-  aDomElement.text ().set (text.c_str());
+  addSpan (html, text, cls);
+}
+
+
+// This adds a span with the $text and with the $classs, if any, to the $html.
+void Editor_Usfm2Html::addSpan (string & html, const string & text, const string & classs)
+{
+  html.append ("<span");
+  if (!classs.empty ()) {
+    html.append (" class=\"");
+    editor_usfm2html_escape (html, classs, true);
+    html.append ("\"");
+  }
+  html.append (">");
+  editor_usfm2html_escape (html, text, false);
+  html.append ("</span>");
 }
 
 
@@ -608,10 +651,10 @@ bool Editor_Usfm2Html::roadIsClear ()
     input_embedded = usfm_is_embedded_marker (currentItem);
     string marker = usfm_get_marker (currentItem);
     input_marker = marker;
-    if (!styles.count (marker)) return true;
-    Database_Styles_Item style = styles [marker];
-    input_type = style.type;
-    input_subtype = style.subtype;
+    const Database_Styles_Item * style = styles->find (marker);
+    if (!style) return true;
+    input_type = style->type;
+    input_subtype = style->subtype;
   }
   
   // Determine the road ahead.
@@ -631,9 +674,9 @@ bool Editor_Usfm2Html::roadIsClear ()
       if (usfm_is_usfm_marker (currentItem))
       {
         string marker = usfm_get_marker (currentItem);
-        if (styles.count (marker))
+        if (const Database_Styles_Item * found = styles->find (marker))
         {
-          Database_Styles_Item style = styles [marker];
+          const Database_Styles_Item & style = * found;
           markers.push_back (marker);
           types.push_back (style.type);
           subtypes.push_back (style.subtype);
@@ -23,12 +23,10 @@
 
 #include <config/libraries.h>
 #include <database/styles.h>
-#include <pugixml/pugixml.hpp>
-
-
-using namespace pugi;
 
 
+// Converts USFM to the html for the editors.
+// It writes the html as it goes, without building a document in memory first.
 class Editor_Usfm2Html
 {
 public:
@@ -44,24 +42,23 @@ private:
   vector <string> markersAndText; // Strings alternating between USFM and text.
   unsigned int markersAndTextPointer = 0;
   
-  map <string, Database_Styles_Item> styles; // All the style information.
+  shared_ptr <const Database_Styles_Sheet> styles = make_shared <Database_Styles_Sheet> (); // All the style information.
   
-  // XML nodes.
-  xml_document document;
-  xml_node body_node;
-  xml_node notes_node;
+  // The html of the text body, and of the note bodies.
+  string body_html;
+  string notes_html;
   
   // Standard content markers for notes.
   string standardContentMarkerFootEndNote;
   string standardContentMarkerCrossReference;
   
-  xml_node current_p_node; // The current p node.
-  bool current_p_open = false;
+  bool current_p_open = false; // Whether there is a current p element.
+  bool current_p_unfinished = false; // Whether the end of the current p element is still to be written.
+  bool current_p_empty = false; // Whether the current p element has no children yet.
   vector <string> currentTextStyles;
   
   int noteCount = 0;
-  xml_node notePnode; // The p DOM element of the current footnote, if any.
-  bool note_p_open = false;
+  bool note_p_open = false; // Whether the p element of the current footnote, if any, is open.
   vector <string> currentNoteTextStyles;
   
   // Whether note is open.
@@ -76,13 +73,15 @@ private:
   void outputAsIs (string marker, bool isOpeningMarker);
   void newParagraph (string style = "");
   void closeParagraph ();
-  void openTextStyle (Database_Styles_Item & style, bool embed);
+  void endParagraph ();
+  void openTextStyle (const Database_Styles_Item & style, bool embed);
   void closeTextStyle (bool embed);
   void addText (string text);
   void addNote (string citation, string style, bool endnote = false);
   void addNoteText (string text);
   void closeCurrentNote ();
-  void addNotelLink (xml_node domNode, int identifier, string style, string text);
+  void addNotelLink (string & html, int identifier, string style, string text);
+  void addSpan (string & html, const string & text, const string & classs);
   
   bool roadIsClear ();
 };
@@ -28,6 +28,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <sources/oshb.h>
 #include <sources/styles.h>
 #include <sources/abbott-smith.h>
+#include <sources/books.h>
 
 
 int main (int argc, char **argv)
@@ -59,6 +60,7 @@ int main (int argc, char **argv)
   string oshb_command = "oshb";
   string stylesheet_command = "styles";
   string abbott_smith_command = "abbott-smith";
+  string books_command = "books";
   
   if (command == locale_command) {
   
@@ -100,6 +102,11 @@ int main (int argc, char **argv)
     cout << "Parsing Abbott-Smith's Manual Greek Lexicon into the abbottsmith database" << endl;
     sources_abbott_smith_parse ();
     
+  } else if (command == books_command) {
+    
+    cout << "Generating the lookup tables of the books in database/booksindex.h" << endl;
+    sources_books_index ();
+    
   } else {
     
     cerr << "This command is unknown" << endl;
@@ -112,6 +119,7 @@ int main (int argc, char **argv)
     cerr << oshb_command << ": Parse Open Scriptures Hebrew Bible with morphology into the oshb database" << endl;
     cerr << stylesheet_command << ": Parse style values and import them into the default styles" << endl;
     cout << abbott_smith_command << ": Parse Abbott-Smith's Manual Greek Lexicon into the abbottsmith database" << endl;
+    cerr << books_command << ": Generate the lookup tables of the books in database/booksindex.h" << endl;
     
     return EXIT_FAILURE;
     
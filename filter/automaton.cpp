@@ -0,0 +1,118 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <filter/automaton.h>
+
+
+Filter_Automaton::Filter_Automaton ()
+{
+  // The root state.
+  add_state ();
+}
+
+
+int Filter_Automaton::add_state ()
+{
+  int state = (int) outputs.size ();
+  transitions.resize (transitions.size () + 256, -1);
+  outputs.push_back ({});
+  return state;
+}
+
+
+// Adds a $fragment to look for.
+// The search gives the $id whenever it finds this fragment.
+// The same fragment can be added more than once with different identifiers.
+void Filter_Automaton::add (const string & fragment, int id)
+{
+  if (fragment.empty ()) return;
+  int state = 0;
+  for (unsigned char c : fragment) {
+    int next = transitions [state * 256 + c];
+    if (next < 0) {
+      next = add_state ();
+      transitions [state * 256 + c] = next;
+    }
+    state = next;
+  }
+  outputs [state].push_back (id);
+}
+
+
+// Adds the failure transitions to the trie, breadth first,
+// so that the search never needs to go back in the text.
+void Filter_Automaton::compile ()
+{
+  vector <int> failures (outputs.size (), 0);
+  vector <int> queue;
+  for (int c = 0; c < 256; c++) {
+    int next = transitions [c];
+    if (next < 0) {
+      transitions [c] = 0;
+    } else {
+      queue.push_back (next);
+    }
+  }
+  for (size_t i = 0; i < queue.size (); i++) {
+    int state = queue [i];
+    // A state also gives the fragments of its failure state, which are suffixes of its own.
+    const vector <int> & inherited = outputs [failures [state]];
+    outputs [state].insert (outputs [state].end (), inherited.begin (), inherited.end ());
+    for (int c = 0; c < 256; c++) {
+      int next = transitions [state * 256 + c];
+      int fallback = transitions [failures [state] * 256 + c];
+      if (next < 0) {
+        transitions [state * 256 + c] = fallback;
+      } else {
+        failures [next] = fallback;
+        queue.push_back (next);
+      }
+    }
+  }
+}
+
+
+// Searches the $text for all fragments in one scan.
+// It returns the identifiers of the fragments found, in the order in which the fragments end in the text.
+vector <int> Filter_Automaton::search (const string & text) const
+{
+  vector <int> ids;
+  int state = 0;
+  for (unsigned char c : text) {
+    state = transitions [state * 256 + c];
+    const vector <int> & found = outputs [state];
+    if (!found.empty ()) ids.insert (ids.end (), found.begin (), found.end ());
+  }
+  return ids;
+}
+
+
+// Searches the $text for all fragments in one scan.
+// It returns the position just past the end of each fragment found, with its identifier,
+// in the order in which the fragments end in the text.
+vector <pair <size_t, int> > Filter_Automaton::locate (const string & text) const
+{
+  vector <pair <size_t, int> > positions;
+  int state = 0;
+  for (size_t i = 0; i < text.size (); i++) {
+    state = transitions [state * 256 + (unsigned char) text [i]];
+    for (int id : outputs [state]) positions.push_back (make_pair (i + 1, id));
+  }
+  return positions;
+}
@@ -0,0 +1,49 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef INCLUDED_FILTER_AUTOMATON_H
+#define INCLUDED_FILTER_AUTOMATON_H
+
+
+#include <config/libraries.h>
+
+
+// An Aho-Corasick automaton that finds many fragments of text in one scan.
+// Add the fragments, compile it, and then search any number of texts with it.
+// Once compiled it does not change anymore, so several threads can search with it at the same time.
+class Filter_Automaton
+{
+public:
+  Filter_Automaton ();
+  void add (const string & fragment, int id);
+  void compile ();
+  vector <int> search (const string & text) const;
+  vector <pair <size_t, int> > locate (const string & text) const;
+private:
+  // The transitions from each state on each byte.
+  // Before compiling, these are the edges of the trie, with -1 where there is no edge.
+  // After compiling, this is the complete state machine, including the failure transitions.
+  vector <int> transitions;
+  // The identifiers of the fragments found on reaching each state.
+  vector <vector <int> > outputs;
+  int add_state ();
+};
+
+
+#endif
@@ -36,7 +36,76 @@
 using dtl::Diff;
 
 
-static mutex filter_diff_mutex;
+// The diff engine does not work on the text tokens themselves.
+// Each distinct token is given an integer, and the engine compares the integers.
+// This interner does not copy the tokens:
+// It points into the input, which should remain in place while the interner is in use.
+// It keeps no state between calls, so diffs can run in parallel on several threads.
+class Filter_Diff_Interner
+{
+public:
+  int intern (const char * data, size_t size);
+  const char * data (int id) { return tokens [id].first; };
+  size_t size (int id) { return tokens [id].second; };
+private:
+  // The tokens, indexed on their integers.
+  vector <pair <const char *, size_t> > tokens;
+  // The next token with the same hash.
+  vector <int> chain;
+  // The first token with a hash.
+  unordered_map <size_t, int> heads;
+};
+
+
+int Filter_Diff_Interner::intern (const char * data, size_t size)
+{
+  // FNV-1a hash of the token.
+  size_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= (unsigned char) data [i];
+    hash *= 16777619u;
+  }
+  auto iterator = heads.find (hash);
+  int head = -1;
+  if (iterator != heads.end ()) {
+    head = iterator->second;
+    for (int id = head; id >= 0; id = chain [id]) {
+      if ((tokens [id].second == size) && (memcmp (tokens [id].first, data, size) == 0)) return id;
+    }
+  }
+  int id = (int) tokens.size ();
+  tokens.push_back (make_pair (data, size));
+  chain.push_back (head);
+  heads [hash] = id;
+  return id;
+}
+
+
+// The marker the word diff uses for a new line.
+static const string filter_diff_newline = "newline_newline_newline";
+
+
+// Splits $text into words separated by spaces, with each new line as a separate word.
+// It gives the same words as exploding the text on the space,
+// after replacing each new line with the new line marker surrounded by spaces.
+void filter_diff_words (const string & text, Filter_Diff_Interner & interner, vector <int> & ids)
+{
+  const char * data = text.data ();
+  size_t length = text.size ();
+  size_t start = 0;
+  for (size_t i = 0; i < length; i++) {
+    char c = data [i];
+    if ((c == ' ') || (c == '\n')) {
+      ids.push_back (interner.intern (data + start, i - start));
+      if (c == '\n') {
+        ids.push_back (interner.intern (filter_diff_newline.data (), filter_diff_newline.size ()));
+      }
+      start = i + 1;
+    }
+  }
+  // A trailing separator does not give an empty word.
+  if (start < length) ids.push_back (interner.intern (data + start, length - start));
+}
 
 
 // This filter returns the diff of two input strings.
@@ -45,60 +114,50 @@ static mutex filter_diff_mutex;
 // The function returns the differences marked.
 // If the containers for $removals and $additions are given,
 // they will be filled with the appropriate text fragments.
-string filter_diff_diff (string oldstring, string newstring,
+string filter_diff_diff (const string & oldstring, const string & newstring,
                          vector <string> * removals,
                          vector <string> * additions)
 {
-  // Save the new lines.
-  string newline = " newline_newline_newline ";
-  oldstring = filter_string_str_replace ("\n", newline, oldstring);
-  newstring = filter_string_str_replace ("\n", newline, newstring);
-  
   // Split the input up into words.
   // It compares with word granularity.
-  vector <string> old_sequence = filter_string_explode (oldstring, ' ');
-  vector <string> new_sequence = filter_string_explode (newstring, ' ');
-  
-  // See issue https://github.com/bibledit/cloud/issues/419
-  // It is unclear at this time whether the code below
-  // to find the differences between texts, is thread-safe.
-  // So just to be sure, a mutex is placed around it.
-  filter_diff_mutex.lock();
+  Filter_Diff_Interner interner;
+  vector <int> old_sequence;
+  vector <int> new_sequence;
+  filter_diff_words (oldstring, interner, old_sequence);
+  filter_diff_words (newstring, interner, new_sequence);
+  int newline_id = interner.intern (filter_diff_newline.data (), filter_diff_newline.size ());
 
   // Run the diff engine.
-  Diff <string> diff (old_sequence, new_sequence);
+  // See issue https://github.com/bibledit/cloud/issues/419
+  // The engine keeps all its state in the Diff object,
+  // so there is no need to serialize the diffs.
+  Diff <int> diff (old_sequence, new_sequence);
   diff.compose();
   
-  // Get the shortest edit distance.
-  stringstream result;
-  diff.printSES (result);
-
-  filter_diff_mutex.unlock();
-  
-  // Add html markup for bold and strikethrough.
-  vector <string> output = filter_string_explode (result.str (), '\n');
-  for (auto & line : output) {
-    if (line.empty ()) continue;
-    char indicator = line.front ();
-    line.erase (0, 1);
-    if (indicator == '+') {
-      if (additions) additions->push_back (line);
-      line.insert (0, "<span style=\"font-weight: bold;\"> ");
-      line.append (" </span>");
+  // Walk through the shortest edit script,
+  // and add html markup for bold and strikethrough.
+  string html;
+  html.reserve (oldstring.size () + newstring.size ());
+  bool first = true;
+  for (auto & element : diff.getSes ().getSequence ()) {
+    int id = element.first;
+    if (!first) html.append (" ");
+    first = false;
+    dtl::edit_t type = element.second.type;
+    if (type == dtl::SES_ADD) {
+      if (additions) additions->push_back (string (interner.data (id), interner.size (id)));
+      html.append ("<span style=\"font-weight: bold;\"> ");
     }
-    if (indicator == '-') {
-      if (removals) removals->push_back(line);
-      line.insert (0, "<span style=\"text-decoration: line-through;\"> ");
-      line.append (" </span>");
+    if (type == dtl::SES_DELETE) {
+      if (removals) removals->push_back (string (interner.data (id), interner.size (id)));
+      html.append ("<span style=\"text-decoration: line-through;\"> ");
     }
+    // Restore the new lines.
+    if (id == newline_id) html.append ("\n");
+    else html.append (interner.data (id), interner.size (id));
+    if (type != dtl::SES_COMMON) html.append (" </span>");
   }
   
-  // Resulting html.
-  string html = filter_string_implode (output, " ");
-  
-  // Restore the new lines.
-  html = filter_string_str_replace (filter_string_trim (newline), "\n", html);
-  
   return html;
 }
 
@@ -145,64 +204,49 @@ void filter_diff_diff_utf16 (const vector<string> & oldinput, const vector<strin
   new_line_diff_count = 0;
   
   // The sequences to compare.
-  vector <string> old_sequence = oldinput;
-  vector <string> new_sequence = newinput;
-
-  // Save the new lines.
-  string newline = "_newline_";
-  for (auto & s : old_sequence) {
-    s = filter_string_str_replace ("\n", newline, s);
-  }
-  for (auto & s : new_sequence) {
-    s = filter_string_str_replace ("\n", newline, s);
-  }
+  Filter_Diff_Interner interner;
+  vector <int> old_sequence;
+  vector <int> new_sequence;
+  old_sequence.reserve (oldinput.size ());
+  new_sequence.reserve (newinput.size ());
+  for (auto & s : oldinput) old_sequence.push_back (interner.intern (s.data (), s.size ()));
+  for (auto & s : newinput) new_sequence.push_back (interner.intern (s.data (), s.size ()));
 
   // Run the diff engine.
-  Diff <string> diff (old_sequence, new_sequence);
+  Diff <int> diff (old_sequence, new_sequence);
   diff.compose();
   
-  // Get the shortest edit distance.
-  stringstream result;
-  diff.printSES (result);
-
-  // Convert the new line place holder back to the original new line.
-  vector <string> differences = filter_string_explode (result.str (), '\n');
-  for (auto & s : differences) {
-    s = filter_string_str_replace (newline, "\n", s);
-  }
-
   // Convert the additions and deletions to a change set.
   int position = 0;
-  for (auto & line : differences) {
-    if (line.empty ()) continue;
-    char indicator = line.front ();
-    line.erase (0, 1);
+  for (auto & element : diff.getSes ().getSequence ()) {
+    string line (interner.data (element.first), interner.size (element.first));
+    dtl::edit_t type = element.second.type;
     // Get the size of the character in UTF-16, whether 1 or 2.
     string utf8 = unicode_string_substr (line, 0, 1);
     u16string utf16 = convert_to_u16string (utf8);
     size_t size = utf16.length();
-    if (indicator == '+') {
+    if (type == dtl::SES_ADD) {
       // Something to be inserted into the old sequence to get at the new sequence.
       positions.push_back(position);
       sizes.push_back((int)size);
       additions.push_back(true);
-      content.push_back(line);
+      // Check on number of changes in paragraphs.
+      if (line.substr(0, 1) == "\n") new_line_diff_count++;
+      content.push_back(move (line));
       // Something was inserted.
       // So increase the position to point to the next offset in the sequence from where to proceed.
       position += size;
-      // Check on number of changes in paragraphs.
-      if (line.substr(0, 1) == "\n") new_line_diff_count++;
     }
-    else if (indicator == '-') {
+    else if (type == dtl::SES_DELETE) {
       // Something to be deleted at the given position.
       positions.push_back(position);
       sizes.push_back((int)size);
       additions.push_back(false);
-      content.push_back(line);
       // Something was deleted.
       // So the position will remain to point to the same offset in the sequence from where to proceed.
       // Check on number of changes in paragraphs.
       if (line.substr(0, 1) == "\n") new_line_diff_count++;
+      content.push_back(move (line));
     }
     else {
       // No difference.
@@ -214,58 +258,44 @@ void filter_diff_diff_utf16 (const vector<string> & oldinput, const vector<strin
 }
 
 
+// Gives the percentage of the elements in the shortest edit script of $diff that the old and new sequences have in common.
+template <typename T>
+int filter_diff_similarity (Diff <T> & diff)
+{
+  // Calculate the total elements compared, and the total differences found.
+  int element_count = 0;
+  int similar_count = 0;
+  for (auto & element : diff.getSes ().getSequence ()) {
+    element_count++;
+    if (element.second.type == dtl::SES_COMMON) similar_count++;
+  }
+  
+  // Calculate the percentage similarity.
+  int percentage = round (100 * ((float) similar_count / (float) element_count));
+  return percentage;
+}
+
+
 // This calculates the similarity between the old and new strings.
 // It works at the character level.
 // It returns the similarity as a percentage.
 // 100% means that the text is completely similar.
 // And 0% means that the text is completely different.
 // The output ranges from 0 to 100%.
-int filter_diff_character_similarity (string oldstring, string newstring)
+int filter_diff_character_similarity (const string & oldstring, const string & newstring)
 {
   try {
    
-    // Split the input up into unicode characers.
-    vector <string> old_sequence;
-    vector <string> new_sequence;
-    size_t oldlength = oldstring.size();
-    for (size_t i = 0; i < oldlength; i++) {
-      old_sequence.push_back (oldstring.substr (i, 1));
-    }
-    size_t newlength = newstring.size();
-    for (size_t i = 0; i < newlength; i++) {
-      new_sequence.push_back (newstring.substr (i, 1));
-    }
-
-    // See issue https://github.com/bibledit/cloud/issues/419
-    // It is unclear at this time whether the code below
-    // to find the differences between texts, is thread-safe.
-    // So just to be sure, a mutex is placed around it.
-    filter_diff_mutex.lock();
+    // Split the input up into bytes.
+    // Comparing bytes gives the same result as comparing strings of one byte each.
+    vector <char> old_sequence (oldstring.begin (), oldstring.end ());
+    vector <char> new_sequence (newstring.begin (), newstring.end ());
 
     // Run the diff engine.
-    Diff <string> diff (old_sequence, new_sequence);
+    Diff <char> diff (old_sequence, new_sequence);
     diff.compose();
     
-    // Get the shortest edit distance.
-    stringstream result;
-    diff.printSES (result);
-
-    filter_diff_mutex.unlock();
-    
-    // Calculate the total elements compared, and the total differences found.
-    int element_count = 0;
-    int similar_count = 0;
-    vector <string> output = filter_string_explode (result.str(), '\n');
-    for (auto & line : output) {
-      if (line.empty ()) continue;
-      element_count++;
-      char indicator = line.front ();
-      if (indicator == ' ') similar_count++;
-    }
-    
-    // Calculate the percentage similarity.
-    int percentage = round (100 * ((float) similar_count / (float) element_count));
-    return percentage;
+    return filter_diff_similarity (diff);
     
   } catch (...) {
   }
@@ -285,43 +315,19 @@ int filter_diff_character_similarity (string oldstring, string newstring)
 int filter_diff_word_similarity (string oldstring, string newstring)
 {
   // Split the input up into words separated by spaces.
-  vector <string> old_sequence;
-  vector <string> new_sequence;
   oldstring = filter_string_str_replace ("\n", " ", oldstring);
   newstring = filter_string_str_replace ("\n", " ", newstring);
-  old_sequence = filter_string_explode (oldstring, ' ');
-  new_sequence = filter_string_explode (newstring, ' ');
+  Filter_Diff_Interner interner;
+  vector <int> old_sequence;
+  vector <int> new_sequence;
+  filter_diff_words (oldstring, interner, old_sequence);
+  filter_diff_words (newstring, interner, new_sequence);
   
-  // See issue https://github.com/bibledit/cloud/issues/419
-  // It is unclear at this time whether the code below
-  // to find the differences between texts, is thread-safe.
-  // So just to be sure, a mutex is placed around it.
-  filter_diff_mutex.lock();
-
   // Run the diff engine.
-  Diff <string> diff (old_sequence, new_sequence);
+  Diff <int> diff (old_sequence, new_sequence);
   diff.compose();
   
-  // Get the shortest edit distance.
-  stringstream result;
-  diff.printSES (result);
-
-  filter_diff_mutex.unlock();
-  
-  // Calculate the total elements compared, and the total differences found.
-  int element_count = 0;
-  int similar_count = 0;
-  vector <string> output = filter_string_explode (result.str(), '\n');
-  for (auto & line : output) {
-    if (line.empty ()) continue;
-    element_count++;
-    char indicator = line.front ();
-    if (indicator == ' ') similar_count++;
-  }
-  
-  // Calculate the percentage similarity.
-  int percentage = round (100 * ((float) similar_count / (float) element_count));
-  return percentage;
+  return filter_diff_similarity (diff);
 }
 
 
@@ -356,15 +362,17 @@ void filter_diff_produce_verse_level (string bible, string directory)
       // Go through the combined verse numbers in the old and new chapter.
       string old_chapter_usfm = database_modifications.getTeamDiff (bible, book, chapter);
       string new_chapter_usfm = request.database_bibles()->getChapter (bible, book, chapter);
-      vector <int> old_verse_numbers = usfm_get_verse_numbers (old_chapter_usfm);
-      vector <int> new_verse_numbers = usfm_get_verse_numbers (new_chapter_usfm);
+      Filter_Usfm_Chapter old_chapter (old_chapter_usfm);
+      Filter_Usfm_Chapter new_chapter (new_chapter_usfm);
+      vector <int> old_verse_numbers = old_chapter.verse_numbers ();
+      vector <int> new_verse_numbers = new_chapter.verse_numbers ();
       vector <int> verses = old_verse_numbers;
       verses.insert (verses.end (), new_verse_numbers.begin (), new_verse_numbers.end ());
       verses = array_unique (verses);
       sort (verses.begin(), verses.end());
       for (auto verse : verses) {
-        string old_verse_text = usfm_get_verse_text (old_chapter_usfm, verse);
-        string new_verse_text = usfm_get_verse_text (new_chapter_usfm, verse);
+        string old_verse_text = old_chapter.verse_text (verse);
+        string new_verse_text = new_chapter.verse_text (verse);
         if (old_verse_text != new_verse_text) {
           string usfmCode = "\\p " + bookname + " " + convert_to_string (chapter) + "." + convert_to_string (verse) + ": " + old_verse_text;
           old_vs_usfm.push_back (usfmCode);
@@ -409,3 +417,37 @@ void filter_diff_run_file (string oldfile, string newfile, string outputfile)
   
   filter_url_file_put_contents (outputfile, differences);
 }
+
+
+// Gives the $text as a delta against the $base.
+// A saved chapter differs from the chapter before the save in one place, usually.
+// So the delta gives the lengths of the parts at the start and at the end that are the same,
+// and then the bytes that are different in between.
+string filter_diff_delta (const string & base, const string & text)
+{
+  size_t limit = min (base.size (), text.size ());
+  size_t prefix = 0;
+  while ((prefix < limit) && (base [prefix] == text [prefix])) prefix++;
+  size_t suffix = 0;
+  while ((suffix < limit - prefix) && (base [base.size () - 1 - suffix] == text [text.size () - 1 - suffix])) suffix++;
+  string delta = convert_to_string (prefix) + " " + convert_to_string (suffix) + " ";
+  delta.append (text, prefix, text.size () - prefix - suffix);
+  return delta;
+}
+
+
+// Gives the text back from the $base and the $delta made by the function above.
+string filter_diff_apply_delta (const string & base, const string & delta)
+{
+  size_t space1 = delta.find (' ');
+  if (space1 == string::npos) return "";
+  size_t space2 = delta.find (' ', space1 + 1);
+  if (space2 == string::npos) return "";
+  size_t prefix = convert_to_int (delta.substr (0, space1));
+  size_t suffix = convert_to_int (delta.substr (space1 + 1, space2 - space1 - 1));
+  if (prefix + suffix > base.size ()) return "";
+  string text = base.substr (0, prefix);
+  text.append (delta, space2 + 1, string::npos);
+  text.append (base, base.size () - suffix, suffix);
+  return text;
+}
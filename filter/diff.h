@@ -24,7 +24,7 @@
 #include <config/libraries.h>
 
 
-string filter_diff_diff (string oldstring, string newstring,
+string filter_diff_diff (const string & oldstring, const string & newstring,
                          vector <string> * removals = nullptr,
                          vector <string> * additions = nullptr);
 void filter_diff_diff_utf16 (const vector<string> & oldinput, const vector<string> & newinput,
@@ -33,10 +33,12 @@ void filter_diff_diff_utf16 (const vector<string> & oldinput, const vector<strin
                              vector <bool> & additions,
                              vector <string> & content,
                              int & new_line_diff_count);
-int filter_diff_character_similarity (string oldstring, string newstring);
+int filter_diff_character_similarity (const string & oldstring, const string & newstring);
 int filter_diff_word_similarity (string oldstring, string newstring);
 void filter_diff_produce_verse_level (string bible, string directory);
 void filter_diff_run_file (string oldfile, string newfile, string outputfile);
+string filter_diff_delta (const string & base, const string & text);
+string filter_diff_apply_delta (const string & base, const string & delta);
 
 
 #endif
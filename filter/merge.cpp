@@ -29,9 +29,6 @@ using dtl::Diff3;
 using namespace pugi;
 
 
-static mutex filter_merge_mutex;
-
-
 // This uses the dtl:: library for merge in C++.
 // At times the library failed to merge.
 // It was tried whether the Linux "merge" command was able to successfully merge such cases.
@@ -39,68 +36,171 @@ static mutex filter_merge_mutex;
 // The conclusion therefore is that the C++ merge library is equivalent in quality.
 
 
-// merge - three-way merge.
-// Merge is useful for combining separate changes to an original.
-// The function normally returns the merged text.
-// If case of conflicts, it returns an empty container.
-vector <string> filter_merge_merge (const vector <string>& base, const vector <string>& user, const vector <string>& server)
+// The merge does not work on the text itself.
+// It tokenizes the text at three levels of granularity:
+// 1. Lines.
+// 2. Words, with the new lines as separate words.
+// 3. Graphemes, with the new lines as separate graphemes.
+// Each distinct token is given an integer, and the merge engine works on those integers.
+// A finer level is tokenized only when the merge at the coarser level conflicts.
+enum { filter_merge_lines, filter_merge_words, filter_merge_graphemes };
+
+
+// A token is a range of characters in one of the texts.
+// Tokens are looked up by their range, so looking them up does not allocate strings.
+class Filter_Merge_Range
 {
-  // See issue https://github.com/bibledit/cloud/issues/418
-  // It is unclear at this time whether the code below
-  // to find the differences between texts, is thread-safe.
-  // So just to be sure, a mutex is placed around it.
-  filter_merge_mutex.lock();
+public:
+  const char * data;
+  size_t size;
+  bool operator == (const Filter_Merge_Range & range) const
+  {
+    return (size == range.size) && (memcmp (data, range.data, size) == 0);
+  }
+};
 
-  vector <string> user_sequence (user);
-  vector <string> base_sequence (base);
-  vector <string> server_sequence (server);
 
-  Diff3 <string, vector <string>> diff3 (user_sequence, base_sequence, server_sequence);
-  diff3.compose ();
-  bool merged = diff3.merge ();
-  filter_merge_mutex.unlock();
-  if (!merged) {
-    return {};
+class Filter_Merge_Range_Hash
+{
+public:
+  // The FNV-1a hash of the characters in the range.
+  size_t operator () (const Filter_Merge_Range & range) const
+  {
+    size_t hash = 2166136261u;
+    for (size_t i = 0; i < range.size; i++) {
+      hash ^= (unsigned char) range.data [i];
+      hash *= 16777619u;
+    }
+    return hash;
   }
-  return diff3.getMergedSequence ();
+};
+
+
+class Filter_Merge_Tokens
+{
+public:
+  Filter_Merge_Tokens (const string & base, const string & change, const string & prioritized_change);
+  bool merge (int level, string & result);
+private:
+  const string * texts [3];
+  int intern (const char * data, size_t size);
+  void tokenize (int level, const string & text, vector <int> & ids);
+  unordered_map <Filter_Merge_Range, int, Filter_Merge_Range_Hash> ids;
+  vector <Filter_Merge_Range> tokens;
+};
+
+
+// The marker for a new line in the word and the grapheme sequences.
+static const string filter_merge_new_line = " new__line ";
+
+
+bool filter_merge_merge (const vector <int>& base, const vector <int>& user, const vector <int>& server, vector <int> & result);
+
+
+Filter_Merge_Tokens::Filter_Merge_Tokens (const string & base, const string & change, const string & prioritized_change)
+{
+  texts [0] = &base;
+  texts [1] = &change;
+  texts [2] = &prioritized_change;
 }
 
 
-string filter_merge_lines2words (string data)
+int Filter_Merge_Tokens::intern (const char * data, size_t size)
 {
-  data = filter_string_str_replace ("\n", " new__line ", data);
-  data = filter_string_str_replace (" ", "\n", data);
-  return data;
+  Filter_Merge_Range range = { data, size };
+  auto result = ids.emplace (range, (int) tokens.size ());
+  if (result.second) tokens.push_back (range);
+  return result.first->second;
 }
 
 
-string filter_merge_words2lines (string data)
+// Tokenizes the $text at the $level of granularity into the $ids.
+// The tokens are the same as those of the following conversions:
+// Lines: The text exploded on the new line.
+// Words: The text with each new line replaced with " new__line ", exploded on the space.
+// Graphemes: The text with each new line replaced with " new__line ", split into Unicode points.
+void Filter_Merge_Tokens::tokenize (int level, const string & text, vector <int> & ids)
 {
-  data = filter_string_str_replace ("\n", " ", data);
-  data = filter_string_str_replace (" new__line ", "\n", data);
-  return data;
+  const char * data = text.data ();
+  size_t length = text.size ();
+  size_t start = 0;
+  size_t position = 0;
+  while (position < length) {
+    unsigned char c = data [position];
+    if (c == '\n') {
+      if (level == filter_merge_graphemes) {
+        for (size_t i = 0; i < filter_merge_new_line.size (); i++) {
+          ids.push_back (intern (filter_merge_new_line.data () + i, 1));
+        }
+      } else {
+        ids.push_back (intern (data + start, position - start));
+        if (level == filter_merge_words) {
+          ids.push_back (intern (filter_merge_new_line.data () + 1, filter_merge_new_line.size () - 2));
+        }
+        start = position + 1;
+      }
+      position++;
+      continue;
+    }
+    if (level != filter_merge_graphemes) {
+      if ((c == ' ') && (level == filter_merge_words)) {
+        ids.push_back (intern (data + start, position - start));
+        start = position + 1;
+      }
+      position++;
+      continue;
+    }
+    // The number of bytes of this UTF-8 sequence.
+    size_t size = 1;
+    if ((c & 0xe0) == 0xc0) size = 2;
+    else if ((c & 0xf0) == 0xe0) size = 3;
+    else if ((c & 0xf8) == 0xf0) size = 4;
+    if (position + size > length) size = length - position;
+    ids.push_back (intern (data + position, size));
+    position += size;
+  }
+  // A trailing separator does not give an empty token.
+  if ((level != filter_merge_graphemes) && (start < length)) ids.push_back (intern (data + start, length - start));
 }
 
 
-string filter_merge_lines2graphemes (string data)
+// Tokenizes the texts at the $level of granularity and merges them.
+// On success it returns true and gives the merged text in $result.
+bool Filter_Merge_Tokens::merge (int level, string & result)
 {
-  data = filter_string_str_replace ("\n", " new__line ", data);
-  string data2;
-  size_t count = unicode_string_length (data);
-  for (size_t i = 0; i < count; i++) {
-    string grapheme = unicode_string_substr (data, i, 1);
-    data2.append (grapheme);
-    data2.append ("\n");
+  vector <int> sequences [3];
+  for (int i = 0; i < 3; i++) tokenize (level, * texts [i], sequences [i]);
+  vector <int> merged;
+  if (!filter_merge_merge (sequences [0], sequences [1], sequences [2], merged)) return false;
+  // Join the merged tokens with the separator they were split on.
+  result.clear ();
+  for (size_t i = 0; i < merged.size (); i++) {
+    if (i) {
+      if (level == filter_merge_lines) result.append ("\n");
+      if (level == filter_merge_words) result.append (" ");
+    }
+    const Filter_Merge_Range & token = tokens [merged [i]];
+    result.append (token.data, token.size);
   }
-  return data2;
+  if (level != filter_merge_lines) result = filter_string_str_replace (filter_merge_new_line, "\n", result);
+  return true;
 }
 
 
-string filter_merge_graphemes2lines (string data)
+// merge - three-way merge.
+// Merge is useful for combining separate changes to an original.
+// The function normally returns true and gives the merged sequence.
+// If case of conflicts, or if the merged sequence is empty, it returns false.
+bool filter_merge_merge (const vector <int>& base, const vector <int>& user, const vector <int>& server, vector <int> & result)
 {
-  data = filter_string_str_replace ("\n", "", data);
-  data = filter_string_str_replace (" new__line ", "\n", data);
-  return data;
+  // See issue https://github.com/bibledit/cloud/issues/418
+  // The merge engine keeps all its state in the Diff3 object,
+  // so merges can run in parallel.
+  Diff3 <int, vector <int>> diff3 (user, base, server);
+  diff3.compose ();
+  if (!diff3.merge ()) return false;
+  result = diff3.getMergedSequence ();
+  return !result.empty ();
 }
 
 
@@ -169,7 +269,7 @@ void filter_merge_detect_conflict (string base, string change, string prioritize
 // $prioritized_change: Data as modified by a user but prioritized.
 // The filter uses a three-way merge algorithm.
 // There should be one unchanged segment (either a line or word) between the modifications.
-// If necessary it converts the data into a new format with one character per line for more fine-grained merging.
+// If necessary it merges at the finer granularity of words, and then of graphemes.
 // In case of a conflict, it prioritizes changes from $prioritized_change.
 // The filter returns the merged data.
 // If $clever, it calls a more clever routine when it fails to merge.
@@ -183,44 +283,14 @@ string filter_merge_run (string base, string change, string prioritized_change,
   prioritized_change = filter_string_trim (prioritized_change);
 
   // Try a standard line-based merge. Should be sufficient for most cases.
-  vector <string> baselines = filter_string_explode (base, '\n');
-  vector <string> userlines = filter_string_explode (change, '\n');
-  vector <string> serverlines = filter_string_explode (prioritized_change, '\n');
-  vector <string> results = filter_merge_merge (baselines, userlines, serverlines);
-  if (!results.empty ()) {
-    string result = filter_string_implode (results, "\n");
-    filter_merge_detect_conflict (base, change, prioritized_change, result, conflicts);
-    return result;
-  }
-
-  // Convert the data to one word per line, and try to merge again.
-  string baseWords = filter_merge_lines2words (base);
-  string userWords = filter_merge_lines2words (change);
-  string serverWords = filter_merge_lines2words (prioritized_change);
-  baselines = filter_string_explode (baseWords, '\n');
-  userlines = filter_string_explode (userWords, '\n');
-  serverlines = filter_string_explode (serverWords, '\n');
-  results = filter_merge_merge (baselines, userlines, serverlines);
-  if (!results.empty ()) {
-    string mergedWords = filter_string_implode (results, "\n");
-    string result = filter_merge_words2lines (mergedWords);
-    filter_merge_detect_conflict (base, change, prioritized_change, result, conflicts);
-    return result;
-  }
-
-  // Convert the data so it has one grapheme per line, and try again.
-  string baseGraphemes = filter_merge_lines2graphemes (base);
-  string userGraphemes = filter_merge_lines2graphemes (change);
-  string serverGraphemes = filter_merge_lines2graphemes (prioritized_change);
-  baselines = filter_string_explode (baseGraphemes, '\n');
-  userlines = filter_string_explode (userGraphemes, '\n');
-  serverlines = filter_string_explode (serverGraphemes, '\n');
-  results = filter_merge_merge (baselines, userlines, serverlines);
-  if (!results.empty ()) {
-    string mergedGraphemes = filter_string_implode (results, "\n");
-    string result = filter_merge_graphemes2lines (mergedGraphemes);
-    filter_merge_detect_conflict (base, change, prioritized_change, result, conflicts);
-    return result;
+  // If that fails, merge the data with one word per token, and then with one grapheme per token.
+  Filter_Merge_Tokens tokens (base, change, prioritized_change);
+  for (int level : { filter_merge_lines, filter_merge_words, filter_merge_graphemes }) {
+    string result;
+    if (tokens.merge (level, result)) {
+      filter_merge_detect_conflict (base, change, prioritized_change, result, conflicts);
+      return result;
+    }
   }
 
   if (clever) {
@@ -249,7 +319,10 @@ string filter_merge_run_clever (string base, string change, string prioritized_c
                                 vector <Merge_Conflict> & conflicts)
 {
   // Get the verse numbers in the changed text.
-  vector <int> verses = usfm_get_verse_numbers (change);
+  Filter_Usfm_Chapter base_chapter (base);
+  Filter_Usfm_Chapter change_chapter (change);
+  Filter_Usfm_Chapter prioritized_change_chapter (prioritized_change);
+  vector <int> verses = change_chapter.verse_numbers ();
   
   vector <string> results;
   
@@ -259,9 +332,9 @@ string filter_merge_run_clever (string base, string change, string prioritized_c
   for (auto verse : verses) {
     
     // Gets the texts to merge for this verse.
-    string base_text = usfm_get_verse_text (base, verse);
-    string change_text = usfm_get_verse_text (change, verse);
-    string prioritized_change_text = usfm_get_verse_text (prioritized_change, verse);
+    string base_text = base_chapter.verse_text (verse);
+    string change_text = change_chapter.verse_text (verse);
+    string prioritized_change_text = prioritized_change_chapter.verse_text (verse);
     
     // Check for combined verses.
     if (change_text == previous_change) continue;
@@ -0,0 +1,253 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <filter/metrics.h>
+#include <filter/url.h>
+#include <filter/date.h>
+
+
+// The upper bounds of the buckets of the latency histograms, in microseconds.
+vector <long> filter_metrics_bounds ()
+{
+  return { 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000 };
+}
+
+
+// Routes beyond this number are counted together, so that odd addresses cannot fill the memory.
+#define FILTER_METRICS_MAXIMUM_ROUTES 300
+// The number of recent traces kept.
+#define FILTER_METRICS_MAXIMUM_TRACES 50
+// The number of spans kept per trace.
+#define FILTER_METRICS_MAXIMUM_SPANS 1000
+
+
+mutex filter_metrics_mutex;
+map <string, Filter_Metrics_Route> filter_metrics_statistics;
+vector <Filter_Metrics_Trace> filter_metrics_recent_traces;
+atomic <int> filter_metrics_requests_in_flight (0);
+atomic <bool> filter_metrics_tracing (false);
+// The trace of the request the current thread handles.
+static thread_local Filter_Metrics_Trace * filter_metrics_current_trace = nullptr;
+
+
+Filter_Metrics_Timer::Filter_Metrics_Timer (const char * kind, const string & detail)
+{
+  trace = filter_metrics_current_trace;
+  if (!trace) return;
+  if (trace->spans.size () >= FILTER_METRICS_MAXIMUM_SPANS) {
+    trace = nullptr;
+    return;
+  }
+  span = trace->spans.size ();
+  Filter_Metrics_Span element;
+  element.kind = kind;
+  element.detail = detail.substr (0, 200);
+  element.start = filter_date_elapsed_microseconds (trace->start);
+  trace->spans.push_back (element);
+}
+
+
+Filter_Metrics_Timer::~Filter_Metrics_Timer ()
+{
+  if (!trace) return;
+  Filter_Metrics_Span & element = trace->spans [span];
+  element.microseconds = filter_date_elapsed_microseconds (trace->start) - element.start;
+}
+
+
+// Gives the route under which to count a request for $get.
+// All files, like stylesheets, scripts, and images, are counted together.
+string filter_metrics_route (const string & get)
+{
+  string route = get;
+  if (!route.empty () && (route [0] == '/')) route.erase (0, 1);
+  if (!filter_url_get_extension (route).empty ()) return "files";
+  return route;
+}
+
+
+// The route under which to count the requests for URLs that no page handles.
+const char * filter_metrics_unknown_route ()
+{
+  return "unknown";
+}
+
+
+// To be called when the web server starts to handle a request for $route.
+void filter_metrics_begin (const string & route)
+{
+  filter_metrics_requests_in_flight++;
+  if (filter_metrics_tracing) {
+    delete filter_metrics_current_trace;
+    filter_metrics_current_trace = new Filter_Metrics_Trace;
+    filter_metrics_current_trace->route = route;
+    filter_metrics_current_trace->start = filter_date_elapsed_microseconds (0);
+  }
+}
+
+
+// To be called when the web server has handled a request for $route.
+// It took $microseconds, and it received $bytes_in and sent $bytes_out.
+void filter_metrics_end (const string & route, long microseconds, long bytes_in, long bytes_out)
+{
+  filter_metrics_requests_in_flight--;
+
+  static vector <long> bounds = filter_metrics_bounds ();
+  size_t bucket = 0;
+  while ((bucket < bounds.size ()) && (microseconds > bounds [bucket])) bucket++;
+
+  lock_guard <mutex> lock (filter_metrics_mutex);
+
+  string key = route;
+  if (!filter_metrics_statistics.count (key)) {
+    if (filter_metrics_statistics.size () >= FILTER_METRICS_MAXIMUM_ROUTES) key = "other";
+  }
+  Filter_Metrics_Route & statistics = filter_metrics_statistics [key];
+  if (statistics.buckets.empty ()) statistics.buckets.resize (bounds.size () + 1, 0);
+  statistics.count++;
+  statistics.microseconds += microseconds;
+  statistics.maximum = max (statistics.maximum, microseconds);
+  statistics.bytes_in += bytes_in;
+  statistics.bytes_out += bytes_out;
+  statistics.buckets [bucket]++;
+
+  if (filter_metrics_current_trace) {
+    filter_metrics_current_trace->route = key;
+    filter_metrics_current_trace->microseconds = microseconds;
+    filter_metrics_recent_traces.insert (filter_metrics_recent_traces.begin (), move (* filter_metrics_current_trace));
+    if (filter_metrics_recent_traces.size () > FILTER_METRICS_MAXIMUM_TRACES) {
+      filter_metrics_recent_traces.pop_back ();
+    }
+    delete filter_metrics_current_trace;
+    filter_metrics_current_trace = nullptr;
+  }
+}
+
+
+// The number of requests the web server is handling right now.
+int filter_metrics_in_flight ()
+{
+  return filter_metrics_requests_in_flight;
+}
+
+
+// Gives a copy of the statistics per route.
+map <string, Filter_Metrics_Route> filter_metrics_routes ()
+{
+  lock_guard <mutex> lock (filter_metrics_mutex);
+  return filter_metrics_statistics;
+}
+
+
+// Estimates the latency in microseconds within which the $percentage of the requests to a $route was handled.
+// This is the upper bound of the bucket of the histogram in which that percentile falls.
+long filter_metrics_percentile (const Filter_Metrics_Route & route, int percentage)
+{
+  vector <long> bounds = filter_metrics_bounds ();
+  long needed = (route.count * percentage + 99) / 100;
+  long cumulative = 0;
+  for (size_t i = 0; i < route.buckets.size (); i++) {
+    cumulative += route.buckets [i];
+    if (cumulative >= needed) {
+      if (i < bounds.size ()) return min (bounds [i], route.maximum);
+      break;
+    }
+  }
+  return route.maximum;
+}
+
+
+// Switches the tracing of the parts of the requests on or off.
+void filter_metrics_set_tracing (bool tracing)
+{
+  filter_metrics_tracing = tracing;
+}
+
+
+bool filter_metrics_get_tracing ()
+{
+  return filter_metrics_tracing;
+}
+
+
+// Gives the traces of the most recent requests, the newest first.
+vector <Filter_Metrics_Trace> filter_metrics_traces ()
+{
+  lock_guard <mutex> lock (filter_metrics_mutex);
+  return filter_metrics_recent_traces;
+}
+
+
+// Clears the statistics and the traces.
+void filter_metrics_clear ()
+{
+  lock_guard <mutex> lock (filter_metrics_mutex);
+  filter_metrics_statistics.clear ();
+  filter_metrics_recent_traces.clear ();
+}
+
+
+// Gives the $microseconds as seconds, without trailing zeroes.
+static string filter_metrics_seconds (long microseconds)
+{
+  string seconds = to_string (microseconds / 1000000) + "." + to_string (1000000 + microseconds % 1000000).substr (1);
+  while (seconds.back () == '0') seconds.pop_back ();
+  if (seconds.back () == '.') seconds.pop_back ();
+  return seconds;
+}
+
+
+// Gives the statistics in the text format that Prometheus scrapes.
+string filter_metrics_prometheus ()
+{
+  vector <long> bounds = filter_metrics_bounds ();
+  map <string, Filter_Metrics_Route> routes = filter_metrics_routes ();
+  string text;
+
+  text.append ("# HELP bibledit_http_request_duration_seconds The time taken to respond to the requests per route.\n");
+  text.append ("# TYPE bibledit_http_request_duration_seconds histogram\n");
+  for (auto & element : routes) {
+    string label = "route=\"" + element.first + "\"";
+    long cumulative = 0;
+    for (size_t i = 0; i < element.second.buckets.size (); i++) {
+      cumulative += element.second.buckets [i];
+      string bound = (i < bounds.size ()) ? filter_metrics_seconds (bounds [i]) : "+Inf";
+      text.append ("bibledit_http_request_duration_seconds_bucket{" + label + ",le=\"" + bound + "\"} " + to_string (cumulative) + "\n");
+    }
+    text.append ("bibledit_http_request_duration_seconds_sum{" + label + "} " + filter_metrics_seconds (element.second.microseconds) + "\n");
+    text.append ("bibledit_http_request_duration_seconds_count{" + label + "} " + to_string (element.second.count) + "\n");
+  }
+
+  text.append ("# HELP bibledit_http_received_bytes_total The bytes received in the requests per route.\n");
+  text.append ("# TYPE bibledit_http_received_bytes_total counter\n");
+  for (auto & element : routes) {
+    text.append ("bibledit_http_received_bytes_total{route=\"" + element.first + "\"} " + to_string (element.second.bytes_in) + "\n");
+  }
+
+  text.append ("# HELP bibledit_http_sent_bytes_total The bytes sent in the responses per route.\n");
+  text.append ("# TYPE bibledit_http_sent_bytes_total counter\n");
+  for (auto & element : routes) {
+    text.append ("bibledit_http_sent_bytes_total{route=\"" + element.first + "\"} " + to_string (element.second.bytes_out) + "\n");
+  }
+
+  text.append ("# HELP bibledit_http_requests_in_flight The requests being handled right now.\n");
+  text.append ("# TYPE bibledit_http_requests_in_flight gauge\n");
+  text.append ("bibledit_http_requests_in_flight " + to_string (filter_metrics_in_flight ()) + "\n");
+
+  return text;
+}
@@ -0,0 +1,91 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef INCLUDED_FILTER_METRICS_H
+#define INCLUDED_FILTER_METRICS_H
+
+
+#include <config/libraries.h>
+
+
+// The statistics of the requests to one route of the web server.
+class Filter_Metrics_Route
+{
+public:
+  long count = 0;
+  long microseconds = 0;
+  long maximum = 0;
+  long bytes_in = 0;
+  long bytes_out = 0;
+  // The number of requests per bucket of the histogram, the last bucket being unbounded.
+  vector <long> buckets;
+};
+
+
+// One timed part of a traced request.
+class Filter_Metrics_Span
+{
+public:
+  string kind;
+  string detail;
+  // Start relative to the start of the request, and duration, both in microseconds.
+  long start = 0;
+  long microseconds = 0;
+};
+
+
+// A traced request, with the timed parts it consists of.
+class Filter_Metrics_Trace
+{
+public:
+  string route;
+  long start = 0;
+  long microseconds = 0;
+  vector <Filter_Metrics_Span> spans;
+};
+
+
+// Times a part of the request being handled by the current thread, while tracing is on.
+// Without tracing, or outside of a request, it does nothing.
+class Filter_Metrics_Timer
+{
+public:
+  Filter_Metrics_Timer (const char * kind, const string & detail);
+  ~Filter_Metrics_Timer ();
+private:
+  Filter_Metrics_Trace * trace;
+  size_t span;
+};
+
+
+vector <long> filter_metrics_bounds ();
+string filter_metrics_route (const string & get);
+const char * filter_metrics_unknown_route ();
+void filter_metrics_begin (const string & route);
+void filter_metrics_end (const string & route, long microseconds, long bytes_in, long bytes_out);
+int filter_metrics_in_flight ();
+map <string, Filter_Metrics_Route> filter_metrics_routes ();
+long filter_metrics_percentile (const Filter_Metrics_Route & route, int percentage);
+void filter_metrics_set_tracing (bool tracing);
+bool filter_metrics_get_tracing ();
+vector <Filter_Metrics_Trace> filter_metrics_traces ();
+void filter_metrics_clear ();
+string filter_metrics_prometheus ();
+
+
+#endif
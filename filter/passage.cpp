@@ -199,7 +199,8 @@ int filter_passage_interpret_book (string book)
   }
 
   // Recognise the USFM book abbreviations.
-  identifier = Database_Books::getIdFromUsfm (book);
+  // The $book is in lower case by now, so ignore the case.
+  identifier = Database_Books::getIdFromUsfmIgnoringCase (book);
   if (identifier) return identifier;
 
   // Try the OSIS abbreviations.
@@ -136,7 +136,7 @@ void Filter_Text::run (string stylesheet)
   usfmMarkersAndTextPointer = 0;
   chapterUsfmMarkersAndText.clear();
   chapterUsfmMarkersAndTextPointer = 0;
-  styles.clear();
+  styles.reset ();
   chapterMarker.clear();
   createdStyles.clear();
 }
@@ -164,9 +164,9 @@ void Filter_Text::getUsfmNextChapter ()
   // Deal with the unlikely case that the chapter marker is non-standard.
   if (chapterMarker.empty()) {
     chapterMarker = "c";
-    for (const auto & style : styles) {
-      if (style.second.type == StyleTypeChapterNumber) {
-        chapterMarker = style.second.marker;
+    for (const auto & style : styles->items) {
+      if (style.type == StyleTypeChapterNumber) {
+        chapterMarker = style.marker;
         break;
       }
     }
@@ -192,17 +192,14 @@ void Filter_Text::getUsfmNextChapter ()
 // and stores them in the object for quicker access.
 void Filter_Text::getStyles (string stylesheet)
 {
-  styles.clear();
   // Get the relevant styles information included.
   if (odf_text_standard) odf_text_standard->createPageBreakStyle ();
   if (odf_text_text_only) odf_text_text_only->createPageBreakStyle ();
   if (odf_text_text_and_note_citations) odf_text_text_and_note_citations->createPageBreakStyle ();
   if (odf_text_text_and_note_citations) odf_text_text_and_note_citations->createSuperscriptStyle ();
   Database_Styles database_styles;
-  vector <string> markers = database_styles.getMarkers (stylesheet);
-  for (auto marker : markers) {
-    Database_Styles_Item style = database_styles.getMarkerData (stylesheet, marker);
-    styles [marker] = style;
+  styles = database_styles.compile (stylesheet);
+  for (auto & style : styles->items) {
     if (style.type == StyleTypeFootEndNote) {
       if (style.subtype == FootEndNoteSubtypeStandardContent) {
         standardContentMarkerFootEndNote = style.marker;
@@ -231,8 +228,8 @@ void Filter_Text::preprocessingStage ()
         string marker = filter_string_trim (currentItem); // Change, e.g. '\id ' to '\id'.
         marker = marker.substr (1); // Remove the initial backslash, e.g. '\id' becomes 'id'.
         if (usfm_is_opening_marker (marker)) {
-          if (styles.find (marker) != styles.end()) {
-            Database_Styles_Item style = styles [marker];
+          if (const Database_Styles_Item * found = styles->find (marker)) {
+            const Database_Styles_Item & style = * found;
             switch (style.type) {
               case StyleTypeIdentifier:
                 switch (style.subtype) {
@@ -382,9 +379,9 @@ void Filter_Text::processUsfm ()
         bool isEmbeddedMarker = usfm_is_embedded_marker (currentItem);
         // Clean up the marker, so we remain with the basic version, e.g. 'id'.
         string marker = usfm_get_marker (currentItem);
-        if (styles.find (marker) != styles.end())
+        if (const Database_Styles_Item * found = styles->find (marker))
         {
-          Database_Styles_Item style = styles [marker];
+          const Database_Styles_Item & style = * found;
           switch (style.type)
           {
             case StyleTypeIdentifier:
@@ -406,6 +403,7 @@ void Filter_Text::processUsfm ()
                   // Reset chapter and verse numbers.
                   currentChapterNumber = 0;
                   currentVerseNumber = "0";
+                  if (text_text) text_text->verse (0);
                   // Throw away whatever follows the \id, e.g. 'GEN xxx xxx'.
                   usfm_get_text_following_marker (chapterUsfmMarkersAndText, chapterUsfmMarkersAndTextPointer);
                   // Whether to insert a new page before the book. But never before the first book.
@@ -618,6 +616,7 @@ void Filter_Text::processUsfm ()
               // Update this object.
               currentChapterNumber = inumber;
               currentVerseNumber = "0";
+              if (text_text) text_text->verse (0);
 
               // If there is a published chapter character, the chapter number takes that value.
               for (auto publishedChapterMarker : publishedChapterMarkers) {
@@ -699,7 +698,7 @@ void Filter_Text::processUsfm ()
               // Open a paragraph for the notes.
               // It takes the style of the footnote content marker, usually 'ft'.
               // This is done specifically for the version that has the notes only.
-              ensureNoteParagraphStyle (standardContentMarkerFootEndNote, styles[standardContentMarkerFootEndNote]);
+              ensureNoteParagraphStyle (standardContentMarkerFootEndNote, styles->get (standardContentMarkerFootEndNote));
               if (odf_text_notes) odf_text_notes->newParagraph (standardContentMarkerFootEndNote);
               // UserBool2ChapterInLeftRunningHeader -> no headings implemented yet.
               // UserBool3ChapterInRightRunningHeader -> no headings implemented yet.
@@ -775,6 +774,7 @@ void Filter_Text::processUsfm ()
               // Extract the verse number, and store it in the object.
               string v_number = usfm_peek_verse_number (textFollowingMarker);
               currentVerseNumber = v_number;
+              if (text_text) text_text->verse (convert_to_int (v_number));
               // In case there was a published verse marker, use that markup for publishing.
               string v_vp_number = v_number;
               for (auto publishedVerseMarker : publishedVerseMarkers) {
@@ -1075,9 +1075,9 @@ void Filter_Text::processNote ()
       bool isEmbeddedMarker = usfm_is_embedded_marker (currentItem);
       // Clean up the marker, so we remain with the basic version, e.g. 'f'.
       string marker = usfm_get_marker (currentItem);
-      if (styles.find (marker) != styles.end())
+      if (const Database_Styles_Item * found = styles->find (marker))
       {
-        Database_Styles_Item style = styles[marker];
+        const Database_Styles_Item & style = * found;
         switch (style.type)
         {
           case StyleTypeVerseNumber:
@@ -1093,7 +1093,7 @@ void Filter_Text::processNote ()
               case FootEndNoteSubtypeFootnote:
               {
                 if (isOpeningMarker) {
-                  ensureNoteParagraphStyle (marker, styles [standardContentMarkerFootEndNote]);
+                  ensureNoteParagraphStyle (marker, styles->get (standardContentMarkerFootEndNote));
                   string citation = getNoteCitation (style);
                   if (odf_text_standard) odf_text_standard->addNote (citation, marker);
                   // Note citation in superscript in the document with text and note citations.
@@ -1129,7 +1129,7 @@ void Filter_Text::processNote ()
               case FootEndNoteSubtypeEndnote:
               {
                 if (isOpeningMarker) {
-                  ensureNoteParagraphStyle (marker, styles[standardContentMarkerFootEndNote]);
+                  ensureNoteParagraphStyle (marker, styles->get (standardContentMarkerFootEndNote));
                   string citation = getNoteCitation (style);
                   if (odf_text_standard) odf_text_standard->addNote (citation, marker, true);
                   // Note citation in superscript in the document with text and note citations.
@@ -1206,7 +1206,7 @@ void Filter_Text::processNote ()
               case CrossreferenceSubtypeCrossreference:
               {
                 if (isOpeningMarker) {
-                  ensureNoteParagraphStyle (marker, styles[standardContentMarkerCrossReference]);
+                  ensureNoteParagraphStyle (marker, styles->get (standardContentMarkerCrossReference));
                   string citation = getNoteCitation (style);
                   if (odf_text_standard) odf_text_standard->addNote (citation, marker);
                   // Note citation in superscript in the document with text and note citations.
@@ -1225,7 +1225,7 @@ void Filter_Text::processNote ()
                   // Add the note citation. And a no-break space (NBSP) after it.
                   if (odf_text_notes) odf_text_notes->addText (citation + non_breaking_space_u00A0());
                   // Open note in the web page.
-                  ensureNoteParagraphStyle (standardContentMarkerCrossReference, styles[standardContentMarkerCrossReference]);
+                  ensureNoteParagraphStyle (standardContentMarkerCrossReference, styles->get (standardContentMarkerCrossReference));
                   if (html_text_standard) html_text_standard->add_note (citation, standardContentMarkerCrossReference);
                   if (html_text_linked) html_text_linked->add_note (citation, standardContentMarkerCrossReference);
                   // Online Bible: Skip notes.
@@ -1526,7 +1526,7 @@ void Filter_Text::applyDropCapsToCurrentParagraph (int dropCapsLength)
   if (odf_text_standard) {
     string combined_style = odf_text_standard->currentParagraphStyle + "_" + chapterMarker + convert_to_string (dropCapsLength);
     if (find (createdStyles.begin(), createdStyles.end(), combined_style) == createdStyles.end()) {
-      Database_Styles_Item style = styles[odf_text_standard->currentParagraphStyle];
+      const Database_Styles_Item & style = styles->get (odf_text_standard->currentParagraphStyle);
       string fontname = Database_Config_Bible::getExportFont (bible);
       float fontsize = style.fontsize;
       int italic = style.italic;
@@ -1559,7 +1559,7 @@ void Filter_Text::applyDropCapsToCurrentParagraph (int dropCapsLength)
 // $chapterText: The text of the chapter indicator to put.
 void Filter_Text::putChapterNumberInFrame (string chapterText)
 {
-  Database_Styles_Item style = styles[chapterMarker];
+  const Database_Styles_Item & style = styles->get (chapterMarker);
   if (odf_text_standard) odf_text_standard->placeTextInFrame (chapterText, this->chapterMarker, style.fontsize, style.italic, style.bold);
   if (odf_text_text_only) odf_text_text_only->placeTextInFrame (chapterText, this->chapterMarker, style.fontsize, style.italic, style.bold);
   if (odf_text_text_and_note_citations) odf_text_text_and_note_citations->placeTextInFrame (chapterText, this->chapterMarker, style.fontsize, style.italic, style.bold);
@@ -80,7 +80,7 @@ private:
 public:
   void getStyles (string stylesheet);
 private:
-  map <string, Database_Styles_Item> styles; // A map of marker -> object with style information.
+  shared_ptr <const Database_Styles_Sheet> styles; // The compiled stylesheet with the style information per marker.
   string chapterMarker; // Usually this is: c
   vector <string> createdStyles; // Array holding styles created in Odf_Text class.
 
@@ -24,6 +24,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/UriCodec.cpp>
 #include <filter/string.h>
 #include <filter/date.h>
+#include <filter/metrics.h>
 #include <database/books.h>
 #include <database/logs.h>
 #ifndef HAVE_CLIENT
@@ -421,6 +422,7 @@ void filter_url_set_write_permission (string path)
 // C++ rough equivalent for PHP's file_get_contents.
 string filter_url_file_get_contents(string filename)
 {
+  Filter_Metrics_Timer timer ("file", filename);
   if (!file_or_dir_exists(filename)) return "";
   try {
 #ifdef HAVE_WINDOWS
@@ -76,9 +76,15 @@ vector <string> usfm_get_markers_and_text (string code)
   code = filter_string_str_replace ("\n", " ", code); // New line only: change to space, according to the USFM specification.
   // No removal of double spaces, because it would remove an opening marker (which already has its own space), followed by a space.
   code = filter_string_trim (code);
-  while (!code.empty ()) {
-    size_t pos = code.find ("\\");
-    if (pos == 0) {
+  // Walk through the code once, from one backslash to the next.
+  size_t start = 0;
+  size_t length = code.length ();
+  while (start < length) {
+    // Text ends at the next backslash or at the end of the string.
+    size_t next = code.find ('\\', start + 1);
+    if (next == string::npos) next = length;
+    size_t end = next;
+    if (code [start] == '\\') {
       // Marker found.
       // The marker ends
       // - after the first space, or
@@ -86,27 +92,15 @@ vector <string> usfm_get_markers_and_text (string code)
       // - at the first backslash (\), or
       // - at the end of the string,
       // whichever comes first.
-      vector <size_t> positions;
-      pos = code.find (" ");
-      if (pos != string::npos) positions.push_back (pos + 1);
-      pos = code.find ("*");
-      if (pos != string::npos) positions.push_back (pos + 1);
-      pos = code.find ("\\", 1);
-      if (pos != string::npos) positions.push_back (pos);
-      positions.push_back (code.length());
-      sort (positions.begin (), positions.end());
-      pos = positions[0];
-      string marker = code.substr (0, pos);
-      markers_and_text.push_back (marker);
-      code = code.substr (pos);
-    } else {
-      // Text found. It ends at the next backslash or at the end of the string.
-      pos = code.find ("\\");
-      if (pos == string::npos) pos = code.length();
-      string text = code.substr (0, pos);
-      markers_and_text.push_back (text);
-      code = code.substr (pos);
+      for (size_t pos = start; pos < next; pos++) {
+        if ((code [pos] == ' ') || (code [pos] == '*')) {
+          end = pos + 1;
+          break;
+        }
+      }
     }
+    markers_and_text.push_back (code.substr (start, end - start));
+    start = end;
   }
   return markers_and_text;
 }
@@ -232,7 +226,7 @@ vector <int> usfm_get_verse_numbers (string usfm)
   vector <int> verse_numbers = { 0 };
   vector <string> markers_and_text = usfm_get_markers_and_text (usfm);
   bool extract_verse = false;
-  for (string marker_or_text : markers_and_text) {
+  for (const string & marker_or_text : markers_and_text) {
     if (extract_verse) {
       string verse = usfm_peek_verse_number (marker_or_text);
       // Range of verses.
@@ -293,18 +287,8 @@ vector <int> usfm_linenumber_to_versenumber (string usfm, unsigned int line_numb
 // Offset is calculated with unicode_string_length to support UTF-8.
 vector <int> usfm_offset_to_versenumber (string usfm, unsigned int offset)
 {
-  unsigned int totalOffset = 0;
-  vector <string> lines = filter_string_explode (usfm, '\n');
-  for (unsigned int i = 0; i < lines.size(); i++) {
-    int length = unicode_string_length (lines [i]);
-    totalOffset += length;
-    if (totalOffset >= offset) {
-      return usfm_linenumber_to_versenumber (usfm, i);
-    }
-    // Add 1 for new line.
-    totalOffset += 1;
-  }
-  return {0};
+  Filter_Usfm_Chapter parsed (usfm);
+  return parsed.offset_verses (offset);
 }
 
 
@@ -312,20 +296,8 @@ vector <int> usfm_offset_to_versenumber (string usfm, unsigned int offset)
 // Returns the offset within the $usfm code where $verse number starts.
 int usfm_versenumber_to_offset (string usfm, int verse)
 {
-  // Verse number 0 starts at offset 0.
-  if (verse == 0) return 0;
-  int totalOffset = 0;
-  vector <string> lines = filter_string_explode (usfm, '\n');
-  for (string line : lines) {
-    vector <int> verses = usfm_get_verse_numbers (line);
-    for (auto & v : verses) {
-      if (v == verse) return totalOffset;
-    }
-    totalOffset += unicode_string_length (line);
-    // Add 1 for new line.
-    totalOffset += 1;
-  }
-  return unicode_string_length (usfm);
+  Filter_Usfm_Chapter parsed (usfm);
+  return parsed.verse_offset (verse);
 }
 
 
@@ -333,32 +305,167 @@ int usfm_versenumber_to_offset (string usfm, int verse)
 // Handles combined verses.
 string usfm_get_verse_text (string usfm, int verse_number)
 {
-  vector <string> result;
-  bool hit = (verse_number == 0);
+  Filter_Usfm_Chapter parsed (usfm);
+  return parsed.verse_text (verse_number);
+}
 
-  vector <string> lines = filter_string_explode (usfm, '\n');
-  for (string line : lines) {
-    vector <int> verses = usfm_get_verse_numbers (line);
-    if (verse_number == 0) {
-      if (verses.size () != 1) hit = false;
-      if (hit) result.push_back (line);
-    } else {
-      if (in_array (verse_number, verses)) {
-        // Desired verse found.
-        hit = true;
-      } else if (verses.size () == 1) {
-        // No verse found: No change in situation.
+
+// Returns the texts of all the verses in the $usfm of a chapter, in one pass.
+// The text of each verse is the same as what usfm_get_verse_text gives for that verse.
+map <int, string> usfm_get_verses_text (string usfm)
+{
+  Filter_Usfm_Chapter parsed (usfm);
+  return parsed.verses_text ();
+}
+
+
+// Holds the $usfm of a chapter, to be parsed once for any number of queries.
+Filter_Usfm_Chapter::Filter_Usfm_Chapter (const string & usfm)
+{
+  chapter_usfm = usfm;
+}
+
+
+// Goes through the lines of the chapter, and notes the verses each line starts.
+// A line that starts one or more verses, plus the lines after it that start none,
+// form the text of those verses, and lines before the first verse belong to verse 0.
+void Filter_Usfm_Chapter::parse_lines () const
+{
+  if (lines_parsed) return;
+  lines_parsed = true;
+  // The verses the current line belongs to.
+  vector <int> verses = { 0 };
+  size_t start = 0;
+  while (start < chapter_usfm.size ()) {
+    size_t end = chapter_usfm.find ('\n', start);
+    if (end == string::npos) end = chapter_usfm.size ();
+    vector <int> line_verses = usfm_get_verse_numbers (chapter_usfm.substr (start, end - start));
+    if (line_verses.size () != 1) {
+      // The line starts one or more new verses.
+      verses.clear ();
+      for (auto verse : line_verses) {
+        if (verse == 0) continue;
+        if (in_array (verse, verses)) continue;
+        verses.push_back (verse);
+      }
+    }
+    for (auto verse : verses) {
+      vector <pair <size_t, size_t> > & verse_spans = spans [verse];
+      if (!verse_spans.empty () && (verse_spans.back ().first + verse_spans.back ().second + 1 == start)) {
+        // The line follows straight after the previous bit of this verse: Extend that bit.
+        verse_spans.back ().second = end - verse_spans.back ().first;
       } else {
-        // Outside desired verse.
-        hit = false;
+        verse_spans.push_back (make_pair (start, end - start));
       }
-      if (hit) result.push_back (line);
     }
+    line_bytes.push_back (make_pair (start, end - start));
+    lines_verses.push_back (line_verses);
+    start = end + 1;
   }
-  
-  // Return the verse text.
-  string verseText = filter_string_implode (result, "\n");
-  return verseText;
+}
+
+
+// Works out the Unicode offset and length of each line, for the queries by offset.
+void Filter_Usfm_Chapter::measure_lines () const
+{
+  if (lines_measured) return;
+  lines_measured = true;
+  parse_lines ();
+  int offset = 0;
+  for (auto & bytes : line_bytes) {
+    int line_length = (int) unicode_string_length (chapter_usfm.substr (bytes.first, bytes.second));
+    line_offsets.push_back (offset);
+    line_lengths.push_back (line_length);
+    // Add 1 for new line.
+    offset += line_length + 1;
+  }
+}
+
+
+// The USFM of the chapter, which the spans of the verses point into.
+const string & Filter_Usfm_Chapter::usfm () const
+{
+  return chapter_usfm;
+}
+
+
+// The verse numbers in the chapter, the same as usfm_get_verse_numbers gives.
+vector <int> Filter_Usfm_Chapter::verse_numbers () const
+{
+  if (!numbers_found) {
+    numbers = usfm_get_verse_numbers (chapter_usfm);
+    numbers_found = true;
+  }
+  return numbers;
+}
+
+
+// Returns where the text of the $verse is in the USFM of the chapter,
+// as pairs of byte offset and length.
+// Most verses are in one bit of text, but a verse can occur more than once in a chapter.
+vector <pair <size_t, size_t> > Filter_Usfm_Chapter::verse_spans (int verse) const
+{
+  parse_lines ();
+  auto iterator = spans.find (verse);
+  if (iterator == spans.end ()) return {};
+  return iterator->second;
+}
+
+
+// Returns the USFM of the $verse, the same as usfm_get_verse_text gives.
+string Filter_Usfm_Chapter::verse_text (int verse) const
+{
+  parse_lines ();
+  string text;
+  auto iterator = spans.find (verse);
+  if (iterator == spans.end ()) return text;
+  const vector <pair <size_t, size_t> > & verse_spans = iterator->second;
+  for (size_t i = 0; i < verse_spans.size (); i++) {
+    if (i) text.append ("\n");
+    text.append (chapter_usfm, verse_spans [i].first, verse_spans [i].second);
+  }
+  return text;
+}
+
+
+// Returns the USFM of all the verses in the chapter, the same as usfm_get_verses_text gives.
+map <int, string> Filter_Usfm_Chapter::verses_text () const
+{
+  parse_lines ();
+  map <int, string> texts;
+  for (auto & element : spans) {
+    texts [element.first] = verse_text (element.first);
+  }
+  return texts;
+}
+
+
+// Returns the offset where the $verse starts, the same as usfm_versenumber_to_offset gives.
+int Filter_Usfm_Chapter::verse_offset (int verse) const
+{
+  // Verse number 0 starts at offset 0.
+  if (verse == 0) return 0;
+  measure_lines ();
+  for (size_t i = 0; i < lines_verses.size (); i++) {
+    if (in_array (verse, lines_verses [i])) return line_offsets [i];
+  }
+  return (int) unicode_string_length (chapter_usfm);
+}
+
+
+// Returns the verse numbers at the $offset, the same as usfm_offset_to_versenumber gives.
+vector <int> Filter_Usfm_Chapter::offset_verses (unsigned int offset) const
+{
+  measure_lines ();
+  vector <int> verses = { 0 };
+  for (size_t i = 0; i < lines_verses.size (); i++) {
+    // The verses of the most recent line that starts verses.
+    if (lines_verses [i].size () >= 2) {
+      verses = filter_string_array_diff (lines_verses [i], {0});
+    }
+    if ((unsigned int) (line_offsets [i] + line_lengths [i]) >= offset) return verses;
+  }
+  return {0};
 }
 
 
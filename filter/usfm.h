@@ -34,6 +34,39 @@ public:
 };
 
 
+// A chapter of USFM, parsed once,
+// so that looking up the verses in it does not need to go through the whole chapter again.
+class Filter_Usfm_Chapter
+{
+public:
+  Filter_Usfm_Chapter (const string & usfm);
+  const string & usfm () const;
+  vector <int> verse_numbers () const;
+  vector <pair <size_t, size_t> > verse_spans (int verse) const;
+  string verse_text (int verse) const;
+  map <int, string> verses_text () const;
+  int verse_offset (int verse) const;
+  vector <int> offset_verses (unsigned int offset) const;
+private:
+  string chapter_usfm;
+  // The parts below are worked out on first use, so a single query only pays for what it needs.
+  void parse_lines () const;
+  void measure_lines () const;
+  mutable bool lines_parsed = false;
+  mutable bool lines_measured = false;
+  mutable bool numbers_found = false;
+  mutable vector <int> numbers;
+  // Per line: Its byte offset and length, and the verse numbers usfm_get_verse_numbers gives for it.
+  mutable vector <pair <size_t, size_t> > line_bytes;
+  mutable vector <vector <int> > lines_verses;
+  // Per line: Its Unicode offset and length.
+  mutable vector <int> line_offsets;
+  mutable vector <int> line_lengths;
+  // Per verse: Where its text is in the chapter.
+  mutable map <int, vector <pair <size_t, size_t> > > spans;
+};
+
+
 string usfm_one_string (string usfm);
 vector <string> usfm_get_markers_and_text (string code);
 string usfm_get_marker (string usfm);
@@ -44,6 +77,7 @@ vector <int> usfm_linenumber_to_versenumber (string usfm, unsigned int line_numb
 vector <int> usfm_offset_to_versenumber (string usfm, unsigned int offset);
 int usfm_versenumber_to_offset (string usfm, int verse);
 string usfm_get_verse_text (string usfm, int verse);
+map <int, string> usfm_get_verses_text (string usfm);
 string usfm_get_verse_text_quill (string usfm, int verse_number);
 string usfm_get_chapter_text (string usfm, int chapter_number);
 string usfm_get_verse_range_text (string usfm, int verse_from, int verse_to, const string& exclude_usfm, bool quill);
@@ -60,9 +60,8 @@ string render_journal_entry (string filename, int userlevel)
   // The first 10 characters are the number of seconds past the Unix epoch,
   // followed by the number of microseconds within the current second.
 
-  // Get the contents of the file.
-  string path = filter_url_create_path (Database_Logs::folder (), filename);
-  string entry = filter_url_file_get_contents (path);
+  // Get the contents of the entry.
+  string entry = Database_Logs::entry (filename);
   
   // Deal with the user-level of the entry.
   int entryLevel = convert_to_int (entry);
@@ -132,11 +131,10 @@ string journal_index (void * webserver_request)
   
   string expansion = request->query ["expansion"];
   if (!expansion.empty ()) {
-    // Get file path.
+    // Get the filename of the record.
     expansion = filter_url_basename_web (expansion);
-    string path = filter_url_create_path (Database_Logs::folder (), expansion);
     // Get contents of the record.
-    expansion = filter_url_file_get_contents (path);
+    expansion = Database_Logs::entry (expansion);
     // Remove the user's level.
     expansion.erase (0, 2);
     // The only formatting currently allowed in the journal is new lines.
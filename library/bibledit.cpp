@@ -355,6 +355,9 @@ void bibledit_stop_library ()
   delete config_globals_http_worker;
   delete config_globals_https_worker;
   delete config_globals_timer;
+
+  // Write the buffered journal entries.
+  Database_Logs::flush ();
 }
 
 
@@ -332,4 +332,7 @@ void locale_logic_obfuscate_initialize ()
   for (auto original : locale_translate_obfuscation_search) {
     locale_translate_obfuscation_replace.push_back (original_to_obfuscated [original]);
   }
+  
+  // Compile the strings for obfuscating them all in one go.
+  locale_translate_obfuscation_compile ();
 }
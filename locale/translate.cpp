@@ -21,6 +21,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <database/config/general.h>
 #include <database/localization.h>
 #include <filter/string.h>
+#include <filter/automaton.h>
 
 
 //string localization;
@@ -47,6 +48,96 @@ void check_user_localization_preference (void * webserver_request)
 // Storage for the user interface obfuscation strings.
 vector <string> locale_translate_obfuscation_search;
 vector <string> locale_translate_obfuscation_replace;
+// All strings to obfuscate compiled into one automaton.
+Filter_Automaton locale_translate_obfuscation_automaton;
+// Whether a replacement can create a string that is replaced after it.
+bool locale_translate_obfuscation_chained = false;
+
+
+// Whether the $search string, when looked for after $replace was put in the text,
+// could find text that $replace put there, or that it joined together.
+static bool locale_translate_obfuscation_interacts (const string & replace, const string & search)
+{
+  // Replacing by nothing joins the text on either side.
+  if (replace.empty ()) return true;
+  if (replace.find (search) != string::npos) return true;
+  if (search.find (replace) != string::npos) return true;
+  // The $search string starting or ending within the replacement.
+  for (size_t length = 1; length < min (replace.size (), search.size ()); length++) {
+    if (replace.compare (replace.size () - length, length, search, 0, length) == 0) return true;
+    if (replace.compare (0, length, search, search.size () - length, length) == 0) return true;
+  }
+  return false;
+}
+
+
+// Compiles the strings to obfuscate, once they have been loaded.
+void locale_translate_obfuscation_compile ()
+{
+  locale_translate_obfuscation_automaton = Filter_Automaton ();
+  locale_translate_obfuscation_chained = false;
+  for (unsigned int i = 0; i < locale_translate_obfuscation_search.size(); i++) {
+    locale_translate_obfuscation_automaton.add (locale_translate_obfuscation_search [i], i);
+    for (unsigned int j = i + 1; j < locale_translate_obfuscation_search.size(); j++) {
+      if (locale_translate_obfuscation_interacts (locale_translate_obfuscation_replace [i], locale_translate_obfuscation_search [j])) {
+        locale_translate_obfuscation_chained = true;
+      }
+    }
+  }
+  locale_translate_obfuscation_automaton.compile ();
+}
+
+
+// Obfuscates the $text: It replaces the strings to obfuscate, the longest first, and the shortest last.
+// It replaces strings, not whole words as having certain boundaries.
+// Normally it does this in one scan of the text.
+// But if a replacement could create a string that is replaced later,
+// it replaces the strings one after the other, so a replacement can be replaced again.
+string locale_translate_obfuscate (const string & text)
+{
+  if (locale_translate_obfuscation_chained) {
+    string result (text);
+    for (unsigned int i = 0; i < locale_translate_obfuscation_search.size(); i++) {
+      result = filter_string_str_replace (locale_translate_obfuscation_search [i], locale_translate_obfuscation_replace [i], result);
+    }
+    return result;
+  }
+  // Find the strings to obfuscate, with their starting positions.
+  vector <pair <size_t, int> > found = locale_translate_obfuscation_automaton.locate (text);
+  if (found.empty ()) return text;
+  for (auto & element : found) {
+    element.first -= locale_translate_obfuscation_search [element.second].size ();
+  }
+  // The search strings are sorted on length, longest first, so the identifiers give the priority.
+  // Take the longest strings first, then the leftmost, as long as they do not overlap strings taken before.
+  sort (found.begin (), found.end (), [] (const pair <size_t, int> & a, const pair <size_t, int> & b) {
+    if (a.second != b.second) return a.second < b.second;
+    return a.first < b.first;
+  });
+  vector <bool> taken (text.size (), false);
+  vector <pair <size_t, int> > replacements;
+  for (auto & element : found) {
+    size_t length = locale_translate_obfuscation_search [element.second].size ();
+    bool overlaps = false;
+    for (size_t i = element.first; i < element.first + length; i++) {
+      if (taken [i]) overlaps = true;
+    }
+    if (overlaps) continue;
+    for (size_t i = element.first; i < element.first + length; i++) taken [i] = true;
+    replacements.push_back (element);
+  }
+  sort (replacements.begin (), replacements.end ());
+  // Assemble the obfuscated text.
+  string result;
+  size_t position = 0;
+  for (auto & element : replacements) {
+    result.append (text, position, element.first - position);
+    result.append (locale_translate_obfuscation_replace [element.second]);
+    position = element.first + locale_translate_obfuscation_search [element.second].size ();
+  }
+  result.append (text, position, string::npos);
+  return result;
+}
 
 
 // Translates $english to its localized string.
@@ -55,7 +146,6 @@ string translate (string english)
   // Start off with the English message.
   string result (english);
   // Check whether a language has been set on the website or the app.
-  // Check whether a language has been set on the website or the app.
   string localization = Database_Config_General::getSiteLanguage ();
   if (!localization.empty ()) {
     // Localize it.
@@ -64,13 +154,8 @@ string translate (string english)
   }
   // Check whether there's obfuscation to be done.
   if (!locale_translate_obfuscation_search.empty ()) {
-    // Obfuscate: Search and replace text.
-    // It replaces strings, not whole words as having certain boundaries.
-    for (unsigned int i = 0; i < locale_translate_obfuscation_search.size(); i++) {
-      result = filter_string_str_replace (locale_translate_obfuscation_search [i], locale_translate_obfuscation_replace [i], result);
-    }
+    result = locale_translate_obfuscate (result);
   }
   // Ready.
   return result;
 }
-
@@ -26,6 +26,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 extern vector <string> locale_translate_obfuscation_search;
 extern vector <string> locale_translate_obfuscation_replace;
+void locale_translate_obfuscation_compile ();
+string locale_translate_obfuscate (const string & text);
 void check_user_localization_preference (void * webserver_request);
 string translate (string english);
 
@@ -19,6 +19,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 $(document).ready (function () {
   navigationNewPassage ();
+  $ ("#noteslist").on ("click", ".notesmore a", notesLoadMore);
 });
 
 
@@ -40,3 +41,24 @@ function navigationNewPassage ()
     },
   });
 }
+
+
+// Loads the next page of notes in place of the link that was clicked.
+function notesLoadMore (event)
+{
+  event.preventDefault ();
+  var paragraph = $ (this).parent ();
+  $.ajax ({
+    url: $ (this).attr ("href"),
+    type: "GET",
+    cache: false,
+    success: function (response) {
+      paragraph.replaceWith (response);
+      if (window.self !== window.top) {
+        document.querySelectorAll('#noteslist a').forEach((element) => {
+          element.href = topbarRemovalQueryAddition (element.href);
+        })
+      }
+    },
+  });
+}
@@ -80,27 +80,14 @@ string notes_notes (void * webserver_request)
   if (request->session_logic ()->currentLevel () == Filter_Roles::admin ()) bibles.clear ();
   
   
-  vector <int> identifiers = database_notes.select_notes (bibles, book, chapter, verse, passage_selector, edit_selector, non_edit_selector, status_selector, bible_selector, assignment_selector, subscription_selector, severity_selector, text_selector, search_text, -1);
-  
-  
-  // In case there aren't too many notes, there's enough time to sort them in passage order.
-  if (identifiers.size () <= 200) {
-    vector <int> passage_sort_keys;
-    for (auto & identifier : identifiers) {
-      int passage_sort_key = 0;
-      vector <double> numeric_passages;
-      vector <Passage> passages = database_notes.get_passages (identifier);
-      for (auto & passage : passages) {
-        numeric_passages.push_back (filter_passage_to_integer (passage));
-      }
-      if (!numeric_passages.empty ()) {
-        double average = accumulate (numeric_passages.begin (), numeric_passages.end (), 0) / numeric_passages.size ();
-        passage_sort_key = round(average);
-      }
-      passage_sort_keys.push_back (passage_sort_key);
-    }
-    quick_sort (passage_sort_keys, identifiers, 0, (int)identifiers.size ());
-  }
+  // The notes come in passage order, a page at a time.
+  // The next page starts after the last note of the previous page.
+  // A search on the text gives all the notes found, in order of relevance.
+  int after_key = convert_to_int (request->query ["afterkey"]);
+  int after = convert_to_int (request->query ["after"]);
+  int page_size = 100;
+  if (text_selector == 1) page_size = -1;
+  vector <int> identifiers = database_notes.select_notes (bibles, book, chapter, verse, passage_selector, edit_selector, non_edit_selector, status_selector, bible_selector, assignment_selector, subscription_selector, severity_selector, text_selector, search_text, page_size, after_key, after);
 
 
   bool show_bible_in_notes_list = request->database_config_user ()->getShowBibleInNotesList ();
@@ -164,7 +151,12 @@ string notes_notes (void * webserver_request)
   }
 
   
-  if (identifiers.empty ()) {
+  // A full page of notes may be followed by more.
+  if ((int) identifiers.size () == page_size) {
+    notesblock.append ("<p class=\"notesmore\"><a href=\"notes?afterkey=" + convert_to_string (database_notes.get_passage_key (identifiers.back ())) + "&after=" + convert_to_string (identifiers.back ()) + "\">" + translate("More notes") + "</a></p>\n");
+  }
+
+  if (identifiers.empty () && !after) {
     return translate("This selection does not display any notes.");
   }
   return notesblock;
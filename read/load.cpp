@@ -31,9 +31,6 @@
 #include <database/config/bible.h>
 
 
-using namespace pugi;
-
-
 string read_load_url ()
 {
   return "read/load";
@@ -28,62 +28,107 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 using namespace pugi;
 
 
-// Internal function that searches related passages in the XML DOM.
-void related_logic_search_related (const string & bookname, int input_chapter, const string & input_verse,
-                                   const xml_node & node, vector <int> & passages)
+// The sets of related passages from the XML files, parsed once into an index.
+// The index has a compressed sparse row layout, with the passages as integers.
+class Related_Logic_Index
 {
-  for (xml_node set : node.children ()) {
-    bool match = false;
-    for (xml_node reference : set.children ()) {
-      
-      // If a match was found, skip further processing.
-      if (match) continue;
-      
-      // Match on book.
-      string book = reference.attribute ("book").value ();
-      match = (book == bookname);
-      
-      // Match on chapter.
-      if (match) {
-        int chapter = convert_to_int (reference.attribute ("chapter").value ());
-        match = (chapter == input_chapter);
-      }
-      
-      // Match on verse(s).
-      if (match) {
-        string verse = reference.attribute ("verse").value ();
-        vector <int> verses;
-        if (usfm_handle_verse_range (verse, verses)) {
-          match = in_array (convert_to_int (input_verse), verses);
-        } else {
-          match = (verse == input_verse);
+public:
+  // The sorted passages that occur in any set,
+  // and for each of them, the range of the sets it occurs in.
+  vector <int> passages;
+  vector <int> passage_offsets;
+  vector <int> passage_sets;
+  // For each set, the range of the passages in it.
+  vector <int> set_offsets;
+  vector <int> set_passages;
+  void add (const xml_node & set);
+  void compile ();
+};
+
+
+// Adds the passages of the references in the $set as a new set.
+void Related_Logic_Index::add (const xml_node & set)
+{
+  if (set_offsets.empty ()) set_offsets.push_back (0);
+  vector <int> members;
+  for (xml_node reference : set.children ("reference")) {
+    string bookname = reference.attribute ("book").value ();
+    int book = Database_Books::getIdFromEnglish (bookname);
+    int chapter = convert_to_int (reference.attribute ("chapter").value ());
+    if (!book || !chapter) continue;
+    string verse = reference.attribute ("verse").value ();
+    vector <int> verses;
+    if (usfm_handle_verse_range (verse, verses));
+    else verses.push_back (convert_to_int (verse));
+    for (auto verse : verses) {
+      members.push_back (filter_passage_to_integer (Passage ("", book, chapter, convert_to_string (verse))));
+    }
+  }
+  sort (members.begin (), members.end ());
+  members.erase (unique (members.begin (), members.end ()), members.end ());
+  set_passages.insert (set_passages.end (), members.begin (), members.end ());
+  set_offsets.push_back (set_passages.size ());
+}
+
+
+// Builds the index from the passages to the sets, after all sets have been added.
+void Related_Logic_Index::compile ()
+{
+  vector <pair <int, int> > pairs;
+  for (size_t set = 0; set + 1 < set_offsets.size (); set++) {
+    for (int i = set_offsets [set]; i < set_offsets [set + 1]; i++) {
+      pairs.push_back (make_pair (set_passages [i], set));
+    }
+  }
+  sort (pairs.begin (), pairs.end ());
+  for (auto & element : pairs) {
+    if (passages.empty () || (passages.back () != element.first)) {
+      passages.push_back (element.first);
+      passage_offsets.push_back (passage_sets.size ());
+    }
+    passage_sets.push_back (element.second);
+  }
+  passage_offsets.push_back (passage_sets.size ());
+}
+
+
+mutex related_logic_mutex;
+shared_ptr <Related_Logic_Index> related_logic_index;
+
+
+// Gives the index of the related passages.
+// The XML files with the parallel passages and the quotations get parsed the first time.
+shared_ptr <Related_Logic_Index> related_logic_get_index ()
+{
+  lock_guard <mutex> lock (related_logic_mutex);
+  if (related_logic_index) return related_logic_index;
+  related_logic_index = make_shared <Related_Logic_Index> ();
+  // The parallel passages are in sets within sections.
+  for (string type : { "ot", "nt" }) {
+    string path = filter_url_create_root_path ("related", "parallel-passages-" + type + ".xml");
+    xml_document document;
+    document.load_file (path.c_str());
+    for (xml_node passages : document.children ()) {
+      for (xml_node section : passages.children ()) {
+        for (xml_node set : section.children ()) {
+          related_logic_index->add (set);
         }
       }
-      
-      // Store all related passages.
-      if (match) {
-        for (xml_node reference : set.children ()) {
-          string bookname = reference.attribute ("book").value ();
-          int book = Database_Books::getIdFromEnglish (bookname);
-          int chapter = convert_to_int (reference.attribute ("chapter").value ());
-          string verse = reference.attribute ("verse").value ();
-          vector <int> verses;
-          if (usfm_handle_verse_range (verse, verses));
-          else verses.push_back (convert_to_int (verse));
-          for (auto verse : verses) {
-            if (book && chapter) {
-              Passage passage ("", book, chapter, convert_to_string (verse));
-              int i = filter_passage_to_integer (passage);
-              // No duplicate passages to be included.
-              if (!in_array (i, passages)) {
-                passages.push_back (i);
-              }
-            }
-          }
-        }
+    }
+  }
+  // The quotations are in sets straight away.
+  {
+    string path = filter_url_create_root_path ("related", "ot-quotations-in-nt.xml");
+    xml_document document;
+    document.load_file (path.c_str());
+    for (xml_node passages : document.children ()) {
+      for (xml_node set : passages.children ()) {
+        related_logic_index->add (set);
       }
     }
   }
+  related_logic_index->compile ();
+  return related_logic_index;
 }
 
 
@@ -91,50 +136,27 @@ void related_logic_search_related (const string & bookname, int input_chapter, c
 // It takes the passages from $input, and returns them plus their related passages, if there's any.
 vector <Passage> related_logic_get_verses (const vector <Passage> & input)
 {
-  vector <int> related_passages;
+  shared_ptr <Related_Logic_Index> index = related_logic_get_index ();
   
   
-  if (!input.empty ()) {
-
-
-    // Get details about the book in the passage.
-    // It assumes all input passages refer to the same book.
-    string bookname = Database_Books::getEnglishFromId (input[0].book);
-    string booktype = Database_Books::getType (input[0].book);
-    bool is_ot = (booktype == "ot");
-    bool is_nt = (booktype == "nt");
-    
-    
-    // Load the parallel passages and the quotations.
-    xml_document parallel_document;
-    xml_document quotation_document;
-    if (is_ot || is_nt) {
-      string path = filter_url_create_root_path ("related", "parallel-passages-" + booktype + ".xml");
-      parallel_document.load_file (path.c_str());
-      path = filter_url_create_root_path ("related", "ot-quotations-in-nt.xml");
-      quotation_document.load_file (path.c_str());
-    }
-
-    
-    // Deal with all of the input passages.
-    for (auto & input_passage : input) {
-      // Search for parallel passages.
-      for (xml_node passages : parallel_document.children ()) {
-        for (xml_node section : passages.children ()) {
-          related_logic_search_related (bookname, input_passage.chapter, input_passage.verse, section, related_passages);
-        }
-      }
-      // Search for quotes.
-      for (xml_node passages : quotation_document.children ()) {
-        related_logic_search_related (bookname, input_passage.chapter, input_passage.verse, passages, related_passages);
-      }
+  // Gather the passages of all sets that any of the input passages occurs in.
+  vector <int> related_passages;
+  for (auto & input_passage : input) {
+    int key = filter_passage_to_integer (input_passage);
+    auto iterator = lower_bound (index->passages.begin (), index->passages.end (), key);
+    if ((iterator == index->passages.end ()) || (*iterator != key)) continue;
+    size_t position = iterator - index->passages.begin ();
+    for (int i = index->passage_offsets [position]; i < index->passage_offsets [position + 1]; i++) {
+      int set = index->passage_sets [i];
+      related_passages.insert (related_passages.end (), index->set_passages.begin () + index->set_offsets [set], index->set_passages.begin () + index->set_offsets [set + 1]);
     }
   }
 
   
-  // Sort the passages and convert them.
+  // Sort the passages, remove duplicates, and convert them.
   vector <Passage> output;
   sort (related_passages.begin (), related_passages.end ());
+  related_passages.erase (unique (related_passages.begin (), related_passages.end ()), related_passages.end ());
   for (auto & related_passage : related_passages) {
     Passage passage = filter_integer_to_passage (related_passage);
     output.push_back (passage);
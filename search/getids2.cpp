@@ -56,20 +56,7 @@ string search_getids2 (void * webserver_request)
   
   
   // Do the search.
-  vector <Passage> passages;
-  if (casesensitive) {
-    if (searchplain) {
-      passages = search_logic_search_bible_text_case_sensitive (bible, searchfor);
-    } else {
-      passages = search_logic_search_bible_usfm_case_sensitive (bible, searchfor);
-    }
-  } else {
-    if (searchplain) {
-      passages = search_logic_search_bible_text (bible, searchfor);
-    } else {
-      passages = search_logic_search_bible_usfm (bible, searchfor);
-    }
-  }
+  vector <Passage> passages = search_logic_search_bible (bible, searchfor, casesensitive, searchplain);
   
   
   // Output identifiers of the search results.
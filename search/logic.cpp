@@ -22,10 +22,13 @@
 #include <filter/string.h>
 #include <filter/usfm.h>
 #include <filter/text.h>
+#include <filter/md5.h>
 #include <config/globals.h>
 #include <database/bibles.h>
 #include <database/config/bible.h>
 #include <database/logic.h>
+#include <database/styles.h>
+#include <search/terms.h>
 
 
 string search_logic_index_folder ()
@@ -70,6 +73,17 @@ string search_logic_index_separator ()
 #define PLAIN_LOWER 4
 
 
+// The line after the verse separator in the index holds the verse, or the combined verses, the text belongs to.
+static vector <int> search_logic_index_verses (const string & line)
+{
+  vector <int> verses;
+  for (auto & number : filter_string_explode (line, ' ')) {
+    verses.push_back (convert_to_int (number));
+  }
+  return verses;
+}
+
+
 // Indexes a $bible $book $chapter for searching.
 void search_logic_index_chapter (string bible, int book, int chapter)
 {
@@ -80,21 +94,52 @@ void search_logic_index_chapter (string bible, int book, int chapter)
 
   vector <string> index;
   
-  set <string> already_processed;
+  // The first line holds the hash of what got indexed.
+  index.push_back (search_logic_chapter_hash (usfm, stylesheet));
+  
+  map <int, string> plains;
   
-  vector <int> verses = usfm_get_verse_numbers (usfm);
+  Filter_Usfm_Chapter parsed_chapter (usfm);
+  vector <int> verses = parsed_chapter.verse_numbers ();
+  
+  // Run the text filter once over the whole chapter.
+  // It gives the plain text, the headings and the notes per verse.
+  Filter_Text filter_text = Filter_Text (bible);
+  filter_text.text_text = new Text_Text ();
+  filter_text.initializeHeadingsAndTextPerVerse (true);
+  filter_text.addUsfmCode (usfm);
+  filter_text.run (stylesheet);
+  map <int, string> texts = filter_text.getVersesText ();
+  map <int, string> headings = filter_text.verses_headings;
+  map <int, string> notes = filter_text.text_text->getversenotes ();
+  
+  // Combined verses, like \v 1-2, or \v 3 and \v 4 on one line, have the same bit of USFM.
+  // Collect the verses that share a bit of USFM, so the index has the text of all of them,
+  // and lists all of them, so each of them gets that text.
+  map <string, vector <int> > combined_verses;
+  for (auto verse : verses) {
+    string raw_usfm = filter_string_trim (parsed_chapter.verse_text (verse));
+    vector <int> & combined = combined_verses [raw_usfm];
+    if (!in_array (verse, combined)) combined.push_back (verse);
+  }
+  
+  set <string> already_processed;
   
   for (auto verse : verses) {
 
-    string raw_usfm = filter_string_trim (usfm_get_verse_text (usfm, verse));
+    string raw_usfm = filter_string_trim (parsed_chapter.verse_text (verse));
 
     // In case of combined verses, the bit of USFM may have been indexed already.
     // Skip it in that case.
     if (already_processed.find (raw_usfm) != already_processed.end ()) continue;
     already_processed.insert (raw_usfm);
+    const vector <int> & combined = combined_verses [raw_usfm];
 
+    // The first verse is the one the search results give.
     index.push_back (search_logic_verse_separator ());
-    index.push_back (convert_to_string (verse));
+    vector <string> combined_numbers;
+    for (auto verse2 : combined) combined_numbers.push_back (convert_to_string (verse2));
+    index.push_back (filter_string_implode (combined_numbers, " "));
     index.push_back (search_logic_index_separator ());
 
     index.push_back (raw_usfm);
@@ -105,26 +150,19 @@ void search_logic_index_chapter (string bible, int book, int chapter)
 
     index.push_back (usfm_lower);
     
-    // Text filter for getting the plain text.
-    Filter_Text filter_text = Filter_Text (bible);
-    filter_text.text_text = new Text_Text ();
-    filter_text.initializeHeadingsAndTextPerVerse (true);
-    filter_text.addUsfmCode (raw_usfm);
-    filter_text.run (stylesheet);
-
     string raw_plain;
     // Add the clean verse texts.
-    map <int, string> texts = filter_text.getVersesText ();
-    for (auto & element : texts) {
-      raw_plain.append (element.second + "\n");
+    for (auto verse2 : combined) {
+      if (texts.count (verse2)) raw_plain.append (texts [verse2] + "\n");
     }
     // Add any clean headings.
-    map <int, string> headings = filter_text.verses_headings;
-    for (auto & element : headings) {
-      raw_plain.append (element.second + "\n");
+    for (auto verse2 : combined) {
+      if (headings.count (verse2)) raw_plain.append (headings [verse2] + "\n");
     }
     // Add any footnotes.
-    raw_plain.append (filter_text.text_text->getnote ());
+    for (auto verse2 : combined) {
+      if (notes.count (verse2)) raw_plain.append (notes [verse2] + "\n");
+    }
     // Clean up.
     raw_plain = filter_string_trim (raw_plain);
     
@@ -137,6 +175,7 @@ void search_logic_index_chapter (string bible, int book, int chapter)
     index.push_back (search_logic_index_separator ());
 
     index.push_back (plain_lower);
+    for (auto verse2 : combined) plains [verse2] = plain_lower;
   }
   
   index.push_back (search_logic_index_separator ());
@@ -144,6 +183,73 @@ void search_logic_index_chapter (string bible, int book, int chapter)
   // Store everything.
   string path = search_logic_chapter_file (bible, book, chapter);
   filter_url_file_put_contents (path, filter_string_implode (index, "\n"));
+  
+  // Keep the statistics for finding similar verses up to date.
+  search_terms_update_chapter (bible, book, chapter, plains);
+}
+
+
+// The hash of the $usfm of a chapter, as indexed with the $stylesheet.
+mutex search_logic_stylesheet_mutex;
+map <string, pair <shared_ptr <const Database_Styles_Sheet>, string> > search_logic_stylesheet_digests;
+
+
+// Returns the hash of the parts of the $stylesheet that the text in the index depends on.
+// It is worked out once for every compiled version of the stylesheet.
+string search_logic_stylesheet_digest (const string & stylesheet)
+{
+  Database_Styles database_styles;
+  shared_ptr <const Database_Styles_Sheet> sheet = database_styles.compile (stylesheet);
+  lock_guard <mutex> lock (search_logic_stylesheet_mutex);
+  pair <shared_ptr <const Database_Styles_Sheet>, string> & digest = search_logic_stylesheet_digests [stylesheet];
+  if (digest.first != sheet) {
+    string signature;
+    for (auto & style : sheet->items) {
+      signature.append (style.marker);
+      signature.append (" " + convert_to_string (style.type));
+      signature.append (" " + convert_to_string (style.subtype));
+      signature.append (" " + convert_to_string (style.userbool1));
+      signature.append (" " + convert_to_string (style.userbool2));
+      signature.append (" " + convert_to_string (style.userbool3));
+      signature.append (" " + convert_to_string (style.userint1));
+      signature.append (" " + convert_to_string (style.userint2));
+      signature.append (" " + convert_to_string (style.userint3));
+      signature.append (" " + style.userstring1);
+      signature.append (" " + style.userstring2);
+      signature.append (" " + style.userstring3);
+      signature.append ("\n");
+    }
+    digest = make_pair (sheet, md5 (signature));
+  }
+  return digest.second;
+}
+
+
+// The format of the index of a chapter.
+// The number goes up whenever the format of the index changes.
+string search_logic_index_format ()
+{
+  return "3";
+}
+
+
+// The hash of what goes into the index of a chapter: The $usfm, and the $stylesheet with its styles.
+string search_logic_chapter_hash (const string & usfm, const string & stylesheet)
+{
+  return md5 (search_logic_index_format () + "\n" + stylesheet + "\n" + search_logic_stylesheet_digest (stylesheet) + "\n" + usfm);
+}
+
+
+// Returns whether the index of the $chapter of the $book of the $bible is up to date with its text.
+bool search_logic_index_current (string bible, int book, int chapter)
+{
+  string path = search_logic_chapter_file (bible, book, chapter);
+  string index = filter_url_file_get_contents (path);
+  string hash = index.substr (0, index.find ('\n'));
+  Database_Bibles database_bibles;
+  string usfm = database_bibles.getChapter (bible, book, chapter);
+  string stylesheet = Database_Config_Bible::getExportStylesheet (bible);
+  return hash == search_logic_chapter_hash (usfm, stylesheet);
 }
 
 
@@ -384,12 +490,12 @@ string search_logic_get_bible_verse_text (string bible, int book, int chapter, i
   string path = search_logic_chapter_file (bible, book, chapter);
   string index = filter_url_file_get_contents (path);
   vector <string> lines = filter_string_explode (index, '\n');
-  int index_verse = 0;
+  vector <int> index_verses;
   bool read_index_verse = false;
   int index_item = 0;
   for (auto & line : lines) {
     if (read_index_verse) {
-      index_verse = convert_to_int (line);
+      index_verses = search_logic_index_verses (line);
       read_index_verse = false;
     } else if (line == search_logic_verse_separator ()) {
       read_index_verse = true;
@@ -397,7 +503,7 @@ string search_logic_get_bible_verse_text (string bible, int book, int chapter, i
     } else if (line == search_logic_index_separator ()) {
       index_item++;
     } else if (index_item == PLAIN_RAW) {
-      if (verse == index_verse) {
+      if (in_array (verse, index_verses)) {
         texts.push_back (line);
       }
     }
@@ -437,6 +543,7 @@ string search_logic_get_bible_verse_usfm (string bible, int book, int chapter, i
 
 void search_logic_delete_bible (string bible)
 {
+  search_terms_delete_bible (bible);
   string fragment = search_logic_bible_fragment (bible);
   fragment = filter_url_basename (fragment);
   vector <string> files = filter_url_scandir (search_logic_index_folder ());
@@ -451,6 +558,7 @@ void search_logic_delete_bible (string bible)
 
 void search_logic_delete_book (string bible, int book)
 {
+  search_terms_delete_book (bible, book);
   string fragment = search_logic_book_fragment (bible, book);
   fragment = filter_url_basename (fragment);
   vector <string> files = filter_url_scandir (search_logic_index_folder ());
@@ -465,6 +573,7 @@ void search_logic_delete_book (string bible, int book)
 
 void search_logic_delete_chapter (string bible, int book, int chapter)
 {
+  search_terms_delete_chapter (bible, book, chapter);
   string fragment = search_logic_chapter_file (bible, book, chapter);
   fragment = filter_url_basename (fragment);
   vector <string> files = filter_url_scandir (search_logic_index_folder ());
@@ -477,6 +586,35 @@ void search_logic_delete_chapter (string bible, int book, int chapter)
 }
 
 
+// Returns the lower case plain text of the verses in the $index of a chapter.
+map <int, string> search_logic_plain_lower_texts (const string & index)
+{
+  map <int, string> texts;
+  vector <string> lines = filter_string_explode (index, '\n');
+  vector <int> index_verses;
+  bool read_index_verse = false;
+  int index_item = 0;
+  for (auto & line : lines) {
+    if (read_index_verse) {
+      index_verses = search_logic_index_verses (line);
+      read_index_verse = false;
+    } else if (line == search_logic_verse_separator ()) {
+      read_index_verse = true;
+      index_item = 0;
+    } else if (line == search_logic_index_separator ()) {
+      index_item++;
+    } else if (index_item == PLAIN_LOWER) {
+      for (auto verse : index_verses) {
+        string & text = texts [verse];
+        if (!text.empty ()) text.append ("\n");
+        text.append (line);
+      }
+    }
+  }
+  return texts;
+}
+
+
 // Returns the total verse count within a $bible.
 int search_logic_get_verse_count (string bible)
 {
@@ -503,6 +641,7 @@ int search_logic_get_verse_count (string bible)
 // Copies the search index of Bible $original to Bible $destination.
 void search_logic_copy_bible (string original, string destination)
 {
+  search_terms_delete_bible (destination);
   string original_fragment = search_logic_bible_fragment (original);
   original_fragment = filter_url_basename (original_fragment);
   string destination_fragment = search_logic_bible_fragment (destination);
@@ -553,3 +692,118 @@ string search_logic_plain_replace_verse_text (string usfm)
   // Done.
   return plain_text;
 }
+
+
+// Searches the $bible for $searchfor, either in the plain text or in the USFM.
+// Returns the passages to replace the text in.
+vector <Passage> search_logic_search_bible (string bible, string searchfor, bool casesensitive, bool searchplain)
+{
+  if (casesensitive) {
+    if (searchplain) return search_logic_search_bible_text_case_sensitive (bible, searchfor);
+    return search_logic_search_bible_usfm_case_sensitive (bible, searchfor);
+  }
+  if (searchplain) return search_logic_search_bible_text (bible, searchfor);
+  return search_logic_search_bible_usfm (bible, searchfor);
+}
+
+
+// Replaces $searchfor with $replacewith in the $usfm of one verse.
+// It gives the updated USFM in $new_usfm, its plain text in $new_plain,
+// and the number of replacements made in $count.
+// Returns whether the replacement can be made safely.
+// When replacing in the plain text, this is the case
+// if doing the same replacement in the plain text gives the same text.
+bool search_logic_replace_verse (const string & usfm, const string & searchfor, const string & replacewith, bool casesensitive, bool searchplain, string & new_usfm, string & new_plain, int & count)
+{
+  // As a standard to compare against, get the plain text, do the replacements, and count them.
+  int standard_count = 0;
+  string standard_plain = search_logic_plain_replace_verse_text (usfm);
+  if (searchplain) {
+    if (casesensitive) {
+      standard_plain = filter_string_str_replace (searchfor, replacewith, standard_plain, &standard_count);
+    } else {
+      vector <string> needles = filter_string_search_needles (searchfor, standard_plain);
+      for (auto & needle : needles) {
+        standard_plain = filter_string_str_replace (needle, replacewith, standard_plain, &standard_count);
+      }
+    }
+  }
+
+  // Do the replacing in the USFM of the verse.
+  count = 0;
+  new_usfm = usfm;
+  if (casesensitive) {
+    new_usfm = filter_string_str_replace (searchfor, replacewith, new_usfm, &count);
+  } else {
+    vector <string> needles = filter_string_search_needles (searchfor, usfm);
+    for (auto & needle : needles) {
+      new_usfm = filter_string_str_replace (needle, replacewith, new_usfm, &count);
+    }
+  }
+
+  // The plain text of the updated USFM should be the same as the standard.
+  new_plain = search_logic_plain_replace_verse_text (new_usfm);
+  if (searchplain) {
+    if (count != standard_count) return false;
+    if (filter_string_trim (new_plain) != filter_string_trim (standard_plain)) return false;
+  }
+  return true;
+}
+
+
+// Plans the replacement of $searchfor with $replacewith in the $passages of the $bible.
+// It reads every chapter once, and does the replacements in all its verses.
+// Returns the chapters that have something to replace, with their updated USFM.
+vector <Search_Replace_Chapter> search_logic_plan_replace (string bible, const vector <Passage> & passages, string searchfor, string replacewith, bool casesensitive, bool searchplain)
+{
+  // Group the verses per chapter.
+  map <pair <int, int>, vector <int> > chapters;
+  for (auto & passage : passages) {
+    chapters [make_pair (passage.book, passage.chapter)].push_back (convert_to_int (passage.verse));
+  }
+
+  vector <Search_Replace_Chapter> plan;
+  for (auto & element : chapters) {
+    Search_Replace_Chapter replace = search_logic_plan_replace_chapter (bible, element.first.first, element.first.second, element.second, searchfor, replacewith, casesensitive, searchplain);
+    if (replace.verses.empty () && replace.failures.empty ()) continue;
+    plan.push_back (replace);
+  }
+  return plan;
+}
+
+
+// Plans the replacement of $searchfor with $replacewith in the $verses of one chapter.
+// It reads the chapter as it is now, and keeps that text in the plan,
+// so that storing the plan can check that the chapter did not change in the meantime.
+Search_Replace_Chapter search_logic_plan_replace_chapter (string bible, int book, int chapter, vector <int> verses, string searchfor, string replacewith, bool casesensitive, bool searchplain)
+{
+  Search_Replace_Chapter replace;
+  replace.book = book;
+  replace.chapter = chapter;
+  Database_Bibles database_bibles;
+  replace.old_usfm = database_bibles.getChapter (bible, book, chapter);
+  replace.new_usfm = replace.old_usfm;
+  sort (verses.begin (), verses.end ());
+  verses.erase (unique (verses.begin (), verses.end ()), verses.end ());
+  // Combined verses have the same USFM, and are replaced once.
+  set <string> already_processed;
+  for (auto verse : verses) {
+    string old_verse_usfm = usfm_get_verse_text (replace.old_usfm, verse);
+    if (already_processed.count (old_verse_usfm)) continue;
+    already_processed.insert (old_verse_usfm);
+    string new_verse_usfm, new_plain;
+    int count = 0;
+    bool okay = search_logic_replace_verse (old_verse_usfm, searchfor, replacewith, casesensitive, searchplain, new_verse_usfm, new_plain, count);
+    size_t pos = replace.new_usfm.find (old_verse_usfm);
+    if (!okay || (pos == string::npos)) {
+      replace.failures.push_back (verse);
+      continue;
+    }
+    if (count == 0) continue;
+    replace.new_usfm.erase (pos, old_verse_usfm.length ());
+    replace.new_usfm.insert (pos, new_verse_usfm);
+    replace.verses.push_back (verse);
+    replace.count += count;
+  }
+  return replace;
+}
@@ -25,11 +25,30 @@
 #include <filter/passage.h>
 
 
+// The replacement of text in one chapter of a Bible.
+class Search_Replace_Chapter
+{
+public:
+  int book = 0;
+  int chapter = 0;
+  string old_usfm;
+  string new_usfm;
+  // The verses the text was replaced in, and the verses where that could not be done safely.
+  vector <int> verses;
+  vector <int> failures;
+  // The number of replacements made.
+  int count = 0;
+};
+
+
 string search_logic_index_folder ();
 string search_logic_bible_fragment (string bible);
 string search_logic_book_fragment (string bible, int book);
 string search_logic_chapter_file (string bible, int book, int chapter);
 void search_logic_index_chapter (string bible, int book, int chapter);
+string search_logic_index_format ();
+string search_logic_chapter_hash (const string & usfm, const string & stylesheet);
+bool search_logic_index_current (string bible, int book, int chapter);
 vector <Passage> search_logic_search_text (string search, vector <string> bibles);
 vector <Passage> search_logic_search_bible_text (string bible, string search);
 vector <Passage> search_logic_search_bible_text_case_sensitive (string bible, string search);
@@ -40,9 +59,14 @@ string search_logic_get_bible_verse_usfm (string bible, int book, int chapter, i
 void search_logic_delete_bible (string bible);
 void search_logic_delete_book (string bible, int book);
 void search_logic_delete_chapter (string bible, int book, int chapter);
+map <int, string> search_logic_plain_lower_texts (const string & index);
 int search_logic_get_verse_count (string bible);
 void search_logic_copy_bible (string original, string destination);
 string search_logic_plain_replace_verse_text (string usfm);
+vector <Passage> search_logic_search_bible (string bible, string searchfor, bool casesensitive, bool searchplain);
+bool search_logic_replace_verse (const string & usfm, const string & searchfor, const string & replacewith, bool casesensitive, bool searchplain, string & new_usfm, string & new_plain, int & count);
+vector <Search_Replace_Chapter> search_logic_plan_replace (string bible, const vector <Passage> & passages, string searchfor, string replacewith, bool casesensitive, bool searchplain);
+Search_Replace_Chapter search_logic_plan_replace_chapter (string bible, int book, int chapter, vector <int> verses, string searchfor, string replacewith, bool casesensitive, bool searchplain);
 
 
 #endif
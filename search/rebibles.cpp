@@ -26,50 +26,123 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <database/bibles.h>
 #include <database/config/general.h>
 #include <search/logic.h>
+#include <filter/date.h>
+#include <filter/passage.h>
 #include <locale/translate.h>
 
 
-bool search_reindex_bibles_running = false;
+// Whether the Bibles are being indexed.
+// A request to index them while that goes on is remembered, and done after the current run.
+atomic <bool> search_reindex_bibles_running (false);
+atomic <bool> search_reindex_bibles_requested (false);
+atomic <bool> search_reindex_bibles_forced (false);
 
 
-void search_reindex_bibles (bool force)
+// Indexes the chapters of all Bibles, spread over as many threads as there are processor cores.
+// Without $force it indexes the chapters that have no index yet,
+// unless the format of the index changed since the last run.
+// With $force it also indexes the chapters whose text changed since they were indexed.
+static void search_reindex_bibles_run (bool force)
 {
-  if (!Database_Config_General::getIndexBibles ()) return;
-  
-  
-  // One simultaneous instance.
-  if (search_reindex_bibles_running) {
-    Database_Logs::log (translate ("Still indexing Bibles"), Filter_Roles::manager ());
-    return;
-  }
-  search_reindex_bibles_running = true;
+  string indexing_bibles = translate ("Indexing Bibles:");
 
+  // After an upgrade that changed the format of the index, the existing indexes are out of date.
+  // So check every chapter against its text.
+  string format = search_logic_index_format ();
+  if (Database_Config_General::getIndexBiblesFormat () != format) force = true;
   
-  string indexing_bible = translate ("Indexing Bible:");
-
-  
-  // This checks whether the data in the search index exists for all chapters in all Bibles.
-  // If it does not exist for a certain chapter, the index will be created.
   Database_Bibles database_bibles;
+  vector <Passage> chapters;
   vector <string> bibles = database_bibles.getBibles ();
   for (auto & bible : bibles) {
-    Database_Logs::log (indexing_bible + " " + translate ("Checking") + " " + bible, Filter_Roles::manager ());
     vector <int> books = database_bibles.getBooks (bible);
     for (auto book : books) {
-      vector <int> chapters = database_bibles.getChapters (bible, book);
-      for (auto chapter : chapters) {
-        string index = search_logic_chapter_file (bible, book, chapter);
-        if (!file_or_dir_exists (index) || force) {
-          string msg = indexing_bible + " " + bible + " " + filter_passage_display (book, chapter, "");
-          Database_Logs::log (msg, Filter_Roles::manager ());
-          search_logic_index_chapter (bible, book, chapter);
-        }
+      vector <int> book_chapters = database_bibles.getChapters (bible, book);
+      for (auto chapter : book_chapters) {
+        chapters.push_back (Passage (bible, book, chapter, ""));
       }
     }
   }
+  Database_Logs::log (indexing_bibles + " " + translate ("Checking") + " " + convert_to_string (chapters.size ()) + " " + translate ("chapters"), Filter_Roles::manager ());
+
+  
+  int start = filter_date_seconds_since_epoch ();
+  atomic <int> reported (start);
+  atomic <size_t> next (0);
+  atomic <size_t> done (0);
+  atomic <size_t> indexed (0);
+  
+  auto index = [&] (size_t i) {
+    const Passage & passage = chapters [i];
+    bool current;
+    if (force) current = search_logic_index_current (passage.bible, passage.book, passage.chapter);
+    else current = file_or_dir_exists (search_logic_chapter_file (passage.bible, passage.book, passage.chapter));
+    if (!current) {
+      search_logic_index_chapter (passage.bible, passage.book, passage.chapter);
+      indexed++;
+    }
+    done++;
+    // Report the throughput and the time left every half minute, by one of the threads.
+    int now = filter_date_seconds_since_epoch ();
+    int previous = reported;
+    if (now - previous < 30) return;
+    if (!reported.compare_exchange_strong (previous, now)) return;
+    size_t count = done;
+    float rate = (float) count / (now - start);
+    int left = round ((chapters.size () - count) / rate);
+    Database_Logs::log (indexing_bibles + " " + convert_to_string (count) + "/" + convert_to_string (chapters.size ()) + " " + translate ("chapters") + ", " + convert_to_string ((int) round (rate)) + " " + translate ("per second") + ", " + translate ("ready in about") + " " + convert_to_string (left) + " " + translate ("seconds"), Filter_Roles::manager ());
+  };
+  
+  // The first chapter of every Bible goes on its own,
+  // so that the settings and stylesheet caches it fills for that Bible are there for all threads.
+  vector <bool> warmed (chapters.size (), false);
+  for (size_t i = 0; i < chapters.size (); i++) {
+    if (i && (chapters [i].bible == chapters [i - 1].bible)) continue;
+    index (i);
+    warmed [i] = true;
+  }
+
+  auto worker = [&] () {
+    size_t i;
+    while ((i = next++) < chapters.size ()) {
+      if (!warmed [i]) index (i);
+    }
+  };
+  
+  size_t count = thread::hardware_concurrency ();
+  vector <thread> threads;
+  for (size_t i = 1; i < count; i++) threads.push_back (thread (worker));
+  worker ();
+  for (auto & thread : threads) thread.join ();
+  Database_Config_General::setIndexBiblesFormat (format);
+
   
+  int seconds = filter_date_seconds_since_epoch () - start;
+  Database_Logs::log (indexing_bibles + " " + translate ("Ready") + ", " + convert_to_string ((size_t) indexed) + "/" + convert_to_string (chapters.size ()) + " " + translate ("chapters indexed in") + " " + convert_to_string (seconds) + " " + translate ("seconds"), Filter_Roles::manager ());
+}
+
+
+void search_reindex_bibles (bool force)
+{
+  if (!Database_Config_General::getIndexBibles ()) return;
   
-  Database_Logs::log (indexing_bible + " " + translate ("Ready"), Filter_Roles::manager ());
-  Database_Config_General::setIndexBibles (false);
-  search_reindex_bibles_running = false;
+  
+  // Remember the request, so that a run that is going on picks it up.
+  if (force) search_reindex_bibles_forced = true;
+  search_reindex_bibles_requested = true;
+  
+  
+  // One simultaneous instance.
+  if (search_reindex_bibles_running.exchange (true)) {
+    Database_Logs::log (translate ("Still indexing Bibles"), Filter_Roles::manager ());
+    return;
+  }
+  do {
+    while (search_reindex_bibles_requested.exchange (false)) {
+      search_reindex_bibles_run (search_reindex_bibles_forced.exchange (false));
+    }
+    Database_Config_General::setIndexBibles (false);
+    search_reindex_bibles_running = false;
+    // A request that came in just before the run ended gets done now.
+  } while (search_reindex_bibles_requested && !search_reindex_bibles_running.exchange (true));
 }
@@ -31,6 +31,8 @@
 #include <access/bible.h>
 #include <ipc/focus.h>
 #include <menu/logic.h>
+#include <tasks/logic.h>
+#include <search/logic.h>
 
 
 string search_replace2_url ()
@@ -50,8 +52,69 @@ bool search_replace2_acl (void * webserver_request)
 
 string search_replace2 (void * webserver_request)
 {
-  // Build the advanced replace page.
   Webserver_Request * request = (Webserver_Request *) webserver_request;
+  
+  // Preview the replacement of all hits, per chapter, before doing it in the background.
+  if (request->query.count ("plan")) {
+    string bible = request->query ["b"];
+    string searchfor = request->query ["q"];
+    string replacewith = request->query ["r"];
+    bool casesensitive = (request->query ["c"] == "true");
+    bool searchplain = (request->query ["p"] == "true");
+    string user = request->session_logic ()->currentUser ();
+    if (searchfor.empty ()) return "";
+    if (!access_bible_read (webserver_request, bible)) return "";
+    vector <Passage> passages = search_logic_search_bible (bible, searchfor, casesensitive, searchplain);
+    vector <Search_Replace_Chapter> plan = search_logic_plan_replace (bible, passages, searchfor, replacewith, casesensitive, searchplain);
+    int count = 0;
+    string chapters;
+    for (auto & replace : plan) {
+      // The background task leaves the books the user cannot write to alone, so list them as failures.
+      if (!access_bible_book_write (webserver_request, user, bible, replace.book)) {
+        replace.failures.insert (replace.failures.end (), replace.verses.begin (), replace.verses.end ());
+        sort (replace.failures.begin (), replace.failures.end ());
+        replace.verses.clear ();
+        replace.count = 0;
+      }
+      count += replace.count;
+      chapters.append ("<div>");
+      if (!replace.verses.empty ()) {
+        vector <string> verses;
+        for (auto verse : replace.verses) verses.push_back (convert_to_string (verse));
+        chapters.append (filter_passage_display (replace.book, replace.chapter, filter_string_implode (verses, ", ")));
+        chapters.append (": " + convert_to_string (replace.count) + " " + translate ("replacements"));
+      }
+      if (!replace.failures.empty ()) {
+        vector <string> verses;
+        for (auto verse : replace.failures) verses.push_back (convert_to_string (verse));
+        if (!replace.verses.empty ()) chapters.append (" ");
+        chapters.append (translate ("The text could not be automatically replaced in:") + " " + filter_passage_display (replace.book, replace.chapter, filter_string_implode (verses, ", ")));
+      }
+      chapters.append ("</div>\n");
+    }
+    return "<p>" + convert_to_string (count) + " " + translate ("replacements") + " " + translate ("in") + " " + convert_to_string (plan.size ()) + " " + translate ("chapters") + "</p>\n" + chapters;
+  }
+
+  // Replace all hits in one go through a background task.
+  // The page posts this once the user has seen the preview and confirmed it.
+  if (request->post.count ("bulk")) {
+    string bible = request->post ["b"];
+    string searchfor = request->post ["q"];
+    string replacewith = request->post ["r"];
+    string casesensitive = convert_to_string (request->post ["c"] == "true");
+    string searchplain = convert_to_string (request->post ["p"] == "true");
+    string user = request->session_logic ()->currentUser ();
+    if (searchfor.empty ()) return "";
+    if (!access_bible_read (webserver_request, bible)) return "";
+    // The task stores its parameters one per line, so a line break in any of them would shift the ones after it.
+    for (auto & parameter : {bible, searchfor, replacewith}) {
+      if (parameter.find_first_of ("\r\n") != string::npos) return translate ("The text to search for or to replace with cannot contain a new line.");
+    }
+    tasks_logic_queue (REPLACEBIBLE, {bible, searchfor, replacewith, casesensitive, searchplain, user});
+    return translate ("The text is being replaced in the background.") + " " + translate ("The Journal shows the progress.");
+  }
+  
+  // Build the advanced replace page.
   string bible = request->database_config_user()->getBible ();
   string page;
   Assets_Header header = Assets_Header (translate("Replace"), request);
@@ -21,6 +21,8 @@ $(document).ready (function () {
   $ ("#searchloading").hide ();
   $ ("progress").hide ();
   $ ("#applybutton").hide ();
+  $ ("#bulkbutton").hide ();
+  $ ("#confirmbutton").hide ();
   $ ("#searchentry").focus ();
   $ ("#searchentry").on ("keypress", function (event) {
     if (event.keyCode == 13) {
@@ -42,6 +44,12 @@ $(document).ready (function () {
     $ ("#applybutton").hide ();
     replaceAll ();
   });
+  $ ("#bulkbutton").on ("click", function (event) {
+    planBulk ();
+  });
+  $ ("#confirmbutton").on ("click", function (event) {
+    replaceBulk ();
+  });
   $ ("#searchresults").on ("click", function (event) {
     handleClick (event);
   });
@@ -77,6 +85,8 @@ function fetchIdentifiers ()
   $ ("#searchresults").empty ();
   $ ("#hitcount").empty ();
   $ ("#applybutton").hide ();
+  $ ("#bulkbutton").hide ();
+  $ ("#confirmbutton").hide ();
   hits.length = 0;
   replacingAll = false;
   ajaxRequest = $.ajax ({
@@ -96,6 +106,7 @@ function fetchIdentifiers ()
       $ ("#searchloading").hide ();
       $ ("#hitcount").text (hits.length);
       $ ("progress").attr ("max", hits.length);
+      if (hits.length > 0) $ ("#bulkbutton").show (1000);
       hitCounter = 0;
       fetchPreviews ();
     }
@@ -184,3 +195,48 @@ function replaceAll ()
 }
 
 
+
+
+// Shows per chapter what replacing all hits would do.
+function planBulk ()
+{
+  try {
+    ajaxRequest.abort ();
+  } catch (err) {
+  }
+  $ ("progress").hide ();
+  $ ("#applybutton").hide ();
+  $ ("#bulkbutton").hide ();
+  $ ("#searchloading").show ();
+  $ ("#searchresults").empty ();
+  hits.length = 0;
+  replacingAll = false;
+  ajaxRequest = $.ajax ({
+    url: "replace2",
+    type: "GET",
+    data: { plan: "", b: searchBible, q: searchfor, c: casesensitive, r: replacewith, p: searchplain },
+    success: function (response) {
+      $ ("#searchresults").append (response);
+      $ ("#confirmbutton").show (1000);
+    },
+    complete: function (xhr, status) {
+      $ ("#searchloading").hide ();
+    }
+  });
+}
+
+
+// Replaces all hits in the background, once the plan was seen.
+function replaceBulk ()
+{
+  $ ("#confirmbutton").hide ();
+  $.ajax ({
+    url: "replace2",
+    type: "POST",
+    data: { bulk: "", b: searchBible, q: searchfor, c: casesensitive, r: replacewith, p: searchplain },
+    success: function (response) {
+      $ ("#searchresults").empty ();
+      $ ("#searchresults").append ($ ("<p>").text (response));
+    }
+  });
+}
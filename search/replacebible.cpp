@@ -0,0 +1,100 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+#include <search/replacebible.h>
+#include <filter/string.h>
+#include <filter/roles.h>
+#include <filter/passage.h>
+#include <database/logs.h>
+#include <database/books.h>
+#include <database/bibles.h>
+#include <webserver/request.h>
+#include <search/logic.h>
+#include <locale/translate.h>
+#include <access/bible.h>
+#include <bb/logic.h>
+
+
+// Stores the chapter with the text replaced, if the chapter is still the text the replacements were made in.
+// Returns whether it stored the chapter.
+bool search_replace_bible_store (string bible, const Search_Replace_Chapter & replace)
+{
+  Database_Bibles database_bibles;
+  if (database_bibles.getChapter (bible, replace.book, replace.chapter) != replace.old_usfm) return false;
+  bible_logic_store_chapter (bible, replace.book, replace.chapter, replace.new_usfm);
+  return true;
+}
+
+
+// Replaces $searchfor with $replacewith throughout the $bible, as a background task.
+// It finds the verses through the search index, and stores every changed chapter once,
+// so there is one modification record and one update of the search index per chapter.
+// Each chapter is planned right before it is stored, from its text at that moment.
+// A chapter that gets saved by someone else in between is left alone.
+void search_replace_bible (string bible, string searchfor, string replacewith, bool casesensitive, bool searchplain, string user)
+{
+  if (searchfor.empty ()) return;
+
+  string replacing = translate ("Replacing in Bible") + " " + bible + ":";
+
+  // Group the verses per chapter.
+  vector <Passage> passages = search_logic_search_bible (bible, searchfor, casesensitive, searchplain);
+  map <pair <int, int>, vector <int> > chapters;
+  for (auto & passage : passages) {
+    chapters [make_pair (passage.book, passage.chapter)].push_back (convert_to_int (passage.verse));
+  }
+  Database_Logs::log (replacing + " " + searchfor + " ▶ " + replacewith + ": " + convert_to_string (passages.size ()) + " " + translate ("verses in") + " " + convert_to_string (chapters.size ()) + " " + translate ("chapters"), Filter_Roles::translator ());
+
+  Webserver_Request request;
+  int count = 0;
+  vector <string> failures;
+  vector <string> changed;
+  size_t done = 0;
+  for (auto iterator = chapters.begin (); iterator != chapters.end (); iterator++) {
+    done++;
+    int book = iterator->first.first;
+    int chapter = iterator->first.second;
+    if (!access_bible_book_write (&request, user, bible, book)) {
+      failures.push_back (filter_passage_display (book, chapter, ""));
+      continue;
+    }
+    Search_Replace_Chapter replace = search_logic_plan_replace_chapter (bible, book, chapter, iterator->second, searchfor, replacewith, casesensitive, searchplain);
+    for (auto verse : replace.failures) {
+      failures.push_back (filter_passage_display (book, chapter, convert_to_string (verse)));
+    }
+    if (!replace.verses.empty ()) {
+      if (search_replace_bible_store (bible, replace)) count += replace.count;
+      else changed.push_back (filter_passage_display (book, chapter, ""));
+    }
+    // Report the progress at the end of every book.
+    auto next = iterator;
+    next++;
+    if ((next == chapters.end ()) || (next->first.first != book)) {
+      Database_Logs::log (replacing + " " + Database_Books::getEnglishFromId (book) + ": " + convert_to_string (done) + "/" + convert_to_string (chapters.size ()) + " " + translate ("chapters"), Filter_Roles::translator ());
+    }
+  }
+
+  if (!failures.empty ()) {
+    Database_Logs::log (replacing + " " + translate ("The text could not be automatically replaced in:") + " " + filter_string_implode (failures, ", "), Filter_Roles::translator ());
+  }
+  if (!changed.empty ()) {
+    Database_Logs::log (replacing + " " + translate ("These chapters were changed while replacing, and were left as they are:") + " " + filter_string_implode (changed, ", "), Filter_Roles::translator ());
+  }
+  Database_Logs::log (replacing + " " + translate ("Ready") + ": " + convert_to_string (count) + " " + translate ("replacements"), Filter_Roles::translator ());
+}
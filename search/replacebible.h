@@ -0,0 +1,32 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+#ifndef INCLUDED_SEARCH_REPLACEBIBLE_H
+#define INCLUDED_SEARCH_REPLACEBIBLE_H
+
+
+#include <config/libraries.h>
+#include <search/logic.h>
+
+
+bool search_replace_bible_store (string bible, const Search_Replace_Chapter & replace);
+void search_replace_bible (string bible, string searchfor, string replacewith, bool casesensitive, bool searchplain, string user);
+
+
+#endif
@@ -82,34 +82,11 @@ string search_replacego (void * webserver_request)
   string old_verse_usfm = usfm_get_verse_text (old_chapter_usfm, verse);
 
   
-  // As a standard to compare against,
-  // get the plain text from the search database,
-  // do the replacements,
-  // get the length difference due to the replacemenents,
-  // and get the desired new plain text.
-  int plain_replacement_count = 0;
-  string standardPlainText = search_logic_plain_replace_verse_text (old_verse_usfm);
-  if (casesensitive) {
-    standardPlainText = filter_string_str_replace (searchfor, replacewith, standardPlainText, &plain_replacement_count);
-  } else {
-    vector <string> needles = filter_string_search_needles (searchfor, standardPlainText);
-    for (auto & needle : needles) {
-      standardPlainText = filter_string_str_replace (needle, replacewith, standardPlainText, &plain_replacement_count);
-    }
-  }
-  
-  
-  // Do the replacing in the verse USFM, and count how many replacement were made.
-  int usfm_replacement_count = 0;
-  string new_verse_usfm (old_verse_usfm);
-  if (casesensitive) {
-    new_verse_usfm = filter_string_str_replace (searchfor, replacewith, new_verse_usfm, &usfm_replacement_count);
-  } else {
-    vector <string> needles = filter_string_search_needles (searchfor, old_verse_usfm);
-    for (auto & needle : needles) {
-      new_verse_usfm = filter_string_str_replace (needle, replacewith, new_verse_usfm, &usfm_replacement_count);
-    }
-  }
+  // Do the replacing in the verse USFM, and check that the plain text gets updated the same way.
+  string new_verse_usfm;
+  string updatedPlainText;
+  int replacement_count = 0;
+  bool replacementOkay = search_logic_replace_verse (old_verse_usfm, searchfor, replacewith, casesensitive, true, new_verse_usfm, updatedPlainText, replacement_count);
   
   
   // Get the updated chapter USFM as a string.
@@ -122,16 +99,6 @@ string search_replacego (void * webserver_request)
   }
   
   
-  // Get the updated plain text of the correct verse of the updated USFM.
-  string updatedPlainText = search_logic_plain_replace_verse_text (new_verse_usfm);
-  
-  
-  // Check that the standard and real number of replacements, and the standard and new texts, are the same.
-  bool replacementOkay = true;
-  if (plain_replacement_count != usfm_replacement_count) replacementOkay = false;
-  if (filter_string_trim (updatedPlainText) != filter_string_trim (standardPlainText)) replacementOkay = false;
-
-  
   // Generate success or failure icon.
   string icon;
   if (replacementOkay && write) {
@@ -83,35 +83,12 @@ string search_replacego2 (void * webserver_request)
   string old_verse_usfm = usfm_get_verse_text (old_chapter_usfm, verse);
   
   
-  // As a standard to compare against, get the plain text from the search database,
-  // do the replacements, count the replacements, and then get the desired new plain text.
-  // This only applies when searching/replacing in the plain text, not when doing it in the USFM.
-  int standardReplacementCount = 0;
-  string standardPlainText = search_logic_plain_replace_verse_text (old_verse_usfm);
-  if (searchplain) {
-    if (casesensitive) {
-      standardPlainText = filter_string_str_replace (searchfor, replacewith, standardPlainText, &standardReplacementCount);
-    } else {
-      vector <string> needles = filter_string_search_needles (searchfor, standardPlainText);
-      for (auto & needle : needles) {
-        standardPlainText = filter_string_str_replace (needle, replacewith, standardPlainText, &standardReplacementCount);
-      }
-    }
-  }
-  
+  // Do the replacing in the verse USFM, and check that the plain text gets updated the same way.
+  string new_verse_usfm;
+  string updatedPlainText;
+  int replacement_count = 0;
+  bool replacementOkay = search_logic_replace_verse (old_verse_usfm, searchfor, replacewith, casesensitive, searchplain, new_verse_usfm, updatedPlainText, replacement_count);
   
-  // Do the replacing in the correct verse of the raw verse USFM.
-  string new_verse_usfm (old_verse_usfm);
-  int usfmReplacementCount = 0;
-  if (casesensitive) {
-    new_verse_usfm = filter_string_str_replace (searchfor, replacewith, new_verse_usfm, &usfmReplacementCount);
-  } else {
-    vector <string> needles = filter_string_search_needles (searchfor, new_verse_usfm);
-    for (auto & needle : needles) {
-      new_verse_usfm = filter_string_str_replace (needle, replacewith, new_verse_usfm, &usfmReplacementCount);
-    }
-  }
-
   
   // Create the updated chapter USFM as a string.
   string new_chapter_usfm = old_chapter_usfm;
@@ -123,20 +100,6 @@ string search_replacego2 (void * webserver_request)
   }
 
   
-  // Get the updated plain text of the correct verse of the updated USFM.
-  // This is for search/replace in plain text, not in USFM.
-  string updatedPlainText = search_logic_plain_replace_verse_text (new_verse_usfm);
-
-  
-  // Check that the standard and real number of replacements, and the standard and new texts, are the same.
-  // This is for search/replace in plain text, not in USFM.
-  bool replacementOkay = true;
-  if (searchplain) {
-    if (usfmReplacementCount != standardReplacementCount) replacementOkay = false;
-    if (filter_string_trim (updatedPlainText) != filter_string_trim (standardPlainText)) replacementOkay = false;
-  }
-  
-  
   // Generate success or failure icon.
   string icon;
   if (replacementOkay && write) {
@@ -30,6 +30,7 @@
 #include <database/config/bible.h>
 #include <ipc/focus.h>
 #include <search/logic.h>
+#include <search/terms.h>
 #include <menu/logic.h>
 #include <access/bible.h>
 
@@ -89,44 +90,9 @@ string search_similar (void * webserver_request)
     string words = request->query ["words"];
     words = filter_string_trim (words);
     Database_Volatile::setValue (myIdentifier, "searchsimilar", words);
-    vector <string> vwords = filter_string_explode (words, ' ');
     
-    // Include items if there are no more search hits than 30% of the total number of verses in the Bible.
-    size_t maxcount = round (0.3 * search_logic_get_verse_count (bible));
-    
-    // Store how often a verse occurs in an array.
-    // The keys are the identifiers of the search results.
-    // The values are how often the identifiers occur in the entire focused verse.
-    map <int, int> identifiers;
-    
-    for (auto & word : vwords) {
-      
-      // Find out how often this word occurs in the Bible. Skip if too often.
-      vector <Passage> passages = search_logic_search_bible_text (bible, word);
-      if (passages.size () > maxcount) continue;
-      
-      // Store the identifiers and their count.
-      for (auto & passage : passages) {
-        int id = filter_passage_to_integer (passage);
-        if (identifiers.count (id)) identifiers [id]++;
-        else identifiers [id] = 1;
-      }
-      
-    }
-    
-    // Sort on occurrence from high to low.
-    // Skip identifiers that only occur once.
-    vector <int> ids;
-    vector <int> counts;
-    for (auto & element : identifiers) {
-      int id = element.first;
-      int count = element.second;
-      if (count <= 1) continue;
-      ids.push_back (id);
-      counts.push_back (count);
-    }
-    quick_sort (counts, ids, 0, counts.size());
-    reverse (ids.begin(), ids.end());
+    // Score the verses on the terms they share with the words, the most similar ones first.
+    vector <int> ids = search_terms_similar (bible, words);
 
     // Output the passage identifiers to the browser.
     string output;
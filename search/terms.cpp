@@ -0,0 +1,293 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <search/terms.h>
+#include <search/logic.h>
+#include <filter/string.h>
+#include <filter/url.h>
+#include <filter/passage.h>
+#include <database/bibles.h>
+
+
+// The term statistics of the verses of one Bible.
+// The similar verses are found by merging the postings of the terms of the focused verse,
+// rather than by searching the whole Bible once for every word.
+class Search_Terms_Bible
+{
+public:
+  // The postings of every term: the passage identifiers of the verses it occurs in,
+  // with how often it occurs in each of them.
+  unordered_map <string, map <int, int> > postings;
+  // The distinct terms of every verse, so a verse can be removed again.
+  map <int, vector <string> > terms;
+  // The length in terms of every verse, and of all verses together.
+  map <int, int> lengths;
+  long total = 0;
+  void add (int id, const string & text);
+  void remove (int first, int last);
+};
+
+
+// Adds the lower case $text of the verse with passage identifier $id.
+void Search_Terms_Bible::add (int id, const string & text)
+{
+  vector <string> tokens = search_terms_tokenize (text);
+  if (tokens.empty ()) return;
+  vector <string> & distinct = terms [id];
+  for (auto & token : tokens) {
+    int & frequency = postings [token] [id];
+    if (frequency == 0) distinct.push_back (token);
+    frequency++;
+  }
+  lengths [id] += tokens.size ();
+  total += tokens.size ();
+}
+
+
+// Removes the verses with passage identifiers from $first up to but not including $last.
+void Search_Terms_Bible::remove (int first, int last)
+{
+  auto begin = terms.lower_bound (first);
+  auto end = terms.lower_bound (last);
+  for (auto iterator = begin; iterator != end; iterator++) {
+    for (auto & term : iterator->second) {
+      auto posting = postings.find (term);
+      if (posting == postings.end ()) continue;
+      posting->second.erase (iterator->first);
+      if (posting->second.empty ()) postings.erase (posting);
+    }
+  }
+  terms.erase (begin, end);
+  auto from = lengths.lower_bound (first);
+  auto to = lengths.lower_bound (last);
+  for (auto iterator = from; iterator != to; iterator++) {
+    total -= iterator->second;
+  }
+  lengths.erase (from, to);
+}
+
+
+// The term statistics of the Bibles used most recently, with when each of them was used last.
+class Search_Terms_Loaded
+{
+public:
+  shared_ptr <Search_Terms_Bible> index;
+  long used = 0;
+};
+
+
+#define SEARCH_TERMS_MAXIMUM_BIBLES 5
+mutex search_terms_mutex;
+map <string, Search_Terms_Loaded> search_terms_bibles;
+long search_terms_sequence = 0;
+// The number of changes of every Bible, also of Bibles whose statistics are not loaded.
+map <string, long> search_terms_changes;
+
+
+// Splits lower case $text into its terms.
+// A term is a run of text between white space, with any punctuation around it removed.
+vector <string> search_terms_tokenize (const string & text)
+{
+  vector <string> tokens;
+  size_t length = text.length ();
+  size_t position = 0;
+  while (position < length) {
+    while ((position < length) && isspace ((unsigned char) text [position])) position++;
+    size_t start = position;
+    while ((position < length) && !isspace ((unsigned char) text [position])) position++;
+    size_t end = position;
+    // Remove punctuation from the start of the term.
+    while (start < end) {
+      unsigned char byte = text [start];
+      size_t size = 1;
+      if (byte >= 0xf0) size = 4;
+      else if (byte >= 0xe0) size = 3;
+      else if (byte >= 0xc0) size = 2;
+      size = min (size, end - start);
+      bool punctuation;
+      if (byte < 0x80) punctuation = ispunct (byte);
+      else punctuation = unicode_string_is_punctuation (text.substr (start, size));
+      if (!punctuation) break;
+      start += size;
+    }
+    // Remove punctuation from the end of the term.
+    while (end > start) {
+      size_t last = end - 1;
+      while ((last > start) && ((text [last] & 0xc0) == 0x80)) last--;
+      unsigned char byte = text [last];
+      bool punctuation;
+      if (byte < 0x80) punctuation = ispunct (byte);
+      else punctuation = unicode_string_is_punctuation (text.substr (last, end - last));
+      if (!punctuation) break;
+      end = last;
+    }
+    if (end > start) tokens.push_back (text.substr (start, end - start));
+  }
+  return tokens;
+}
+
+
+// Reads the term statistics of the $bible from the search index of all its chapters.
+static shared_ptr <Search_Terms_Bible> search_terms_load (const string & bible)
+{
+  shared_ptr <Search_Terms_Bible> index = make_shared <Search_Terms_Bible> ();
+  Database_Bibles database_bibles;
+  vector <int> books = database_bibles.getBooks (bible);
+  for (auto book : books) {
+    vector <int> chapters = database_bibles.getChapters (bible, book);
+    for (auto chapter : chapters) {
+      string path = search_logic_chapter_file (bible, book, chapter);
+      string contents = filter_url_file_get_contents (path);
+      map <int, string> texts = search_logic_plain_lower_texts (contents);
+      for (auto & element : texts) {
+        index->add (filter_passage_to_integer (Passage ("", book, chapter, convert_to_string (element.first))), element.second);
+      }
+    }
+  }
+  return index;
+}
+
+
+// Gets the term statistics of the $bible.
+// The caller should hold the $lock.
+// Loading the statistics the first time takes a while, so the lock is released meanwhile.
+// If the Bible changed while loading, the statistics are used this once, and not kept.
+static shared_ptr <Search_Terms_Bible> search_terms_get (const string & bible, unique_lock <mutex> & lock)
+{
+  auto iterator = search_terms_bibles.find (bible);
+  if (iterator == search_terms_bibles.end ()) {
+    long changes = search_terms_changes [bible];
+    lock.unlock ();
+    shared_ptr <Search_Terms_Bible> index = search_terms_load (bible);
+    lock.lock ();
+    // Another thread may have loaded them in the meantime.
+    iterator = search_terms_bibles.find (bible);
+    if (iterator == search_terms_bibles.end ()) {
+      if (search_terms_changes [bible] != changes) return index;
+      // Make space by forgetting the Bible used longest ago.
+      if (search_terms_bibles.size () >= SEARCH_TERMS_MAXIMUM_BIBLES) {
+        auto oldest = search_terms_bibles.begin ();
+        for (auto iter = oldest; iter != search_terms_bibles.end (); iter++) {
+          if (iter->second.used < oldest->second.used) oldest = iter;
+        }
+        search_terms_bibles.erase (oldest);
+      }
+      iterator = search_terms_bibles.insert ({bible, Search_Terms_Loaded ()}).first;
+      iterator->second.index = index;
+    }
+  }
+  iterator->second.used = ++search_terms_sequence;
+  return iterator->second.index;
+}
+
+
+// Updates the term statistics of the $chapter of the $book of the $bible
+// from the lower case plain $texts of its verses.
+// If the statistics have not yet been loaded, this is left to the first lookup.
+void search_terms_update_chapter (const string & bible, int book, int chapter, const map <int, string> & texts)
+{
+  lock_guard <mutex> lock (search_terms_mutex);
+  search_terms_changes [bible]++;
+  auto iterator = search_terms_bibles.find (bible);
+  if (iterator == search_terms_bibles.end ()) return;
+  int first = filter_passage_to_integer (Passage ("", book, chapter, "0"));
+  iterator->second.index->remove (first, first + 1000);
+  for (auto & element : texts) {
+    iterator->second.index->add (first + element.first, element.second);
+  }
+}
+
+
+void search_terms_delete_bible (const string & bible)
+{
+  lock_guard <mutex> lock (search_terms_mutex);
+  search_terms_changes [bible]++;
+  search_terms_bibles.erase (bible);
+}
+
+
+void search_terms_delete_book (const string & bible, int book)
+{
+  lock_guard <mutex> lock (search_terms_mutex);
+  search_terms_changes [bible]++;
+  auto iterator = search_terms_bibles.find (bible);
+  if (iterator == search_terms_bibles.end ()) return;
+  int first = filter_passage_to_integer (Passage ("", book, 0, "0"));
+  iterator->second.index->remove (first, first + 1000000);
+}
+
+
+void search_terms_delete_chapter (const string & bible, int book, int chapter)
+{
+  lock_guard <mutex> lock (search_terms_mutex);
+  search_terms_changes [bible]++;
+  auto iterator = search_terms_bibles.find (bible);
+  if (iterator == search_terms_bibles.end ()) return;
+  int first = filter_passage_to_integer (Passage ("", book, chapter, "0"));
+  iterator->second.index->remove (first, first + 1000);
+}
+
+
+// Finds the verses in the $bible that are similar to the $text.
+// Returns their passage identifiers, the most similar one first.
+// The verses are scored with Okapi BM25 on the terms they share with the $text.
+// Terms that occur in more than 30% of the verses are left out,
+// and so are verses that share only one term with the $text.
+vector <int> search_terms_similar (const string & bible, const string & text)
+{
+  vector <string> query = search_terms_tokenize (unicode_string_casefold (text));
+  sort (query.begin (), query.end ());
+  query.erase (unique (query.begin (), query.end ()), query.end ());
+
+  unique_lock <mutex> lock (search_terms_mutex);
+  shared_ptr <Search_Terms_Bible> index = search_terms_get (bible, lock);
+
+  double verses = index->lengths.size ();
+  if (verses == 0) return {};
+  double average = index->total / verses;
+  size_t maxcount = round (0.3 * verses);
+  const double k1 = 1.2;
+  const double b = 0.75;
+
+  unordered_map <int, double> scores;
+  unordered_map <int, int> matches;
+  for (auto & term : query) {
+    auto posting = index->postings.find (term);
+    if (posting == index->postings.end ()) continue;
+    double frequency = posting->second.size ();
+    if (frequency > maxcount) continue;
+    double idf = log (1 + (verses - frequency + 0.5) / (frequency + 0.5));
+    for (auto & element : posting->second) {
+      double tf = element.second;
+      double length = index->lengths [element.first];
+      scores [element.first] += idf * tf * (k1 + 1) / (tf + k1 * (1 - b + b * length / average));
+      matches [element.first]++;
+    }
+  }
+
+  vector <pair <double, int> > ranking;
+  for (auto & element : scores) {
+    if (matches [element.first] <= 1) continue;
+    ranking.push_back ({- element.second, element.first});
+  }
+  sort (ranking.begin (), ranking.end ());
+  vector <int> ids;
+  for (auto & element : ranking) ids.push_back (element.second);
+  return ids;
+}
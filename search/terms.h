@@ -0,0 +1,36 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+
+#ifndef INCLUDED_SEARCH_TERMS_H
+#define INCLUDED_SEARCH_TERMS_H
+
+
+#include <config/libraries.h>
+
+
+vector <string> search_terms_tokenize (const string & text);
+void search_terms_update_chapter (const string & bible, int book, int chapter, const map <int, string> & texts);
+void search_terms_delete_bible (const string & bible);
+void search_terms_delete_book (const string & bible, int book);
+void search_terms_delete_chapter (const string & bible, int book, int chapter);
+vector <int> search_terms_similar (const string & bible, const string & text);
+
+
+#endif
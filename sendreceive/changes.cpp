@@ -87,8 +87,7 @@ void sendreceive_changes ()
   
   if (!database_modifications.healthy ()) {
     Database_Logs::log (sendreceive_changes_text () + translate("Recreate damaged modifications database"), Filter_Roles::translator ());
-    database_modifications.erase ();
-    database_modifications.create ();
+    database_modifications.checkup ();
   }
   
   
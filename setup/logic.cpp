@@ -38,6 +38,11 @@
 #include <database/privileges.h>
 #include <database/git.h>
 #include <database/statistics.h>
+#include <database/etcbc4.h>
+#include <database/kjv.h>
+#include <database/oshb.h>
+#include <database/sblgnt.h>
+#include <database/morphgnt.h>
 #include <styles/sheets.h>
 #include <filter/string.h>
 #include <filter/url.h>
@@ -46,6 +51,7 @@
 #include <demo/logic.h>
 #include <locale/logic.h>
 #include <tasks/logic.h>
+#include <search/logic.h>
 #include <database/logic.h>
 
 
@@ -119,6 +125,10 @@ void setup_conditionally (const char * package)
   // the app may shut down before the tasks have been completed.
   // Next time the app starts, the tasks will be restarted here, and they will run if a flag was set for them.
   // Once the tasks are really complete, they will clear the flag.
+  // When the format of the Bible indexes changed, they get rebuilt.
+  if (Database_Config_General::getIndexBiblesFormat () != search_logic_index_format ()) {
+    Database_Config_General::setIndexBibles (true);
+  }
   tasks_logic_queue (REINDEXBIBLES);
   tasks_logic_queue (REINDEXNOTES);
 #ifdef HAVE_CLIENT
@@ -273,6 +283,18 @@ void setup_initialize_data ()
   Database_Statistics::create ();
   Database_Statistics::optimize ();
 #endif
+  // The columnar stores of the original-language texts.
+  config_globals_setup_message = "original languages";
+  Database_Etcbc4 database_etcbc4;
+  database_etcbc4.compile ();
+  Database_Kjv database_kjv;
+  database_kjv.compile ();
+  Database_OsHb database_oshb;
+  database_oshb.compile ();
+  Database_Sblgnt database_sblgnt;
+  database_sblgnt.compile ();
+  Database_MorphGnt database_morphgnt;
+  database_morphgnt.compile ();
 
   // Create stylesheets.
   config_globals_setup_message = "stylesheets";
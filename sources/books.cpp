@@ -0,0 +1,124 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <sources/books.h>
+#include <database/books.h>
+#include <filter/url.h>
+#include <filter/string.h>
+#include <database/booksdata.h>
+
+
+// The number of slots in each perfect hash table.
+// With about twice as many slots as keys, a seed without collisions is found quickly.
+static const unsigned int sources_books_slot_count = 512;
+
+
+// Finds a seed that hashes each of the $keys to a slot of its own.
+// A key that occurs more than once goes to the first book that has it, as in the table.
+// If $fold is set, keys that differ only in case count as the same key.
+// Returns the seed, and gives the positions of the books per slot in $slots.
+static unsigned int sources_books_perfect_hash (const vector <string> & keys, bool fold, vector <int> & slots)
+{
+  for (unsigned int seed = 1; ; seed++) {
+    slots.assign (sources_books_slot_count, -1);
+    bool collision = false;
+    for (size_t i = 0; i < keys.size (); i++) {
+      if (keys [i].empty ()) continue;
+      unsigned int slot = Database_Books::hash (keys [i], seed, fold) % sources_books_slot_count;
+      if (slots [slot] < 0) {
+        slots [slot] = i;
+        continue;
+      }
+      string key = keys [i];
+      string previous = keys [slots [slot]];
+      if (fold) {
+        key = unicode_string_casefold (key);
+        previous = unicode_string_casefold (previous);
+      }
+      if (key == previous) continue;
+      collision = true;
+      break;
+    }
+    if (!collision) return seed;
+  }
+}
+
+
+// Writes a C++ array with the $values.
+static string sources_books_array (string type, string name, const vector <int> & values)
+{
+  string code = "constexpr " + type + " " + name + " [] =\n{";
+  for (size_t i = 0; i < values.size (); i++) {
+    if (i % 16 == 0) code.append ("\n ");
+    code.append (" " + convert_to_string (values [i]));
+    if (i + 1 < values.size ()) code.append (",");
+  }
+  code.append ("\n};\n");
+  return code;
+}
+
+
+// Generates the tables in booksindex.h from the table of books in booksdata.h.
+// They give the position of a book in that table
+// from the identifier of the book, and from each of its names and abbreviations.
+void sources_books_index ()
+{
+  size_t count = sizeof (books_table) / sizeof (*books_table);
+
+  // The generated file has the same license as the table it is generated from.
+  vector <string> code;
+  string data = filter_url_file_get_contents (filter_url_create_root_path ("database", "booksdata.h"));
+  code.push_back (data.substr (0, data.find ("*/") + 2) + "\n");
+  code.push_back ("// This file is generated from the table of books in booksdata.h by running \"generate . books\".\n// Do not edit it.\n");
+  
+  int maximum = 0;
+  for (size_t i = 0; i < count; i++) maximum = max (maximum, books_table [i].id);
+  vector <int> positions (maximum + 1, -1);
+  for (size_t i = 0; i < count; i++) {
+    if (positions [books_table [i].id] < 0) positions [books_table [i].id] = i;
+  }
+  code.push_back (sources_books_array ("short", "books_id_positions", positions));
+
+  code.push_back ("constexpr unsigned int books_slot_count = " + convert_to_string ((size_t) sources_books_slot_count) + ";\n");
+
+  vector <pair <string, const char * book_record::*> > fields = {
+    { "english", &book_record::english },
+    { "usfm", &book_record::usfm },
+    { "osis", &book_record::osis },
+    { "bibleworks", &book_record::bibleworks },
+    { "onlinebible", &book_record::onlinebible },
+  };
+  for (auto & field : fields) {
+    vector <string> keys;
+    for (size_t i = 0; i < count; i++) keys.push_back (books_table [i].*field.second);
+    vector <int> slots;
+    unsigned int seed = sources_books_perfect_hash (keys, false, slots);
+    string name = "books_" + field.first;
+    code.push_back ("constexpr unsigned int " + name + "_seed = " + convert_to_string ((size_t) seed) + ";\n" + sources_books_array ("short", name + "_slots", slots));
+    // The USFM identifiers and the OSIS abbreviations can also be looked up regardless of case.
+    if ((field.first == "usfm") || (field.first == "osis")) {
+      seed = sources_books_perfect_hash (keys, true, slots);
+      name.append ("_folded");
+      code.push_back ("constexpr unsigned int " + name + "_seed = " + convert_to_string ((size_t) seed) + ";\n" + sources_books_array ("short", name + "_slots", slots));
+    }
+  }
+  
+  string path = filter_url_create_root_path ("database", "booksindex.h");
+  filter_url_file_put_contents (path, filter_string_implode (code, "\n\n"));
+}
@@ -218,5 +218,6 @@ void sources_etcbc4_parse ()
     }
   }
   
+  database_etcbc4.compile ();
   Database_Logs::log ("Finished parsing data from the ETCBC4 database");
 }
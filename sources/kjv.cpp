@@ -166,5 +166,6 @@ void sources_kjv_parse ()
   }
 
   database_kjv.optimize ();
+  database_kjv.compile ();
   Database_Logs::log ("Finished parsing data from the KJV XML file");
 }
@@ -74,5 +74,6 @@ void sources_morphgnt_parse ()
   }
 
   database_morphgnt.optimize ();
+  database_morphgnt.compile ();
   Database_Logs::log ("Finished parsing MorphGNT");
 }
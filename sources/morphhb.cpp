@@ -161,5 +161,6 @@ void sources_morphhb_parse ()
   }
 
   database_oshb.optimize ();
+  database_oshb.compile ();
   cout << "Completed" << endl;
 }
@@ -172,6 +172,7 @@ void sources_oshb_parse ()
   }
 
   database_oshb.optimize ();
+  database_oshb.compile ();
 
   cout << "Completed" << endl;
 }
@@ -18,6 +18,7 @@
 
 
 #include <sword/logic.h>
+#include <sword/reader.h>
 #include <webserver/request.h>
 #include <filter/string.h>
 #include <filter/url.h>
@@ -320,6 +321,9 @@ void sword_logic_install_module (string source_name, string module_name)
   
 #endif
 
+  // The module's data files may have changed.
+  sword_reader_forget (module_name);
+
   // After the installation is complete, write some temporal some data.
   // This temporal data indicates the last access time for this SWORD module.
   {
@@ -336,6 +340,7 @@ void sword_logic_uninstall_module (string module)
   string sword_path = sword_logic_get_path ();
   filter_shell_run ("cd " + sword_path + "; installmgr -u \"" + module + "\"", out_err);
   sword_logic_log (out_err);
+  sword_reader_forget (module);
 }
 
 
@@ -420,12 +425,21 @@ string sword_logic_get_text (string source, string module, int book, int chapter
   string osis = Database_Books::getOsisFromId (book);
   string chapter_verse = convert_to_string (chapter) + ":" + convert_to_string (verse);
 
+  string sword_path = sword_logic_get_path ();
+
+  // Read the verse straight from the data files of the installed module, if possible.
+  // This saves running diatheke for every verse.
+  if (sword_reader_get_verse (sword_path, module, book, chapter, verse, module_text)) {
+    string path = sword_logic_access_tracker (module);
+    filter_url_file_put_contents (path, "access");
+    return sword_logic_clean_verse (module, chapter, verse, module_text);
+  }
+
   // See notes on function sword_logic_diatheke
   // for why it is not currently fetching content via a SWORD library call.
   // module_text = sword_logic_diatheke (module, osis, chapter, verse, module_available);
   
   // Running diatheke only works when it runs in the SWORD installation directory.
-  string sword_path = sword_logic_get_path ();
   // Running several instances of diatheke simultaneously fails.
   sword_logic_diatheke_run_mutex.lock ();
   // The server fetches the module text as follows:
@@ -487,6 +501,19 @@ map <int, string> sword_logic_get_bulk_text (const string & module, int book, in
     filter_url_file_put_contents (path, "bulk");
   }
 
+  // Resulting verse text.
+  map <int, string> output;
+
+  // Read the chapter straight from the data files of the installed module, if possible.
+  map <int, string> chapter_texts;
+  if (sword_reader_get_chapter (sword_logic_get_path (), module, book, chapter, chapter_texts)) {
+    for (auto & verse : verses) {
+      if (!chapter_texts.count (verse)) continue;
+      output [verse] = sword_logic_clean_verse (module, chapter, verse, chapter_texts [verse]);
+    }
+    return output;
+  }
+
   // The name of the book to pass to diatheke.
   string osis = Database_Books::getOsisFromId (book);
 
@@ -513,9 +540,6 @@ map <int, string> sword_logic_get_bulk_text (const string & module, int book, in
 
   sword_logic_diatheke_run_mutex.unlock ();
 
-  // Resulting verse text.
-  map <int, string> output;
-
   // Iterate over all requested verses to extract the correct content from the chapter.
   // This works well in general.
   // It has been seen in a sample module, the "AB", that some verses in the SWORD module were empty.
@@ -0,0 +1,420 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <sword/reader.h>
+#include <filter/string.h>
+#include <filter/url.h>
+#include <database/versifications.h>
+#include <miniz/miniz.h>
+#include <list>
+
+
+// This reads the text of installed SWORD modules straight from their data files.
+// It handles the RawText, RawText4, zText and zText4 drivers.
+// Such a module has an index file per testament with one entry per verse key.
+// The key order follows the KJV versification:
+// [module heading] [testament heading] then per book: [book heading],
+// and per chapter: [chapter heading] [verse 1] [verse 2] ...
+// A zText module points each verse into a zlib-compressed block,
+// and a number of recently decompressed blocks are kept in memory.
+// Anything it does not handle, like ciphered modules, or other compressions,
+// or other versifications, is left to diatheke.
+
+
+class Sword_Reader_Module
+{
+public:
+  bool supported = false;
+  string data_path;
+  bool compressed = false;
+  bool wide = false;
+  bool latin1 = false;
+};
+
+
+mutex sword_reader_mutex;
+map <string, Sword_Reader_Module> sword_reader_modules;
+// The offsets of the chapter headings within the testament indexes, per book and chapter.
+vector <vector <int> > sword_reader_chapter_offsets;
+// The number of verses per book and chapter.
+vector <vector <int> > sword_reader_verse_counts;
+// Least recently used cache of decompressed blocks: The most recent block is at the front.
+const size_t sword_reader_block_cache_size = 64;
+list <pair <string, string> > sword_reader_blocks;
+map <string, list <pair <string, string> >::iterator> sword_reader_block_index;
+
+
+// Loads the KJV layout of the verse keys.
+// It should be called with the mutex locked.
+bool sword_reader_load_layout ()
+{
+  if (!sword_reader_chapter_offsets.empty ()) return true;
+  // SWORD's KJV versification has the same books, chapters and verses as the English one.
+  Database_Versifications database_versifications;
+  vector <Passage> passages = database_versifications.getBooksChaptersVerses ("English");
+  if (passages.empty ()) return false;
+  vector <vector <int> > verse_counts (67);
+  for (auto & passage : passages) {
+    if ((passage.book < 1) || (passage.book > 66)) continue;
+    if (passage.chapter < 1) continue;
+    vector <int> & counts = verse_counts [passage.book];
+    if ((int) counts.size () <= passage.chapter) counts.resize (passage.chapter + 1, 0);
+    counts [passage.chapter] = convert_to_int (passage.verse);
+  }
+  vector <vector <int> > chapter_offsets (67);
+  int offset = 0;
+  for (int book = 1; book <= 66; book++) {
+    // Each testament starts after the module heading and the testament heading.
+    if ((book == 1) || (book == 40)) offset = 2;
+    vector <int> & counts = verse_counts [book];
+    if (counts.empty ()) counts.resize (1, 0);
+    vector <int> & offsets = chapter_offsets [book];
+    // Chapter 0 refers to the book heading.
+    offsets.push_back (offset);
+    offset++;
+    for (size_t chapter = 1; chapter < counts.size (); chapter++) {
+      offsets.push_back (offset);
+      offset += 1 + counts [chapter];
+    }
+  }
+  sword_reader_verse_counts = verse_counts;
+  sword_reader_chapter_offsets = chapter_offsets;
+  return true;
+}
+
+
+// Gives the testament and the index of a verse key.
+// It should be called with the mutex locked.
+bool sword_reader_verse_index (int book, int chapter, int verse, string & testament, int & index)
+{
+  if (!sword_reader_load_layout ()) return false;
+  if ((book < 1) || (book > 66)) return false;
+  if ((chapter < 0) || (chapter >= (int) sword_reader_chapter_offsets [book].size ())) return false;
+  if ((verse < 0) || (verse > sword_reader_verse_counts [book] [chapter])) return false;
+  if (book < 40) testament = "ot";
+  else testament = "nt";
+  index = sword_reader_chapter_offsets [book] [chapter] + verse;
+  return true;
+}
+
+
+// Reads the SWORD module configuration from the "mods.d" folder.
+Sword_Reader_Module sword_reader_load_module (const string & sword_path, const string & module, bool & found)
+{
+  Sword_Reader_Module reader_module;
+  found = false;
+
+  // The configuration file is normally named after the module in lower case.
+  string mods_d = filter_url_create_path (sword_path, "mods.d");
+  string conf = filter_url_create_path (mods_d, unicode_string_casefold (module) + ".conf");
+  string contents;
+  if (file_or_dir_exists (conf)) {
+    contents = filter_url_file_get_contents (conf);
+  } else {
+    // Else look for the file that defines the module.
+    string section = unicode_string_casefold ("[" + module + "]");
+    vector <string> files = filter_url_scandir (mods_d);
+    for (auto & file : files) {
+      if (filter_url_get_extension (file) != "conf") continue;
+      string data = filter_url_file_get_contents (filter_url_create_path (mods_d, file));
+      string first_line = filter_string_trim (data.substr (0, data.find ("\n")));
+      if (unicode_string_casefold (first_line) == section) {
+        contents = data;
+        break;
+      }
+    }
+  }
+  if (contents.empty ()) return reader_module;
+  found = true;
+
+  map <string, string> settings;
+  vector <string> lines = filter_string_explode (contents, '\n');
+  for (auto & line : lines) {
+    size_t pos = line.find ("=");
+    if (pos == string::npos) continue;
+    string key = filter_string_trim (line.substr (0, pos));
+    string value = filter_string_trim (line.substr (pos + 1));
+    settings [key] = value;
+  }
+
+  string driver = unicode_string_casefold (settings ["ModDrv"]);
+  if ((driver == "rawtext") || (driver == "rawtext4")) {
+    reader_module.compressed = false;
+  } else if ((driver == "ztext") || (driver == "ztext4")) {
+    reader_module.compressed = true;
+    // The zText driver defaults to LZSS compression: Only ZIP is handled here.
+    if (unicode_string_casefold (settings ["CompressType"]) != "zip") return reader_module;
+  } else {
+    return reader_module;
+  }
+  reader_module.wide = (driver.find ("4") != string::npos);
+
+  // A ciphered module, or a module that awaits its unlock key, is left to diatheke.
+  if (settings.count ("CipherKey")) return reader_module;
+
+  string versification = settings ["Versification"];
+  if (!versification.empty () && (versification != "KJV")) return reader_module;
+
+  // SWORD takes Latin-1 as the encoding if none is given.
+  string encoding = unicode_string_casefold (settings ["Encoding"]);
+  if (encoding.empty () || (encoding == "latin-1")) reader_module.latin1 = true;
+  else if (encoding != "utf-8") return reader_module;
+
+  string data_path = settings ["DataPath"];
+  if (data_path.empty ()) return reader_module;
+  if (data_path.find ("./") == 0) data_path.erase (0, 2);
+  if (data_path.find ("/") != 0) data_path = filter_url_create_path (sword_path, data_path);
+  // The zText drivers give the path to the data file names rather than to the folder.
+  if (!filter_url_is_dir (data_path)) data_path = filter_url_dirname (data_path);
+  reader_module.data_path = data_path;
+
+  reader_module.supported = true;
+  return reader_module;
+}
+
+
+// Gets the reader for the installed module, or a reader that does not support it.
+Sword_Reader_Module sword_reader_get_module (const string & sword_path, const string & module)
+{
+  // SWORD module names do not depend on case, so neither does the key of the module.
+  string key = sword_path + "|" + unicode_string_casefold (module);
+  {
+    lock_guard<mutex> lock (sword_reader_mutex);
+    auto iterator = sword_reader_modules.find (key);
+    if (iterator != sword_reader_modules.end ()) return iterator->second;
+  }
+  bool found = false;
+  Sword_Reader_Module reader_module = sword_reader_load_module (sword_path, module, found);
+  // Only remember installed modules, so a module installed later on gets noticed.
+  if (found) {
+    lock_guard<mutex> lock (sword_reader_mutex);
+    sword_reader_modules [key] = reader_module;
+  }
+  return reader_module;
+}
+
+
+// Reads $length bytes from $path starting at $offset.
+bool sword_reader_read (const string & path, size_t offset, size_t length, string & data)
+{
+  data.clear ();
+  ifstream file (path, ios::in | ios::binary);
+  if (!file.is_open ()) return false;
+  file.seekg (offset);
+  data.resize (length);
+  file.read (&data [0], length);
+  data.resize (file.gcount ());
+  return data.size () == length;
+}
+
+
+// Decodes a little-endian unsigned integer from $size bytes in $data at $offset.
+unsigned int sword_reader_decode (const string & data, size_t offset, size_t size)
+{
+  unsigned int value = 0;
+  for (size_t i = 0; i < size; i++) {
+    value |= (unsigned int) (unsigned char) data [offset + i] << (8 * i);
+  }
+  return value;
+}
+
+
+// Gets the decompressed $block of a zText module from the cache or else from disk.
+bool sword_reader_get_block (const Sword_Reader_Module & reader_module, const string & testament, unsigned int block, string & text)
+{
+  string key = reader_module.data_path + "|" + testament + "|" + convert_to_string ((size_t) block);
+
+  {
+    lock_guard<mutex> lock (sword_reader_mutex);
+    auto iterator = sword_reader_block_index.find (key);
+    if (iterator != sword_reader_block_index.end ()) {
+      // Move this block to the front, as it is now the most recently used one.
+      sword_reader_blocks.splice (sword_reader_blocks.begin (), sword_reader_blocks, iterator->second);
+      text = iterator->second->second;
+      return true;
+    }
+  }
+
+  // The block index entry: Offset and size of the compressed block, and the size when decompressed.
+  string entry;
+  string path = filter_url_create_path (reader_module.data_path, testament + ".bzs");
+  if (!sword_reader_read (path, block * 12, 12, entry)) return false;
+  unsigned int offset = sword_reader_decode (entry, 0, 4);
+  unsigned int size = sword_reader_decode (entry, 4, 4);
+  unsigned int uncompressed_size = sword_reader_decode (entry, 8, 4);
+  string compressed;
+  path = filter_url_create_path (reader_module.data_path, testament + ".bzz");
+  if (!sword_reader_read (path, offset, size, compressed)) return false;
+  text.resize (uncompressed_size);
+  mz_ulong length = uncompressed_size;
+  if (uncompressed_size) {
+    int status = mz_uncompress ((unsigned char *) &text [0], &length, (const unsigned char *) compressed.data (), compressed.size ());
+    if (status != MZ_OK) return false;
+  }
+  text.resize (length);
+
+  {
+    lock_guard<mutex> lock (sword_reader_mutex);
+    if (!sword_reader_block_index.count (key)) {
+      sword_reader_blocks.push_front (make_pair (key, text));
+      sword_reader_block_index [key] = sword_reader_blocks.begin ();
+      while (sword_reader_blocks.size () > sword_reader_block_cache_size) {
+        sword_reader_block_index.erase (sword_reader_blocks.back ().first);
+        sword_reader_blocks.pop_back ();
+      }
+    }
+  }
+
+  return true;
+}
+
+
+// Reads the raw text of one verse key from the module.
+bool sword_reader_get_entry (const Sword_Reader_Module & reader_module, const string & testament, int index, string & text)
+{
+  text.clear ();
+
+  if (reader_module.compressed) {
+    // The verse index entry: Block number, offset within the block, and size.
+    size_t entry_size = reader_module.wide ? 12 : 10;
+    string path = filter_url_create_path (reader_module.data_path, testament + ".bzv");
+    string entry;
+    // A module may lack a testament or end before the last verse.
+    if (!sword_reader_read (path, index * entry_size, entry_size, entry)) return true;
+    unsigned int block = sword_reader_decode (entry, 0, 4);
+    unsigned int start = sword_reader_decode (entry, 4, 4);
+    unsigned int size = sword_reader_decode (entry, 8, entry_size - 8);
+    if (size == 0) return true;
+    string block_text;
+    if (!sword_reader_get_block (reader_module, testament, block, block_text)) return false;
+    if (start >= block_text.size ()) return true;
+    text = block_text.substr (start, size);
+  } else {
+    // The verse index entry: Offset within the data file, and size.
+    size_t entry_size = reader_module.wide ? 8 : 6;
+    string path = filter_url_create_path (reader_module.data_path, testament + ".vss");
+    string entry;
+    if (!sword_reader_read (path, index * entry_size, entry_size, entry)) return true;
+    unsigned int offset = sword_reader_decode (entry, 0, 4);
+    unsigned int size = sword_reader_decode (entry, 4, entry_size - 4);
+    if (size == 0) return true;
+    path = filter_url_create_path (reader_module.data_path, testament);
+    sword_reader_read (path, offset, size, text);
+  }
+
+  if (reader_module.latin1) {
+    string utf8;
+    for (unsigned char c : text) {
+      if (c < 0x80) {
+        utf8.push_back (c);
+      } else {
+        utf8.push_back (0xc0 | (c >> 6));
+        utf8.push_back (0x80 | (c & 0x3f));
+      }
+    }
+    text = utf8;
+  }
+
+  text = sword_reader_clean_markup (text);
+  return true;
+}
+
+
+// Gives the $testament file and the $index of the verse key for $book $chapter $verse.
+bool sword_reader_get_index (int book, int chapter, int verse, string & testament, int & index)
+{
+  lock_guard<mutex> lock (sword_reader_mutex);
+  return sword_reader_verse_index (book, chapter, verse, testament, index);
+}
+
+
+// Gets the text of a verse from SWORD $module installed at $sword_path.
+// Returns false if the module cannot be read here, so the caller can use diatheke instead.
+bool sword_reader_get_verse (const string & sword_path, const string & module, int book, int chapter, int verse, string & text)
+{
+  Sword_Reader_Module reader_module = sword_reader_get_module (sword_path, module);
+  if (!reader_module.supported) return false;
+  string testament;
+  int index = 0;
+  {
+    lock_guard<mutex> lock (sword_reader_mutex);
+    if (!sword_reader_verse_index (book, chapter, verse, testament, index)) {
+      // A verse outside of the versification has no text.
+      text.clear ();
+      return sword_reader_load_layout ();
+    }
+  }
+  return sword_reader_get_entry (reader_module, testament, index, text);
+}
+
+
+// Gets the texts of all verses in a chapter from SWORD $module installed at $sword_path.
+// Returns false if the module cannot be read here, so the caller can use diatheke instead.
+bool sword_reader_get_chapter (const string & sword_path, const string & module, int book, int chapter, map <int, string> & texts)
+{
+  texts.clear ();
+  Sword_Reader_Module reader_module = sword_reader_get_module (sword_path, module);
+  if (!reader_module.supported) return false;
+  string testament;
+  int index = 0;
+  int verse_count = 0;
+  {
+    lock_guard<mutex> lock (sword_reader_mutex);
+    if (!sword_reader_verse_index (book, chapter, 0, testament, index)) {
+      return sword_reader_load_layout ();
+    }
+    verse_count = sword_reader_verse_counts [book] [chapter];
+  }
+  for (int verse = 1; verse <= verse_count; verse++) {
+    string text;
+    if (!sword_reader_get_entry (reader_module, testament, index + verse, text)) return false;
+    if (!text.empty ()) texts [verse] = text;
+  }
+  return true;
+}
+
+
+// Forgets what it knows about $module, for after the module was installed or uninstalled.
+void sword_reader_forget (const string & module)
+{
+  lock_guard<mutex> lock (sword_reader_mutex);
+  string suffix = "|" + unicode_string_casefold (module);
+  for (auto iterator = sword_reader_modules.begin (); iterator != sword_reader_modules.end ();) {
+    const string & key = iterator->first;
+    if ((key.size () >= suffix.size ()) && (key.compare (key.size () - suffix.size (), suffix.size (), suffix) == 0)) {
+      iterator = sword_reader_modules.erase (iterator);
+    } else {
+      iterator++;
+    }
+  }
+  sword_reader_blocks.clear ();
+  sword_reader_block_index.clear ();
+}
+
+
+// Removes the footnotes and headings that diatheke leaves out too.
+string sword_reader_clean_markup (string text)
+{
+  // OSIS and ThML notes and headings.
+  filter_string_replace_between (text, "<note", "</note>", "");
+  filter_string_replace_between (text, "<title", "</title>", "");
+  // GBF footnotes.
+  filter_string_replace_between (text, "<RF>", "<Rf>", "");
+  return text;
+}
@@ -0,0 +1,34 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef INCLUDED_SWORD_READER_H
+#define INCLUDED_SWORD_READER_H
+
+
+#include <config/libraries.h>
+
+
+bool sword_reader_get_index (int book, int chapter, int verse, string & testament, int & index);
+bool sword_reader_get_verse (const string & sword_path, const string & module, int book, int chapter, int verse, string & text);
+bool sword_reader_get_chapter (const string & sword_path, const string & module, int book, int chapter, map <int, string> & texts);
+void sword_reader_forget (const string & module);
+string sword_reader_clean_markup (string text);
+
+
+#endif
@@ -29,6 +29,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #define SENDEMAIL "sendemail"
 #define REINDEXBIBLES "reindexbibles"
 #define REINDEXNOTES "reindexnotes"
+#define REPLACEBIBLE "replacebible"
 #define CREATECSS "createcss"
 #define IMPORTBIBLE "importusfm"
 #define IMPORTRESOURCE "importresource"
@@ -25,6 +25,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <email/receive.h>
 #include <email/send.h>
 #include <search/rebibles.h>
+#include <search/replacebible.h>
 #include <search/renotes.h>
 #include <styles/sheets.h>
 #include <bb/import_run.h>
@@ -139,6 +140,9 @@ void tasks_run_one (string filename)
   else if (command == REINDEXNOTES) {
     search_reindex_notes ();
   }
+  else if (command == REPLACEBIBLE) {
+    search_replace_bible (parameter1, parameter2, parameter3, convert_to_bool (parameter4), convert_to_bool (parameter5), parameter6);
+  }
   else if (command == CREATECSS) {
     styles_sheets_create_all_run ();
   }
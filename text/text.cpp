@@ -69,6 +69,7 @@ void Text_Text::note (string text)
 {
   if (!thisnoteline.empty ()) {
     notes.push_back (thisnoteline);
+    noteverses.push_back (thisnoteverse);
     thisnoteline.clear ();
   }
   addnotetext (text);
@@ -77,6 +78,8 @@ void Text_Text::note (string text)
 
 void Text_Text::addnotetext (string text)
 {
+  // A note belongs to the verse it starts in.
+  if (thisnoteline.empty ()) thisnoteverse = currentverse;
   thisnoteline.append (text);
 }
 
@@ -88,3 +91,22 @@ string Text_Text::getnote ()
 }
 
 
+// Sets the verse the text that follows belongs to.
+void Text_Text::verse (int number)
+{
+  currentverse = number;
+}
+
+
+// Gets the clear text notes per verse.
+map <int, string> Text_Text::getversenotes ()
+{
+  note ();
+  map <int, string> versenotes;
+  for (size_t i = 0; i < notes.size (); i++) {
+    string & text = versenotes [noteverses [i]];
+    if (!text.empty ()) text.append ("\n");
+    text.append (notes [i]);
+  }
+  return versenotes;
+}
@@ -35,11 +35,16 @@ public:
   void note (string text = "");
   void addnotetext (string text);
   string getnote ();
+  void verse (int number);
+  map <int, string> getversenotes ();
 private:
   vector <string> output;
   string thisline;
   vector <string> notes;
   string thisnoteline;
+  vector <int> noteverses;
+  int thisnoteverse = 0;
+  int currentverse = 0;
 };
 
 
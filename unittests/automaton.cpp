@@ -0,0 +1,98 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+#include <unittests/automaton.h>
+#include <unittests/utilities.h>
+#include <filter/automaton.h>
+#include <checks/automaton.h>
+
+
+void test_automaton ()
+{
+  trace_unit_tests (__func__);
+  
+  // Test finding overlapping fragments in one scan.
+  {
+    Filter_Automaton automaton;
+    automaton.add ("he", 0);
+    automaton.add ("she", 1);
+    automaton.add ("his", 2);
+    automaton.add ("hers", 3);
+    automaton.add ("", 4);
+    automaton.compile ();
+    vector <int> ids = automaton.search ("ushers");
+    evaluate (__LINE__, __func__, {1, 0, 3}, ids);
+    ids = automaton.search ("this is");
+    evaluate (__LINE__, __func__, {2}, ids);
+    ids = automaton.search ("");
+    evaluate (__LINE__, __func__, vector <int> {}, ids);
+  }
+  
+  // Test the positions where the fragments end.
+  {
+    Filter_Automaton automaton;
+    automaton.add ("he", 0);
+    automaton.add ("she", 1);
+    automaton.compile ();
+    vector <pair <size_t, int> > positions = automaton.locate ("ushe he");
+    evaluate (__LINE__, __func__, 3, (int)positions.size ());
+    if (positions.size () == 3) {
+      evaluate (__LINE__, __func__, 4, (int)positions [0].first);
+      evaluate (__LINE__, __func__, 1, positions [0].second);
+      evaluate (__LINE__, __func__, 4, (int)positions [1].first);
+      evaluate (__LINE__, __func__, 0, positions [1].second);
+      evaluate (__LINE__, __func__, 7, (int)positions [2].first);
+    }
+  }
+  
+  // Test the same fragment with more than one identifier, and Unicode.
+  {
+    Filter_Automaton automaton;
+    automaton.add ("«", 0);
+    automaton.add ("»", 1);
+    automaton.add ("«", 2);
+    automaton.compile ();
+    vector <int> ids = automaton.search ("« Bonjour » «");
+    evaluate (__LINE__, __func__, {0, 2, 1, 0, 2}, ids);
+  }
+  
+  // Test the automaton for the checks.
+  {
+    Checks_Automaton automaton ({"did", "", "did"}, {make_pair ("(", ")"), make_pair ("[", "]"), make_pair ("((", "))")});
+    evaluate (__LINE__, __func__, 3 + 6 + 4, automaton.fragments.size ());
+    evaluate (__LINE__, __func__, Checks_Automaton::kind_pattern, automaton.kinds [2]);
+    evaluate (__LINE__, __func__, " ,", automaton.fragments [3]);
+    evaluate (__LINE__, __func__, Checks_Automaton::kind_pair, automaton.kinds [9]);
+    map <int, vector <int> > found = automaton.scan ({ make_pair (1, "He did (it) ,"), make_pair (2, "") });
+    evaluate (__LINE__, __func__, 2, found.size ());
+    evaluate (__LINE__, __func__, {0, 2, 9, 10, 3}, found [1]);
+    evaluate (__LINE__, __func__, vector <int> {}, found [2]);
+  }
+  
+  // Test that the automaton for a Bible is kept till its settings change.
+  {
+    shared_ptr <Checks_Automaton> automaton1 = Checks_Automaton::get ("bible", {"pattern"}, {});
+    shared_ptr <Checks_Automaton> automaton2 = Checks_Automaton::get ("bible", {"pattern"}, {});
+    evaluate (__LINE__, __func__, true, automaton1 == automaton2);
+    automaton2 = Checks_Automaton::get ("bible", {"other"}, {});
+    evaluate (__LINE__, __func__, false, automaton1 == automaton2);
+    automaton1 = Checks_Automaton::get ("bible2", {"other"}, {});
+    evaluate (__LINE__, __func__, false, automaton1 == automaton2);
+  }
+}
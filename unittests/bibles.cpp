@@ -25,6 +25,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <database/bibleactions.h>
 #include <filter/usfm.h>
 #include <filter/string.h>
+#include <filter/url.h>
 #include <bb/logic.h>
 
 
@@ -900,7 +901,95 @@ void test_database_bibles ()
     age = database_bibles.getChapterAge (testbible, 1, 2);
     evaluate (__LINE__, __func__, 1, age);
   }
-  
+
+  // Test that the chapter's text goes into one file, and its older revisions as deltas into another.
+  {
+    refresh_sandbox (true);
+    Database_Bibles database_bibles;
+    Database_State::create ();
+    database_bibles.createBible (testbible);
+    string usfm;
+    for (int verse = 1; verse <= 50; verse++) {
+      usfm.append ("\\v " + convert_to_string (verse) + " Text of the verse.\n");
+      database_bibles.storeChapter (testbible, 1, 2, usfm);
+    }
+    string folder = filter_url_create_path (database_bibles.bibleFolder (testbible), "1", "2");
+    evaluate (__LINE__, __func__, {"history", "text"}, filter_url_scandir (folder));
+    // The history is much smaller than the revisions in full.
+    int size = filter_url_filesize (filter_url_create_path (folder, "history"));
+    evaluate (__LINE__, __func__, true, size < 2 * (int) usfm.size ());
+    evaluate (__LINE__, __func__, filter_string_trim (usfm), database_bibles.getChapter (testbible, 1, 2));
+    evaluate (__LINE__, __func__, 100000050, database_bibles.getChapterId (testbible, 1, 2));
+    // Optimizing keeps the history.
+    database_bibles.storeChapter (testbible, 1, 2, "");
+    database_bibles.optimize ();
+    evaluate (__LINE__, __func__, filter_string_trim (usfm), database_bibles.getChapter (testbible, 1, 2));
+    evaluate (__LINE__, __func__, 100000050, database_bibles.getChapterId (testbible, 1, 2));
+  }
+
+  // Test that storing the same chapter from several threads at once keeps every revision.
+  {
+    refresh_sandbox (true);
+    Database_Bibles database_bibles;
+    Database_State::create ();
+    database_bibles.createBible (testbible);
+    vector <thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.push_back (thread ([t, testbible] {
+        Database_Bibles database_bibles;
+        for (int i = 0; i < 10; i++) {
+          database_bibles.storeChapter (testbible, 1, 2, "\\v 1 Thread " + convert_to_string (t) + " revision " + convert_to_string (i) + ".");
+        }
+      }));
+    }
+    for (auto & thread : threads) thread.join ();
+    evaluate (__LINE__, __func__, 100000040, database_bibles.getChapterId (testbible, 1, 2));
+    evaluate (__LINE__, __func__, "\\v 1 Thread", database_bibles.getChapter (testbible, 1, 2).substr (0, 11));
+    string folder = filter_url_create_path (database_bibles.bibleFolder (testbible), "1", "2");
+    evaluate (__LINE__, __func__, {"history", "text"}, filter_url_scandir (folder));
+  }
+
+  // Test that what an interrupted store leaves behind after the history gets dropped.
+  {
+    refresh_sandbox (true);
+    Database_Bibles database_bibles;
+    Database_State::create ();
+    database_bibles.createBible (testbible);
+    database_bibles.storeChapter (testbible, 1, 2, "\\v 1 One.");
+    database_bibles.storeChapter (testbible, 1, 2, "\\v 1 Two.");
+    string folder = filter_url_create_path (database_bibles.bibleFolder (testbible), "1", "2");
+    string history = filter_url_create_path (folder, "history");
+    int size = filter_url_filesize (history);
+    filter_url_file_put_contents_append (history, "100000003 0 100\nhalf a revision");
+    database_bibles.storeChapter (testbible, 1, 2, "\\v 1 Three.");
+    evaluate (__LINE__, __func__, "\\v 1 Three.", database_bibles.getChapter (testbible, 1, 2));
+    evaluate (__LINE__, __func__, 100000003, database_bibles.getChapterId (testbible, 1, 2));
+    // Emptying the chapter and optimizing gets the revision before it back, so the history still reads.
+    database_bibles.storeChapter (testbible, 1, 2, "");
+    database_bibles.optimize ();
+    evaluate (__LINE__, __func__, "\\v 1 Three.", database_bibles.getChapter (testbible, 1, 2));
+    evaluate (__LINE__, __func__, 100000003, database_bibles.getChapterId (testbible, 1, 2));
+    evaluate (__LINE__, __func__, true, filter_url_filesize (history) > size);
+  }
+
+  // Test that the chapters stored as one file per revision get converted.
+  {
+    refresh_sandbox (true);
+    Database_Bibles database_bibles;
+    Database_State::create ();
+    database_bibles.createBible (testbible);
+    string folder = filter_url_create_path (database_bibles.bibleFolder (testbible), "1", "2");
+    filter_url_mkdir (folder);
+    filter_url_file_put_contents (filter_url_create_path (folder, "100000001"), "\\c 2\n");
+    filter_url_file_put_contents (filter_url_create_path (folder, "100000002"), "\\c 2\n\\p\n");
+    evaluate (__LINE__, __func__, "\\c 2\n\\p", database_bibles.getChapter (testbible, 1, 2));
+    evaluate (__LINE__, __func__, 100000002, database_bibles.getChapterId (testbible, 1, 2));
+    database_bibles.optimize ();
+    evaluate (__LINE__, __func__, {"history", "text"}, filter_url_scandir (folder));
+    evaluate (__LINE__, __func__, "\\c 2\n\\p", database_bibles.getChapter (testbible, 1, 2));
+    database_bibles.storeChapter (testbible, 1, 2, "\\c 2\n\\p\n\\v 1 Verse.");
+    evaluate (__LINE__, __func__, 100000003, database_bibles.getChapterId (testbible, 1, 2));
+  }
 }
 
 
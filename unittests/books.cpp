@@ -47,6 +47,47 @@ void test_database_books ()
   evaluate (__LINE__, __func__, "ot", Database_Books::getType (39));
   evaluate (__LINE__, __func__, "", Database_Books::getType (0));
   evaluate (__LINE__, __func__, 105, Database_Books::getIdFromUsfm ("INT"));
+  
+  // The USFM identifiers and the OSIS abbreviations are case-sensitive,
+  // so the check on the USFM can tell an identifier in the wrong case.
+  evaluate (__LINE__, __func__, 0, Database_Books::getIdFromUsfm ("sng"));
+  evaluate (__LINE__, __func__, 0, Database_Books::getIdFromOsis ("1CHR"));
+  // The lookups that ignore the case find them.
+  evaluate (__LINE__, __func__, 22, Database_Books::getIdFromUsfmIgnoringCase ("sng"));
+  evaluate (__LINE__, __func__, 22, Database_Books::getIdFromUsfmIgnoringCase ("SNG"));
+  evaluate (__LINE__, __func__, 13, Database_Books::getIdFromOsisIgnoringCase ("1CHR"));
+  evaluate (__LINE__, __func__, 13, Database_Books::getIdFromOsisIgnoringCase ("1Chr"));
+  evaluate (__LINE__, __func__, 0, Database_Books::getIdFromUsfmIgnoringCase ("gen1"));
+  evaluate (__LINE__, __func__, 0, Database_Books::getIdFromOsisIgnoringCase (""));
+  evaluate (__LINE__, __func__, 0, Database_Books::getIdFromBibleworks ("2KI"));
+  evaluate (__LINE__, __func__, 0, Database_Books::getIdFromUsfm ("GENX"));
+  evaluate (__LINE__, __func__, 0, Database_Books::getIdFromOsis (""));
+  evaluate (__LINE__, __func__, "Unknown", Database_Books::getEnglishFromId (1000));
+  evaluate (__LINE__, __func__, "XXX", Database_Books::getUsfmFromId (-1));
+  
+  // The generated lookup tables agree with the table of books.
+  // If this fails, run "generate . books" to update them.
+  map <string, int> english, usfm, osis, bibleworks, onlinebible;
+  for (auto id : Database_Books::getIDs ()) {
+    english.insert ({Database_Books::getEnglishFromId (id), id});
+    usfm.insert ({Database_Books::getUsfmFromId (id), id});
+    osis.insert ({Database_Books::getOsisFromId (id), id});
+    bibleworks.insert ({Database_Books::getBibleworksFromId (id), id});
+    onlinebible.insert ({Database_Books::getOnlinebibleFromId (id), id});
+  }
+  for (auto id : Database_Books::getIDs ()) {
+    evaluate (__LINE__, __func__, english [Database_Books::getEnglishFromId (id)], Database_Books::getIdFromEnglish (Database_Books::getEnglishFromId (id)));
+    evaluate (__LINE__, __func__, usfm [Database_Books::getUsfmFromId (id)], Database_Books::getIdFromUsfm (Database_Books::getUsfmFromId (id)));
+    if (!Database_Books::getOsisFromId (id).empty ()) {
+      evaluate (__LINE__, __func__, osis [Database_Books::getOsisFromId (id)], Database_Books::getIdFromOsis (Database_Books::getOsisFromId (id)));
+    }
+    if (!Database_Books::getBibleworksFromId (id).empty ()) {
+      evaluate (__LINE__, __func__, bibleworks [Database_Books::getBibleworksFromId (id)], Database_Books::getIdFromBibleworks (Database_Books::getBibleworksFromId (id)));
+    }
+    if (!Database_Books::getOnlinebibleFromId (id).empty ()) {
+      evaluate (__LINE__, __func__, onlinebible [Database_Books::getOnlinebibleFromId (id)], Database_Books::getIdFromOnlinebible (Database_Books::getOnlinebibleFromId (id)));
+    }
+  }
 }
 
 
@@ -22,6 +22,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <database/check.h>
 #include <database/state.h>
 #include <database/bibles.h>
+#include <database/users.h>
+#include <database/config/bible.h>
+#include <database/versifications.h>
+#include <checks/run.h>
 
 
 void test_database_check ()
@@ -152,4 +156,122 @@ void test_database_check ()
     vector <Database_Check_Hit> hits = database_check.getHits ();
     evaluate (__LINE__, __func__, 12, (int)hits.size());
   }
+
+  {
+    // Test collecting the output in memory, and recording it in one go.
+    refresh_sandbox (true);
+    Database_State::create ();
+    Database_Bibles database_bibles;
+    database_bibles.createBible ("phpunit");
+    Database_Check database_check = Database_Check ();
+    database_check.create ();
+    vector <Database_Check_Hit> collected;
+    Database_Check::collect (&collected);
+    database_check.recordOutput ("phpunit", 3, 4, 5, "test1");
+    database_check.recordOutput ("phpunit", 6, 7, 8, "test2");
+    Database_Check::collect (NULL);
+    evaluate (__LINE__, __func__, 2, (int)collected.size());
+    evaluate (__LINE__, __func__, 0, (int)database_check.getHits ().size());
+    evaluate (__LINE__, __func__, 6, collected [1].book);
+    evaluate (__LINE__, __func__, "test2", collected [1].data);
+    for (unsigned int i = 0; i < 20; i++) collected.push_back (collected [0]);
+    database_check.recordOutput (collected);
+    vector <Database_Check_Hit> hits = database_check.getHits ();
+    evaluate (__LINE__, __func__, 12, (int)hits.size());
+    evaluate (__LINE__, __func__, "test2", hits [1].data);
+  }
+
+  {
+    // Test caching the output per chapter.
+    refresh_sandbox (true);
+    Database_Check database_check = Database_Check ();
+    database_check.create ();
+    Database_Check_Hit hit;
+    hit.verse = 5;
+    hit.data = "test1";
+    database_check.storeChapterHits ("phpunit", 3, 4, "hash4", {hit});
+    database_check.storeChapterHits ("phpunit", 3, 5, "hash5", {});
+    hit.data = "test2";
+    database_check.storeChapterHits ("phpunit", 3, 4, "hash4b", {hit, hit});
+    map <int, string> hashes = database_check.getChapterHashes ("phpunit", 3);
+    evaluate (__LINE__, __func__, 2, (int)hashes.size ());
+    evaluate (__LINE__, __func__, "hash4b", hashes [4]);
+    evaluate (__LINE__, __func__, "hash5", hashes [5]);
+    vector <Database_Check_Hit> hits = database_check.getChapterHits ("phpunit", 3);
+    evaluate (__LINE__, __func__, 2, (int)hits.size ());
+    evaluate (__LINE__, __func__, 4, hits [0].chapter);
+    evaluate (__LINE__, __func__, 5, hits [0].verse);
+    evaluate (__LINE__, __func__, "test2", hits [0].data);
+    database_check.eraseChapterHits ("phpunit", 3, 4);
+    hashes = database_check.getChapterHashes ("phpunit", 3);
+    evaluate (__LINE__, __func__, 1, (int)hashes.size ());
+    hits = database_check.getChapterHits ("phpunit", 3);
+    evaluate (__LINE__, __func__, 0, (int)hits.size ());
+  }
+  
+  {
+    // Test running the checks, and running them again on the cached and the changed chapters.
+    refresh_sandbox (true);
+    Database_State::create ();
+    Database_Bibles database_bibles;
+    Database_Users database_users;
+    database_users.create ();
+    Database_Check database_check = Database_Check ();
+    database_check.create ();
+    string bible = "phpunit";
+    database_bibles.createBible (bible);
+    database_bibles.storeChapter (bible, 1, 1, "\\c 1\n\\p\n\\v 1 Double  space.\n\\v 2 Space ,comma.");
+    database_bibles.storeChapter (bible, 1, 2, "\\c 2\n\\p\n\\v 1 Space ,comma.");
+    Database_Config_Bible::setCheckDoubleSpacesUsfm (bible, true);
+    Database_Config_Bible::setCheckSpaceBeforePunctuation (bible, true);
+    checks_run (bible);
+    vector <Database_Check_Hit> hits = database_check.getHits ();
+    evaluate (__LINE__, __func__, 3, (int)hits.size ());
+    evaluate (__LINE__, __func__, 2, (int)database_check.getChapterHashes (bible, 1).size ());
+    checks_run (bible);
+    vector <Database_Check_Hit> hits2 = database_check.getHits ();
+    evaluate (__LINE__, __func__, 3, (int)hits2.size ());
+    for (size_t i = 0; i < hits.size () && i < hits2.size (); i++) {
+      evaluate (__LINE__, __func__, hits [i].chapter, hits2 [i].chapter);
+      evaluate (__LINE__, __func__, hits [i].verse, hits2 [i].verse);
+      evaluate (__LINE__, __func__, hits [i].data, hits2 [i].data);
+    }
+    database_bibles.storeChapter (bible, 1, 2, "\\c 2\n\\p\n\\v 1 No comma.");
+    checks_run (bible);
+    hits = database_check.getHits ();
+    evaluate (__LINE__, __func__, 2, (int)hits.size ());
+    Database_Config_Bible::setCheckDoubleSpacesUsfm (bible, false);
+    checks_run (bible);
+    hits = database_check.getHits ();
+    evaluate (__LINE__, __func__, 1, (int)hits.size ());
+    refresh_sandbox (true, {"Check phpunit: "});
+  }
+  
+  {
+    // Test that editing a versification system without renaming it runs the checks again.
+    refresh_sandbox (true);
+    Database_State::create ();
+    Database_Bibles database_bibles;
+    Database_Users database_users;
+    database_users.create ();
+    Database_Check database_check = Database_Check ();
+    database_check.create ();
+    Database_Versifications database_versifications;
+    database_versifications.create ();
+    database_versifications.input ("Genesis 1:2", "phpunit");
+    string bible = "phpunit";
+    database_bibles.createBible (bible);
+    database_bibles.storeChapter (bible, 1, 0, "\\id GEN\n\\toc1 Genesis\n\\toc2 Genesis");
+    database_bibles.storeChapter (bible, 1, 1, "\\c 1\n\\p\n\\v 1 One.\n\\v 2 Two.");
+    Database_Config_Bible::setVersificationSystem (bible, "phpunit");
+    Database_Config_Bible::setCheckChaptesVersesVersification (bible, true);
+    checks_run (bible);
+    evaluate (__LINE__, __func__, 0, (int)database_check.getHits ().size ());
+    database_versifications.input ("Genesis 1:3", "phpunit");
+    checks_run (bible);
+    vector <Database_Check_Hit> hits = database_check.getHits ();
+    evaluate (__LINE__, __func__, 1, (int)hits.size ());
+    if (hits.size () == 1) evaluate (__LINE__, __func__, 3, hits [0].verse);
+    refresh_sandbox (true, {"Check phpunit: "});
+  }
 }
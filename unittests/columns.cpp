@@ -0,0 +1,115 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+
+#include <unittests/columns.h>
+#include <unittests/utilities.h>
+#include <database/columns.h>
+#include <database/sqlite.h>
+#include <database/morphgnt.h>
+#include <filter/url.h>
+
+
+void test_database_columns ()
+{
+  trace_unit_tests (__func__);
+  refresh_sandbox (true);
+  
+  // A database with words stored out of verse order.
+  // One column refers to a table with the strings, and the other one holds the strings.
+  {
+    SqliteDatabase sql ("columns");
+    sql.add ("CREATE TABLE words (book int, chapter int, verse int, word int, strong text);");
+    sql.execute ();
+    sql.clear ();
+    sql.add ("CREATE TABLE word (word text);");
+    sql.execute ();
+    sql.clear ();
+    sql.add ("INSERT INTO word VALUES ('alpha'), ('beta'), ('gamma');");
+    sql.execute ();
+    sql.clear ();
+    sql.add ("INSERT INTO words VALUES (2, 1, 1, 3, 'H2'), (1, 1, 2, 2, 'H1'), (1, 1, 1, 1, 'H1'), (1, 1, 2, 1, 'H3');");
+    sql.execute ();
+  }
+  vector <string> columns = {"word", "strong"};
+
+  {
+    shared_ptr <Database_Columns> store = Database_Columns::get ("columns", "words", columns, {"strong"});
+    evaluate (__LINE__, __func__, true, file_or_dir_exists (Database_Columns::file ("columns")));
+
+    // The verse index.
+    evaluate (__LINE__, __func__, {3}, store->rowids (1, 1, 1));
+    evaluate (__LINE__, __func__, {2, 4}, store->rowids (1, 1, 2));
+    evaluate (__LINE__, __func__, {1}, store->rowids (2, 1, 1));
+    evaluate (__LINE__, __func__, {}, store->rowids (1, 1, 3));
+    evaluate (__LINE__, __func__, {}, store->rowids (3, 1, 1));
+
+    // The interned strings.
+    evaluate (__LINE__, __func__, "gamma", store->value (0, 1));
+    evaluate (__LINE__, __func__, "H3", store->value (1, 4));
+    evaluate (__LINE__, __func__, "", store->value (0, 5));
+    evaluate (__LINE__, __func__, "", store->value (2, 1));
+    evaluate (__LINE__, __func__, {"beta", "alpha"}, store->values (0, 1, 1, 2));
+    evaluate (__LINE__, __func__, {"H1", "H3"}, store->values (1, 1, 1, 2));
+
+    // Searching the indexed column, and a column without an index.
+    vector <Passage> passages = store->search (1, "H1");
+    evaluate (__LINE__, __func__, 2, (int)passages.size ());
+    if (passages.size () == 2) {
+      evaluate (__LINE__, __func__, "1", passages[0].verse);
+      evaluate (__LINE__, __func__, "2", passages[1].verse);
+    }
+    evaluate (__LINE__, __func__, 0, (int)store->search (1, "H4").size ());
+    passages = store->search (0, "gamma");
+    evaluate (__LINE__, __func__, 1, (int)passages.size ());
+    if (passages.size () == 1) {
+      evaluate (__LINE__, __func__, 2, passages[0].book);
+    }
+  }
+  
+  // A store that is gone is built again.
+  {
+    filter_url_unlink (Database_Columns::file ("columns"));
+    Database_Columns::compile ("columns", "words", columns, {"strong"});
+    evaluate (__LINE__, __func__, true, file_or_dir_exists (Database_Columns::file ("columns")));
+    shared_ptr <Database_Columns> store = Database_Columns::get ("columns", "words", columns, {"strong"});
+    evaluate (__LINE__, __func__, {2, 4}, store->rowids (1, 1, 2));
+  }
+
+  // Without a database there's an empty store.
+  {
+    shared_ptr <Database_Columns> store = Database_Columns::get ("nonexisting", "words", columns, {});
+    evaluate (__LINE__, __func__, {}, store->rowids (1, 1, 1));
+    evaluate (__LINE__, __func__, "", store->value (0, 1));
+    evaluate (__LINE__, __func__, false, file_or_dir_exists (Database_Columns::file ("nonexisting")));
+  }
+  
+  // The store of the Greek morphology gives the same words as its database.
+  {
+    Database_MorphGnt database;
+    vector <int> rowids = database.rowids (40, 5, 6);
+    evaluate (__LINE__, __func__, 10, rowids.size ());
+    SqliteDatabase sql ("morphgnt");
+    sql.add ("SELECT word.word FROM morphgnt, word WHERE morphgnt.word = word.rowid AND book = 40 AND chapter = 5 AND verse = 6 ORDER BY morphgnt.rowid;");
+    vector <string> standard = sql.query () ["word"];
+    vector <string> words;
+    for (auto rowid : rowids) words.push_back (database.word (rowid));
+    evaluate (__LINE__, __func__, standard, words);
+  }
+}
@@ -353,5 +353,19 @@ void test_diff ()
     evaluate (__LINE__, __func__, standard, output);
   }
 
+  // Deltas.
+  {
+    string delta = filter_diff_delta ("In the beginning", "In the very beginning");
+    evaluate (__LINE__, __func__, "7 9 very ", delta);
+    evaluate (__LINE__, __func__, "In the very beginning", filter_diff_apply_delta ("In the beginning", delta));
+    delta = filter_diff_delta ("aaa", "aa");
+    evaluate (__LINE__, __func__, "2 0 ", delta);
+    evaluate (__LINE__, __func__, "aa", filter_diff_apply_delta ("aaa", delta));
+    delta = filter_diff_delta ("", "text");
+    evaluate (__LINE__, __func__, "0 0 text", delta);
+    evaluate (__LINE__, __func__, "text", filter_diff_apply_delta ("", delta));
+    evaluate (__LINE__, __func__, "", filter_diff_apply_delta ("", "5 0 x"));
+  }
+
   refresh_sandbox (true);
 }
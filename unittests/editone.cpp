@@ -23,7 +23,19 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/url.h>
 #include <filter/string.h>
 #include <filter/usfm.h>
+#include <filter/diff.h>
+#include <filter/roles.h>
 #include <editone2/logic.h>
+#include <edit/logic.h>
+#include <edit/load.h>
+#include <edit/update.h>
+#include <editor/usfm2html.h>
+#include <checksum/logic.h>
+#include <database/state.h>
+#include <database/login.h>
+#include <database/privileges.h>
+#include <database/config/bible.h>
+#include <webserver/request.h>
 
 
 void test_editone_logic_verse_indicator (int verse)
@@ -197,3 +209,105 @@ void test_editone_logic ()
     }
   }
 }
+
+
+// Sends an update from the chapter editor with the $unique_id to edit/update.
+// It sends the $loaded and $edited html in full,
+// or if there's a $revision, the deltas against the $revision_html.
+// It returns the revision in the response, or -1 on a conflict.
+int test_edit_update_send (string unique_id, int revision, string revision_html, string loaded, string edited)
+{
+  Webserver_Request request;
+  request.session_logic ()->setUsername ("phpunit");
+  request.post ["bible"] = "phpunit";
+  request.post ["book"] = "1";
+  request.post ["chapter"] = "1";
+  request.post ["id"] = unique_id;
+  request.post ["checksum1"] = Checksum_Logic::get (loaded);
+  request.post ["checksum2"] = Checksum_Logic::get (edited);
+  if (revision) {
+    request.post ["revision"] = convert_to_string (revision);
+    request.post ["loadeddelta"] = filter_diff_delta (revision_html, loaded);
+    request.post ["editeddelta"] = filter_diff_delta (loaded, edited);
+  } else {
+    request.post ["loaded"] = loaded;
+    request.post ["edited"] = edited;
+  }
+  string response = edit_update (&request);
+  if (request.response_code == 409) return -1;
+  // The response is the checksum, the write access, and then the bits separated by "#_be_#".
+  // The third bit is the revision.
+  size_t pos = response.find ("#_be_#");
+  if (pos == string::npos) return 0;
+  pos = response.find ("#_be_#", pos + 1);
+  if (pos == string::npos) return 0;
+  response.erase (0, pos + 6);
+  return convert_to_int (response.substr (0, response.find ("#_be_#")));
+}
+
+
+// Test the chapter editor sending its updates as deltas against the revision the server has.
+void test_edit_update ()
+{
+  trace_unit_tests (__func__);
+  
+  refresh_sandbox (true);
+  Database_State::create ();
+  Database_Login::create ();
+  Webserver_Request request;
+  request.database_users ()->create ();
+  request.database_users ()->add_user ("phpunit", "phpunit", Filter_Roles::translator (), "");
+  request.session_logic ()->setUsername ("phpunit");
+  request.database_bibles ()->createBible ("phpunit");
+  Database_Privileges::create ();
+  Database_Privileges::setBibleBook ("phpunit", "phpunit", 1, true);
+  request.database_bibles ()->storeChapter ("phpunit", 1, 1, "\\c 1\n\\p\n\\v 1 One.");
+  
+  Editor_Usfm2Html editor_usfm2html;
+  editor_usfm2html.load (request.database_bibles ()->getChapter ("phpunit", 1, 1));
+  editor_usfm2html.stylesheet (Database_Config_Bible::getEditorStylesheet ("phpunit"));
+  editor_usfm2html.run ();
+  string html = editor_usfm2html.get ();
+  string edited = filter_string_str_replace ("One.", "Uno.", html);
+  
+  // The first update sends the full html, and the server then has revision 1.
+  int revision = test_edit_update_send ("1", 0, "", html, html);
+  evaluate (__LINE__, __func__, 1, revision);
+  
+  // The next update sends the deltas against revision 1, and saves the edit.
+  revision = test_edit_update_send ("1", revision, html, html, edited);
+  evaluate (__LINE__, __func__, 2, revision);
+  evaluate (__LINE__, __func__, "\\c 1\n\\p\n\\v 1 Uno.", request.database_bibles ()->getChapter ("phpunit", 1, 1));
+  
+  // A revision the server does not have gives a conflict, and the editor then sends the full html.
+  evaluate (__LINE__, __func__, -1, test_edit_update_send ("1", 5, edited, edited, edited));
+  evaluate (__LINE__, __func__, 3, test_edit_update_send ("1", 0, "", edited, edited));
+  
+  // Other editors do not affect this editor's revision, even if there are many of them.
+  revision = 3;
+  for (int editor = 2; editor <= 120; editor++) {
+    evaluate (__LINE__, __func__, 1, test_edit_update_send (convert_to_string (editor), 0, "", edited, edited));
+    if (editor % 50 == 0) {
+      int next = test_edit_update_send ("1", revision, edited, edited, edited);
+      evaluate (__LINE__, __func__, revision + 1, next);
+      revision = next;
+    }
+  }
+  evaluate (__LINE__, __func__, 2, test_edit_update_send ("120", 1, edited, edited, edited));
+  // The editor updated longest ago got forgotten.
+  evaluate (__LINE__, __func__, -1, test_edit_update_send ("2", 1, edited, edited, edited));
+  
+  // Loading a chapter in the editor forgets the revision it had.
+  {
+    Webserver_Request request;
+    request.session_logic ()->setUsername ("phpunit");
+    request.query ["bible"] = "phpunit";
+    request.query ["book"] = "1";
+    request.query ["chapter"] = "1";
+    request.query ["id"] = "1";
+    edit_load (&request);
+  }
+  evaluate (__LINE__, __func__, -1, test_edit_update_send ("1", revision, edited, edited, edited));
+  
+  refresh_sandbox (true);
+}
@@ -21,3 +21,4 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 
 void test_editone_logic ();
+void test_edit_update ();
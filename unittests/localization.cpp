@@ -21,6 +21,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <unittests/utilities.h>
 #include <filter/url.h>
 #include <database/localization.h>
+#include <database/config/general.h>
+#include <locale/translate.h>
 
 
 void test_database_localization ()
@@ -45,4 +47,56 @@ void test_database_localization ()
   evaluate (__LINE__, __func__, msgstr, result);
   result = database_localization.backtranslate (msgstr);
   evaluate (__LINE__, __func__, msgid, result);
+  
+  // Test translating through the site language.
+  Database_Config_General::setSiteLanguage ("nl");
+  evaluate (__LINE__, __func__, msgstr, translate (msgid));
+  evaluate (__LINE__, __func__, "not in the catalog", translate ("not in the catalog"));
+  Database_Config_General::setSiteLanguage ("");
+  evaluate (__LINE__, __func__, msgid, translate (msgid));
+  
+  // Test that the translations in memory get renewed when the database is recreated.
+  {
+    Database_Localization database_localization2 = Database_Localization ("nl");
+    evaluate (__LINE__, __func__, msgstr, database_localization2.translate (msgid));
+    filter_url_file_put_contents (filter_url_create_path (testing_directory, "test.po"), "msgid \"phpunit\"\nmsgstr \"phpunit2\"\n");
+    database_localization2.create (filter_url_create_path (testing_directory, "test.po"));
+    evaluate (__LINE__, __func__, "phpunit2", database_localization2.translate ("phpunit"));
+    evaluate (__LINE__, __func__, msgid, database_localization2.translate (msgid));
+  }
+  
+  // Test obfuscating in one pass, as if the longest strings were replaced first.
+  {
+    locale_translate_obfuscation_search = {"Bibledit", "Bible", "ible", "dit"};
+    locale_translate_obfuscation_replace = {"Translate", "Book", "x", "y"};
+    locale_translate_obfuscation_compile ();
+    evaluate (__LINE__, __func__, "Translate Book", locale_translate_obfuscate ("Bibledit Bible"));
+    evaluate (__LINE__, __func__, "Book ey y Translatex", locale_translate_obfuscate ("Bible edit dit Bibleditible"));
+    evaluate (__LINE__, __func__, "No change", locale_translate_obfuscate ("No change"));
+    evaluate (__LINE__, __func__, "", locale_translate_obfuscate (""));
+    evaluate (__LINE__, __func__, "Book", translate ("Bible"));
+  }
+  
+  // Test that a replacement that creates a string replaced later, gets replaced again,
+  // the same as when the strings were replaced one after the other.
+  {
+    locale_translate_obfuscation_search = {"Bibledit", "Bible", "Book"};
+    locale_translate_obfuscation_replace = {"Translate", "Book", "Volume"};
+    locale_translate_obfuscation_compile ();
+    evaluate (__LINE__, __func__, "Translate Volume Volume", locale_translate_obfuscate ("Bibledit Bible Book"));
+    // A replacement that forms a string replaced later together with the text after it.
+    locale_translate_obfuscation_search = {"ab", "xc"};
+    locale_translate_obfuscation_replace = {"x", "y"};
+    locale_translate_obfuscation_compile ();
+    evaluate (__LINE__, __func__, "y y", locale_translate_obfuscate ("abc xc"));
+    // Removing a string joins the text on either side.
+    locale_translate_obfuscation_search = {"--", "ab"};
+    locale_translate_obfuscation_replace = {"", "z"};
+    locale_translate_obfuscation_compile ();
+    evaluate (__LINE__, __func__, "z", locale_translate_obfuscate ("a--b"));
+    locale_translate_obfuscation_search.clear ();
+    locale_translate_obfuscation_replace.clear ();
+    locale_translate_obfuscation_compile ();
+    evaluate (__LINE__, __func__, "Bible", translate ("Bible"));
+  }
 }
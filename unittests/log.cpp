@@ -54,8 +54,7 @@ void test_database_logs ()
     vector <string> result = Database_Logs::get (s);
     if (result.size () == 1) {
       s = result [0];
-      string path = filter_url_create_path (Database_Logs::folder (), s);
-      string contents = filter_url_file_get_contents (path);
+      string contents = Database_Logs::entry (s);
       evaluate (__LINE__, __func__, 50006, contents.find ("This entry was too large and has been truncated: 60000 bytes"));
     } else {
       evaluate (__LINE__, __func__, 1, (int)result.size ());
@@ -78,4 +77,71 @@ void test_database_logs ()
     evaluate (__LINE__, __func__, "", s);
     refresh_sandbox (false);
   }
+  {
+    // Test that entries logged in quick succession each get their own increasing filename,
+    // and that the journal can be followed entry by entry.
+    refresh_sandbox (true);
+    Database_Logs::log ("one", 2);
+    Database_Logs::log ("two", "body", 3);
+    Database_Logs::log ("three", 4);
+    string filename = "0";
+    vector <string> filenames;
+    string s;
+    while (!(s = Database_Logs::next (filename)).empty ()) filenames.push_back (s);
+    evaluate (__LINE__, __func__, 3, (int)filenames.size ());
+    if (filenames.size () == 3) {
+      evaluate (__LINE__, __func__, true, filenames [0] < filenames [1]);
+      evaluate (__LINE__, __func__, true, filenames [1] < filenames [2]);
+      evaluate (__LINE__, __func__, "2 one", Database_Logs::entry (filenames [0]));
+      evaluate (__LINE__, __func__, "3 two\nbody", Database_Logs::entry (filenames [1]));
+      evaluate (__LINE__, __func__, "4 three", Database_Logs::entry (filenames [2]));
+    }
+    evaluate (__LINE__, __func__, "", Database_Logs::entry ("1"));
+    // The entries are in segments rather than in a file per entry.
+    vector <string> files = filter_url_scandir (Database_Logs::folder ());
+    evaluate (__LINE__, __func__, 1, (int)files.size ());
+    refresh_sandbox (false);
+  }
+  {
+    // Test that entries in a file each, as older versions stored them, are moved into a segment,
+    // and that rotating the journal removes expired entries.
+    refresh_sandbox (true);
+    string old_filename = "100000000000000000";
+    string recent_filename = convert_to_string (filter_date_seconds_since_epoch ()) + "00000000";
+    filter_url_file_put_contents (filter_url_create_path (Database_Logs::folder (), old_filename), "5 old");
+    filter_url_file_put_contents (filter_url_create_path (Database_Logs::folder (), recent_filename), "5 recent");
+    string lastfilename;
+    vector <string> filenames = Database_Logs::get (lastfilename);
+    evaluate (__LINE__, __func__, {old_filename, recent_filename}, filenames);
+    evaluate (__LINE__, __func__, recent_filename, lastfilename);
+    evaluate (__LINE__, __func__, "5 recent", Database_Logs::entry (recent_filename));
+    evaluate (__LINE__, __func__, false, file_or_dir_exists (filter_url_create_path (Database_Logs::folder (), old_filename)));
+    Database_Logs::rotate ();
+    filenames = Database_Logs::get (lastfilename);
+    evaluate (__LINE__, __func__, {recent_filename}, filenames);
+    evaluate (__LINE__, __func__, "5 recent", Database_Logs::entry (recent_filename));
+    // New entries come after the ones already there.
+    Database_Logs::log ("new");
+    filenames = Database_Logs::get (lastfilename);
+    evaluate (__LINE__, __func__, 2, (int)filenames.size ());
+    evaluate (__LINE__, __func__, "5 new", Database_Logs::entry (lastfilename));
+    refresh_sandbox (true, {"recent", "new"});
+  }
+  {
+    // Test limiting the number of entries.
+    refresh_sandbox (true);
+    for (int i = 0; i < 2010; i++) Database_Logs::log ("entry " + convert_to_string (i));
+    Database_Logs::rotate ();
+    string lastfilename;
+    vector <string> filenames = Database_Logs::get (lastfilename);
+    evaluate (__LINE__, __func__, 2000, (int)filenames.size ());
+    if (!filenames.empty ()) {
+      evaluate (__LINE__, __func__, "5 entry 10", Database_Logs::entry (filenames [0]));
+      evaluate (__LINE__, __func__, "5 entry 2009", Database_Logs::entry (lastfilename));
+    }
+    Database_Logs::clear ();
+    filenames = Database_Logs::get (lastfilename);
+    evaluate (__LINE__, __func__, 1, (int)filenames.size ());
+    refresh_sandbox (false);
+  }
 }
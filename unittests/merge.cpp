@@ -225,6 +225,50 @@ void test_merge ()
     evaluate (__LINE__, __func__, 0, conflicts.size ());
   }
   
+  // Test word merge inside a conflicting line, with an empty line and with multibyte characters.
+  {
+    vector <Merge_Conflict> conflicts;
+    string mergeBaseData =
+    "\\c 1\n"
+    "\n"
+    "\\v 1 Ἐν ἀρχῇ ἦν ὁ λόγος.\n";
+    string userModificationData =
+    "\\c 1\n"
+    "\n"
+    "\\v 1 Ἐν ἀρχῇ ἦν ὁ Λόγος.\n";
+    string serverModificationData =
+    "\\c 1\n"
+    "\n"
+    "\\v 1 Ἐν ἀρχῇ ἐστιν ὁ λόγος.\n";
+    string output = filter_merge_run (mergeBaseData, userModificationData, serverModificationData, false, conflicts);
+    string standard =
+    "\\c 1\n"
+    "\n"
+    "\\v 1 Ἐν ἀρχῇ ἐστιν ὁ Λόγος.";
+    evaluate (__LINE__, __func__, standard, output);
+    evaluate (__LINE__, __func__, 0, conflicts.size ());
+  }
+  
+  // Test grapheme merge inside a conflicting word, with multibyte characters.
+  {
+    vector <Merge_Conflict> conflicts;
+    string mergeBaseData =
+    "\\c 1\n"
+    "\\v 1 ὁ λόγος καὶ\n";
+    string userModificationData =
+    "\\c 1\n"
+    "\\v 1 ὁ Λόγος καὶ\n";
+    string serverModificationData =
+    "\\c 1\n"
+    "\\v 1 ὁ λόγον καὶ\n";
+    string output = filter_merge_run (mergeBaseData, userModificationData, serverModificationData, false, conflicts);
+    string standard =
+    "\\c 1\n"
+    "\\v 1 ὁ Λόγον καὶ";
+    evaluate (__LINE__, __func__, standard, output);
+    evaluate (__LINE__, __func__, 0, conflicts.size ());
+  }
+  
   // Test that in case of a conflict, it takes the server's version.
   {
     vector <Merge_Conflict> conflicts;
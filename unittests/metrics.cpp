@@ -0,0 +1,106 @@
+/*
+ Copyright (©) 2003-2021 Teus Benschop.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <unittests/metrics.h>
+#include <unittests/utilities.h>
+#include <filter/metrics.h>
+
+
+void test_metrics ()
+{
+  trace_unit_tests (__func__);
+  
+  filter_metrics_clear ();
+  filter_metrics_set_tracing (false);
+  
+  // Test the routes under which requests are counted.
+  {
+    evaluate (__LINE__, __func__, "edit/index", filter_metrics_route ("/edit/index"));
+    evaluate (__LINE__, __func__, "", filter_metrics_route ("/"));
+    evaluate (__LINE__, __func__, "files", filter_metrics_route ("/css/stylesheet.css"));
+    evaluate (__LINE__, __func__, "unknown", filter_metrics_unknown_route ());
+  }
+  
+  // Test the histograms and the byte counts.
+  {
+    filter_metrics_begin ("edit/index");
+    evaluate (__LINE__, __func__, 1, filter_metrics_in_flight ());
+    filter_metrics_end ("edit/index", 800, 100, 2000);
+    filter_metrics_begin ("edit/index");
+    filter_metrics_end ("edit/index", 30000, 200, 3000);
+    filter_metrics_begin ("read/index");
+    filter_metrics_end ("read/index", 20000000, 10, 20);
+    evaluate (__LINE__, __func__, 0, filter_metrics_in_flight ());
+    map <string, Filter_Metrics_Route> routes = filter_metrics_routes ();
+    evaluate (__LINE__, __func__, 2, (int) routes.size ());
+    Filter_Metrics_Route route = routes ["edit/index"];
+    evaluate (__LINE__, __func__, 2, (int) route.count);
+    evaluate (__LINE__, __func__, 30800, (int) route.microseconds);
+    evaluate (__LINE__, __func__, 30000, (int) route.maximum);
+    evaluate (__LINE__, __func__, 300, (int) route.bytes_in);
+    evaluate (__LINE__, __func__, 5000, (int) route.bytes_out);
+    evaluate (__LINE__, __func__, 1, (int) route.buckets [0]);
+    evaluate (__LINE__, __func__, 1, (int) route.buckets [5]);
+    evaluate (__LINE__, __func__, 1000, (int) filter_metrics_percentile (route, 50));
+    evaluate (__LINE__, __func__, 30000, (int) filter_metrics_percentile (route, 95));
+    route = routes ["read/index"];
+    evaluate (__LINE__, __func__, 1, (int) route.buckets.back ());
+    evaluate (__LINE__, __func__, 20000000, (int) filter_metrics_percentile (route, 50));
+  }
+  
+  // Test the text for Prometheus.
+  {
+    string text = filter_metrics_prometheus ();
+    evaluate (__LINE__, __func__, true, text.find ("bibledit_http_request_duration_seconds_bucket{route=\"edit/index\",le=\"0.001\"} 1\n") != string::npos);
+    evaluate (__LINE__, __func__, true, text.find ("bibledit_http_request_duration_seconds_bucket{route=\"edit/index\",le=\"0.05\"} 2\n") != string::npos);
+    evaluate (__LINE__, __func__, true, text.find ("bibledit_http_request_duration_seconds_bucket{route=\"edit/index\",le=\"+Inf\"} 2\n") != string::npos);
+    evaluate (__LINE__, __func__, true, text.find ("bibledit_http_request_duration_seconds_sum{route=\"edit/index\"} 0.0308\n") != string::npos);
+    evaluate (__LINE__, __func__, true, text.find ("bibledit_http_request_duration_seconds_count{route=\"read/index\"} 1\n") != string::npos);
+    evaluate (__LINE__, __func__, true, text.find ("bibledit_http_sent_bytes_total{route=\"edit/index\"} 5000\n") != string::npos);
+    evaluate (__LINE__, __func__, true, text.find ("bibledit_http_requests_in_flight 0\n") != string::npos);
+  }
+  
+  // Test tracing the parts of a request.
+  {
+    {
+      Filter_Metrics_Timer timer ("sql", "outside of a request");
+    }
+    filter_metrics_set_tracing (true);
+    filter_metrics_begin ("edit/index");
+    {
+      Filter_Metrics_Timer timer ("template", "edit/index");
+      Filter_Metrics_Timer timer2 ("sql", "SELECT 1;");
+    }
+    filter_metrics_end ("edit/index", 10, 0, 0);
+    filter_metrics_set_tracing (false);
+    filter_metrics_begin ("edit/index");
+    {
+      Filter_Metrics_Timer timer ("file", "not traced");
+    }
+    filter_metrics_end ("edit/index", 10, 0, 0);
+    vector <Filter_Metrics_Trace> traces = filter_metrics_traces ();
+    evaluate (__LINE__, __func__, 1, (int) traces.size ());
+    evaluate (__LINE__, __func__, "edit/index", traces [0].route);
+    evaluate (__LINE__, __func__, 2, (int) traces [0].spans.size ());
+    evaluate (__LINE__, __func__, "template", traces [0].spans [0].kind);
+    evaluate (__LINE__, __func__, "SELECT 1;", traces [0].spans [1].detail);
+  }
+  
+  filter_metrics_clear ();
+  evaluate (__LINE__, __func__, 0, (int) filter_metrics_routes ().size ());
+}
@@ -25,6 +25,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <database/bibles.h>
 #include <bb/logic.h>
 #include <changes/logic.h>
+#include <database/sqlite.h>
+#include <database/logic.h>
+#include <filter/url.h>
+#include <filter/string.h>
 
 
 void test_database_modifications_user ()
@@ -140,6 +144,89 @@ void test_database_modifications_user ()
     int currenttime = filter_date_seconds_since_epoch ();
     if ((time < currenttime - 1) || (time > currenttime + 1)) evaluate (__LINE__, __func__, currenttime, time);
   }
+
+  // The log stores the texts as deltas against the previous save.
+  {
+    refresh_sandbox (true);
+    Database_Modifications database_modifications;
+    string text1 = "\\c 1\n\\p\n\\v 1 In the beginning God created the heavens and the earth.\n";
+    string text2 = text1 + "\\v 2 The earth was formless and empty.\n";
+    string text3 = text2 + "\\v 3 God said, Let there be light.\n";
+    database_modifications.recordUserSave ("phpunit1", "bible", 1, 1, 10, text1, 11, text2);
+    database_modifications.recordUserSave ("phpunit1", "bible", 1, 1, 11, text2, 12, text3);
+    database_modifications.recordUserSave ("phpunit1", "bible", 1, 2, 20, "old", 21, "new");
+    string path = filter_url_create_root_path (database_logic_databases (), "modifications", "saves", "phpunit1");
+    int size = filter_url_filesize (path);
+    if (size >= (int) (text1.size () + text2.size () + text3.size ())) evaluate (__LINE__, __func__, "smaller", convert_to_string (size));
+    Database_Modifications_Text chapter = database_modifications.getUserChapter ("phpunit1", "bible", 1, 1, 12);
+    evaluate (__LINE__, __func__, text2, chapter.oldtext);
+    evaluate (__LINE__, __func__, text3, chapter.newtext);
+    chapter = database_modifications.getUserChapter ("phpunit1", "bible", 1, 2, 21);
+    evaluate (__LINE__, __func__, "old", chapter.oldtext);
+    evaluate (__LINE__, __func__, "new", chapter.newtext);
+    // A save that was not written in full is left out.
+    filter_url_file_put_contents_append (path, "0 1 1 12 13 1 5 10 10\nbible");
+    vector <Database_Modifications_Id> identifiers = database_modifications.getUserIdentifiers ("phpunit1", "bible", 1, 1);
+    evaluate (__LINE__, __func__, 2, (int)identifiers.size());
+    // The saves after a save that was not written in full can still be read.
+    string text4 = text3 + "\\v 4 God saw the light, and saw that it was good.\n";
+    database_modifications.recordUserSave ("phpunit1", "bible", 1, 1, 12, text3, 13, text4);
+    database_modifications.recordUserSave ("phpunit1", "bible", 1, 2, 21, "new", 22, "newer");
+    identifiers = database_modifications.getUserIdentifiers ("phpunit1", "bible", 1, 1);
+    evaluate (__LINE__, __func__, 3, (int)identifiers.size());
+    chapter = database_modifications.getUserChapter ("phpunit1", "bible", 1, 1, 13);
+    evaluate (__LINE__, __func__, text3, chapter.oldtext);
+    evaluate (__LINE__, __func__, text4, chapter.newtext);
+    chapter = database_modifications.getUserChapter ("phpunit1", "bible", 1, 2, 22);
+    evaluate (__LINE__, __func__, "new", chapter.oldtext);
+    evaluate (__LINE__, __func__, "newer", chapter.newtext);
+    // Clearing the user removes the log.
+    database_modifications.clearUserUser ("phpunit1");
+    evaluate (__LINE__, __func__, {}, database_modifications.getUserUsernames ());
+  }
+
+  // Import the saves stored in the deep folder structure.
+  {
+    refresh_sandbox (true);
+    string folder = filter_url_create_root_path (database_logic_databases (), "modifications", "users", "phpunit1", "bible");
+    folder = filter_url_create_path (folder, "1", "2");
+    for (int newid = 4; newid <= 5; newid++) {
+      string save = filter_url_create_path (folder, convert_to_string (newid));
+      filter_url_mkdir (save);
+      filter_url_file_put_contents (filter_url_create_path (save, "time"), convert_to_string (filter_date_seconds_since_epoch ()));
+      filter_url_file_put_contents (filter_url_create_path (save, "oldid"), convert_to_string (newid - 1));
+      filter_url_file_put_contents (filter_url_create_path (save, "oldtext"), "old" + convert_to_string (newid));
+      filter_url_file_put_contents (filter_url_create_path (save, "newtext"), "new" + convert_to_string (newid));
+    }
+    Database_Modifications database_modifications;
+    evaluate (__LINE__, __func__, {"phpunit1"}, database_modifications.getUserUsernames ());
+    evaluate (__LINE__, __func__, false, file_or_dir_exists (filter_url_create_root_path (database_logic_databases (), "modifications", "users", "phpunit1")));
+    evaluate (__LINE__, __func__, {2}, database_modifications.getUserChapters ("phpunit1", "bible", 1));
+    vector <Database_Modifications_Id> identifiers = database_modifications.getUserIdentifiers ("phpunit1", "bible", 1, 2);
+    evaluate (__LINE__, __func__, 2, (int)identifiers.size());
+    evaluate (__LINE__, __func__, 5, identifiers[1].newid);
+    Database_Modifications_Text chapter = database_modifications.getUserChapter ("phpunit1", "bible", 1, 2, 5);
+    evaluate (__LINE__, __func__, "old5", chapter.oldtext);
+    evaluate (__LINE__, __func__, "new5", chapter.newtext);
+  }
+  
+  // Saves to more chapters than there are last saves kept in memory still read back in full.
+  {
+    refresh_sandbox (true);
+    Database_Modifications database_modifications;
+    for (int chapter = 1; chapter <= 510; chapter++) {
+      database_modifications.recordUserSave ("phpunit1", "bible", 1, chapter, 1, "old" + convert_to_string (chapter), 2, "new" + convert_to_string (chapter));
+    }
+    database_modifications.recordUserSave ("phpunit1", "bible", 1, 1, 2, "new1", 3, "newer1");
+    Database_Modifications_Text chapter = database_modifications.getUserChapter ("phpunit1", "bible", 1, 1, 3);
+    evaluate (__LINE__, __func__, "new1", chapter.oldtext);
+    evaluate (__LINE__, __func__, "newer1", chapter.newtext);
+    chapter = database_modifications.getUserChapter ("phpunit1", "bible", 1, 510, 2);
+    evaluate (__LINE__, __func__, "old510", chapter.oldtext);
+    evaluate (__LINE__, __func__, "new510", chapter.newtext);
+    evaluate (__LINE__, __func__, 2, (int)database_modifications.getUserIdentifiers ("phpunit1", "bible", 1, 1).size ());
+    evaluate (__LINE__, __func__, 0, (int)database_modifications.getUserIdentifiers ("phpunit1", "bible", 1, 511).size ());
+  }
 }
 
 
@@ -667,4 +754,67 @@ void test_database_modifications_notifications ()
     vector <int> ids = database_modifications.getNotificationIdentifiers (any_user, any_bible);
     evaluate (__LINE__, __func__, {3, 5}, ids);
   }
+
+  // Batch of notifications.
+  {
+    refresh_sandbox (true);
+    Database_Modifications database_modifications;
+    database_modifications.create ();
+    database_modifications.recordNotification ({"phpunit1"}, "A", "1", 1, 2, 3, "old1", "mod1", "new1");
+    database_modifications.beginNotifications ();
+    database_modifications.recordNotification ({"phpunit1", "phpunit2"}, "A", "1", 1, 2, 4, "old2", "mod2", "new2");
+    database_modifications.recordNotification ({"phpunit3"}, "A", "1", 1, 2, 5, "old3", "mod3", "new3");
+    evaluate (__LINE__, __func__, 5, database_modifications.getNextAvailableNotificationIdentifier ());
+    database_modifications.commitNotifications ();
+    vector <int> ids = database_modifications.getNotificationIdentifiers (any_user, any_bible);
+    evaluate (__LINE__, __func__, {1, 2, 3, 4}, ids);
+    evaluate (__LINE__, __func__, "new3", database_modifications.getNotificationNewText (4));
+    evaluate (__LINE__, __func__, 5, database_modifications.getNextAvailableNotificationIdentifier ());
+  }
+
+  // The checkup keeps the notifications of a healthy database,
+  // and sets a damaged database aside rather than deleting it.
+  {
+    refresh_sandbox (true);
+    Database_Modifications database_modifications;
+    database_modifications.checkup ();
+    database_modifications.recordNotification ({"phpunit1"}, "A", "1", 1, 2, 3, "old1", "mod1", "new1");
+    database_modifications.checkup ();
+    evaluate (__LINE__, __func__, {1}, database_modifications.getNotificationIdentifiers (any_user, any_bible));
+    string file = database_sqlite_file ("modifications");
+    filter_url_file_put_contents (file, "This is not a database");
+    database_modifications.checkup ();
+    evaluate (__LINE__, __func__, "This is not a database", filter_url_file_get_contents (file + ".damaged"));
+    evaluate (__LINE__, __func__, true, database_modifications.healthy ());
+    evaluate (__LINE__, __func__, {}, database_modifications.getNotificationIdentifiers (any_user, any_bible));
+    database_modifications.recordNotification ({"phpunit1"}, "A", "1", 1, 2, 3, "old1", "mod1", "new1");
+    evaluate (__LINE__, __func__, {1}, database_modifications.getNotificationIdentifiers (any_user, any_bible));
+    refresh_sandbox (true, {"change notifications", "file is not a database", "no such table: damaged.notifications"});
+  }
+
+  // Import the notifications stored in one small database each.
+  {
+    refresh_sandbox (true);
+    string folder = filter_url_create_root_path (database_logic_databases (), "modifications", "notifications");
+    filter_url_mkdir (folder);
+    {
+      SqliteDatabase sql (filter_url_create_path (folder, "7"));
+      sql.add ("CREATE TABLE notification (timestamp integer, username text, category text, bible text, book integer, chapter integer, verse integer, oldtext text, modification text, newtext text);");
+      sql.execute ();
+      sql.clear ();
+      sql.add ("INSERT INTO notification VALUES (");
+      sql.add (filter_date_seconds_since_epoch ());
+      sql.add (", 'phpunit', 'A', 'bible', 1, 2, 3, 'old7', 'mod7', 'new7');");
+      sql.execute ();
+    }
+    Database_Modifications database_modifications;
+    database_modifications.create ();
+    evaluate (__LINE__, __func__, false, file_or_dir_exists (folder));
+    vector <int> ids = database_modifications.getNotificationIdentifiers (any_user, any_bible);
+    evaluate (__LINE__, __func__, {7}, ids);
+    evaluate (__LINE__, __func__, "old7", database_modifications.getNotificationOldText (7));
+    evaluate (__LINE__, __func__, "mod7", database_modifications.getNotificationModification (7));
+    evaluate (__LINE__, __func__, "new7", database_modifications.getNotificationNewText (7));
+    evaluate (__LINE__, __func__, 8, database_modifications.getNextAvailableNotificationIdentifier ());
+  }
 }
@@ -21,6 +21,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <unittests/utilities.h>
 #include <database/noteactions.h>
 #include <database/notes.h>
+#include <database/sqlite.h>
 #include <database/state.h>
 #include <database/mail.h>
 #include <database/noteassignment.h>
@@ -516,7 +517,7 @@ void test_database_notes ()
     for (auto & status : statuses) {
       rawstatuses.push_back (status.raw);
     }
-    evaluate (__LINE__, __func__, {"yyyyy", "xxxxx", "New", "Pending", "In progress", "Done", "Reopened"}, rawstatuses);
+    evaluate (__LINE__, __func__, {"xxxxx", "yyyyy", "New", "Pending", "In progress", "Done", "Reopened"}, rawstatuses);
   }
 
   // Getting and setting the severity.
@@ -1227,8 +1228,9 @@ void test_database_notes ()
     identifiers = database_notes.select_notes ({"bible1", "bible2"}, 0, 0, 0, 3, 0, 0, "", "bible2", "", false, -1, 0, "", -1);
     evaluate (__LINE__, __func__, {identifier2}, identifiers);
     
+    // Notes on the same passages come in the order of their identifiers.
     identifiers = database_notes.select_notes ({"bible1", "bible2"}, 0, 0, 0, 3, 0, 0, "", "", "", false, -1, 0, "", -1);
-    evaluate (__LINE__, __func__, {identifier1, identifier2}, identifiers);
+    evaluate (__LINE__, __func__, {min (identifier1, identifier2), max (identifier1, identifier2)}, identifiers);
     
     identifiers = database_notes.select_notes ({"bible1", "bible2", "bible4"}, 0, 0, 0, 3, 0, 0, "", "bible", "", false, -1, 0, "", -1);
     evaluate (__LINE__, __func__, {}, identifiers);
@@ -1776,6 +1778,117 @@ void test_database_notes ()
     evaluate (__LINE__, __func__, true, database_notes.get_public (identifier2));
   }
 
+  // Test selecting notes through the indexes on the passages, the assignees, the subscribers, and the text,
+  // and selecting them a page at a time.
+  {
+    refresh_sandbox (true);
+    Database_State::create ();
+    Database_Login::create ();
+    Database_Users database_users;
+    database_users.create ();
+    Webserver_Request request;
+    Database_Notes database_notes (&request);
+    database_notes.create ();
+
+    int identifier1 = database_notes.store_new_note ("", 2, 3, 4, "summary", "contents one", false);
+    int identifier2 = database_notes.store_new_note ("", 1, 2, 3, "summary", "contents two", false);
+    int identifier3 = database_notes.store_new_note ("", 1, 2, 4, "summary", "contents three", false);
+    int identifier4 = database_notes.store_new_note ("", 1, 3, 1, "summary", "contents four", false);
+    // A note that refers to two passages sorts on the average of them.
+    database_notes.set_passages (identifier4, { Passage ("", 1, 3, "1"), Passage ("", 3, 1, "1") });
+    int identifier5 = database_notes.store_new_note ("", 1, 2, 3, "summary", "contents five", false);
+
+    // Notes on the same passages come in the order of their identifiers.
+    int identifier25 = min (identifier2, identifier5);
+    int identifier52 = max (identifier2, identifier5);
+
+    // Passage selectors for the verse, the chapter, and the book.
+    vector <int> identifiers;
+    identifiers = database_notes.select_notes ({}, 1, 2, 3, 0, 0, 0, "", "", "", false, -1, 0, "", -1);
+    evaluate (__LINE__, __func__, {identifier25, identifier52}, identifiers);
+    identifiers = database_notes.select_notes ({}, 1, 2, 3, 1, 0, 0, "", "", "", false, -1, 0, "", -1);
+    evaluate (__LINE__, __func__, {identifier25, identifier52, identifier3}, identifiers);
+    identifiers = database_notes.select_notes ({}, 1, 2, 3, 2, 0, 0, "", "", "", false, -1, 0, "", -1);
+    evaluate (__LINE__, __func__, {identifier25, identifier52, identifier3, identifier4}, identifiers);
+
+    // All notes, in passage order, then in pages of two notes.
+    vector <int> all = {identifier25, identifier52, identifier3, identifier4, identifier1};
+    identifiers = database_notes.select_notes ({}, 0, 0, 0, 3, 0, 0, "", "", "", false, -1, 0, "", -1);
+    evaluate (__LINE__, __func__, all, identifiers);
+    identifiers = database_notes.select_notes ({}, 0, 0, 0, 3, 0, 0, "", "", "", false, -1, 0, "", 2);
+    evaluate (__LINE__, __func__, {identifier25, identifier52}, identifiers);
+    identifiers = database_notes.select_notes ({}, 0, 0, 0, 3, 0, 0, "", "", "", false, -1, 0, "", 2, database_notes.get_passage_key (identifiers.back ()), identifiers.back ());
+    evaluate (__LINE__, __func__, {identifier3, identifier4}, identifiers);
+    int after_key = database_notes.get_passage_key (identifiers.back ());
+    int after = identifiers.back ();
+    identifiers = database_notes.select_notes ({}, 0, 0, 0, 3, 0, 0, "", "", "", false, -1, 0, "", 2, after_key, after);
+    evaluate (__LINE__, __func__, {identifier1}, identifiers);
+
+    // The next page remains the same after the last note of the previous page got deleted.
+    database_notes.erase (after);
+    identifiers = database_notes.select_notes ({}, 0, 0, 0, 3, 0, 0, "", "", "", false, -1, 0, "", 2, after_key, after);
+    evaluate (__LINE__, __func__, {identifier1}, identifiers);
+    identifier4 = database_notes.store_new_note ("", 1, 3, 1, "summary", "contents four", false);
+    database_notes.set_passages (identifier4, { Passage ("", 1, 3, "1"), Passage ("", 3, 1, "1") });
+
+    // Assignees and subscribers.
+    database_notes.assign_user (identifier3, "user1");
+    database_notes.assign_user (identifier3, "user2");
+    database_notes.subscribe_user (identifier1, "user1");
+    identifiers = database_notes.select_notes ({}, 0, 0, 0, 3, 0, 0, "", "", "user2", false, -1, 0, "", -1);
+    evaluate (__LINE__, __func__, {identifier3}, identifiers);
+    identifiers = database_notes.select_notes ({}, 0, 0, 0, 3, 0, 0, "", "", "user", false, -1, 0, "", -1);
+    evaluate (__LINE__, __func__, {}, identifiers);
+    evaluate (__LINE__, __func__, {"user1", "user2"}, database_notes.get_all_assignees ({}));
+    database_notes.unassign_user (identifier3, "user2");
+    identifiers = database_notes.select_notes ({}, 0, 0, 0, 3, 0, 0, "", "", "user2", false, -1, 0, "", -1);
+    evaluate (__LINE__, __func__, {}, identifiers);
+
+    // Searching the text finds any bit of it, also after the note got a new identifier.
+    identifiers = database_notes.select_notes ({}, 0, 0, 0, 3, 0, 0, "", "", "", false, -1, 1, "thr", -1);
+    evaluate (__LINE__, __func__, {identifier3}, identifiers);
+    int identifier6 = identifier3 + 1;
+    database_notes.set_identifier (identifier3, identifier6);
+    evaluate (__LINE__, __func__, {identifier6}, database_notes.search_notes ("ontents thr", {}));
+    identifiers = database_notes.select_notes ({}, 1, 2, 4, 0, 0, 0, "", "", "user1", false, -1, 0, "", -1);
+    evaluate (__LINE__, __func__, {identifier6}, identifiers);
+
+    // Indexing the notes already in the database again gives the same selections.
+    database_notes.reindex ();
+    identifiers = database_notes.select_notes ({}, 0, 0, 0, 3, 0, 0, "", "", "", false, -1, 0, "", -1);
+    evaluate (__LINE__, __func__, {identifier25, identifier52, identifier6, identifier4, identifier1}, identifiers);
+    evaluate (__LINE__, __func__, {identifier6}, database_notes.search_notes ("thr", {}));
+
+    // A note that refers to passages but has no sort key gets one when the database is opened.
+    {
+      sqlite3 * db = database_sqlite_connect ("notes");
+      database_sqlite_exec (db, "UPDATE notes SET passagekey = 0 WHERE identifier = " + convert_to_string (identifier1) + ";");
+      database_sqlite_disconnect (db);
+    }
+    database_notes.create ();
+    evaluate (__LINE__, __func__, true, database_notes.get_passage_key (identifier1) > 0);
+
+    // Upgrading a database from before the sort key gives every note a key, so paging still finds all of them.
+    {
+      sqlite3 * db = database_sqlite_connect ("notes");
+      database_sqlite_exec (db, "CREATE TABLE old AS SELECT id, identifier, modified, assigned, subscriptions, bible, passage, status, severity, summary, contents, cleantext FROM notes;");
+      database_sqlite_exec (db, "DROP TABLE notes;");
+      database_sqlite_exec (db, "ALTER TABLE old RENAME TO notes;");
+      database_sqlite_disconnect (db);
+    }
+    database_notes.create ();
+    identifiers = database_notes.select_notes ({}, 0, 0, 0, 3, 0, 0, "", "", "", false, -1, 0, "", 3);
+    evaluate (__LINE__, __func__, {identifier25, identifier52, identifier6}, identifiers);
+    identifiers = database_notes.select_notes ({}, 0, 0, 0, 3, 0, 0, "", "", "", false, -1, 0, "", 3, database_notes.get_passage_key (identifiers.back ()), identifiers.back ());
+    evaluate (__LINE__, __func__, {identifier4, identifier1}, identifiers);
+
+    // Erasing a note removes it from the indexes.
+    database_notes.erase (identifier6);
+    evaluate (__LINE__, __func__, {}, database_notes.search_notes ("thr", {}));
+    identifiers = database_notes.select_notes ({}, 1, 2, 4, 0, 0, 0, "", "", "", false, -1, 0, "", -1);
+    evaluate (__LINE__, __func__, {}, identifiers);
+  }
+
 }
 
 
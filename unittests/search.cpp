@@ -22,6 +22,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <database/state.h>
 #include <database/bibles.h>
 #include <search/logic.h>
+#include <search/terms.h>
+#include <search/replacebible.h>
+#include <search/rebibles.h>
+#include <database/config/general.h>
+#include <database/config/bible.h>
+#include <database/styles.h>
+#include <filter/url.h>
+#include <database/users.h>
+#include <filter/roles.h>
+#include <filter/string.h>
 
 
 void test_search_setup ()
@@ -195,4 +205,165 @@ void test_search ()
     int count = search_logic_get_verse_count ("phpunit");
     evaluate (__LINE__, __func__, 11, count);
   }
+  
+  // The plain text, the headings and the notes go to the verses they belong to.
+  {
+    refresh_sandbox (true);
+    Database_State::create ();
+    Database_Bibles database_bibles;
+    database_bibles.createBible ("phpunit");
+    string usfm =
+    "\\c 1\n"
+    "\\p\n"
+    "\\v 1 First verse\\f + \\fr 1.1: \\ft note one\\f*.\n"
+    "\\v 2 Second verse.\n"
+    "\\s Heading\n"
+    "\\p\n"
+    "\\v 3 Third verse\\x + \\xo 1.3: \\xt note three\\x*.";
+    database_bibles.storeChapter ("phpunit", 1, 1, usfm);
+    database_bibles.storeChapter ("phpunit", 1, 2, filter_string_str_replace ("verse", "line", usfm));
+    Database_Config_General::setIndexBibles (true);
+    search_reindex_bibles (false);
+    evaluate (__LINE__, __func__, "First verse.\n1.1: note one", search_logic_get_bible_verse_text ("phpunit", 1, 1, 1));
+    evaluate (__LINE__, __func__, "Second verse.\nHeading", search_logic_get_bible_verse_text ("phpunit", 1, 1, 2));
+    evaluate (__LINE__, __func__, "Third verse.\n1.3: note three", search_logic_get_bible_verse_text ("phpunit", 1, 1, 3));
+    evaluate (__LINE__, __func__, "Second line.\nHeading", search_logic_get_bible_verse_text ("phpunit", 1, 2, 2));
+    refresh_sandbox (true, {"Indexing Bibles"});
+  }
+
+  // The plain text of combined verses goes to every verse they consist of.
+  {
+    refresh_sandbox (true);
+    Database_State::create ();
+    search_terms_delete_bible ("phpunit");
+    Database_Bibles database_bibles;
+    database_bibles.createBible ("phpunit");
+    string usfm =
+    "\\c 1\n"
+    "\\p\n"
+    "\\v 1-2 Verses one and two.\n"
+    "\\v 3 Verse three \\v 4 and verse four.\n"
+    "\\v 5 Verse five.";
+    database_bibles.storeChapter ("phpunit", 1, 1, usfm);
+    search_logic_index_chapter ("phpunit", 1, 1);
+    evaluate (__LINE__, __func__, "Verses one and two.", search_logic_get_bible_verse_text ("phpunit", 1, 1, 1));
+    evaluate (__LINE__, __func__, "Verses one and two.", search_logic_get_bible_verse_text ("phpunit", 1, 1, 2));
+    evaluate (__LINE__, __func__, "Verse three\nand verse four.", search_logic_get_bible_verse_text ("phpunit", 1, 1, 3));
+    evaluate (__LINE__, __func__, "Verse three\nand verse four.", search_logic_get_bible_verse_text ("phpunit", 1, 1, 4));
+    // Searching gives the first of the combined verses.
+    vector <Passage> passages = search_logic_search_bible ("phpunit", "four", false, true);
+    evaluate (__LINE__, __func__, 1, (int)passages.size ());
+    if (passages.size () == 1) evaluate (__LINE__, __func__, "3", passages[0].verse);
+    // Every verse gets the text for the statistics for similar verses.
+    map <int, string> plains = search_logic_plain_lower_texts (filter_url_file_get_contents (search_logic_chapter_file ("phpunit", 1, 1)));
+    evaluate (__LINE__, __func__, {
+      {0, ""}, {1, "verses one and two."}, {2, "verses one and two."},
+      {3, "verse three\nand verse four."}, {4, "verse three\nand verse four."},
+      {5, "verse five."}
+    }, plains);
+  }
+  
+  // Similar verses come from the term statistics, which follow the changes to the chapters.
+  {
+    evaluate (__LINE__, __func__, vector <string> {"apakah", "benar", "allah", "jangan", "6th"}, search_terms_tokenize ("“apakah benar, allah.” ‘jangan’ — 6th."));
+    refresh_sandbox (true);
+    search_terms_delete_bible ("phpunit");
+    test_search_setup ();
+    // Terms in more than 30% of the verses do not count, and one shared term is not enough.
+    evaluate (__LINE__, __func__, vector <int> {2003006}, search_terms_similar ("phpunit", "Sixth 6th fifth verse ✆"));
+    Database_Bibles database_bibles;
+    string usfm = database_bibles.getChapter ("phpunit", 2, 3);
+    usfm = filter_string_str_replace ("Text of the 5th fifth verse is this: Verse five ✆.", "The fifth verse, and not the sixth one, is long.", usfm);
+    database_bibles.storeChapter ("phpunit", 2, 3, usfm);
+    evaluate (__LINE__, __func__, vector <int> {2003006, 2003005}, search_terms_similar ("phpunit", "Sixth 6th fifth verse ✆"));
+    search_logic_delete_chapter ("phpunit", 2, 3);
+    evaluate (__LINE__, __func__, vector <int> {}, search_terms_similar ("phpunit", "Sixth 6th fifth verse ✆"));
+  }
+  
+  // Replacing text throughout a Bible plans the replacements per chapter, and stores every chapter once.
+  {
+    refresh_sandbox (true);
+    test_search_setup ();
+    vector <Passage> passages = search_logic_search_bible ("phpunit", "sixth", true, true);
+    evaluate (__LINE__, __func__, 1, (int)passages.size ());
+    passages = search_logic_search_bible ("phpunit", "Text", true, true);
+    vector <Search_Replace_Chapter> plan = search_logic_plan_replace ("phpunit", passages, "Text", "Word", true, true);
+    evaluate (__LINE__, __func__, 1, (int)plan.size ());
+    if (plan.size () == 1) {
+      evaluate (__LINE__, __func__, vector <int> {1, 2, 3, 4, 5, 6, 7}, plan [0].verses);
+      evaluate (__LINE__, __func__, vector <int> {}, plan [0].failures);
+      evaluate (__LINE__, __func__, 7, plan [0].count);
+      evaluate (__LINE__, __func__, false, plan [0].new_usfm.find ("Text") != string::npos);
+    }
+    // Text split by markup in the USFM cannot be replaced safely in the plain text.
+    passages = search_logic_search_bible ("phpunit", "fourth verse", true, true);
+    plan = search_logic_plan_replace ("phpunit", passages, "fourth verse", "verse", true, true);
+    evaluate (__LINE__, __func__, 1, (int)plan.size ());
+    if (plan.size () == 1) {
+      evaluate (__LINE__, __func__, vector <int> {}, plan [0].verses);
+      evaluate (__LINE__, __func__, vector <int> {4}, plan [0].failures);
+    }
+    Database_Users database_users;
+    database_users.create ();
+    database_users.add_user ("manager", "", Filter_Roles::manager (), "");
+    search_replace_bible ("phpunit", "text", "Word", false, true, "manager");
+    Database_Bibles database_bibles;
+    string usfm = database_bibles.getChapter ("phpunit", 2, 3);
+    evaluate (__LINE__, __func__, false, usfm.find ("Text") != string::npos);
+    evaluate (__LINE__, __func__, 7, (int)search_logic_search_bible_text ("phpunit", "word of").size ());
+    refresh_sandbox (true, {"Replacing in Bible"});
+  }
+
+  // A chapter saved after its replacements were planned is left as it is.
+  {
+    refresh_sandbox (true);
+    test_search_setup ();
+    Search_Replace_Chapter replace = search_logic_plan_replace_chapter ("phpunit", 2, 3, {1, 2}, "Text", "Word", true, true);
+    evaluate (__LINE__, __func__, vector <int> {1, 2}, replace.verses);
+    Database_Bibles database_bibles;
+    string usfm = database_bibles.getChapter ("phpunit", 2, 3);
+    database_bibles.storeChapter ("phpunit", 2, 3, usfm + "\\v 8 Saved meanwhile.");
+    evaluate (__LINE__, __func__, false, search_replace_bible_store ("phpunit", replace));
+    evaluate (__LINE__, __func__, "\\v 8 Saved meanwhile.", database_bibles.getChapter ("phpunit", 2, 3).substr (usfm.size ()));
+    replace = search_logic_plan_replace_chapter ("phpunit", 2, 3, {1, 2}, "Text", "Word", true, true);
+    evaluate (__LINE__, __func__, true, search_replace_bible_store ("phpunit", replace));
+    evaluate (__LINE__, __func__, replace.new_usfm, database_bibles.getChapter ("phpunit", 2, 3));
+  }
+  
+  // Forced reindexing only indexes the chapters whose text changed since they were indexed.
+  {
+    refresh_sandbox (true);
+    test_search_setup ();
+    evaluate (__LINE__, __func__, true, search_logic_index_current ("phpunit", 2, 3));
+    string path = search_logic_chapter_file ("phpunit", 2, 3);
+    filter_url_file_put_contents (path, "hash");
+    string path2 = search_logic_chapter_file ("phpunit2", 4, 5);
+    string index2 = filter_url_file_get_contents (path2);
+    filter_url_file_put_contents (path2, index2 + "\nunchanged");
+    evaluate (__LINE__, __func__, false, search_logic_index_current ("phpunit", 2, 3));
+    evaluate (__LINE__, __func__, true, search_logic_index_current ("phpunit2", 4, 5));
+    Database_Config_General::setIndexBibles (true);
+    search_reindex_bibles (true);
+    evaluate (__LINE__, __func__, true, search_logic_index_current ("phpunit", 2, 3));
+    evaluate (__LINE__, __func__, "Text of the 6th sixth verse ✆.", search_logic_get_bible_verse_text ("phpunit", 2, 3, 6));
+    evaluate (__LINE__, __func__, index2 + "\nunchanged", filter_url_file_get_contents (path2));
+    evaluate (__LINE__, __func__, false, Database_Config_General::getIndexBibles ());
+    refresh_sandbox (true, {"Indexing Bibles"});
+  }
+
+  // A change in the stylesheet of a Bible makes its index out of date.
+  {
+    refresh_sandbox (true);
+    test_search_setup ();
+    Database_Styles database_styles;
+    database_styles.create ();
+    database_styles.createSheet ("phpunit");
+    Database_Config_Bible::setExportStylesheet ("phpunit", "phpunit");
+    search_logic_index_chapter ("phpunit", 2, 3);
+    evaluate (__LINE__, __func__, true, search_logic_index_current ("phpunit", 2, 3));
+    database_styles.updateUserbool1 ("phpunit", "f", true);
+    evaluate (__LINE__, __func__, false, search_logic_index_current ("phpunit", 2, 3));
+    search_logic_index_chapter ("phpunit", 2, 3);
+    evaluate (__LINE__, __func__, true, search_logic_index_current ("phpunit", 2, 3));
+  }
 }
@@ -277,6 +277,27 @@ void test_styles ()
     evaluate (__LINE__, __func__, "Paragraph", data.info);
   }
   
+  // The compiled stylesheet is shared, and is compiled again after a change.
+  {
+    refresh_sandbox (true);
+    Database_Styles database_styles;
+    database_styles.createSheet ("phpunit");
+    shared_ptr <const Database_Styles_Sheet> sheet = database_styles.compile ("phpunit");
+    evaluate (__LINE__, __func__, true, sheet == database_styles.compile ("phpunit"));
+    int id = sheet->identifier ("add");
+    evaluate (__LINE__, __func__, true, id >= 0);
+    if (id >= 0) evaluate (__LINE__, __func__, "add", sheet->items [id].marker);
+    evaluate (__LINE__, __func__, -1, sheet->identifier ("zhq"));
+    evaluate (__LINE__, __func__, true, sheet->find ("zhq") == nullptr);
+    evaluate (__LINE__, __func__, "", sheet->get ("zhq").marker);
+    evaluate (__LINE__, __func__, "st", sheet->get ("add").category);
+    database_styles.updateName ("phpunit", "add", "Addition");
+    shared_ptr <const Database_Styles_Sheet> updated = database_styles.compile ("phpunit");
+    evaluate (__LINE__, __func__, true, updated->version > sheet->version);
+    evaluate (__LINE__, __func__, "Addition", updated->get ("add").name);
+    evaluate (__LINE__, __func__, false, sheet->get ("add").name == "Addition");
+  }
+  
   // Read and write access to the styles database.
   {
     refresh_sandbox (true);
@@ -0,0 +1,122 @@
+/*
+Copyright (©) 2003-2021 Teus Benschop.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+#include <unittests/sword.h>
+#include <unittests/utilities.h>
+#include <filter/url.h>
+#include <filter/string.h>
+#include <database/versifications.h>
+#include <sword/reader.h>
+#include <sword/logic.h>
+
+
+void test_sword ()
+{
+  trace_unit_tests (__func__);
+  
+  refresh_sandbox (true);
+  Database_Versifications database_versifications;
+  database_versifications.create ();
+  database_versifications.defaults ();
+  string sword_path = filter_url_create_root_path ("sword");
+
+  // Test the position of verse keys in the testament indexes.
+  {
+    string testament;
+    int index = 0;
+    evaluate (__LINE__, __func__, true, sword_reader_get_index (1, 1, 1, testament, index));
+    evaluate (__LINE__, __func__, "ot", testament);
+    evaluate (__LINE__, __func__, 4, index);
+    sword_reader_get_index (1, 2, 1, testament, index);
+    evaluate (__LINE__, __func__, 36, index);
+    sword_reader_get_index (2, 1, 1, testament, index);
+    evaluate (__LINE__, __func__, 1588, index);
+    sword_reader_get_index (40, 1, 1, testament, index);
+    evaluate (__LINE__, __func__, "nt", testament);
+    evaluate (__LINE__, __func__, 4, index);
+    evaluate (__LINE__, __func__, false, sword_reader_get_index (1, 1, 32, testament, index));
+    evaluate (__LINE__, __func__, false, sword_reader_get_index (67, 1, 1, testament, index));
+  }
+  
+  // Test reading uncompressed and compressed modules.
+  map <string, map <int, string> > texts;
+  texts ["ot"][4] = "<w lemma=\"strong:H07225\">In the beginning</w> God created the heaven and the earth.";
+  texts ["ot"][5] = "And the earth was without form<note type=\"x-study\">Or, empty</note>, and void.";
+  texts ["ot"][36] = "Thus the heavens and the earth were finished.";
+  texts ["ot"][1588] = "Now these are the names.";
+  texts ["nt"][4] = "The book of the generation of Jesus Christ.";
+  test_sword_write_module (sword_path, "RAW", false, texts);
+  test_sword_write_module (sword_path, "ZIP", true, texts);
+  for (auto module : { "RAW", "ZIP" }) {
+    string text;
+    evaluate (__LINE__, __func__, true, sword_reader_get_verse (sword_path, module, 1, 1, 1, text));
+    evaluate (__LINE__, __func__, texts ["ot"][4], text);
+    sword_reader_get_verse (sword_path, module, 1, 1, 2, text);
+    evaluate (__LINE__, __func__, "And the earth was without form, and void.", text);
+    sword_reader_get_verse (sword_path, module, 1, 1, 3, text);
+    evaluate (__LINE__, __func__, "", text);
+    sword_reader_get_verse (sword_path, module, 2, 1, 1, text);
+    evaluate (__LINE__, __func__, texts ["ot"][1588], text);
+    sword_reader_get_verse (sword_path, module, 40, 1, 1, text);
+    evaluate (__LINE__, __func__, texts ["nt"][4], text);
+    // Beyond the end of the index files.
+    evaluate (__LINE__, __func__, true, sword_reader_get_verse (sword_path, module, 66, 22, 21, text));
+    evaluate (__LINE__, __func__, "", text);
+    map <int, string> chapter;
+    evaluate (__LINE__, __func__, true, sword_reader_get_chapter (sword_path, module, 1, 1, chapter));
+    evaluate (__LINE__, __func__, {
+      make_pair (1, texts ["ot"][4]),
+      make_pair (2, string ("And the earth was without form, and void."))
+    }, vector <pair <int, string> > (chapter.begin (), chapter.end ()));
+    // The module name is not case-sensitive.
+    evaluate (__LINE__, __func__, true, sword_reader_get_verse (sword_path, unicode_string_casefold (module), 1, 2, 1, text));
+    evaluate (__LINE__, __func__, texts ["ot"][36], text);
+  }
+  
+  // The text is cleaned the same way as the output of diatheke.
+  {
+    string text;
+    sword_reader_get_verse (sword_path, "ZIP", 1, 1, 1, text);
+    text = sword_logic_clean_verse ("ZIP", 1, 1, text);
+    evaluate (__LINE__, __func__, "In the beginning God created the heaven and the earth.", text);
+  }
+  
+  // A module that is not installed, or that cannot be read, is left to diatheke.
+  {
+    string text;
+    evaluate (__LINE__, __func__, false, sword_reader_get_verse (sword_path, "NONE", 1, 1, 1, text));
+    string path = filter_url_create_path (sword_path, "mods.d", "raw.conf");
+    string conf = filter_url_file_get_contents (path);
+    filter_url_file_put_contents (path, conf + "CipherKey=\n");
+    sword_reader_forget ("RAW");
+    evaluate (__LINE__, __func__, false, sword_reader_get_verse (sword_path, "RAW", 1, 1, 1, text));
+    filter_url_file_put_contents (path, conf);
+    sword_reader_forget ("RAW");
+    evaluate (__LINE__, __func__, true, sword_reader_get_verse (sword_path, "RAW", 1, 1, 1, text));
+    // Forgetting a module does not depend on the case of its name.
+    filter_url_file_put_contents (path, conf + "CipherKey=\n");
+    sword_reader_forget ("raw");
+    evaluate (__LINE__, __func__, false, sword_reader_get_verse (sword_path, "RAW", 1, 1, 1, text));
+    filter_url_file_put_contents (path, conf);
+    sword_reader_forget ("Raw");
+    evaluate (__LINE__, __func__, true, sword_reader_get_verse (sword_path, "RAW", 1, 1, 1, text));
+  }
+  
+  refresh_sandbox (true);
+}
@@ -49,13 +49,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <unittests/usfm.h>
 #include <unittests/verses.h>
 #include <unittests/pairs.h>
+#include <unittests/automaton.h>
 #include <unittests/hyphenate.h>
 #include <unittests/search.h>
 #include <unittests/json.h>
 #include <unittests/related.h>
+#include <unittests/sword.h>
 #include <unittests/editone.h>
 #include <unittests/http.h>
 #include <unittests/memory.h>
+#include <unittests/metrics.h>
 #include <unittests/tasks.h>
 #include <unittests/biblegateway.h>
 #include <unittests/rss.h>
@@ -99,6 +102,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <unittests/state.h>
 #include <unittests/strong.h>
 #include <unittests/morphgnt.h>
+#include <unittests/columns.h>
 #include <unittests/etcbc4.h>
 #include <unittests/lexicon.h>
 #include <unittests/cache.h>
@@ -125,8 +129,8 @@ int main (int argc, char **argv)
   // Directory where the unit tests will run.
   testing_directory = "/tmp/bibledit-unittests";  
   filter_url_mkdir (testing_directory);
-  refresh_sandbox (true);
   config_globals_document_root = testing_directory;
+  refresh_sandbox (true);
 
   // Initialize SSL/TLS (after webroot has been set).
   filter_url_ssl_tls_initialize ();
@@ -197,10 +201,12 @@ int main (int argc, char **argv)
   test_versification ();
   test_usfm ();
   test_pairs ();
+  test_automaton ();
   test_hyphenate ();
   test_database_noteassignment ();
   test_database_strong ();
   test_database_morphgnt ();
+  test_database_columns ();
   test_database_etcbc4 ();
   test_lexicons ();
   test_database_cache ();
@@ -211,9 +217,12 @@ int main (int argc, char **argv)
   test_database_git ();
   test_database_userresources ();
   test_related ();
+  test_sword ();
   test_editone_logic ();
+  test_edit_update ();
   test_http ();
   test_memory ();
+  test_metrics ();
   test_database_statistics ();
   test_tasks_logic ();
   test_biblegateway ();
@@ -690,6 +690,66 @@ void test_usfm ()
     evaluate (__LINE__, __func__, "\\v 2-4 Verse 2, 3, and 4.", result);
   }
   
+  // Test getting the texts of all verses in one pass gives the same as getting them one by one.
+  {
+    string usfm =
+    "\\c 1\n"
+    "\\s Heading\n"
+    "\\p\n"
+    "\\v 1 Verse 1.\n"
+    "\\v 2-4 Verse 2, 3, and 4.\n"
+    "\\p\n"
+    "\\v 5 Verse 5. \\v 6 Verse 6.\n"
+    "\\v 8,9 Verse 8 and 9.\n"
+    "\\v 7 Verse 7 out of order.\n"
+    "\\v 1 Verse 1 again.\n"
+    "\\p Ending";
+    map <int, string> texts = usfm_get_verses_text (usfm);
+    for (int verse = 0; verse <= 10; verse++) {
+      evaluate (__LINE__, __func__, usfm_get_verse_text (usfm, verse), texts [verse]);
+    }
+    evaluate (__LINE__, __func__, "\\v 1 Verse 1.\n\\v 1 Verse 1 again.\n\\p Ending", texts [1]);
+    evaluate (__LINE__, __func__, "\\v 2-4 Verse 2, 3, and 4.\n\\p", texts [3]);
+  }
+
+  // Test the chapter parsed once gives the same as the functions that go through the whole chapter.
+  {
+    string usfm =
+    "\\c 1\n"
+    "\\s Heading\n"
+    "\\p\n"
+    "\\v 1 Verse 1.\n"
+    "\\v 2-4 Verse 2, 3, and 4.\n"
+    "\\p\n"
+    "\\v 5 Verse ü5. \\v 6 Verse 6.\n"
+    "\\v 8,9 Verse 8 and 9.\n"
+    "\\v 7 Verse 7 out of order.\n"
+    "\\v 1 Verse 1 again.\n"
+    "\\p Ending\n";
+    Filter_Usfm_Chapter parsed (usfm);
+    evaluate (__LINE__, __func__, usfm_get_verse_numbers (usfm), parsed.verse_numbers ());
+    evaluate (__LINE__, __func__, {0, 1, 2, 3, 4, 5, 6, 8, 9, 7, 1}, parsed.verse_numbers ());
+    for (int verse = 0; verse <= 10; verse++) {
+      evaluate (__LINE__, __func__, usfm_get_verse_text (usfm, verse), parsed.verse_text (verse));
+      evaluate (__LINE__, __func__, usfm_versenumber_to_offset (usfm, verse), parsed.verse_offset (verse));
+    }
+    for (unsigned int offset = 0; offset < usfm.size (); offset += 7) {
+      evaluate (__LINE__, __func__, usfm_offset_to_versenumber (usfm, offset), parsed.offset_verses (offset));
+    }
+    // The spans point into the USFM of the chapter.
+    vector <pair <size_t, size_t> > spans = parsed.verse_spans (1);
+    evaluate (__LINE__, __func__, 2, (int) spans.size ());
+    evaluate (__LINE__, __func__, "\\v 1 Verse 1.", parsed.usfm ().substr (spans [0].first, spans [0].second));
+    evaluate (__LINE__, __func__, "\\v 1 Verse 1 again.\n\\p Ending", parsed.usfm ().substr (spans [1].first, spans [1].second));
+    spans = parsed.verse_spans (3);
+    evaluate (__LINE__, __func__, 1, (int) spans.size ());
+    evaluate (__LINE__, __func__, "\\v 2-4 Verse 2, 3, and 4.\n\\p", parsed.usfm ().substr (spans [0].first, spans [0].second));
+    evaluate (__LINE__, __func__, 0, (int) parsed.verse_spans (10).size ());
+    evaluate (__LINE__, __func__, "", parsed.verse_text (10));
+    evaluate (__LINE__, __func__, {5, 6}, parsed.offset_verses (80));
+    evaluate (__LINE__, __func__, (int) unicode_string_length (usfm), parsed.verse_offset (10));
+  }
+
   // Testing USFM extraction for Quill-based visual verse editor with more than one empty paragraph in sequence.
   {
     string usfm =
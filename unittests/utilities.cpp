@@ -20,8 +20,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <unittests/utilities.h>
 #include <filter/string.h>
 #include <filter/url.h>
+#include <database/logs.h>
 #include <filter/shell.h>
 #include <webserver/request.h>
+#include <sword/reader.h>
+#include <miniz/miniz.h>
 
 
 string testing_directory;
@@ -36,11 +39,10 @@ void refresh_sandbox (bool displayjournal, vector <string> allowed)
   // Display any old journal entries.
   if (displayjournal) {
     bool output = false;
-    string directory = filter_url_create_path (testing_directory, "logbook");
-    vector <string> files = filter_url_scandir (directory);
+    string lastfilename;
+    vector <string> files = Database_Logs::get (lastfilename);
     for (unsigned int i = 0; i < files.size (); i++) {
-      if (files [i] == "gitflag") continue;
-      string contents = filter_url_file_get_contents (filter_url_create_path (directory, files [i]));
+      string contents = Database_Logs::entry (files [i]);
       bool display = true;
       for (auto & allow : allowed) {
         if (contents.find (allow) != string::npos) display = false;
@@ -53,6 +55,9 @@ void refresh_sandbox (bool displayjournal, vector <string> allowed)
     if (output) error_count++;
   }
   
+  // Write buffered journal entries now, so they do not end up in the refreshed sandbox.
+  Database_Logs::flush ();
+  
   // Refresh.
   string command = "rsync . -a --delete " + testing_directory;
   int status = system (command.c_str());
@@ -268,3 +273,92 @@ int odf2txt (string odf, string txt)
   int ret = system (command.c_str());
   return ret;
 }
+
+
+// Encodes $value as a little-endian unsigned integer of $size bytes.
+static string test_sword_encode (unsigned int value, size_t size)
+{
+  string data;
+  for (size_t i = 0; i < size; i++) {
+    data.push_back ((char) ((value >> (8 * i)) & 0xff));
+  }
+  return data;
+}
+
+
+// Writes a SWORD module with the $texts per testament and per index into $sword_path.
+// A $compressed module uses the zText driver and puts each book into a separate block.
+void test_sword_write_module (string sword_path, string module, bool compressed, map <string, map <int, string> > texts)
+{
+  string folder = unicode_string_casefold (module);
+  string data_path = filter_url_create_path (sword_path, "modules", "texts", compressed ? "ztext" : "rawtext", folder);
+  filter_url_mkdir (data_path);
+  filter_url_mkdir (filter_url_create_path (sword_path, "mods.d"));
+
+  string conf;
+  conf.append ("[" + module + "]\n");
+  conf.append ("DataPath=./modules/texts/" + string (compressed ? "ztext" : "rawtext") + "/" + folder + "/\n");
+  conf.append ("ModDrv=" + string (compressed ? "zText" : "RawText") + "\n");
+  if (compressed) {
+    conf.append ("BlockType=BOOK\n");
+    conf.append ("CompressType=ZIP\n");
+  }
+  conf.append ("SourceType=OSIS\n");
+  conf.append ("Encoding=UTF-8\n");
+  conf.append ("Lang=en\n");
+  conf.append ("Description=Test module\n");
+  filter_url_file_put_contents (filter_url_create_path (sword_path, "mods.d", folder + ".conf"), conf);
+
+  for (auto & testament_texts : texts) {
+    string testament = testament_texts.first;
+    map <int, string> & entries = testament_texts.second;
+    int last_index = entries.empty () ? 0 : entries.rbegin ()->first;
+    if (compressed) {
+      // The books of the KJV versification start at these indexes.
+      vector <int> book_starts;
+      for (int book = 1; book <= 66; book++) {
+        string book_testament;
+        int index = 0;
+        if (sword_reader_get_index (book, 0, 0, book_testament, index)) {
+          if (book_testament == testament) book_starts.push_back (index);
+        }
+      }
+      string verse_index, block_index, blocks, block;
+      unsigned int block_number = 0;
+      auto flush = [&] () {
+        mz_ulong length = mz_compressBound (block.size ());
+        string compressed_block (length, '\0');
+        mz_compress ((unsigned char *) &compressed_block [0], &length, (const unsigned char *) block.data (), block.size ());
+        compressed_block.resize (length);
+        block_index.append (test_sword_encode (blocks.size (), 4));
+        block_index.append (test_sword_encode (compressed_block.size (), 4));
+        block_index.append (test_sword_encode (block.size (), 4));
+        blocks.append (compressed_block);
+        block.clear ();
+        block_number++;
+      };
+      for (int index = 0; index <= last_index; index++) {
+        if ((index > 0) && in_array (index, book_starts) && !block.empty ()) flush ();
+        string text = entries.count (index) ? entries [index] : "";
+        verse_index.append (test_sword_encode (block_number, 4));
+        verse_index.append (test_sword_encode (block.size (), 4));
+        verse_index.append (test_sword_encode (text.size (), 2));
+        block.append (text);
+      }
+      flush ();
+      filter_url_file_put_contents (filter_url_create_path (data_path, testament + ".bzv"), verse_index);
+      filter_url_file_put_contents (filter_url_create_path (data_path, testament + ".bzs"), block_index);
+      filter_url_file_put_contents (filter_url_create_path (data_path, testament + ".bzz"), blocks);
+    } else {
+      string verse_index, data;
+      for (int index = 0; index <= last_index; index++) {
+        string text = entries.count (index) ? entries [index] : "";
+        verse_index.append (test_sword_encode (data.size (), 4));
+        verse_index.append (test_sword_encode (text.size (), 2));
+        data.append (text);
+      }
+      filter_url_file_put_contents (filter_url_create_path (data_path, testament + ".vss"), verse_index);
+      filter_url_file_put_contents (filter_url_create_path (data_path, testament), data);
+    }
+  }
+}
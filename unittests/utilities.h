@@ -43,6 +43,7 @@ void evaluate (int line, string func, map <string, string> desired, map <string,
 void evaluate (int line, string func, vector <pair<int, string>> desired, vector <pair<int, string>> actual);
 void trace_unit_tests (string func);
 int odf2txt (string odf, string txt);
+void test_sword_write_module (string sword_path, string module, bool compressed, map <string, map <int, string> > texts);
 
 
 #endif
@@ -377,6 +377,27 @@ void test_database_mappings ()
     standard = Passage ("", 14, 14, "14");
     evaluate (__LINE__, __func__, true, passages[1].equal (standard));
   }
+  // Translate after the mapping changes.
+  {
+    refresh_sandbox (true);
+    Database_Mappings database_mappings;
+    database_mappings.create1 ();
+    database_mappings.import ("ABA", "2 Chronicles 14:12 = 2 Chronicles 14:14");
+    vector <Passage> passages = database_mappings.translate ("ABA", "Hebrew Greek", 14, 14, 12);
+    evaluate (__LINE__, __func__, 1, (int)passages.size ());
+    Passage standard = Passage ("", 14, 14, "14");
+    evaluate (__LINE__, __func__, true, passages[0].equal (standard));
+    database_mappings.import ("ABA", "2 Chronicles 14:12 = 2 Chronicles 14:15");
+    passages = database_mappings.translate ("ABA", "Hebrew Greek", 14, 14, 12);
+    evaluate (__LINE__, __func__, 1, (int)passages.size ());
+    standard = Passage ("", 14, 14, "15");
+    evaluate (__LINE__, __func__, true, passages[0].equal (standard));
+    database_mappings.erase ("ABA");
+    passages = database_mappings.translate ("ABA", "Hebrew Greek", 14, 14, 12);
+    evaluate (__LINE__, __func__, 1, (int)passages.size ());
+    standard = Passage ("", 14, 14, "12");
+    evaluate (__LINE__, __func__, true, passages[0].equal (standard));
+  }
   
 }
 
@@ -476,4 +497,25 @@ void test_database_versifications ()
     string output = database_versifications.output ("phpunit");
     evaluate (__LINE__, __func__, filter_string_trim (input), filter_string_trim (output));
   }
+  // Reading after the system changes.
+  {
+    refresh_sandbox (true);
+    Database_Versifications database_versifications;
+    database_versifications.create ();
+    database_versifications.input ("Genesis 1:31\nGenesis 3:24\n", "phpunit");
+    evaluate (__LINE__, __func__, {1}, database_versifications.getBooks ("phpunit"));
+    evaluate (__LINE__, __func__, {1, 3}, database_versifications.getChapters ("phpunit", 1));
+    evaluate (__LINE__, __func__, {}, database_versifications.getVerses ("phpunit", 1, 2));
+    evaluate (__LINE__, __func__, 25, (int)database_versifications.getVerses ("phpunit", 1, 3).size ());
+    evaluate (__LINE__, __func__, {}, database_versifications.getVerses ("phpunit", 2, 1));
+    database_versifications.input ("Genesis 1:31\nGenesis 2:25\nExodus 1:22\n", "phpunit");
+    evaluate (__LINE__, __func__, {1, 2}, database_versifications.getBooks ("phpunit"));
+    evaluate (__LINE__, __func__, {1, 2}, database_versifications.getChapters ("phpunit", 1));
+    evaluate (__LINE__, __func__, 26, (int)database_versifications.getVerses ("phpunit", 1, 2).size ());
+    evaluate (__LINE__, __func__, 23, (int)database_versifications.getVerses ("phpunit", 2, 1).size ());
+    evaluate (__LINE__, __func__, 3, (int)database_versifications.getBooksChaptersVerses ("phpunit").size ());
+    database_versifications.erase ("phpunit");
+    evaluate (__LINE__, __func__, {}, database_versifications.getBooks ("phpunit"));
+    evaluate (__LINE__, __func__, {}, database_versifications.getChapters ("phpunit", 1));
+  }
 }
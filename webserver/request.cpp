@@ -30,6 +30,7 @@ Webserver_Request::Webserver_Request ()
   content_length = 0;
   response_code = 200;
   resend_cookie = false;
+  unknown_route = false;
 }
 
 
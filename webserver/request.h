@@ -76,6 +76,8 @@ public:
   string response_content_type;
    // The path of the file to copy from disk straight to the network without loading it in memory.
   string stream_file;
+   // Whether none of the pages handled the request, so it was forwarded to the home page.
+  bool unknown_route;
   // Extra objects.
   Session_Logic * session_logic ();
   Database_Config_User * database_config_user ();
@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 #include <filter/string.h>
 #include <filter/url.h>
 #include <filter/date.h>
+#include <filter/metrics.h>
 #include <mbedtls/entropy.h>
 #include <mbedtls/ctr_drbg.h>
 #include <mbedtls/certs.h>
@@ -85,6 +86,30 @@ int get_line (int sock, char *buf, int size)
 }
 
 
+// Runs the $request through the handlers to assemble the response.
+// It keeps the statistics of the request, which came in as $bytes_in.
+void webserver_respond (Webserver_Request & request, long bytes_in)
+{
+  string route = filter_metrics_route (request.get);
+  filter_metrics_begin (route);
+  long start = filter_date_elapsed_microseconds (0);
+  try {
+    bootstrap_index (&request);
+    http_assemble_response (&request);
+  } catch (...) {
+    // Still count the request, so it does not remain in flight.
+    filter_metrics_end (route, filter_date_elapsed_microseconds (start), bytes_in, 0);
+    throw;
+  }
+  long microseconds = filter_date_elapsed_microseconds (start);
+  // Count all URLs that no page handles together, so they do not fill up the statistics.
+  if (request.unknown_route) route = filter_metrics_unknown_route ();
+  long bytes_out = request.reply.size ();
+  if (!request.stream_file.empty ()) bytes_out += filter_url_filesize (request.stream_file);
+  filter_metrics_end (route, microseconds, bytes_in, bytes_out);
+}
+
+
 // Processes a single request from a web client.
 void webserver_process_request (int connfd, string clientaddress)
 {
@@ -114,6 +139,7 @@ void webserver_process_request (int connfd, string clientaddress)
       // An empty line marks the end of the headers.
 #define BUFFERSIZE 2048
       int bytes_read;
+      long bytes_in = 0;
       bool header_parsed = true;
       char buffer [BUFFERSIZE];
       // Fix valgrind unitialized value message.
@@ -121,6 +147,7 @@ void webserver_process_request (int connfd, string clientaddress)
       do {
         bytes_read = get_line (connfd, buffer, BUFFERSIZE);
         if (bytes_read <= 0) connection_healthy = false;
+        else bytes_in += bytes_read;
         // Parse the browser's request's headers.
         header_parsed = http_parse_header (buffer, &request);
       } while (header_parsed);
@@ -155,8 +182,7 @@ void webserver_process_request (int connfd, string clientaddress)
           http_parse_post (postdata, &request);
           
           // Assemble response.
-          bootstrap_index (&request);
-          http_assemble_response (&request);
+          webserver_respond (request, bytes_in + postdata.size ());
           
           // Send response to browser.
           const char * output = request.reply.c_str();
@@ -537,6 +563,7 @@ void secure_webserver_process_request (mbedtls_ssl_config * conf, mbedtls_net_co
       }
       
       // Read the HTTP headers.
+      long bytes_in = 0;
       bool header_parsed = true;
       string header_line;
       while (connection_healthy && header_parsed) {
@@ -555,6 +582,7 @@ void secure_webserver_process_request (mbedtls_ssl_config * conf, mbedtls_net_co
         if (ret == 0) header_parsed = false; // 0: EOF
         if (ret < 0) connection_healthy = false;
         if (connection_healthy && header_parsed) {
+          bytes_in++;
           char c = buffer [0];
           // The request contains a carriage return (\r) and a new line feed (\n).
           // The traditional order of this is \r\n.
@@ -597,6 +625,7 @@ void secure_webserver_process_request (mbedtls_ssl_config * conf, mbedtls_net_co
           if (total_bytes_read >= request.content_length) done_reading = true;
         }
         if (total_bytes_read < request.content_length) connection_healthy = false;
+        bytes_in += postdata.size ();
         // Parse the POSTed data.
         if (connection_healthy) {
           http_parse_post (postdata, &request);
@@ -605,8 +634,7 @@ void secure_webserver_process_request (mbedtls_ssl_config * conf, mbedtls_net_co
       
       // Assemble response.
       if (connection_healthy) {
-        bootstrap_index (&request);
-        http_assemble_response (&request);
+        webserver_respond (request, bytes_in);
       }
       
       // Write the response to the browser.